@@ -31,12 +31,47 @@
 
 #define DEPRECATED(msg) [[deprecated(msg)]]
 
+// Compile time evaluation check, std::is_constant_evaluated in C++20 and the compiler builtin before that
+// (msvc 19.25, gcc 9, clang 9), without either constexpr math functions always take the runtime path
+#if defined(CXX20)
+    #include <type_traits>
+#endif
+#if defined(__cpp_lib_is_constant_evaluated)
+    #define IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif (defined(_MSC_VER) && _MSC_VER >= 1925) || (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9)
+    #define IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#elif defined(__has_builtin)
+    #if __has_builtin(__builtin_is_constant_evaluated)
+        #define IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+    #endif
+#endif
+#ifndef IS_CONSTANT_EVALUATED
+    #define IS_CONSTANT_EVALUATED() false
+#endif
+
+// Vectorization hint for batch loops, the loop body must not depend on earlier iterations
+#if defined(_MSC_VER)
+    #define VECTORIZE __pragma(loop(ivdep))
+#elif defined(__clang__)
+    #define VECTORIZE _Pragma("clang loop vectorize(enable)")
+#elif defined(__GNUC__)
+    #define VECTORIZE _Pragma("GCC ivdep")
+#else
+    #define VECTORIZE
+#endif
+
 // Standard includes
 #include <ostream>
 #include <exception>
 #include <numeric>
 #include <cmath>
 
+// Hot path counters, empty unless BARDCORE_INSTRUMENTATION is defined, the per pixel costs are made of them
+#if defined(BARDCORE_PIXEL_COST) && !defined(BARDCORE_INSTRUMENTATION)
+    #define BARDCORE_INSTRUMENTATION
+#endif
+#include "BardCore/utility/instrumentation.h"
+
 namespace bardcore
 {
     namespace exception
@@ -52,10 +87,12 @@ namespace bardcore
         public:
             explicit bard_exception(const char* msg) : msg_(msg)
             {
+                INSTRUMENT(exceptions);
             }
 
             explicit bard_exception(const std::string& msg): msg_(msg)
             {
+                INSTRUMENT(exceptions);
             }
 
             ~bard_exception() noexcept override = default;
@@ -77,5 +114,6 @@ namespace bardcore
 #include "BardCore/exception/negative_exception.h"
 #include "BardCore/exception/same_object_exception.h"
 #include "BardCore/exception/out_of_range_exception.h"
+#include "BardCore/exception/io_exception.h"
 
 #endif // BARDCORE_H
\ No newline at end of file
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/geometry/sphere_set.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/camera.h"
+
+namespace bardcore
+{
+    namespace geometry
+    {
+        /**
+         * \brief view frustum of a camera as 6 planes, culls batches of spheres and boxes against it
+         *
+         * a point p is inside a plane if normal . p + offset >= 0, it is inside the frustum if it is inside every
+         * plane. the culling is conservative, a box near a corner of the frustum can be visible while it is outside
+         */
+        class frustum
+        {
+        public:
+            /**
+             * \brief amount of planes: left, right, top, bottom, near, far
+             */
+            INLINE static constexpr std::size_t plane_count = 6;
+
+        protected:
+            std::array<double, plane_count> normal_x_{}, normal_y_{}, normal_z_{}; // inward normal of every plane
+            std::array<double, plane_count> offset_{}; // offset of every plane
+
+        public:
+            /**
+             * \brief constructor for frustum, extracts the planes from a camera
+             * \throws negative_exception if near is negative
+             * \throws out_of_range_exception if far is not greater than near
+             * \param camera camera to extract the planes from
+             * \param near_plane distance of the near plane along the camera direction
+             * \param far_plane distance of the far plane along the camera direction, infinite by default
+             */
+            explicit frustum(const utility::camera& camera, const double near_plane = 0,
+                             const double far_plane = math::inf)
+            {
+                if (near_plane < 0)
+                    throw exception::negative_exception("near plane can't be negative");
+                if (far_plane <= near_plane)
+                    throw exception::out_of_range_exception("far plane must be greater than near plane");
+
+                const point3d& position = camera.get_position();
+                const vector3d& direction = camera.get_direction();
+                const vector3d& horizontal = camera.get_half_horizontal();
+                const vector3d& vertical = camera.get_half_vertical();
+
+                //the edges of the view, from the camera through the corners of the screen
+                const vector3d top_left = direction - horizontal + vertical;
+                const vector3d top_right = direction + horizontal + vertical;
+                const vector3d bottom_left = direction - horizontal - vertical;
+                const vector3d bottom_right = direction + horizontal - vertical;
+
+                set_plane(0, bottom_left.cross(top_left), position, direction);
+                set_plane(1, top_right.cross(bottom_right), position, direction);
+                set_plane(2, top_left.cross(top_right), position, direction);
+                set_plane(3, bottom_right.cross(bottom_left), position, direction);
+
+                normal_x_[4] = direction.x;
+                normal_y_[4] = direction.y;
+                normal_z_[4] = direction.z;
+                offset_[4] = -(direction.dot(vector3d(position.x, position.y, position.z)) + near_plane);
+
+                normal_x_[5] = -direction.x;
+                normal_y_[5] = -direction.y;
+                normal_z_[5] = -direction.z;
+                offset_[5] = direction.dot(vector3d(position.x, position.y, position.z)) + far_plane;
+            }
+
+            /**
+             * \brief checks if a point is inside the frustum
+             * \param point point to check
+             * \return true if the point is inside every plane
+             */
+            NODISCARD bool contains(const point3d& point) const noexcept { return intersects_sphere(point, 0); }
+
+            /**
+             * \brief checks if a sphere is (partly) inside the frustum
+             * \param center center of the sphere
+             * \param radius radius of the sphere
+             * \return true if the sphere is not completely outside one of the planes
+             */
+            NODISCARD bool intersects_sphere(const point3d& center, const double radius) const noexcept
+            {
+                bool visible = true;
+                for (std::size_t plane = 0; plane < plane_count; ++plane)
+                    visible &= distance(plane, center.x, center.y, center.z) >= -radius;
+
+                return visible;
+            }
+
+            /**
+             * \brief checks if an axis aligned box is (partly) inside the frustum
+             * \param min minimum corner of the box
+             * \param max maximum corner of the box
+             * \return true if the box is not completely outside one of the planes
+             */
+            NODISCARD bool intersects_box(const point3d& min, const point3d& max) const noexcept
+            {
+                INSTRUMENT(box_tests);
+
+                bool visible = true;
+                for (std::size_t plane = 0; plane < plane_count; ++plane)
+                    visible &= box_distance(plane, min.x, min.y, min.z, max.x, max.y, max.z) >= 0;
+
+                return visible;
+            }
+
+            /**
+             * \brief culls spheres, collects the indices of the spheres that are (partly) inside the frustum
+             * \param centers center of every sphere
+             * \param radius radius of every sphere
+             * \param visible indices of the visible spheres in ascending order, resized to the amount of them
+             * \return amount of visible spheres
+             */
+            std::size_t cull_spheres(const dimension3_soa<point3d>& centers, const std::vector<double>& radius,
+                                     std::vector<std::uint32_t>& visible) const
+            {
+                const std::size_t count = centers.size();
+                const double* x = centers.x();
+                const double* y = centers.y();
+                const double* z = centers.z();
+                const double* r = radius.data();
+
+                //visible holds the mask until it is compacted
+                visible.assign(count, 1);
+                std::uint32_t* mask = visible.data();
+
+                //one plane at a time so the loop over the spheres is branch free
+                for (std::size_t plane = 0; plane < plane_count; ++plane)
+                {
+                    const double nx = normal_x_[plane], ny = normal_y_[plane], nz = normal_z_[plane];
+                    const double offset = offset_[plane];
+
+                    VECTORIZE
+                    for (std::size_t index = 0; index < count; ++index)
+                    {
+                        const double signed_distance = nx * x[index] + ny * y[index] + nz * z[index] + offset;
+                        mask[index] = signed_distance >= -r[index] ? mask[index] : 0;
+                    }
+                }
+
+                return compact(visible);
+            }
+
+            /**
+             * \brief culls the spheres of a sphere_set
+             * \param spheres spheres to cull
+             * \param visible indices of the visible spheres in ascending order, resized to the amount of them
+             * \return amount of visible spheres
+             */
+            std::size_t cull_spheres(const sphere_set& spheres, std::vector<std::uint32_t>& visible) const
+            {
+                return cull_spheres(spheres.get_centers(), spheres.get_radii(), visible);
+            }
+
+            /**
+             * \brief culls axis aligned boxes, collects the indices of the boxes that are (partly) inside the frustum
+             * \param min minimum corner of every box
+             * \param max maximum corner of every box
+             * \param visible indices of the visible boxes in ascending order, resized to the amount of visible boxes
+             * \return amount of visible boxes
+             */
+            std::size_t cull_boxes(const dimension3_soa<point3d>& min, const dimension3_soa<point3d>& max,
+                                   std::vector<std::uint32_t>& visible) const
+            {
+                const std::size_t count = min.size();
+                const double* min_x = min.x();
+                const double* min_y = min.y();
+                const double* min_z = min.z();
+                const double* max_x = max.x();
+                const double* max_y = max.y();
+                const double* max_z = max.z();
+                INSTRUMENT_ADD(box_tests, count);
+
+                visible.assign(count, 1);
+                std::uint32_t* mask = visible.data();
+
+                for (std::size_t plane = 0; plane < plane_count; ++plane)
+                {
+                    const double nx = normal_x_[plane], ny = normal_y_[plane], nz = normal_z_[plane];
+                    const double offset = offset_[plane];
+
+                    //the corner furthest along the normal decides, it is picked per axis by the sign of the normal
+                    const bool positive_x = nx >= 0, positive_y = ny >= 0, positive_z = nz >= 0;
+                    const double* corner_x = positive_x ? max_x : min_x;
+                    const double* corner_y = positive_y ? max_y : min_y;
+                    const double* corner_z = positive_z ? max_z : min_z;
+
+                    VECTORIZE
+                    for (std::size_t index = 0; index < count; ++index)
+                    {
+                        const double signed_distance = nx * corner_x[index] + ny * corner_y[index] + nz *
+                            corner_z[index] + offset;
+                        mask[index] = signed_distance >= 0 ? mask[index] : 0;
+                    }
+                }
+
+                return compact(visible);
+            }
+
+        protected:
+            /**
+             * \brief sets a side plane through the camera position, flipped so it faces the view direction
+             * \param plane index of the plane
+             * \param normal normal of the plane, not normalized
+             * \param position position of the camera
+             * \param direction direction of the camera
+             */
+            void set_plane(const std::size_t plane, const vector3d& normal, const point3d& position,
+                           const vector3d& direction)
+            {
+                vector3d inward = normal.normalize();
+                if (inward.dot(direction) < 0)
+                    inward = inward * -1;
+
+                normal_x_[plane] = inward.x;
+                normal_y_[plane] = inward.y;
+                normal_z_[plane] = inward.z;
+                offset_[plane] = -inward.dot(vector3d(position.x, position.y, position.z));
+            }
+
+            /**
+             * \brief signed distance of a point to a plane, positive inside
+             */
+            NODISCARD double distance(const std::size_t plane, const double x, const double y, const double z) const
+                noexcept
+            {
+                return normal_x_[plane] * x + normal_y_[plane] * y + normal_z_[plane] * z + offset_[plane];
+            }
+
+            /**
+             * \brief signed distance of the corner of a box that is furthest inside a plane
+             */
+            NODISCARD double box_distance(const std::size_t plane, const double min_x, const double min_y,
+                                          const double min_z, const double max_x, const double max_y,
+                                          const double max_z) const noexcept
+            {
+                return distance(plane, normal_x_[plane] >= 0 ? max_x : min_x, normal_y_[plane] >= 0 ? max_y : min_y,
+                                normal_z_[plane] >= 0 ? max_z : min_z);
+            }
+
+            /**
+             * \brief replaces a mask (1 visible, 0 culled) with the indices of the visible objects, branch free
+             * \param visible mask of every object, indices of the visible objects afterwards
+             * \return amount of visible objects
+             */
+            static std::size_t compact(std::vector<std::uint32_t>& visible)
+            {
+                const std::size_t count = visible.size();
+
+                //every index is written, but the write position only moves on for visible ones, it never passes the
+                //read position so the mask can be overwritten in place
+                std::size_t written = 0;
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const std::uint32_t mask = visible[index];
+                    visible[written] = static_cast<std::uint32_t>(index);
+                    written += mask;
+                }
+
+                visible.resize(written);
+                return written;
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            /**
+             * \brief gets the inward normal of a plane
+             * \param plane index of the plane, 0 left, 1 right, 2 top, 3 bottom, 4 near, 5 far
+             * \return normalized inward normal
+             */
+            NODISCARD vector3d get_normal(const std::size_t plane) const noexcept
+            {
+                return {normal_x_[plane], normal_y_[plane], normal_z_[plane]};
+            }
+
+            /**
+             * \brief gets the offset of a plane, normal . p + offset is the signed distance of p
+             * \param plane index of the plane, 0 left, 1 right, 2 top, 3 bottom, 4 near, 5 far
+             * \return offset of the plane
+             */
+            NODISCARD double get_offset(const std::size_t plane) const noexcept { return offset_[plane]; }
+        };
+    } // namespace bardcore::geometry
+} // namespace bardcore
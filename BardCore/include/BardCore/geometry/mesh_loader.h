@@ -0,0 +1,1109 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <limits>
+#include <cmath>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/number_parser.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/scene_cache.h"
+
+namespace bardcore
+{
+    namespace geometry
+    {
+        /**
+         * \brief triangle mesh in structure of arrays layout, filled by mesh_loader
+         */
+        class mesh_buffers
+        {
+        public:
+            /**
+             * \brief position of every vertex
+             */
+            dimension3_soa<point3d> positions;
+
+            /**
+             * \brief normal of every vertex, empty if the file has no normals
+             * \note an obj file indexes its normals separately, they are stored in the order of the file
+             */
+            dimension3_soa<vector3d> normals;
+
+            /**
+             * \brief three vertex indices per triangle, polygons are split into a fan of triangles
+             */
+            std::vector<std::uint32_t> indices;
+
+        public:
+            NODISCARD std::size_t vertex_count() const noexcept { return positions.size(); }
+            NODISCARD std::size_t triangle_count() const noexcept { return indices.size() / 3; }
+
+            /**
+             * \brief removes all vertices, normals and triangles, memory is kept
+             */
+            void clear() noexcept
+            {
+                positions.clear();
+                normals.clear();
+                indices.clear();
+            }
+        };
+
+        /**
+         * \brief loads obj and ply meshes into mesh_buffers, e.g. scanned models of several gigabytes
+         *
+         * the file is memory mapped and split into chunks of whole lines that are parsed on their own threads. a
+         * first pass counts the vertices and triangles of every chunk, the buffers are then sized once and the second
+         * pass writes every chunk straight into its part of the buffers, no vertex is ever stored as an object
+         * \note binary ply vertices are converted straight from the mapped file, without reading it into a buffer
+         */
+        class mesh_loader
+        {
+        public:
+            /**
+             * \brief chunks are at least this many bytes, smaller files are parsed on one thread
+             */
+            INLINE static constexpr std::size_t min_chunk_bytes = 1 << 20;
+
+            /**
+             * \brief loads an obj or ply file, the format is detected from the start of the file
+             * \throws io_exception if the file can't be read or isn't a valid obj or ply file
+             * \param path path of the file
+             * \param threads amount of threads, 0 means parallel::hardware_threads()
+             * \return loaded mesh
+             */
+            NODISCARD static mesh_buffers load(const std::string& path, const unsigned int threads = 0)
+            {
+                const utility::mapped_file file(path);
+                return load(static_cast<const char*>(file.data()), file.size(), threads);
+            }
+
+            /**
+             * \brief loads an obj or ply file from memory, a file starting with "ply" is a ply file
+             * \throws io_exception if the memory isn't a valid obj or ply file
+             * \param data start of the file
+             * \param size size of the file in bytes
+             * \param threads amount of threads, 0 means parallel::hardware_threads()
+             * \return loaded mesh
+             */
+            NODISCARD static mesh_buffers load(const char* data, const std::size_t size, const unsigned int threads = 0)
+            {
+                mesh_buffers mesh;
+                if (size >= 3 && std::memcmp(data, "ply", 3) == 0)
+                    load_ply(data, size, mesh, threads);
+                else
+                    load_obj(data, size, mesh, threads);
+                return mesh;
+            }
+
+            /**
+             * \brief loads an obj file from memory, only v, vn and f lines are used
+             * \note face corners may be v, v/vt, v//vn or v/vt/vn and negative (relative) indices
+             * \throws io_exception if a line can't be parsed or a face refers to a vertex that doesn't exist
+             * \param data start of the file
+             * \param size size of the file in bytes
+             * \param mesh loaded mesh, overwritten
+             * \param threads amount of threads, 0 means parallel::hardware_threads()
+             */
+            static void load_obj(const char* data, const std::size_t size, mesh_buffers& mesh,
+                                 const unsigned int threads = 0)
+            {
+                const std::vector<const char*> bounds = split_lines(data, data + size, threads);
+                const std::size_t chunks = bounds.size() - 1;
+
+                //first pass, amounts per chunk
+                std::vector<obj_counts> counts(chunks);
+                run_chunks(chunks, [&](const std::size_t chunk)
+                {
+                    counts[chunk] = count_obj(bounds[chunk], bounds[chunk + 1]);
+                });
+
+                //offsets of every chunk in the buffers
+                std::vector<obj_counts> offsets(chunks + 1);
+                for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+                {
+                    offsets[chunk + 1].vertices = offsets[chunk].vertices + counts[chunk].vertices;
+                    offsets[chunk + 1].normals = offsets[chunk].normals + counts[chunk].normals;
+                    offsets[chunk + 1].triangles = offsets[chunk].triangles + counts[chunk].triangles;
+                    offsets[chunk + 1].invalid = offsets[chunk].invalid || counts[chunk].invalid;
+                }
+
+                const obj_counts& total = offsets[chunks];
+                if (total.invalid)
+                    throw exception::io_exception("obj file has a face with less than 3 corners");
+                check_vertex_count(total.vertices);
+
+                mesh.positions.resize(total.vertices);
+                mesh.normals.resize(total.normals);
+                mesh.indices.resize(total.triangles * 3);
+
+                //second pass, every chunk writes its own part of the buffers
+                std::vector<std::uint8_t> failed(chunks, 0);
+                run_chunks(chunks, [&](const std::size_t chunk)
+                {
+                    failed[chunk] = parse_obj(bounds[chunk], bounds[chunk + 1], offsets[chunk], total.vertices, mesh)
+                                        ? 0
+                                        : 1;
+                });
+
+                for (const std::uint8_t chunk_failed : failed)
+                    if (chunk_failed)
+                        throw exception::io_exception("obj file has an invalid vertex or face");
+            }
+
+            /**
+             * \brief loads an ascii, binary little endian or binary big endian ply file from memory
+             * \note the vertex element gives the positions (x, y, z) and the normals (nx, ny, nz), the face element
+             * the vertex_indices (or vertex_index) list, other elements and properties are skipped
+             * \throws io_exception if the header or an element can't be parsed or a face refers to a vertex that
+             * doesn't exist
+             * \param data start of the file
+             * \param size size of the file in bytes
+             * \param mesh loaded mesh, overwritten
+             * \param threads amount of threads, 0 means parallel::hardware_threads()
+             */
+            static void load_ply(const char* data, const std::size_t size, mesh_buffers& mesh,
+                                 const unsigned int threads = 0)
+            {
+                if (size < 3 || std::memcmp(data, "ply", 3) != 0)
+                    throw exception::io_exception("memory doesn't contain a ply file");
+
+                const char* last = data + size;
+                ply_header header;
+                const char* body = parse_ply_header(data, last, header);
+
+                mesh.clear();
+                for (const ply_element& element : header.elements)
+                {
+                    if (element.name == "vertex")
+                    {
+                        check_vertex_count(element.count);
+                        body = header.format == ply_format::ascii
+                                   ? parse_ply_ascii_vertices(body, last, element, mesh, threads)
+                                   : parse_ply_binary_vertices(body, last, element, header.format, mesh, threads);
+                    }
+                    else if (element.name == "face")
+                        body = header.format == ply_format::ascii
+                                   ? parse_ply_ascii_faces(body, last, element, mesh, threads)
+                                   : parse_ply_binary_faces(body, last, element, header.format, mesh);
+                    else
+                        body = skip_ply_element(body, last, element, header.format);
+                }
+            }
+
+        protected:
+            /**
+             * \brief amounts in a chunk of an obj file
+             */
+            struct obj_counts
+            {
+                std::size_t vertices = 0;
+                std::size_t normals = 0;
+                std::size_t triangles = 0;
+                bool invalid = false; // a face with less than 3 corners
+            };
+
+            /**
+             * \brief type of a ply property
+             */
+            enum class ply_type : std::uint8_t { int8, uint8, int16, uint16, int32, uint32, float32, float64 };
+
+            /**
+             * \brief encoding of a ply file
+             */
+            enum class ply_format : std::uint8_t { ascii, binary_little_endian, binary_big_endian };
+
+            /**
+             * \brief property of a ply element, a list has a count before its values
+             */
+            struct ply_property
+            {
+                std::string name;
+                ply_type type = ply_type::float32; // type of the value, or of the values of a list
+                ply_type count_type = ply_type::uint8; // type of the count of a list
+                bool list = false;
+            };
+
+            /**
+             * \brief element of a ply file, e.g. vertex or face
+             */
+            struct ply_element
+            {
+                std::string name;
+                std::size_t count = 0;
+                std::vector<ply_property> properties;
+            };
+
+            /**
+             * \brief header of a ply file
+             */
+            struct ply_header
+            {
+                ply_format format = ply_format::ascii;
+                std::vector<ply_element> elements;
+            };
+
+            /**
+             * \brief runs function(chunk) for every chunk, one chunk per thread
+             */
+            template <typename Function>
+            static void run_chunks(const std::size_t chunks, Function&& function)
+            {
+                utility::parallel::for_each_chunk(chunks, static_cast<unsigned int>(chunks),
+                                                  [&function](unsigned int, const std::size_t begin,
+                                                              const std::size_t end)
+                                                  {
+                                                      for (std::size_t chunk = begin; chunk < end; ++chunk)
+                                                          function(chunk);
+                                                  });
+            }
+
+            /**
+             * \brief splits [first, last) into chunks of whole lines, at least min_chunk_bytes each
+             * \return bounds of the chunks, chunk i is [bounds[i], bounds[i + 1])
+             */
+            static std::vector<const char*> split_lines(const char* first, const char* last, const unsigned int threads)
+            {
+                const std::size_t size = static_cast<std::size_t>(last - first);
+                const std::size_t chunks = utility::parallel::thread_count(size / min_chunk_bytes + 1, threads);
+
+                std::vector<const char*> bounds{first};
+                for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+                {
+                    //a chunk starts after the newline at or after its even share
+                    const char* split = first + utility::parallel::chunk_begin(size, static_cast<unsigned int>(chunks),
+                                                                               static_cast<unsigned int>(chunk));
+                    split = split < bounds.back() ? bounds.back() : split;
+                    const void* newline = std::memchr(split, '\n', static_cast<std::size_t>(last - split));
+                    bounds.push_back(newline != nullptr ? static_cast<const char*>(newline) + 1 : last);
+                }
+                bounds.push_back(last);
+                return bounds;
+            }
+
+            /**
+             * \brief gets the end of the line at first, the newline excluded
+             */
+            NODISCARD static const char* line_end(const char* first, const char* last) noexcept
+            {
+                const void* newline = std::memchr(first, '\n', static_cast<std::size_t>(last - first));
+                return newline != nullptr ? static_cast<const char*>(newline) : last;
+            }
+
+            /**
+             * \brief gets the start of the next line from the end of a line
+             */
+            NODISCARD static const char* next_line(const char* end, const char* last) noexcept
+            {
+                return end == last ? last : end + 1;
+            }
+
+            /**
+             * \brief gets the start of the line after count lines
+             * \return start of the line, nullptr if there are less than count lines
+             */
+            NODISCARD static const char* skip_lines(const char* first, const char* last, std::size_t count) noexcept
+            {
+                for (; count > 0; --count)
+                {
+                    if (first == last)
+                        return nullptr;
+                    first = next_line(line_end(first, last), last);
+                }
+                return first;
+            }
+
+            /**
+             * \brief throws if the vertices can't be indexed by 32 bit indices
+             */
+            static void check_vertex_count(const std::size_t count)
+            {
+                if (count > std::numeric_limits<std::uint32_t>::max())
+                    throw exception::io_exception("mesh has too many vertices for 32 bit indices");
+            }
+
+            /**
+             * \brief checks the keyword at the start of an obj line
+             * \return 1 for a vertex, 2 for a normal, 3 for a face, 0 for anything else
+             */
+            NODISCARD static int obj_keyword(const char*& first, const char* end) noexcept
+            {
+                const std::size_t length = static_cast<std::size_t>(end - first);
+                const bool space1 = length > 1 && (first[1] == ' ' || first[1] == '\t');
+                const bool space2 = length > 2 && (first[2] == ' ' || first[2] == '\t');
+
+                if (length > 0 && first[0] == 'v' && space1)
+                {
+                    first += 2;
+                    return 1;
+                }
+                if (length > 1 && first[0] == 'v' && first[1] == 'n' && space2)
+                {
+                    first += 3;
+                    return 2;
+                }
+                if (length > 0 && first[0] == 'f' && space1)
+                {
+                    first += 2;
+                    return 3;
+                }
+                return 0;
+            }
+
+            /**
+             * \brief first pass over a chunk of an obj file, counts vertices, normals and triangles
+             */
+            static obj_counts count_obj(const char* first, const char* last) noexcept
+            {
+                obj_counts counts;
+                while (first < last)
+                {
+                    const char* end = line_end(first, last);
+                    const char* line = utility::number_parser::skip_spaces(first, end);
+
+                    switch (obj_keyword(line, end))
+                    {
+                    case 1:
+                        ++counts.vertices;
+                        break;
+                    case 2:
+                        ++counts.normals;
+                        break;
+                    case 3:
+                        {
+                            std::size_t corners = 0;
+                            for (line = utility::number_parser::skip_spaces(line, end); line != end && *line != '#';
+                                 line = utility::number_parser::skip_spaces(line, end))
+                            {
+                                ++corners;
+                                line = utility::number_parser::skip_token(line, end);
+                            }
+
+                            counts.invalid = counts.invalid || corners < 3;
+                            counts.triangles += corners >= 3 ? corners - 2 : 0;
+                            break;
+                        }
+                    default:
+                        break;
+                    }
+
+                    first = next_line(end, last);
+                }
+
+                return counts;
+            }
+
+            /**
+             * \brief second pass over a chunk of an obj file, writes it to its part of the buffers
+             * \param first first character of the chunk
+             * \param last one past the last character of the chunk
+             * \param offsets amounts in all earlier chunks
+             * \param vertex_count amount of vertices in the whole file
+             * \param mesh buffers, already sized for the whole file
+             * \return false if a vertex or face can't be parsed
+             */
+            static bool parse_obj(const char* first, const char* last, const obj_counts& offsets,
+                                  const std::size_t vertex_count, mesh_buffers& mesh) noexcept
+            {
+                double* position_x = mesh.positions.x();
+                double* position_y = mesh.positions.y();
+                double* position_z = mesh.positions.z();
+                double* normal_x = mesh.normals.x();
+                double* normal_y = mesh.normals.y();
+                double* normal_z = mesh.normals.z();
+                std::uint32_t* index = mesh.indices.data() + offsets.triangles * 3;
+                std::size_t vertex = offsets.vertices;
+                std::size_t normal = offsets.normals;
+
+                while (first < last)
+                {
+                    const char* end = line_end(first, last);
+                    const char* line = utility::number_parser::skip_spaces(first, end);
+
+                    switch (obj_keyword(line, end))
+                    {
+                    case 1:
+                        if (!parse_xyz(line, end, position_x[vertex], position_y[vertex], position_z[vertex]))
+                            return false;
+                        ++vertex;
+                        break;
+                    case 2:
+                        if (!parse_xyz(line, end, normal_x[normal], normal_y[normal], normal_z[normal]))
+                            return false;
+                        ++normal;
+                        break;
+                    case 3:
+                        {
+                            //fan of triangles (first, previous, current)
+                            std::uint32_t first_corner = 0, previous = 0;
+                            std::size_t corner = 0;
+                            for (line = utility::number_parser::skip_spaces(line, end); line != end && *line != '#';
+                                 line = utility::number_parser::skip_spaces(line, end), ++corner)
+                            {
+                                std::int64_t value = 0;
+                                line = utility::number_parser::parse(line, end, value);
+                                if (line == nullptr)
+                                    return false;
+
+                                //1 based, negative is relative to the vertices before this line
+                                const std::int64_t resolved = value < 0
+                                                                  ? static_cast<std::int64_t>(vertex) + value
+                                                                  : value - 1;
+                                if (value == 0 || resolved < 0 || resolved >= static_cast<std::int64_t>(vertex_count))
+                                    return false;
+
+                                const std::uint32_t current = static_cast<std::uint32_t>(resolved);
+                                if (corner == 0)
+                                    first_corner = current;
+                                else if (corner >= 2)
+                                {
+                                    index[0] = first_corner;
+                                    index[1] = previous;
+                                    index[2] = current;
+                                    index += 3;
+                                }
+                                previous = current;
+
+                                //texture and normal indices are skipped
+                                line = utility::number_parser::skip_token(line, end);
+                            }
+                            break;
+                        }
+                    default:
+                        break;
+                    }
+
+                    first = next_line(end, last);
+                }
+
+                return true;
+            }
+
+            /**
+             * \brief parses three numbers
+             * \return false if there are less than three numbers
+             */
+            static bool parse_xyz(const char* first, const char* last, double& x, double& y, double& z) noexcept
+            {
+                first = utility::number_parser::parse(first, last, x);
+                first = first != nullptr ? utility::number_parser::parse(first, last, y) : nullptr;
+                first = first != nullptr ? utility::number_parser::parse(first, last, z) : nullptr;
+                return first != nullptr;
+            }
+
+            /**
+             * \brief parses the type of a ply property
+             */
+            static ply_type parse_ply_type(const std::string& name)
+            {
+                if (name == "char" || name == "int8")
+                    return ply_type::int8;
+                if (name == "uchar" || name == "uint8")
+                    return ply_type::uint8;
+                if (name == "short" || name == "int16")
+                    return ply_type::int16;
+                if (name == "ushort" || name == "uint16")
+                    return ply_type::uint16;
+                if (name == "int" || name == "int32")
+                    return ply_type::int32;
+                if (name == "uint" || name == "uint32")
+                    return ply_type::uint32;
+                if (name == "float" || name == "float32")
+                    return ply_type::float32;
+                if (name == "double" || name == "float64")
+                    return ply_type::float64;
+
+                throw exception::io_exception("ply file has an unknown property type " + name);
+            }
+
+            /**
+             * \brief gets the size of a ply type in bytes
+             */
+            NODISCARD static std::size_t ply_size(const ply_type type) noexcept
+            {
+                switch (type)
+                {
+                case ply_type::int8:
+                case ply_type::uint8:
+                    return 1;
+                case ply_type::int16:
+                case ply_type::uint16:
+                    return 2;
+                case ply_type::int32:
+                case ply_type::uint32:
+                case ply_type::float32:
+                    return 4;
+                default:
+                    return 8;
+                }
+            }
+
+            /**
+             * \brief splits a header line into its words
+             */
+            static std::vector<std::string> split_words(const char* first, const char* last)
+            {
+                std::vector<std::string> words;
+                for (first = utility::number_parser::skip_spaces(first, last); first != last;
+                     first = utility::number_parser::skip_spaces(first, last))
+                {
+                    const char* end = utility::number_parser::skip_token(first, last);
+                    words.emplace_back(first, end);
+                    first = end;
+                }
+                return words;
+            }
+
+            /**
+             * \brief parses the header of a ply file
+             * \return first character after end_header
+             */
+            static const char* parse_ply_header(const char* first, const char* last, ply_header& header)
+            {
+                bool has_format = false;
+                const char* line = skip_lines(first, last, 1);
+                while (line != nullptr && line != last)
+                {
+                    const char* end = line_end(line, last);
+                    const std::vector<std::string> words = split_words(line, end);
+                    line = next_line(end, last);
+
+                    if (words.empty() || words[0] == "comment" || words[0] == "obj_info")
+                        continue;
+
+                    if (words[0] == "end_header")
+                    {
+                        if (!has_format)
+                            throw exception::io_exception("ply file has no format");
+                        return line;
+                    }
+
+                    if (words[0] == "format" && words.size() >= 2)
+                    {
+                        if (words[1] == "ascii")
+                            header.format = ply_format::ascii;
+                        else if (words[1] == "binary_little_endian")
+                            header.format = ply_format::binary_little_endian;
+                        else if (words[1] == "binary_big_endian")
+                            header.format = ply_format::binary_big_endian;
+                        else
+                            throw exception::io_exception("ply file has an unknown format " + words[1]);
+                        has_format = true;
+                    }
+                    else if (words[0] == "element" && words.size() >= 3)
+                    {
+                        std::int64_t count = 0;
+                        const char* number = words[2].c_str();
+                        if (utility::number_parser::parse(number, number + words[2].size(), count) == nullptr ||
+                            count < 0)
+                            throw exception::io_exception("ply file has an invalid element count");
+
+                        header.elements.push_back({words[1], static_cast<std::size_t>(count), {}});
+                    }
+                    else if (words[0] == "property" && !header.elements.empty())
+                    {
+                        ply_property property;
+                        if (words.size() >= 5 && words[1] == "list")
+                        {
+                            property.list = true;
+                            property.count_type = parse_ply_type(words[2]);
+                            property.type = parse_ply_type(words[3]);
+                            property.name = words[4];
+                        }
+                        else if (words.size() >= 3)
+                        {
+                            property.type = parse_ply_type(words[1]);
+                            property.name = words[2];
+                        }
+                        else
+                            throw exception::io_exception("ply file has an invalid property");
+
+                        header.elements.back().properties.push_back(property);
+                    }
+                    else
+                        throw exception::io_exception("ply file has an invalid header line");
+                }
+
+                throw exception::io_exception("ply file has no end_header");
+            }
+
+            /**
+             * \brief finds the index of a property, properties.size() if there is none
+             */
+            NODISCARD static std::size_t find_property(const ply_element& element, const char* name) noexcept
+            {
+                for (std::size_t index = 0; index < element.properties.size(); ++index)
+                    if (element.properties[index].name == name)
+                        return index;
+                return element.properties.size();
+            }
+
+            /**
+             * \brief finds the vertex index list of a face element
+             */
+            static std::size_t find_face_list(const ply_element& element)
+            {
+                std::size_t list = find_property(element, "vertex_indices");
+                list = list == element.properties.size() ? find_property(element, "vertex_index") : list;
+                if (list == element.properties.size() || !element.properties[list].list)
+                    throw exception::io_exception("ply face element has no vertex_indices list");
+                return list;
+            }
+
+            /**
+             * \brief reads a binary ply value from the file, converted to double
+             */
+            NODISCARD static double read_ply(const char* data, const ply_type type, const bool swap) noexcept
+            {
+                unsigned char bytes[8];
+                const std::size_t size = ply_size(type);
+                std::memcpy(bytes, data, size);
+                for (std::size_t index = 0; swap && index < size / 2; ++index)
+                {
+                    const unsigned char byte = bytes[index];
+                    bytes[index] = bytes[size - 1 - index];
+                    bytes[size - 1 - index] = byte;
+                }
+
+                switch (type)
+                {
+                case ply_type::int8: return read_bytes<std::int8_t>(bytes);
+                case ply_type::uint8: return read_bytes<std::uint8_t>(bytes);
+                case ply_type::int16: return read_bytes<std::int16_t>(bytes);
+                case ply_type::uint16: return read_bytes<std::uint16_t>(bytes);
+                case ply_type::int32: return read_bytes<std::int32_t>(bytes);
+                case ply_type::uint32: return read_bytes<std::uint32_t>(bytes);
+                case ply_type::float32: return read_bytes<float>(bytes);
+                default: return read_bytes<double>(bytes);
+                }
+            }
+
+            /**
+             * \brief converts the count of a binary ply list, which the header may declare as a float or double
+             * \throws io_exception if the count is negative, not finite, not a whole number or more than bytes_left
+             * \param value count read with read_ply
+             * \param bytes_left bytes left in the file, every list element takes at least one
+             * \return count of the list
+             */
+            NODISCARD static std::size_t ply_list_count(const double value, const std::size_t bytes_left)
+            {
+                //the comparisons are false for nan, the bound also rejects infinity before the conversion
+                if (!(value >= 0 && value <= static_cast<double>(bytes_left)) || value != std::floor(value))
+                    throw exception::io_exception("ply file has an invalid list");
+                return static_cast<std::size_t>(value);
+            }
+
+            /**
+             * \brief reads a value of type T from bytes in the byte order of the machine
+             */
+            template <typename T>
+            NODISCARD static double read_bytes(const unsigned char* bytes) noexcept
+            {
+                T value;
+                std::memcpy(&value, bytes, sizeof(T));
+                return static_cast<double>(value);
+            }
+
+            /**
+             * \brief checks if the byte order of a binary ply file differs from the machine
+             */
+            NODISCARD static bool swaps(const ply_format format) noexcept
+            {
+                const std::uint16_t probe = 1;
+                unsigned char low = 0;
+                std::memcpy(&low, &probe, 1);
+                return (format == ply_format::binary_little_endian) != (low == 1);
+            }
+
+            /**
+             * \brief parses the ascii vertex element, in parallel chunks of whole lines
+             * \return first character after the element
+             */
+            static const char* parse_ply_ascii_vertices(const char* first, const char* last,
+                                                        const ply_element& element, mesh_buffers& mesh,
+                                                        const unsigned int threads)
+            {
+                const char* end = skip_lines(first, last, element.count);
+                if (end == nullptr)
+                    throw exception::io_exception("ply file has less vertices than its header");
+
+                std::size_t columns[6];
+                const bool has_normals = vertex_columns(element, columns);
+                mesh.positions.resize(element.count);
+                mesh.normals.resize(has_normals ? element.count : 0);
+
+                //first pass, lines per chunk
+                const std::vector<const char*> bounds = split_lines(first, end, threads);
+                const std::size_t chunks = bounds.size() - 1;
+                std::vector<std::size_t> offsets(chunks + 1, 0);
+                run_chunks(chunks, [&](const std::size_t chunk)
+                {
+                    std::size_t lines = 0;
+                    for (const char* line = bounds[chunk]; line < bounds[chunk + 1];
+                         line = next_line(line_end(line, bounds[chunk + 1]), bounds[chunk + 1]))
+                        ++lines;
+                    offsets[chunk + 1] = lines;
+                });
+                for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+                    offsets[chunk + 1] += offsets[chunk];
+
+                //second pass, every line is one vertex
+                std::vector<std::uint8_t> failed(chunks, 0);
+                run_chunks(chunks, [&](const std::size_t chunk)
+                {
+                    double* targets[6] = {
+                        mesh.positions.x(), mesh.positions.y(), mesh.positions.z(), mesh.normals.x(), mesh.normals.y(),
+                        mesh.normals.z()
+                    };
+
+                    std::size_t vertex = offsets[chunk];
+                    for (const char* line = bounds[chunk]; line < bounds[chunk + 1] && !failed[chunk]; ++vertex)
+                    {
+                        const char* line_last = line_end(line, bounds[chunk + 1]);
+                        for (std::size_t column = 0; column < element.properties.size() && line != nullptr; ++column)
+                        {
+                            double value = 0;
+                            line = utility::number_parser::parse(line, line_last, value);
+                            for (std::size_t target = 0; target < (has_normals ? 6u : 3u); ++target)
+                                if (columns[target] == column)
+                                    targets[target][vertex] = value;
+                        }
+
+                        failed[chunk] = line == nullptr ? 1 : 0;
+                        line = next_line(line_last, bounds[chunk + 1]);
+                    }
+                });
+
+                for (const std::uint8_t chunk_failed : failed)
+                    if (chunk_failed)
+                        throw exception::io_exception("ply file has an invalid vertex");
+
+                return end;
+            }
+
+            /**
+             * \brief finds the columns of x, y, z, nx, ny and nz of the vertex element
+             * \return true if all normal columns are present
+             */
+            static bool vertex_columns(const ply_element& element, std::size_t (&columns)[6])
+            {
+                const char* names[6] = {"x", "y", "z", "nx", "ny", "nz"};
+                for (std::size_t index = 0; index < 6; ++index)
+                    columns[index] = find_property(element, names[index]);
+
+                for (const ply_property& property : element.properties)
+                    if (property.list)
+                        throw exception::io_exception("ply vertex element can't have a list property");
+
+                if (columns[0] == element.properties.size() || columns[1] == element.properties.size() ||
+                    columns[2] == element.properties.size())
+                    throw exception::io_exception("ply vertex element needs x, y and z");
+
+                return columns[3] != element.properties.size() && columns[4] != element.properties.size() &&
+                    columns[5] != element.properties.size();
+            }
+
+            /**
+             * \brief parses the binary vertex element, in parallel straight from the mapped file
+             * \return first character after the element
+             */
+            static const char* parse_ply_binary_vertices(const char* first, const char* last,
+                                                         const ply_element& element, const ply_format format,
+                                                         mesh_buffers& mesh, const unsigned int threads)
+            {
+                std::size_t columns[6];
+                const bool has_normals = vertex_columns(element, columns);
+
+                //offset of every property, the stride is fixed without lists
+                std::vector<std::size_t> offsets;
+                std::size_t stride = 0;
+                for (const ply_property& property : element.properties)
+                {
+                    offsets.push_back(stride);
+                    stride += ply_size(property.type);
+                }
+
+                if (static_cast<std::size_t>(last - first) / stride < element.count)
+                    throw exception::io_exception("ply file has less vertices than its header");
+
+                mesh.positions.resize(element.count);
+                mesh.normals.resize(has_normals ? element.count : 0);
+
+                const bool swap = swaps(format);
+                utility::parallel::for_each_chunk(element.count, threads, [&](unsigned int, const std::size_t begin,
+                                                                              const std::size_t end)
+                {
+                    double* targets[6] = {
+                        mesh.positions.x(), mesh.positions.y(), mesh.positions.z(), mesh.normals.x(), mesh.normals.y(),
+                        mesh.normals.z()
+                    };
+
+                    for (std::size_t target = 0; target < (has_normals ? 6u : 3u); ++target)
+                    {
+                        const ply_type type = element.properties[columns[target]].type;
+                        const char* source = first + offsets[columns[target]];
+                        double* values = targets[target];
+                        for (std::size_t vertex = begin; vertex < end; ++vertex)
+                            values[vertex] = read_ply(source + vertex * stride, type, swap);
+                    }
+                });
+
+                return first + element.count * stride;
+            }
+
+            /**
+             * \brief reads the faces of one ascii line
+             * \param first start of the line
+             * \param last end of the line
+             * \param element face element
+             * \param list index of the vertex index list
+             * \param vertex_count amount of vertices, nullptr to only count the triangles
+             * \param index where to write the triangles, nullptr to only count
+             * \param triangles amount of triangles of the line
+             * \return false if the line can't be parsed or refers to a vertex that doesn't exist
+             */
+            static bool parse_ply_ascii_face(const char* first, const char* last, const ply_element& element,
+                                             const std::size_t list, const std::size_t vertex_count,
+                                             std::uint32_t* index, std::size_t& triangles) noexcept
+            {
+                triangles = 0;
+                for (std::size_t column = 0; column < element.properties.size(); ++column)
+                {
+                    std::int64_t count = 1;
+                    if (element.properties[column].list)
+                    {
+                        first = utility::number_parser::parse(first, last, count);
+                        if (first == nullptr || count < 0)
+                            return false;
+                    }
+
+                    if (column != list)
+                    {
+                        for (std::int64_t value = 0; value < count; ++value)
+                        {
+                            first = utility::number_parser::skip_spaces(first, last);
+                            if (first == last)
+                                return false;
+                            first = utility::number_parser::skip_token(first, last);
+                        }
+                        continue;
+                    }
+
+                    if (count < 3)
+                        return false;
+                    triangles = static_cast<std::size_t>(count - 2);
+
+                    std::uint32_t first_corner = 0, previous = 0;
+                    for (std::int64_t corner = 0; corner < count; ++corner)
+                    {
+                        std::int64_t value = 0;
+                        first = utility::number_parser::parse(first, last, value);
+                        if (first == nullptr)
+                            return false;
+                        if (index == nullptr)
+                            continue;
+                        if (value < 0 || value >= static_cast<std::int64_t>(vertex_count))
+                            return false;
+
+                        const std::uint32_t current = static_cast<std::uint32_t>(value);
+                        if (corner == 0)
+                            first_corner = current;
+                        else if (corner >= 2)
+                        {
+                            index[0] = first_corner;
+                            index[1] = previous;
+                            index[2] = current;
+                            index += 3;
+                        }
+                        previous = current;
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+             * \brief parses the ascii face element, in parallel chunks of whole lines
+             * \return first character after the element
+             */
+            static const char* parse_ply_ascii_faces(const char* first, const char* last,
+                                                     const ply_element& element, mesh_buffers& mesh,
+                                                     const unsigned int threads)
+            {
+                const char* end = skip_lines(first, last, element.count);
+                if (end == nullptr)
+                    throw exception::io_exception("ply file has less faces than its header");
+
+                const std::size_t list = find_face_list(element);
+                const std::size_t vertex_count = mesh.positions.size();
+
+                //first pass, triangles per chunk
+                const std::vector<const char*> bounds = split_lines(first, end, threads);
+                const std::size_t chunks = bounds.size() - 1;
+                std::vector<std::size_t> offsets(chunks + 1, 0);
+                std::vector<std::uint8_t> failed(chunks, 0);
+                run_chunks(chunks, [&](const std::size_t chunk)
+                {
+                    for (const char* line = bounds[chunk]; line < bounds[chunk + 1] && !failed[chunk];)
+                    {
+                        const char* line_last = line_end(line, bounds[chunk + 1]);
+                        std::size_t triangles = 0;
+                        failed[chunk] = parse_ply_ascii_face(line, line_last, element, list, vertex_count, nullptr,
+                                                             triangles)
+                                            ? 0
+                                            : 1;
+                        offsets[chunk + 1] += triangles;
+                        line = next_line(line_last, bounds[chunk + 1]);
+                    }
+                });
+
+                for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+                {
+                    if (failed[chunk])
+                        throw exception::io_exception("ply file has an invalid face");
+                    offsets[chunk + 1] += offsets[chunk];
+                }
+
+                const std::size_t first_index = mesh.indices.size();
+                mesh.indices.resize(first_index + offsets[chunks] * 3);
+
+                //second pass, every chunk writes its own part of the indices
+                run_chunks(chunks, [&](const std::size_t chunk)
+                {
+                    std::uint32_t* index = mesh.indices.data() + first_index + offsets[chunk] * 3;
+                    for (const char* line = bounds[chunk]; line < bounds[chunk + 1] && !failed[chunk];)
+                    {
+                        const char* line_last = line_end(line, bounds[chunk + 1]);
+                        std::size_t triangles = 0;
+                        failed[chunk] = parse_ply_ascii_face(line, line_last, element, list, vertex_count, index,
+                                                             triangles)
+                                            ? 0
+                                            : 1;
+                        index += triangles * 3;
+                        line = next_line(line_last, bounds[chunk + 1]);
+                    }
+                });
+
+                for (const std::uint8_t chunk_failed : failed)
+                    if (chunk_failed)
+                        throw exception::io_exception("ply face refers to a vertex that doesn't exist");
+
+                return end;
+            }
+
+            /**
+             * \brief parses the binary face element, the lists have a variable size so it is one pass in order
+             * \return first character after the element
+             */
+            static const char* parse_ply_binary_faces(const char* first, const char* last,
+                                                      const ply_element& element, const ply_format format,
+                                                      mesh_buffers& mesh)
+            {
+                const std::size_t list = find_face_list(element);
+                const std::size_t vertex_count = mesh.positions.size();
+                const bool swap = swaps(format);
+
+                mesh.indices.reserve(mesh.indices.size() + element.count * 3);
+                for (std::size_t face = 0; face < element.count; ++face)
+                {
+                    for (std::size_t column = 0; column < element.properties.size(); ++column)
+                    {
+                        const ply_property& property = element.properties[column];
+                        std::size_t count = 1;
+                        if (property.list)
+                        {
+                            if (static_cast<std::size_t>(last - first) < ply_size(property.count_type))
+                                throw exception::io_exception("ply file has less faces than its header");
+
+                            const double value = read_ply(first, property.count_type, swap);
+                            first += ply_size(property.count_type);
+                            count = ply_list_count(value, static_cast<std::size_t>(last - first));
+                        }
+
+                        const std::size_t size = ply_size(property.type);
+                        if (static_cast<std::size_t>(last - first) / size < count)
+                            throw exception::io_exception("ply file has less faces than its header");
+
+                        if (column == list)
+                        {
+                            if (count < 3)
+                                throw exception::io_exception("ply file has a face with less than 3 corners");
+
+                            //fan of triangles (first, previous, current)
+                            std::uint32_t first_corner = 0, previous = 0;
+                            for (std::size_t corner = 0; corner < count; ++corner)
+                            {
+                                const double value = read_ply(first + corner * size, property.type, swap);
+                                if (!(value >= 0 && value < static_cast<double>(vertex_count)) ||
+                                    value != std::floor(value))
+                                    throw exception::io_exception("ply face refers to a vertex that doesn't exist");
+
+                                const std::uint32_t current = static_cast<std::uint32_t>(value);
+                                if (corner == 0)
+                                    first_corner = current;
+                                else if (corner >= 2)
+                                {
+                                    mesh.indices.push_back(first_corner);
+                                    mesh.indices.push_back(previous);
+                                    mesh.indices.push_back(current);
+                                }
+                                previous = current;
+                            }
+                        }
+
+                        first += count * size;
+                    }
+                }
+
+                return first;
+            }
+
+            /**
+             * \brief skips an element that isn't used
+             * \return first character after the element
+             */
+            static const char* skip_ply_element(const char* first, const char* last, const ply_element& element,
+                                                const ply_format format)
+            {
+                if (format == ply_format::ascii)
+                {
+                    const char* end = skip_lines(first, last, element.count);
+                    if (end == nullptr)
+                        throw exception::io_exception("ply file has less elements than its header");
+                    return end;
+                }
+
+                const bool swap = swaps(format);
+                for (std::size_t item = 0; item < element.count; ++item)
+                {
+                    for (const ply_property& property : element.properties)
+                    {
+                        std::size_t count = 1;
+                        if (property.list)
+                        {
+                            if (static_cast<std::size_t>(last - first) < ply_size(property.count_type))
+                                throw exception::io_exception("ply file has less elements than its header");
+
+                            const double value = read_ply(first, property.count_type, swap);
+                            first += ply_size(property.count_type);
+                            count = ply_list_count(value, static_cast<std::size_t>(last - first));
+                        }
+
+                        if (static_cast<std::size_t>(last - first) / ply_size(property.type) < count)
+                            throw exception::io_exception("ply file has less elements than its header");
+                        first += count * ply_size(property.type);
+                    }
+                }
+
+                return first;
+            }
+        };
+    } // namespace bardcore::geometry
+} // namespace bardcore
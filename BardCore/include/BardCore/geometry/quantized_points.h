@@ -0,0 +1,475 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/ray_queue.h"
+
+namespace bardcore
+{
+    namespace geometry
+    {
+        /**
+         * \brief storage of the quantized cells of quantized_points, specialized for 16 and 21 bits per axis
+         * \tparam Bits amount of bits per axis
+         */
+        template <unsigned Bits>
+        class quantized_cells;
+
+        /**
+         * \brief 16 bits per axis, three arrays of 16 bit values, 6 bytes per point
+         */
+        template <>
+        class quantized_cells<16>
+        {
+        public:
+            /**
+             * \brief raw pointers to the cells, used by the batch loops so they can be vectorized
+             */
+            struct view
+            {
+                const std::uint16_t* x;
+                const std::uint16_t* y;
+                const std::uint16_t* z;
+            };
+
+        protected:
+            std::vector<std::uint16_t> x_{}, y_{}, z_{};
+
+        public:
+            NODISCARD std::size_t size() const noexcept { return x_.size(); }
+            NODISCARD view get_view() const noexcept { return {x_.data(), y_.data(), z_.data()}; }
+
+            void resize(const std::size_t count)
+            {
+                x_.resize(count);
+                y_.resize(count);
+                z_.resize(count);
+            }
+
+            void reserve(const std::size_t count)
+            {
+                x_.reserve(count);
+                y_.reserve(count);
+                z_.reserve(count);
+            }
+
+            void set(const std::size_t index, const std::uint32_t x, const std::uint32_t y,
+                     const std::uint32_t z) noexcept
+            {
+                x_[index] = static_cast<std::uint16_t>(x);
+                y_[index] = static_cast<std::uint16_t>(y);
+                z_[index] = static_cast<std::uint16_t>(z);
+            }
+
+            static void get(const view& cells, const std::size_t index, std::int32_t& x, std::int32_t& y,
+                            std::int32_t& z) noexcept
+            {
+                x = cells.x[index];
+                y = cells.y[index];
+                z = cells.z[index];
+            }
+        };
+
+        /**
+         * \brief 21 bits per axis, packed in one 64 bit value (x in the lowest bits), 8 bytes per point
+         */
+        template <>
+        class quantized_cells<21>
+        {
+        public:
+            /**
+             * \brief raw pointer to the cells, used by the batch loops so they can be vectorized
+             */
+            struct view
+            {
+                const std::uint64_t* packed;
+            };
+
+        protected:
+            std::vector<std::uint64_t> packed_{};
+
+        public:
+            NODISCARD std::size_t size() const noexcept { return packed_.size(); }
+            NODISCARD view get_view() const noexcept { return {packed_.data()}; }
+
+            void resize(const std::size_t count) { packed_.resize(count); }
+            void reserve(const std::size_t count) { packed_.reserve(count); }
+
+            void set(const std::size_t index, const std::uint32_t x, const std::uint32_t y,
+                     const std::uint32_t z) noexcept
+            {
+                packed_[index] = static_cast<std::uint64_t>(x) | static_cast<std::uint64_t>(y) << 21 |
+                    static_cast<std::uint64_t>(z) << 42;
+            }
+
+            static void get(const view& cells, const std::size_t index, std::int32_t& x, std::int32_t& y,
+                            std::int32_t& z) noexcept
+            {
+                const std::uint64_t packed = cells.packed[index];
+                x = static_cast<std::int32_t>(packed & 0x1FFFFF);
+                y = static_cast<std::int32_t>(packed >> 21 & 0x1FFFFF);
+                z = static_cast<std::int32_t>(packed >> 42 & 0x1FFFFF);
+            }
+        };
+
+        /**
+         * \brief positions stored as fixed point numbers inside a bounding box, e.g. the vertices of a big mesh
+         *
+         * every axis of the box is split in 2^Bits - 1 steps, a point is stored as the closest step on every axis, so
+         * the error is at most half a step per axis. 16 bits per axis take 6 bytes per point and 21 bits take 8 bytes,
+         * a point3d takes 24 bytes
+         * \note the batch functions decode a point with a multiply add per axis, without branches, so they can be
+         * vectorized
+         * \tparam Bits amount of bits per axis, 16 or 21
+         */
+        template <unsigned Bits>
+        class quantized_points
+        {
+            static_assert(Bits == 16 || Bits == 21, "quantized_points supports 16 or 21 bits per axis");
+
+        public:
+            /**
+             * \brief largest step on an axis, the maximum of the box
+             */
+            INLINE static constexpr std::uint32_t max_step = (1u << Bits) - 1;
+
+            /**
+             * \brief hits closer than this are ignored, see sphere_set::min_distance
+             */
+            INLINE static constexpr double min_distance = math::epsilon;
+
+        protected:
+            point3d min_, max_; // corners of the bounding box
+            vector3d step_; // size of a step on every axis, 0 for a flat axis
+            vector3d scale_; // steps per unit on every axis, 0 for a flat axis
+            quantized_cells<Bits> cells_{}; // step of every point on every axis
+
+        public:
+            /**
+             * \brief constructor for quantized_points
+             * \throws out_of_range_exception if min is greater than max on any axis
+             * \param min minimum corner of the bounding box
+             * \param max maximum corner of the bounding box
+             */
+            quantized_points(const point3d& min, const point3d& max) : min_(min), max_(max)
+            {
+                if (min.x > max.x || min.y > max.y || min.z > max.z)
+                    throw exception::out_of_range_exception("min must not be greater than max");
+
+                const double steps = static_cast<double>(max_step);
+                const vector3d size = min.get_vector(max);
+                step_ = size / steps;
+                scale_ = vector3d(size.x > 0 ? steps / size.x : 0, size.y > 0 ? steps / size.y : 0,
+                                  size.z > 0 ? steps / size.z : 0);
+            }
+
+            /**
+             * \brief quantizes points inside their own bounding box
+             * \throws zero_exception if points is empty
+             * \param points points to quantize
+             * \return quantized points, point i is points[i]
+             */
+            NODISCARD static quantized_points from_points(const dimension3_soa<point3d>& points)
+            {
+                if (points.empty())
+                    throw exception::zero_exception("points must not be empty");
+
+                point3d min = points.get(0), max = points.get(0);
+                for (std::size_t index = 1; index < points.size(); ++index)
+                {
+                    const point3d point = points.get(index);
+                    min = point3d(point.x < min.x ? point.x : min.x, point.y < min.y ? point.y : min.y,
+                                  point.z < min.z ? point.z : min.z);
+                    max = point3d(point.x > max.x ? point.x : max.x, point.y > max.y ? point.y : max.y,
+                                  point.z > max.z ? point.z : max.z);
+                }
+
+                quantized_points result(min, max);
+                result.add(points);
+                return result;
+            }
+
+            /**
+             * \brief adds a point
+             * \throws out_of_range_exception if point is outside the bounding box
+             * \param point point to add
+             * \return index of the point
+             */
+            std::size_t add(const point3d& point)
+            {
+                if (!contains(point))
+                    throw exception::out_of_range_exception("point must be inside the bounding box");
+
+                const std::size_t index = cells_.size();
+                cells_.resize(index + 1);
+                cells_.set(index, quantize(point.x, min_.x, scale_.x), quantize(point.y, min_.y, scale_.y),
+                           quantize(point.z, min_.z, scale_.z));
+                return index;
+            }
+
+            /**
+             * \brief adds a batch of points
+             * \throws out_of_range_exception if any point is outside the bounding box, nothing is added then
+             * \param points points to add
+             */
+            void add(const dimension3_soa<point3d>& points)
+            {
+                for (std::size_t index = 0; index < points.size(); ++index)
+                    if (!contains(points.get(index)))
+                        throw exception::out_of_range_exception("point must be inside the bounding box");
+
+                const std::size_t first = cells_.size();
+                cells_.resize(first + points.size());
+
+                const double* x = points.x();
+                const double* y = points.y();
+                const double* z = points.z();
+                for (std::size_t index = 0; index < points.size(); ++index)
+                    cells_.set(first + index, quantize(x[index], min_.x, scale_.x),
+                               quantize(y[index], min_.y, scale_.y), quantize(z[index], min_.z, scale_.z));
+            }
+
+            /**
+             * \brief reserves memory for points
+             * \param count amount of points to reserve
+             */
+            void reserve(const std::size_t count) { cells_.reserve(count); }
+
+            /**
+             * \brief decodes a point
+             * \param index index of the point
+             * \return decoded point, at most half a step away from the point that was added
+             */
+            NODISCARD point3d get(const std::size_t index) const noexcept
+            {
+                double x = 0, y = 0, z = 0;
+                decode(cells_.get_view(), index, x, y, z);
+                return {x, y, z};
+            }
+
+            /**
+             * \brief decodes all points in double precision
+             * \param points decoded points, resized to size()
+             */
+            void dequantize(dimension3_soa<point3d>& points) const
+            {
+                points.resize(size());
+                dequantize(0, size(), points.x(), points.y(), points.z());
+            }
+
+            /**
+             * \brief decodes the points in [begin, end) in double precision
+             * \param begin first point
+             * \param end one past the last point
+             * \param x x of every point, x[0] is point begin, must have room for end - begin values
+             * \param y y of every point, must have room for end - begin values
+             * \param z z of every point, must have room for end - begin values
+             */
+            void dequantize(const std::size_t begin, const std::size_t end, double* x, double* y,
+                            double* z) const noexcept
+            {
+                const typename quantized_cells<Bits>::view cells = cells_.get_view();
+
+                VECTORIZE
+                for (std::size_t index = begin; index < end; ++index)
+                    decode(cells, index, x[index - begin], y[index - begin], z[index - begin]);
+            }
+
+            /**
+             * \brief decodes the points in [begin, end) in single precision, e.g. for float traversal kernels
+             * \param begin first point
+             * \param end one past the last point
+             * \param x x of every point, x[0] is point begin, must have room for end - begin values
+             * \param y y of every point, must have room for end - begin values
+             * \param z z of every point, must have room for end - begin values
+             */
+            void dequantize(const std::size_t begin, const std::size_t end, float* x, float* y,
+                            float* z) const noexcept
+            {
+                const typename quantized_cells<Bits>::view cells = cells_.get_view();
+
+                VECTORIZE
+                for (std::size_t index = begin; index < end; ++index)
+                {
+                    double px = 0, py = 0, pz = 0;
+                    decode(cells, index, px, py, pz);
+                    x[index - begin] = static_cast<float>(px);
+                    y[index - begin] = static_cast<float>(py);
+                    z[index - begin] = static_cast<float>(pz);
+                }
+            }
+
+            /**
+             * \brief finds the closest hit of every ray in [begin, end) with a sphere of radius around every point,
+             * e.g. to render a scanned point cloud as splats
+             * \note every point is decoded once per call, right before the loop over the rays, so the decoded points
+             * are never stored. the same as sphere_set::intersect with a sphere at every decoded point
+             * \note hits must already have the size of rays, rays that hit nothing keep their own distance
+             * \throws zero_exception if radius is zero
+             * \throws negative_exception if radius is negative
+             * \param rays rays with normalized directions
+             * \param begin first ray
+             * \param end one past the last ray
+             * \param hits closest hit of every ray, the primitive is the index of the point
+             * \param radius radius of the sphere around every point
+             * \param material material of every hit
+             */
+            void intersect(const utility::ray_queue& rays, const std::size_t begin, const std::size_t end,
+                           utility::hit_queue& hits, const double radius, const std::uint32_t material = 0) const
+            {
+                if (radius == 0)
+                    throw exception::zero_exception("radius must not be zero");
+                if (radius < 0)
+                    throw exception::negative_exception("radius can't be negative");
+
+                const double* origin_x = rays.origin.x();
+                const double* origin_y = rays.origin.y();
+                const double* origin_z = rays.origin.z();
+                const double* direction_x = rays.direction.x();
+                const double* direction_y = rays.direction.y();
+                const double* direction_z = rays.direction.z();
+                const double radius_squared = radius * radius;
+                const double closest = min_distance;
+
+                double* best = hits.distance.data();
+                std::uint32_t* primitive = hits.primitive.data();
+
+                for (std::size_t index = begin; index < end; ++index)
+                {
+                    best[index] = rays.distance[index];
+                    primitive[index] = utility::hit_queue::no_hit;
+                }
+
+                INSTRUMENT_ADD(intersection_tests, (end - begin) * size());
+                const typename quantized_cells<Bits>::view cells = cells_.get_view();
+                for (std::uint32_t point = 0; point < size(); ++point)
+                {
+                    double center_x = 0, center_y = 0, center_z = 0;
+                    decode(cells, point, center_x, center_y, center_z);
+
+                    VECTORIZE
+                    for (std::size_t index = begin; index < end; ++index)
+                    {
+                        const double offset_x = origin_x[index] - center_x;
+                        const double offset_y = origin_y[index] - center_y;
+                        const double offset_z = origin_z[index] - center_z;
+                        const double b = offset_x * direction_x[index] + offset_y * direction_y[index] + offset_z *
+                            direction_z[index];
+                        const double c = offset_x * offset_x + offset_y * offset_y + offset_z * offset_z -
+                            radius_squared;
+                        const double discriminant = b * b - c;
+
+                        const double root = std::sqrt(discriminant > 0 ? discriminant : 0);
+                        const double t_near = -b - root;
+                        const double t = t_near > closest ? t_near : -b + root;
+
+                        const bool hit = (discriminant >= 0) & (t > closest) & (t < best[index]);
+                        best[index] = hit ? t : best[index];
+                        primitive[index] = hit ? point : primitive[index];
+                    }
+                }
+
+                //normal and material of every hit
+                for (std::size_t index = begin; index < end; ++index)
+                {
+                    const std::uint32_t point = primitive[index];
+                    if (point == utility::hit_queue::no_hit)
+                    {
+                        hits.material[index] = utility::hit_queue::no_hit;
+                        hits.normal.set(index, vector3d::zero());
+                        continue;
+                    }
+
+                    const point3d position = rays.origin.get(index) + rays.direction.get(index) * best[index];
+                    hits.normal.set(index, get(point).get_vector(position) * (1. / radius));
+                    hits.material[index] = material;
+                }
+            }
+
+            /**
+             * \brief finds the closest hit of every ray with a sphere of radius around every point, hits is resized to
+             * the size of rays
+             * \throws zero_exception if radius is zero
+             * \throws negative_exception if radius is negative
+             * \param rays rays with normalized directions
+             * \param hits closest hit of every ray, the primitive is the index of the point
+             * \param radius radius of the sphere around every point
+             * \param material material of every hit
+             */
+            void intersect(const utility::ray_queue& rays, utility::hit_queue& hits, const double radius,
+                           const std::uint32_t material = 0) const
+            {
+                hits.resize(rays.size());
+                intersect(rays, 0, rays.size(), hits, radius, material);
+            }
+
+            /**
+             * \brief checks if a point is inside the bounding box
+             * \param point point to check
+             * \return true if point is inside the bounding box, the border included
+             */
+            NODISCARD bool contains(const point3d& point) const noexcept
+            {
+                return point.x >= min_.x && point.y >= min_.y && point.z >= min_.z && point.x <= max_.x &&
+                    point.y <= max_.y && point.z <= max_.z;
+            }
+
+        protected:
+            /**
+             * \brief closest step of a coordinate on an axis
+             */
+            NODISCARD static std::uint32_t quantize(const double value, const double min, const double scale) noexcept
+            {
+                const double step = (value - min) * scale + 0.5;
+                const double largest = static_cast<double>(max_step);
+                return static_cast<std::uint32_t>(step < largest ? step : largest);
+            }
+
+            /**
+             * \brief decodes point index, through int32 so the conversion can be vectorized
+             */
+            void decode(const typename quantized_cells<Bits>::view& cells, const std::size_t index, double& x,
+                        double& y, double& z) const noexcept
+            {
+                std::int32_t cell_x = 0, cell_y = 0, cell_z = 0;
+                quantized_cells<Bits>::get(cells, index, cell_x, cell_y, cell_z);
+                x = min_.x + static_cast<double>(cell_x) * step_.x;
+                y = min_.y + static_cast<double>(cell_y) * step_.y;
+                z = min_.z + static_cast<double>(cell_z) * step_.z;
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return cells_.size(); }
+            NODISCARD bool empty() const noexcept { return cells_.size() == 0; }
+            NODISCARD const point3d& get_min() const noexcept { return min_; }
+            NODISCARD const point3d& get_max() const noexcept { return max_; }
+
+            /**
+             * \brief gets the size of a step on every axis, a decoded point is at most half a step away on every axis
+             * \return size of a step on every axis
+             */
+            NODISCARD const vector3d& get_step() const noexcept { return step_; }
+        };
+
+        /**
+         * \brief quantized points with 16 bits per axis, 6 bytes per point
+         */
+        using quantized_points16 = quantized_points<16>;
+
+        /**
+         * \brief quantized points with 21 bits per axis, 8 bytes per point
+         */
+        using quantized_points21 = quantized_points<21>;
+    } // namespace bardcore::geometry
+} // namespace bardcore
@@ -0,0 +1,625 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/utility/ray_queue.h"
+#include "BardCore/utility/ray32.h"
+#include "BardCore/utility/scene_cache.h"
+
+namespace bardcore
+{
+    namespace geometry
+    {
+        /**
+         * \brief read only spheres in structure of arrays layout, intersected with whole ray queues at once
+         *
+         * the view doesn't own the arrays, they belong to a sphere_set or lie in a scene cache, e.g. a mapped_file, so
+         * a cached scene is intersected right where it is mapped
+         * \note the loops run over the rays for one sphere at a time, so they can be vectorized
+         */
+        class sphere_view
+        {
+        protected:
+            const double* center_x_ = nullptr; // x of the center of every sphere
+            const double* center_y_ = nullptr; // y of the center of every sphere
+            const double* center_z_ = nullptr; // z of the center of every sphere
+            const double* radius_ = nullptr; // radius of every sphere
+            const std::uint32_t* material_ = nullptr; // material of every sphere
+            std::size_t size_ = 0; // amount of spheres
+
+        public:
+            /**
+             * \brief hits closer than this are ignored, this prevents a ray from hitting the surface it starts on
+             */
+            INLINE static constexpr double min_distance = math::epsilon;
+
+            /**
+             * \brief tags of the sections of a scene cache, see sphere_set::save
+             */
+            INLINE static constexpr std::uint32_t center_x_tag = utility::scene_format::make_tag('S', 'P', 'C', 'X');
+            INLINE static constexpr std::uint32_t center_y_tag = utility::scene_format::make_tag('S', 'P', 'C', 'Y');
+            INLINE static constexpr std::uint32_t center_z_tag = utility::scene_format::make_tag('S', 'P', 'C', 'Z');
+            INLINE static constexpr std::uint32_t radius_tag = utility::scene_format::make_tag('S', 'P', 'R', 'A');
+            INLINE static constexpr std::uint32_t material_tag = utility::scene_format::make_tag('S', 'P', 'M', 'A');
+
+            sphere_view() = default;
+
+            /**
+             * \brief constructor for sphere_view
+             * \param center_x x of the center of every sphere
+             * \param center_y y of the center of every sphere
+             * \param center_z z of the center of every sphere
+             * \param radius radius of every sphere, greater than 0
+             * \param material material of every sphere
+             * \param size amount of spheres
+             */
+            sphere_view(const double* center_x, const double* center_y, const double* center_z, const double* radius,
+                        const std::uint32_t* material, const std::size_t size) noexcept : center_x_(center_x),
+                center_y_(center_y), center_z_(center_z), radius_(radius), material_(material), size_(size)
+            {
+            }
+
+            /**
+             * \brief constructor for sphere_view, uses the spheres of a scene cache in place
+             * \throws io_exception if a section is missing, has another type or the sections differ in size
+             * \param scene scene cache written with sphere_set::save
+             */
+            explicit sphere_view(const utility::scene_view& scene)
+            {
+                const utility::scene_array<double> center_x = scene.get<double>(center_x_tag);
+                const utility::scene_array<double> center_y = scene.get<double>(center_y_tag);
+                const utility::scene_array<double> center_z = scene.get<double>(center_z_tag);
+                const utility::scene_array<double> radius = scene.get<double>(radius_tag);
+                const utility::scene_array<std::uint32_t> material = scene.get<std::uint32_t>(material_tag);
+
+                size_ = radius.size();
+                if (center_x.size() != size_ || center_y.size() != size_ || center_z.size() != size_ ||
+                    material.size() != size_)
+                    throw exception::io_exception("scene cache has spheres of different sizes");
+
+                center_x_ = center_x.data();
+                center_y_ = center_y.data();
+                center_z_ = center_z.data();
+                radius_ = radius.data();
+                material_ = material.data();
+            }
+
+            /**
+             * \brief finds the closest hit of every ray in [begin, end)
+             * \note hits must already have the size of rays, rays that hit nothing keep their own distance
+             * \param rays rays with normalized directions
+             * \param begin first ray
+             * \param end one past the last ray
+             * \param hits closest hit of every ray
+             */
+            void intersect(const utility::ray_queue& rays, const std::size_t begin, const std::size_t end,
+                           utility::hit_queue& hits) const
+            {
+                const double* origin_x = rays.origin.x();
+                const double* origin_y = rays.origin.y();
+                const double* origin_z = rays.origin.z();
+                const double* direction_x = rays.direction.x();
+                const double* direction_y = rays.direction.y();
+                const double* direction_z = rays.direction.z();
+
+                double* best = hits.distance.data();
+                std::uint32_t* primitive = hits.primitive.data();
+
+                for (std::size_t index = begin; index < end; ++index)
+                {
+                    best[index] = rays.distance[index];
+                    primitive[index] = utility::hit_queue::no_hit;
+                }
+
+                INSTRUMENT_ADD(intersection_tests, (end - begin) * size_);
+                for (std::uint32_t sphere = 0; sphere < size_; ++sphere)
+                {
+                    const double center_x = center_x_[sphere];
+                    const double center_y = center_y_[sphere];
+                    const double center_z = center_z_[sphere];
+                    const double radius_squared = radius_[sphere] * radius_[sphere];
+
+                    VECTORIZE
+                    for (std::size_t index = begin; index < end; ++index)
+                    {
+                        //formula: t^2 + 2bt + c = 0, with b = (o - c) . d and c = |o - c|^2 - r^2
+                        const double offset_x = origin_x[index] - center_x;
+                        const double offset_y = origin_y[index] - center_y;
+                        const double offset_z = origin_z[index] - center_z;
+                        const double b = offset_x * direction_x[index] + offset_y * direction_y[index] + offset_z *
+                            direction_z[index];
+                        const double c = offset_x * offset_x + offset_y * offset_y + offset_z * offset_z -
+                            radius_squared;
+                        const double discriminant = b * b - c;
+
+                        const double root = std::sqrt(discriminant > 0 ? discriminant : 0);
+                        const double t_near = -b - root;
+                        const double t = t_near > min_distance ? t_near : -b + root;
+
+                        const bool hit = (discriminant >= 0) & (t > min_distance) & (t < best[index]);
+                        best[index] = hit ? t : best[index];
+                        primitive[index] = hit ? sphere : primitive[index];
+                    }
+                }
+
+                finish_hits(rays, begin, end, hits);
+            }
+
+            /**
+             * \brief finds the closest hit of every ray, hits is resized to the size of rays
+             * \param rays rays with normalized directions
+             * \param hits closest hit of every ray
+             */
+            void intersect(const utility::ray_queue& rays, utility::hit_queue& hits) const
+            {
+                hits.resize(rays.size());
+                intersect(rays, 0, rays.size(), hits);
+            }
+
+            /**
+             * \brief checks for every ray in [begin, end) if anything is hit before its distance, e.g. for shadow rays
+             *
+             * this is an any hit query, a ray stops at the first sphere it hits, no distance, normal or material is
+             * calculated and the spheres are not visited in any particular order
+             * \note result must already have the size of rays
+             * \param rays rays with normalized directions, usually segments to a light, see ray_queue::push_segment
+             * \param begin first ray
+             * \param end one past the last ray
+             * \param result 1 if the ray hit something, otherwise 0
+             */
+            void occluded(const utility::ray_queue& rays, const std::size_t begin, const std::size_t end,
+                          std::vector<std::uint8_t>& result) const noexcept
+            {
+                for (std::size_t index = begin; index < end; ++index)
+                    result[index] = any_hit(rays.origin.get(index), rays.direction.get(index), rays.distance[index]);
+            }
+
+            /**
+             * \brief checks for every ray if anything is hit before its distance, result is resized to the size of rays
+             * \param rays rays with normalized directions, usually segments to a light, see ray_queue::push_segment
+             * \param result 1 if the ray hit something, otherwise 0
+             */
+            void occluded(const utility::ray_queue& rays, std::vector<std::uint8_t>& result) const
+            {
+                result.resize(rays.size());
+                occluded(rays, 0, rays.size(), result);
+            }
+
+            /**
+             * \brief checks if anything is hit before the distance of the ray, e.g. ray(surface_point, light.position)
+             * \param ray ray to check
+             * \return true if the ray hit something before its distance
+             */
+            NODISCARD bool occluded(const utility::ray& ray) const noexcept
+            {
+                return any_hit(ray.get_position(), ray.get_direction(), ray.get_distance());
+            }
+
+            /**
+             * \brief finds the closest hit of every ray in [begin, end) of a single precision queue
+             * \note the math is in single precision, so a vector register holds twice as many rays as with a
+             * ray_queue. tmin of every ray takes the place of min_distance, a hit shrinks tmax of the ray to its
+             * distance, rays that hit nothing keep their tmax
+             * \param rays rays with normalized directions
+             * \param begin first ray
+             * \param end one past the last ray
+             * \param primitive sphere every ray hit, hit_queue::no_hit if it hit nothing, must already have the size
+             * of rays
+             */
+            void intersect(utility::ray32_queue& rays, const std::size_t begin, const std::size_t end,
+                           std::vector<std::uint32_t>& primitive) const
+            {
+                const float* origin_x = rays.origin_x.data();
+                const float* origin_y = rays.origin_y.data();
+                const float* origin_z = rays.origin_z.data();
+                const float* direction_x = rays.direction_x.data();
+                const float* direction_y = rays.direction_y.data();
+                const float* direction_z = rays.direction_z.data();
+                const float* tmin = rays.tmin.data();
+                float* tmax = rays.tmax.data();
+                std::uint32_t* hit_primitive = primitive.data();
+
+                for (std::size_t index = begin; index < end; ++index)
+                    hit_primitive[index] = utility::hit_queue::no_hit;
+
+                INSTRUMENT_ADD(intersection_tests, (end - begin) * size_);
+                for (std::uint32_t sphere = 0; sphere < size_; ++sphere)
+                {
+                    const float center_x = static_cast<float>(center_x_[sphere]);
+                    const float center_y = static_cast<float>(center_y_[sphere]);
+                    const float center_z = static_cast<float>(center_z_[sphere]);
+                    const float radius_squared = static_cast<float>(radius_[sphere] * radius_[sphere]);
+
+                    VECTORIZE
+                    for (std::size_t index = begin; index < end; ++index)
+                    {
+                        //b^2 - c of the double precision intersect cancels in single precision for spheres far
+                        //from the origin, r^2 - |offset - b * d|^2 is the same value without the cancellation
+                        const float offset_x = origin_x[index] - center_x;
+                        const float offset_y = origin_y[index] - center_y;
+                        const float offset_z = origin_z[index] - center_z;
+                        const float b = offset_x * direction_x[index] + offset_y * direction_y[index] + offset_z *
+                            direction_z[index];
+                        const float closest_x = offset_x - b * direction_x[index];
+                        const float closest_y = offset_y - b * direction_y[index];
+                        const float closest_z = offset_z - b * direction_z[index];
+                        const float discriminant = radius_squared - (closest_x * closest_x + closest_y * closest_y +
+                            closest_z * closest_z);
+
+                        const float root = std::sqrt(discriminant > 0 ? discriminant : 0);
+                        const float t_near = -b - root;
+                        const float t = t_near > tmin[index] ? t_near : -b + root;
+
+                        const bool hit = (discriminant >= 0) & (t > tmin[index]) & (t < tmax[index]);
+                        tmax[index] = hit ? t : tmax[index];
+                        hit_primitive[index] = hit ? sphere : hit_primitive[index];
+                    }
+                }
+            }
+
+            /**
+             * \brief finds the closest hit of every ray of a single precision queue, primitive is resized to the size
+             * of rays
+             * \note a hit shrinks tmax of the ray to its distance
+             * \param rays rays with normalized directions
+             * \param primitive sphere every ray hit, hit_queue::no_hit if it hit nothing
+             */
+            void intersect(utility::ray32_queue& rays, std::vector<std::uint32_t>& primitive) const
+            {
+                primitive.resize(rays.size());
+                intersect(rays, 0, rays.size(), primitive);
+            }
+
+            /**
+             * \brief checks for every ray in [begin, end) of a single precision queue if anything is hit between its
+             * tmin and tmax, e.g. for shadow rays
+             * \note unlike occluded on a ray_queue the loop runs over the rays for one sphere at a time, so it can be
+             * vectorized, but it can't stop at the first hit
+             * \param rays rays with normalized directions
+             * \param begin first ray
+             * \param end one past the last ray
+             * \param result 1 if the ray hit something, otherwise 0, must already have the size of rays
+             */
+            void occluded(const utility::ray32_queue& rays, const std::size_t begin, const std::size_t end,
+                          std::vector<std::uint8_t>& result) const noexcept
+            {
+                const float* origin_x = rays.origin_x.data();
+                const float* origin_y = rays.origin_y.data();
+                const float* origin_z = rays.origin_z.data();
+                const float* direction_x = rays.direction_x.data();
+                const float* direction_y = rays.direction_y.data();
+                const float* direction_z = rays.direction_z.data();
+                const float* tmin = rays.tmin.data();
+                const float* tmax = rays.tmax.data();
+                std::uint8_t* hit_any = result.data();
+
+                for (std::size_t index = begin; index < end; ++index)
+                    hit_any[index] = 0;
+
+                INSTRUMENT_ADD(intersection_tests, (end - begin) * size_);
+                for (std::size_t sphere = 0; sphere < size_; ++sphere)
+                {
+                    const float center_x = static_cast<float>(center_x_[sphere]);
+                    const float center_y = static_cast<float>(center_y_[sphere]);
+                    const float center_z = static_cast<float>(center_z_[sphere]);
+                    const float radius_squared = static_cast<float>(radius_[sphere] * radius_[sphere]);
+
+                    VECTORIZE
+                    for (std::size_t index = begin; index < end; ++index)
+                    {
+                        //robust discriminant, see intersect
+                        const float offset_x = origin_x[index] - center_x;
+                        const float offset_y = origin_y[index] - center_y;
+                        const float offset_z = origin_z[index] - center_z;
+                        const float b = offset_x * direction_x[index] + offset_y * direction_y[index] + offset_z *
+                            direction_z[index];
+                        const float closest_x = offset_x - b * direction_x[index];
+                        const float closest_y = offset_y - b * direction_y[index];
+                        const float closest_z = offset_z - b * direction_z[index];
+                        const float discriminant = radius_squared - (closest_x * closest_x + closest_y * closest_y +
+                            closest_z * closest_z);
+
+                        //either intersection within (tmin, tmax) occludes the ray, e.g. when it starts inside
+                        const float root = std::sqrt(discriminant > 0 ? discriminant : 0);
+                        const float t_near = -b - root;
+                        const float t_far = -b + root;
+                        const bool hit = (discriminant >= 0) & (((t_near > tmin[index]) & (t_near < tmax[index])) |
+                            ((t_far > tmin[index]) & (t_far < tmax[index])));
+                        hit_any[index] = hit ? 1 : hit_any[index];
+                    }
+                }
+            }
+
+            /**
+             * \brief checks for every ray of a single precision queue if anything is hit between its tmin and tmax,
+             * result is resized to the size of rays
+             * \param rays rays with normalized directions
+             * \param result 1 if the ray hit something, otherwise 0
+             */
+            void occluded(const utility::ray32_queue& rays, std::vector<std::uint8_t>& result) const
+            {
+                result.resize(rays.size());
+                occluded(rays, 0, rays.size(), result);
+            }
+
+        protected:
+            /**
+             * \brief checks if a ray hits any sphere before distance, stops at the first sphere that is hit
+             * \param origin position of the ray
+             * \param direction normalized direction of the ray
+             * \param distance distance of the ray
+             * \return true if any sphere is hit within (min_distance, distance)
+             */
+            NODISCARD bool any_hit(const point3d& origin, const vector3d& direction, const double distance) const
+                noexcept
+            {
+                for (std::size_t sphere = 0; sphere < size_; ++sphere)
+                {
+                    const double offset_x = origin.x - center_x_[sphere];
+                    const double offset_y = origin.y - center_y_[sphere];
+                    const double offset_z = origin.z - center_z_[sphere];
+                    const double b = offset_x * direction.x + offset_y * direction.y + offset_z * direction.z;
+                    const double c = offset_x * offset_x + offset_y * offset_y + offset_z * offset_z - radius_[sphere]
+                        * radius_[sphere];
+                    const double discriminant = b * b - c;
+                    if (discriminant < 0)
+                        continue;
+
+                    //either intersection within (min_distance, distance) occludes the ray, e.g. when it starts inside
+                    const double root = std::sqrt(discriminant);
+                    const double t_near = -b - root;
+                    const double t_far = -b + root;
+                    if ((t_near > min_distance && t_near < distance) || (t_far > min_distance && t_far < distance))
+                    {
+                        INSTRUMENT_ADD(intersection_tests, sphere + 1);
+                        return true;
+                    }
+                }
+
+                INSTRUMENT_ADD(intersection_tests, size_);
+                return false;
+            }
+
+            /**
+             * \brief fills in the normal and material of every hit in [begin, end)
+             * \param rays rays with normalized directions
+             * \param begin first ray
+             * \param end one past the last ray
+             * \param hits hits with distance and primitive filled in
+             */
+            void finish_hits(const utility::ray_queue& rays, const std::size_t begin, const std::size_t end,
+                             utility::hit_queue& hits) const
+            {
+                for (std::size_t index = begin; index < end; ++index)
+                {
+                    const std::uint32_t sphere = hits.primitive[index];
+                    if (sphere == utility::hit_queue::no_hit)
+                    {
+                        hits.material[index] = utility::hit_queue::no_hit;
+                        hits.normal.set(index, vector3d::zero());
+                        continue;
+                    }
+
+                    const point3d point = rays.origin.get(index) + rays.direction.get(index) * hits.distance[index];
+                    hits.normal.set(index, get_center(sphere).get_vector(point) * (1. / radius_[sphere]));
+                    hits.material[index] = material_[sphere];
+                }
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return size_; }
+            NODISCARD bool empty() const noexcept { return size_ == 0; }
+            NODISCARD point3d get_center(const std::size_t index) const noexcept
+            {
+                return {center_x_[index], center_y_[index], center_z_[index]};
+            }
+            NODISCARD double get_radius(const std::size_t index) const noexcept { return radius_[index]; }
+            NODISCARD std::uint32_t get_material(const std::size_t index) const noexcept { return material_[index]; }
+        };
+
+        /**
+         * \brief set of spheres in structure of arrays layout, intersected with whole ray queues at once
+         * \note the intersection functions are the ones of sphere_view, see view
+         */
+        class sphere_set
+        {
+        protected:
+            dimension3_soa<point3d> center_{}; // center of every sphere
+            std::vector<double> radius_{}; // radius of every sphere
+            std::vector<std::uint32_t> material_{}; // material of every sphere
+
+        public:
+            /**
+             * \brief hits closer than this are ignored, this prevents a ray from hitting the surface it starts on
+             */
+            INLINE static constexpr double min_distance = sphere_view::min_distance;
+
+            sphere_set() = default;
+
+            /**
+             * \brief constructor for sphere_set, copies the spheres of a view, e.g. to change a cached scene
+             * \param spheres spheres to copy
+             */
+            explicit sphere_set(const sphere_view& spheres)
+            {
+                for (std::size_t index = 0; index < spheres.size(); ++index)
+                    add(spheres.get_center(index), spheres.get_radius(index), spheres.get_material(index));
+            }
+
+            /**
+             * \brief adds a sphere
+             * \throws zero_exception if radius is zero
+             * \throws negative_exception if radius is negative
+             * \param center center of the sphere
+             * \param radius radius of the sphere
+             * \param material material of the sphere
+             * \return index of the sphere
+             */
+            std::uint32_t add(const point3d& center, const double radius, const std::uint32_t material = 0)
+            {
+                if (radius == 0)
+                    throw exception::zero_exception("radius must not be zero");
+                if (radius < 0)
+                    throw exception::negative_exception("radius can't be negative");
+
+                center_.push_back(center);
+                radius_.push_back(radius);
+                material_.push_back(material);
+                return static_cast<std::uint32_t>(radius_.size() - 1);
+            }
+
+            /**
+             * \brief gets a view of the spheres, valid until a sphere is added or the set is destroyed
+             * \return view of all spheres
+             */
+            NODISCARD sphere_view view() const noexcept
+            {
+                return {center_.x(), center_.y(), center_.z(), radius_.data(), material_.data(), radius_.size()};
+            }
+
+            /**
+             * \brief adds the spheres to a scene cache, load them with sphere_view(scene_view)
+             * \note the writer keeps pointers to the arrays, the set must not change until the cache is written
+             * \throws same_object_exception if the writer already has spheres
+             * \param writer writer of the scene cache
+             */
+            void save(utility::scene_writer& writer) const
+            {
+                writer.add(sphere_view::center_x_tag, center_.x(), center_.size());
+                writer.add(sphere_view::center_y_tag, center_.y(), center_.size());
+                writer.add(sphere_view::center_z_tag, center_.z(), center_.size());
+                writer.add(sphere_view::radius_tag, radius_);
+                writer.add(sphere_view::material_tag, material_);
+            }
+
+            /**
+             * \brief finds the closest hit of every ray in [begin, end), see sphere_view::intersect
+             * \note hits must already have the size of rays, rays that hit nothing keep their own distance
+             * \param rays rays with normalized directions
+             * \param begin first ray
+             * \param end one past the last ray
+             * \param hits closest hit of every ray
+             */
+            void intersect(const utility::ray_queue& rays, const std::size_t begin, const std::size_t end,
+                           utility::hit_queue& hits) const
+            {
+                view().intersect(rays, begin, end, hits);
+            }
+
+            /**
+             * \brief finds the closest hit of every ray, hits is resized to the size of rays
+             * \param rays rays with normalized directions
+             * \param hits closest hit of every ray
+             */
+            void intersect(const utility::ray_queue& rays, utility::hit_queue& hits) const
+            {
+                view().intersect(rays, hits);
+            }
+
+            /**
+             * \brief checks for every ray in [begin, end) if anything is hit before its distance, see
+             * sphere_view::occluded
+             * \note result must already have the size of rays
+             * \param rays rays with normalized directions, usually segments to a light, see ray_queue::push_segment
+             * \param begin first ray
+             * \param end one past the last ray
+             * \param result 1 if the ray hit something, otherwise 0
+             */
+            void occluded(const utility::ray_queue& rays, const std::size_t begin, const std::size_t end,
+                          std::vector<std::uint8_t>& result) const noexcept
+            {
+                view().occluded(rays, begin, end, result);
+            }
+
+            /**
+             * \brief checks for every ray if anything is hit before its distance, result is resized to the size of rays
+             * \param rays rays with normalized directions, usually segments to a light, see ray_queue::push_segment
+             * \param result 1 if the ray hit something, otherwise 0
+             */
+            void occluded(const utility::ray_queue& rays, std::vector<std::uint8_t>& result) const
+            {
+                view().occluded(rays, result);
+            }
+
+            /**
+             * \brief checks if anything is hit before the distance of the ray, e.g. ray(surface_point, light.position)
+             * \param ray ray to check
+             * \return true if the ray hit something before its distance
+             */
+            NODISCARD bool occluded(const utility::ray& ray) const noexcept { return view().occluded(ray); }
+
+            /**
+             * \brief finds the closest hit of every ray in [begin, end) of a single precision queue, see
+             * sphere_view::intersect
+             * \note a hit shrinks tmax of the ray to its distance
+             * \param rays rays with normalized directions
+             * \param begin first ray
+             * \param end one past the last ray
+             * \param primitive sphere every ray hit, hit_queue::no_hit if it hit nothing, must already have the size
+             * of rays
+             */
+            void intersect(utility::ray32_queue& rays, const std::size_t begin, const std::size_t end,
+                           std::vector<std::uint32_t>& primitive) const
+            {
+                view().intersect(rays, begin, end, primitive);
+            }
+
+            /**
+             * \brief finds the closest hit of every ray of a single precision queue, primitive is resized to the size
+             * of rays
+             * \note a hit shrinks tmax of the ray to its distance
+             * \param rays rays with normalized directions
+             * \param primitive sphere every ray hit, hit_queue::no_hit if it hit nothing
+             */
+            void intersect(utility::ray32_queue& rays, std::vector<std::uint32_t>& primitive) const
+            {
+                view().intersect(rays, primitive);
+            }
+
+            /**
+             * \brief checks for every ray in [begin, end) of a single precision queue if anything is hit between its
+             * tmin and tmax, see sphere_view::occluded
+             * \param rays rays with normalized directions
+             * \param begin first ray
+             * \param end one past the last ray
+             * \param result 1 if the ray hit something, otherwise 0, must already have the size of rays
+             */
+            void occluded(const utility::ray32_queue& rays, const std::size_t begin, const std::size_t end,
+                          std::vector<std::uint8_t>& result) const noexcept
+            {
+                view().occluded(rays, begin, end, result);
+            }
+
+            /**
+             * \brief checks for every ray of a single precision queue if anything is hit between its tmin and tmax,
+             * result is resized to the size of rays
+             * \param rays rays with normalized directions
+             * \param result 1 if the ray hit something, otherwise 0
+             */
+            void occluded(const utility::ray32_queue& rays, std::vector<std::uint8_t>& result) const
+            {
+                view().occluded(rays, result);
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return radius_.size(); }
+            NODISCARD point3d get_center(const std::size_t index) const noexcept { return center_.get(index); }
+            NODISCARD double get_radius(const std::size_t index) const noexcept { return radius_[index]; }
+            NODISCARD std::uint32_t get_material(const std::size_t index) const noexcept { return material_[index]; }
+            NODISCARD const dimension3_soa<point3d>& get_centers() const noexcept { return center_; }
+            NODISCARD const std::vector<double>& get_radii() const noexcept { return radius_; }
+        };
+    } // namespace bardcore::geometry
+} // namespace bardcore
@@ -33,25 +33,16 @@ namespace bardcore
 
         /**
          * \brief copy constructor
+         * \note defaulted so point3d and vector3d stay trivially copyable, e.g. for memory mapped scene caches
          * \param other other dimension3
          */
-        constexpr dimension3(const dimension3& other)
-            : x{other.x},
-              y{other.y},
-              z{other.z}
-        {
-        }
+        constexpr dimension3(const dimension3& other) = default;
 
         /**
          * \brief move constructor
          * \param other other dimension3
          */
-        constexpr dimension3(dimension3&& other) noexcept
-            : x{other.x},
-              y{other.y},
-              z{other.z}
-        {
-        }
+        constexpr dimension3(dimension3&& other) noexcept = default;
 
         /**
          * \brief copy constructor
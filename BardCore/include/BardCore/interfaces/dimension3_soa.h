@@ -0,0 +1,156 @@
+#pragma once
+
+#include <vector>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3.h"
+
+namespace bardcore
+{
+    /**
+     * \brief structure of arrays for dimension3 types, x, y and z are stored in separate contiguous arrays
+     *
+     * this is the layout batch kernels want, a loop over x(), y() and z() can be vectorized by the compiler
+     * \note dimension3_soa<point3d> stores points, dimension3_soa<vector3d> stores vectors
+     * \tparam T implementation of dimension3, e.g. point3d
+     */
+    template <typename T, ENABLE_IF_DERIVED(dimension3, T)>
+    class dimension3_soa
+    {
+    protected:
+        std::vector<double> x_{}, y_{}, z_{};
+
+    public:
+        /**
+         * \brief default constructor, empty
+         */
+        dimension3_soa() = default;
+
+        /**
+         * \brief constructor with count elements, all (0, 0, 0)
+         * \param count amount of elements
+         */
+        explicit dimension3_soa(const std::size_t count) : x_(count), y_(count), z_(count)
+        {
+        }
+
+        /**
+         * \brief constructor from an array of structures
+         * \param values values to copy
+         */
+        explicit dimension3_soa(const std::vector<T>& values)
+        {
+            reserve(values.size());
+            for (const T& value : values)
+                push_back(value);
+        }
+
+        NODISCARD std::size_t size() const noexcept { return x_.size(); }
+        NODISCARD bool empty() const noexcept { return x_.empty(); }
+
+        /**
+         * \brief resizes all arrays, new elements are (0, 0, 0)
+         * \param count new amount of elements
+         */
+        void resize(const std::size_t count)
+        {
+            x_.resize(count);
+            y_.resize(count);
+            z_.resize(count);
+        }
+
+        /**
+         * \brief reserves memory in all arrays
+         * \param count amount of elements to reserve
+         */
+        void reserve(const std::size_t count)
+        {
+            x_.reserve(count);
+            y_.reserve(count);
+            z_.reserve(count);
+        }
+
+        /**
+         * \brief removes all elements, memory is kept
+         */
+        void clear() noexcept
+        {
+            x_.clear();
+            y_.clear();
+            z_.clear();
+        }
+
+        /**
+         * \brief adds a value to the end
+         * \param value value to add
+         */
+        void push_back(const T& value)
+        {
+            x_.push_back(value.x);
+            y_.push_back(value.y);
+            z_.push_back(value.z);
+        }
+
+        /**
+         * \brief gets an element, no bounds check
+         * \param index index of the element
+         * \return element at index
+         */
+        NODISCARD T get(const std::size_t index) const noexcept
+        {
+            return T(x_[index], y_[index], z_[index]);
+        }
+
+        /**
+         * \brief sets an element, no bounds check
+         * \param index index of the element
+         * \param value new value
+         */
+        void set(const std::size_t index, const T& value) noexcept
+        {
+            x_[index] = value.x;
+            y_[index] = value.y;
+            z_[index] = value.z;
+        }
+
+        /**
+         * \brief gathers elements from another array, this[i] = source[indices[i]]
+         * \note this is resized to count
+         * \param source array to gather from, must not be this
+         * \param indices indices in source
+         * \param count amount of indices
+         */
+        void gather(const dimension3_soa& source, const std::size_t* indices, const std::size_t count)
+        {
+            resize(count);
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                x_[index] = source.x_[indices[index]];
+                y_[index] = source.y_[indices[index]];
+                z_[index] = source.z_[indices[index]];
+            }
+        }
+
+        /**
+         * \brief swaps the content with another array
+         * \param other other array
+         */
+        void swap(dimension3_soa& other) noexcept
+        {
+            x_.swap(other.x_);
+            y_.swap(other.y_);
+            z_.swap(other.z_);
+        }
+
+        ///////////////////////////////////////////////////////
+        ///                 getters/setters                 ///
+        ///////////////////////////////////////////////////////
+
+        NODISCARD double* x() noexcept { return x_.data(); }
+        NODISCARD double* y() noexcept { return y_.data(); }
+        NODISCARD double* z() noexcept { return z_.data(); }
+        NODISCARD const double* x() const noexcept { return x_.data(); }
+        NODISCARD const double* y() const noexcept { return y_.data(); }
+        NODISCARD const double* z() const noexcept { return z_.data(); }
+    };
+} // namespace bardcore
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+
 #include "BardCore/bardcore.h"
 
 namespace bardcore
@@ -8,20 +13,58 @@ namespace bardcore
     {
     private:
         /**
-         * \brief helper function for calculating the square root via Newton-Raphson 
-         * \note credit: Alex Shtoff - https://stackoverflow.com/questions/8622256/in-c11-is-sqrt-defined-as-constexpr
-         * \param value value to calculate the square root from
-         * \param curr current value
-         * \param prev previous value
+         * \brief helper function for calculating the square root via Newton-Raphson
+         * \note the value is scaled by powers of 4 into [0.25, 4) first, so it converges in a few iterations from 1
+         * for any value, this keeps compile time evaluation cheap enough for e.g. a table of normalized rays
+         * \param value value to calculate the square root from, positive and finite
          * \return square root of value
          */
-        NODISCARD constexpr static double helper_sqrt_newton_raphson(
-            const double value, const double curr,
-            const double prev)
+        NODISCARD constexpr static double helper_sqrt_newton_raphson(const double value)
         {
-            return curr == prev
-                       ? curr
-                       : helper_sqrt_newton_raphson(value, 0.5 * (curr + value / curr), curr);
+            //scaling by 4 and 2 is exact, so the scaled root is exact as well
+            double scaled = value;
+            double factor = 1;
+            while (scaled >= 4)
+            {
+                scaled /= 4;
+                factor *= 2;
+            }
+            while (scaled < 0.25)
+            {
+                scaled *= 4;
+                factor /= 2;
+            }
+
+            //stop when the estimate is stable or alternates between two neighbouring values
+            double curr = 1, prev = 0, before = 0;
+            while (curr != prev && curr != before)
+            {
+                before = prev;
+                prev = curr;
+                curr = 0.5 * (curr + scaled / curr);
+            }
+
+            return curr * factor;
+        }
+
+        /**
+         * \brief checks if a value is not a number, usable at compile time unlike std::isnan
+         * \param value value to check
+         * \return true if value is nan
+         */
+        NODISCARD constexpr static bool is_nan(const double value) noexcept
+        {
+            return value != value;
+        }
+
+        /**
+         * \brief checks if a value is positive or negative infinity, usable at compile time unlike std::isinf
+         * \param value value to check
+         * \return true if value is inf or -inf
+         */
+        NODISCARD constexpr static bool is_inf(const double value) noexcept
+        {
+            return value > std::numeric_limits<double>::max() || value < -std::numeric_limits<double>::max();
         }
 
     public:
@@ -109,12 +152,15 @@ namespace bardcore
             if (value < 0)
                 throw exception::negative_exception("sqrt(value) can not be negative");
 
-            if (!std::_Is_constant_evaluated())
+            if (!IS_CONSTANT_EVALUATED())
                 return std::sqrt(value);
 
             // use std at runtime
             // use constexpr at compile time
-            return helper_sqrt_newton_raphson(value, value, 0);
+            if (value == 0 || value != value || value > std::numeric_limits<double>::max()) // zero, nan or inf
+                return value;
+
+            return helper_sqrt_newton_raphson(value);
         }
 
         /**
@@ -128,7 +174,7 @@ namespace bardcore
             if (value == 0)
                 return 1;
 
-            if (!std::_Is_constant_evaluated()) // use std if runtime
+            if (!IS_CONSTANT_EVALUATED()) // use std if runtime
                 return std::tgamma(static_cast<double>(value) + 1);
 
             return static_cast<double>(value) * factorial(value - 1);
@@ -143,10 +189,10 @@ namespace bardcore
          */
         NODISCARD constexpr static double pow(const double base, const int exponent) noexcept
         {
-            if (!std::_Is_constant_evaluated()) // use std if runtime
+            if (!IS_CONSTANT_EVALUATED()) // use std if runtime
                 return std::pow(base, static_cast<double>(exponent));
 
-            if (std::_Is_nan(base) || std::_Is_inf(base)) // base is inf
+            if (is_nan(base) || is_inf(base)) // base is inf
                 return NAN;
 
             if (exponent == 0 || equals(base, 1.)) // base is 1 or exponent is 0
@@ -166,10 +212,10 @@ namespace bardcore
          */
         NODISCARD constexpr static double cos(const double value) noexcept
         {
-            if (!std::_Is_constant_evaluated()) // use std if runtime
+            if (!IS_CONSTANT_EVALUATED()) // use std if runtime
                 return std::cos(value);
 
-            if (std::_Is_nan(value) || std::_Is_inf(value)) // value is inf
+            if (is_nan(value) || is_inf(value)) // value is inf
                 return NAN;
 
             return sin(value + pi_2);
@@ -184,10 +230,10 @@ namespace bardcore
          */
         NODISCARD constexpr static double sin(double value) noexcept
         {
-            if (!std::_Is_constant_evaluated()) // use std if runtime
+            if (!IS_CONSTANT_EVALUATED()) // use std if runtime
                 return std::sin(value);
 
-            if (std::_Is_nan(value) || std::_Is_inf(value)) // value is inf
+            if (is_nan(value) || is_inf(value)) // value is inf
                 return NAN;
 
             value = mod(value, 2 * pi); // make value between 0 and 2pi
@@ -200,7 +246,7 @@ namespace bardcore
 
                 // r is near zero, adding it to the result will not change the result
                 // r is not a number or inf, stop calculating
-                if (equals(r, 0) || (std::_Is_nan(r) || std::_Is_inf(r)))
+                if (equals(r, 0) || (is_nan(r) || is_inf(r)))
                     break;
 
                 result += r;
@@ -219,7 +265,7 @@ namespace bardcore
          */
         NODISCARD constexpr static double tan(const double value) noexcept
         {
-            if (std::_Is_nan(value) || std::_Is_inf(value)) // value is inf
+            if (is_nan(value) || is_inf(value)) // value is inf
                 return NAN;
 
             if (equals(mod(value, pi), 0)) // value is a multiple of pi
@@ -228,7 +274,7 @@ namespace bardcore
             if (!equals(value, 0) && equals(mod(value, pi_2), 0)) // value is a multiple of pi/2
                 return NAN;
 
-            if (!std::_Is_constant_evaluated()) // use std if runtime
+            if (!IS_CONSTANT_EVALUATED()) // use std if runtime
                 return std::tan(value);
 
             return sin(value) / cos(value);
@@ -247,17 +293,18 @@ namespace bardcore
          */
         NODISCARD constexpr static double arcsin(const double value)
         {
-            if (math::greater_than(math::abs(value), 1.) || std::_Is_nan(value) || std::_Is_inf(value))
+            if (math::greater_than(math::abs(value), 1.) || is_nan(value) || is_inf(value))
                 throw exception::out_of_range_exception("arcsin(x) must be between -1 and 1");
 
-            if (!std::_Is_constant_evaluated()) // use std if runtime
+            if (!IS_CONSTANT_EVALUATED()) // use std if runtime
                 return std::asin(value);
 
             if (equals(math::abs(value), 1))
                 return pi_2 * sign(value);
 
+            // (2n)! is larger than the largest double after n = 85, an overflow is not a constant expression
             double result = 0;
-            for (int index = 0; index < 1'000; ++index) // 1 thousand iterations as hard limit
+            for (int index = 0; index <= 85; ++index)
             {
                 //formula: Σ ((2n)! / (2^(2n) * (n!)^2)) * (x^(2n+1) / (2n+1))
                 const double r = factorial(2 * index) / (pow(2, 2 * index) * pow(factorial(index), 2)) * pow(
@@ -265,7 +312,7 @@ namespace bardcore
 
                 // r is near zero, adding it to the result will not change the result
                 // r is not a number or inf, stop calculating
-                if (equals(r, 0) || (std::_Is_nan(r) || std::_Is_inf(r)))
+                if (equals(r, 0) || (is_nan(r) || is_inf(r)))
                     break;
 
                 result += r;
@@ -287,10 +334,10 @@ namespace bardcore
          */
         NODISCARD constexpr static double arccos(const double value)
         {
-            if (math::greater_than(math::abs(value), 1.) || std::_Is_nan(value) || std::_Is_inf(value))
+            if (math::greater_than(math::abs(value), 1.) || is_nan(value) || is_inf(value))
                 throw exception::out_of_range_exception("arccos(x) must be between -1 and 1");
 
-            if (!std::_Is_constant_evaluated()) // use std if runtime
+            if (!IS_CONSTANT_EVALUATED()) // use std if runtime
                 return std::acos(value);
 
             return pi_2 - arcsin(value);
@@ -306,13 +353,13 @@ namespace bardcore
          */
         NODISCARD constexpr static double arctan(const double value) noexcept
         {
-            if (!std::_Is_constant_evaluated()) // use std if runtime
+            if (!IS_CONSTANT_EVALUATED()) // use std if runtime
                 return std::atan(value);
 
-            if (std::_Is_nan(value))
+            if (is_nan(value))
                 return NAN;
 
-            if (std::_Is_inf(value)) // value is inf
+            if (is_inf(value)) // value is inf
                 return pi_2 * sign(value); //https://en.cppreference.com/w/cpp/numeric/math/atan
 
             if (equals(value, 0)) // value is zero
@@ -333,7 +380,7 @@ namespace bardcore
 
                 // r is near zero, adding it to the result will not change the result
                 // r is not a number or inf, stop calculating
-                if (equals(r, 0) || (std::_Is_nan(r) || std::_Is_inf(r)))
+                if (equals(r, 0) || (is_nan(r) || is_inf(r)))
                     break;
 
                 result += r;
@@ -357,7 +404,7 @@ namespace bardcore
             if (equals(divisor, 0))
                 throw exception::zero_exception("mod divisor can not be zero");
 
-            if (!std::_Is_constant_evaluated()) // use std if runtime
+            if (!IS_CONSTANT_EVALUATED()) // use std if runtime
             {
                 const auto mod = std::fmod(value, divisor);
                 return equals(abs(mod), abs(divisor))
@@ -500,5 +547,48 @@ namespace bardcore
 
             return euclidean_gcd(value2, mod);
         }
+
+        /**
+         * \brief integer hash with a good avalanche, e.g. to turn a pixel and sample index into a random number
+         * \note read more at: https://nullprogram.com/blog/2018/07/31/
+         * \param value value to hash
+         * \return hash of value
+         */
+        NODISCARD constexpr static std::uint32_t hash(std::uint32_t value) noexcept
+        {
+            value ^= value >> 16;
+            value *= 0x7FEB352Du;
+            value ^= value >> 15;
+            value *= 0x846CA68Bu;
+            value ^= value >> 16;
+            return value;
+        }
+
+        /**
+         * \brief converts a 32 bit fixed point fraction to a double in the range [0, 1)
+         * \note the lowest bit is dropped so the conversion goes through int32, which can be vectorized
+         * \param value fraction, value / 2^32
+         * \return value / 2^32, rounded down to 31 bits
+         */
+        NODISCARD constexpr static double to_unit_interval(const std::uint32_t value) noexcept
+        {
+            return static_cast<double>(static_cast<std::int32_t>(value >> 1)) / 2147483648.;
+        }
+
+        /**
+         * \brief reverses the order of the bits, bit 0 becomes bit 31
+         * \note branch free, so loops that call it can be vectorized
+         * \param value value to reverse
+         * \return reversed value
+         */
+        NODISCARD constexpr static std::uint32_t reverse_bits(std::uint32_t value) noexcept
+        {
+            value = (value << 16) | (value >> 16);
+            value = ((value & 0x00FF00FFu) << 8) | ((value & 0xFF00FF00u) >> 8);
+            value = ((value & 0x0F0F0F0Fu) << 4) | ((value & 0xF0F0F0F0u) >> 4);
+            value = ((value & 0x33333333u) << 2) | ((value & 0xCCCCCCCCu) >> 2);
+            value = ((value & 0x55555555u) << 1) | ((value & 0xAAAAAAAAu) >> 1);
+            return value;
+        }
     };
 } // namespace bardcore
@@ -0,0 +1,370 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/vector3d.h"
+
+namespace bardcore
+{
+    /**
+     * \brief octahedral mapping of unit vectors to two unsigned integers of Bits bits, and back
+     *
+     * the unit sphere is projected on the octahedron |x| + |y| + |z| = 1, the lower half is folded over the upper
+     * half and the square that is left is quantized, the error is about the same in every direction
+     * \note read more at: https://jcgt.org/published/0003/02/01/
+     * \tparam Bits amount of bits of every component
+     */
+    template <unsigned Bits>
+    class octahedral_encoding
+    {
+    protected:
+        INLINE static constexpr std::uint32_t max_value = (1u << Bits) - 1; // largest quantized component
+
+        /**
+         * \brief maps a vector to its quantized components, branch free so batch loops can be vectorized
+         * \note a zero vector gives the components of (0, 0, 1)
+         */
+        static void encode(const double x, const double y, const double z, std::uint32_t& u,
+                           std::uint32_t& v) noexcept
+        {
+            const double scale = static_cast<double>(max_value);
+            const double sum = std::abs(x) + std::abs(y) + std::abs(z);
+            const double inverse_sum = sum > 0 ? 1. / sum : 0;
+            const double px = x * inverse_sum;
+            const double py = y * inverse_sum;
+
+            //fold the lower half over the diagonals of the square
+            const double fold_x = (1 - std::abs(py)) * (px >= 0 ? 1. : -1.);
+            const double fold_y = (1 - std::abs(px)) * (py >= 0 ? 1. : -1.);
+            const double ox = z < 0 ? fold_x : px;
+            const double oy = z < 0 ? fold_y : py;
+
+            //through int32 so the conversion can be vectorized, the values always fit
+            u = static_cast<std::uint32_t>(static_cast<std::int32_t>((ox * 0.5 + 0.5) * scale + 0.5));
+            v = static_cast<std::uint32_t>(static_cast<std::int32_t>((oy * 0.5 + 0.5) * scale + 0.5));
+        }
+
+        /**
+         * \brief maps quantized components back to a normalized vector, branch free so batch loops can be vectorized
+         */
+        static void decode(const std::uint32_t u, const std::uint32_t v, double& x, double& y, double& z) noexcept
+        {
+            const double scale = 2. / static_cast<double>(max_value);
+            const double px = static_cast<double>(static_cast<std::int32_t>(u)) * scale - 1;
+            const double py = static_cast<double>(static_cast<std::int32_t>(v)) * scale - 1;
+            const double pz = 1 - std::abs(px) - std::abs(py);
+
+            //unfold the lower half
+            const double fold = pz < 0 ? -pz : 0;
+            const double ox = px + (px >= 0 ? -fold : fold);
+            const double oy = py + (py >= 0 ? -fold : fold);
+
+            const double inverse_length = 1. / std::sqrt(ox * ox + oy * oy + pz * pz);
+            x = ox * inverse_length;
+            y = oy * inverse_length;
+            z = pz * inverse_length;
+        }
+    };
+
+    /**
+     * \brief unit vector in 32 bits, two 16 bit octahedral components, the error is below 0.005 degrees
+     * \note 24 bytes less than a vector3d, e.g. for normals in meshes or hits
+     */
+    class octahedral32 : protected octahedral_encoding<16>
+    {
+    protected:
+        std::uint32_t bits_ = 0; // first component in the upper 16 bits, second component in the lower 16 bits
+
+    public:
+        /**
+         * \brief default constructor, the encoding of (0, 0, 1)
+         */
+        constexpr octahedral32() noexcept : bits_(0x80008000)
+        {
+        }
+
+        /**
+         * \brief constructor for octahedral32
+         * \throws zero_exception if the length of vector is zero
+         * \param vector vector to encode (it will be normalized for you)
+         */
+        explicit octahedral32(const vector3d& vector)
+        {
+            const vector3d normalized = vector.normalize();
+            encode_single(normalized.x, normalized.y, normalized.z, *this);
+        }
+
+        /**
+         * \brief constructor from encoded bits, e.g. loaded from a file
+         * \param bits encoded bits, see get_bits
+         * \return octahedral32 with the bits
+         */
+        NODISCARD static octahedral32 from_bits(const std::uint32_t bits) noexcept
+        {
+            octahedral32 result;
+            result.bits_ = bits;
+            return result;
+        }
+
+        /**
+         * \brief decodes the unit vector
+         * \return normalized vector
+         */
+        NODISCARD vector3d decode() const noexcept
+        {
+            double x = 0, y = 0, z = 0;
+            decode_single(*this, x, y, z);
+            return {x, y, z};
+        }
+
+        /**
+         * \brief encodes a batch of vectors
+         * \note the loop is branch free so it can be vectorized, the vectors are normalized but a zero vector
+         * doesn't throw, it is encoded as (0, 0, 1)
+         * \param x x of every vector
+         * \param y y of every vector
+         * \param z z of every vector
+         * \param count amount of vectors
+         * \param result encoding of every vector, must have room for count values
+         */
+        static void encode(const double* x, const double* y, const double* z, const std::size_t count,
+                           octahedral32* result) noexcept
+        {
+            VECTORIZE
+            for (std::size_t index = 0; index < count; ++index)
+                encode_single(x[index], y[index], z[index], result[index]);
+        }
+
+        /**
+         * \brief encodes a batch of vectors, see encode(x, y, z, count, result)
+         * \param vectors vectors to encode
+         * \param result encoding of every vector, resized to the size of vectors
+         */
+        static void encode(const dimension3_soa<vector3d>& vectors, std::vector<octahedral32>& result)
+        {
+            result.resize(vectors.size());
+            encode(vectors.x(), vectors.y(), vectors.z(), vectors.size(), result.data());
+        }
+
+        /**
+         * \brief decodes a batch of unit vectors
+         * \note the loop is branch free so it can be vectorized
+         * \param values encoded unit vectors
+         * \param count amount of values
+         * \param x x of every vector, must have room for count values
+         * \param y y of every vector, must have room for count values
+         * \param z z of every vector, must have room for count values
+         */
+        static void decode(const octahedral32* values, const std::size_t count, double* x, double* y,
+                           double* z) noexcept
+        {
+            VECTORIZE
+            for (std::size_t index = 0; index < count; ++index)
+                decode_single(values[index], x[index], y[index], z[index]);
+        }
+
+        /**
+         * \brief decodes a batch of unit vectors, see decode(values, count, x, y, z)
+         * \param values encoded unit vectors
+         * \param result normalized vectors, resized to the size of values
+         */
+        static void decode(const std::vector<octahedral32>& values, dimension3_soa<vector3d>& result)
+        {
+            result.resize(values.size());
+            decode(values.data(), values.size(), result.x(), result.y(), result.z());
+        }
+
+    protected:
+        static void encode_single(const double x, const double y, const double z, octahedral32& result) noexcept
+        {
+            std::uint32_t u = 0, v = 0;
+            octahedral_encoding::encode(x, y, z, u, v);
+            result.bits_ = u << 16 | v;
+        }
+
+        static void decode_single(const octahedral32& value, double& x, double& y, double& z) noexcept
+        {
+            octahedral_encoding::decode(value.bits_ >> 16, value.bits_ & 0xFFFF, x, y, z);
+        }
+
+    public:
+        ///////////////////////////////////////////////////////
+        ///                 getters/setters                 ///
+        ///////////////////////////////////////////////////////
+
+        NODISCARD std::uint32_t get_bits() const noexcept { return bits_; }
+
+        ///////////////////////////////////////////////////////
+        ///                    operators                    ///
+        ///////////////////////////////////////////////////////
+
+        /**
+         * \brief equal operator (the encoded bits are equal)
+         * \param left left value
+         * \param right right value
+         * \return true if left == right
+         */
+        NODISCARD friend bool operator==(const octahedral32& left, const octahedral32& right) noexcept
+        {
+            return left.bits_ == right.bits_;
+        }
+
+        /**
+         * \brief not equal operator (the encoded bits are not equal)
+         * \param left left value
+         * \param right right value
+         * \return true if left != right
+         */
+        NODISCARD friend bool operator!=(const octahedral32& left, const octahedral32& right) noexcept
+        {
+            return !(left == right);
+        }
+    };
+
+    /**
+     * \brief unit vector in 48 bits, two 24 bit octahedral components, the error is below 0.00002 degrees
+     * \note stored as three 16 bit values, so it is 6 bytes and 2 byte aligned
+     */
+    class octahedral48 : protected octahedral_encoding<24>
+    {
+    protected:
+        // lower 16 bits of the first component, upper 8 bits of the first and lower 8 bits of the second component,
+        // upper 16 bits of the second component
+        std::uint16_t bits_[3] = {0x0000, 0x0080, 0x8000};
+
+    public:
+        /**
+         * \brief default constructor, the encoding of (0, 0, 1)
+         */
+        octahedral48() noexcept = default;
+
+        /**
+         * \brief constructor for octahedral48
+         * \throws zero_exception if the length of vector is zero
+         * \param vector vector to encode (it will be normalized for you)
+         */
+        explicit octahedral48(const vector3d& vector)
+        {
+            const vector3d normalized = vector.normalize();
+            encode_single(normalized.x, normalized.y, normalized.z, *this);
+        }
+
+        /**
+         * \brief decodes the unit vector
+         * \return normalized vector
+         */
+        NODISCARD vector3d decode() const noexcept
+        {
+            double x = 0, y = 0, z = 0;
+            decode_single(*this, x, y, z);
+            return {x, y, z};
+        }
+
+        /**
+         * \brief encodes a batch of vectors
+         * \note the loop is branch free so it can be vectorized, the vectors are normalized but a zero vector
+         * doesn't throw, it is encoded as (0, 0, 1)
+         * \param x x of every vector
+         * \param y y of every vector
+         * \param z z of every vector
+         * \param count amount of vectors
+         * \param result encoding of every vector, must have room for count values
+         */
+        static void encode(const double* x, const double* y, const double* z, const std::size_t count,
+                           octahedral48* result) noexcept
+        {
+            VECTORIZE
+            for (std::size_t index = 0; index < count; ++index)
+                encode_single(x[index], y[index], z[index], result[index]);
+        }
+
+        /**
+         * \brief encodes a batch of vectors, see encode(x, y, z, count, result)
+         * \param vectors vectors to encode
+         * \param result encoding of every vector, resized to the size of vectors
+         */
+        static void encode(const dimension3_soa<vector3d>& vectors, std::vector<octahedral48>& result)
+        {
+            result.resize(vectors.size());
+            encode(vectors.x(), vectors.y(), vectors.z(), vectors.size(), result.data());
+        }
+
+        /**
+         * \brief decodes a batch of unit vectors
+         * \note the loop is branch free so it can be vectorized
+         * \param values encoded unit vectors
+         * \param count amount of values
+         * \param x x of every vector, must have room for count values
+         * \param y y of every vector, must have room for count values
+         * \param z z of every vector, must have room for count values
+         */
+        static void decode(const octahedral48* values, const std::size_t count, double* x, double* y,
+                           double* z) noexcept
+        {
+            VECTORIZE
+            for (std::size_t index = 0; index < count; ++index)
+                decode_single(values[index], x[index], y[index], z[index]);
+        }
+
+        /**
+         * \brief decodes a batch of unit vectors, see decode(values, count, x, y, z)
+         * \param values encoded unit vectors
+         * \param result normalized vectors, resized to the size of values
+         */
+        static void decode(const std::vector<octahedral48>& values, dimension3_soa<vector3d>& result)
+        {
+            result.resize(values.size());
+            decode(values.data(), values.size(), result.x(), result.y(), result.z());
+        }
+
+    protected:
+        static void encode_single(const double x, const double y, const double z, octahedral48& result) noexcept
+        {
+            std::uint32_t u = 0, v = 0;
+            octahedral_encoding::encode(x, y, z, u, v);
+            result.bits_[0] = static_cast<std::uint16_t>(u);
+            result.bits_[1] = static_cast<std::uint16_t>(u >> 16 | (v & 0xFF) << 8);
+            result.bits_[2] = static_cast<std::uint16_t>(v >> 8);
+        }
+
+        static void decode_single(const octahedral48& value, double& x, double& y, double& z) noexcept
+        {
+            const std::uint32_t u = value.bits_[0] | (value.bits_[1] & 0xFFu) << 16;
+            const std::uint32_t v = static_cast<std::uint32_t>(value.bits_[1]) >> 8 |
+                static_cast<std::uint32_t>(value.bits_[2]) << 8;
+            octahedral_encoding::decode(u, v, x, y, z);
+        }
+
+    public:
+        ///////////////////////////////////////////////////////
+        ///                    operators                    ///
+        ///////////////////////////////////////////////////////
+
+        /**
+         * \brief equal operator (the encoded bits are equal)
+         * \param left left value
+         * \param right right value
+         * \return true if left == right
+         */
+        NODISCARD friend bool operator==(const octahedral48& left, const octahedral48& right) noexcept
+        {
+            return left.bits_[0] == right.bits_[0] && left.bits_[1] == right.bits_[1] && left.bits_[2] == right.
+                bits_[2];
+        }
+
+        /**
+         * \brief not equal operator (the encoded bits are not equal)
+         * \param left left value
+         * \param right right value
+         * \return true if left != right
+         */
+        NODISCARD friend bool operator!=(const octahedral48& left, const octahedral48& right) noexcept
+        {
+            return !(left == right);
+        }
+    };
+} // namespace bardcore
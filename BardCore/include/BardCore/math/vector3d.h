@@ -27,6 +27,8 @@ namespace bardcore
             if (l == 0)
                 throw exception::zero_exception("vector length must not be zero");
 
+            INSTRUMENT(normalizations);
+
             //branchless normalization
             return l == 1.
                        ? *this
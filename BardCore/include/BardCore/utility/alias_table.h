@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "BardCore/bardcore.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief alias table, samples index i with probability weights[i] / sum(weights) in constant time
+         * \note read more at: https://en.wikipedia.org/wiki/Alias_method (built with vose's method)
+         */
+        class alias_table
+        {
+        protected:
+            std::vector<double> probability_{}; // chance to keep the bucket instead of taking its alias
+            std::vector<std::uint32_t> alias_{}; // index taken when the bucket isn't kept
+            std::vector<double> pdf_{}; // normalized weight of every index
+
+        public:
+            /**
+             * \brief constructor for alias_table
+             * \throws negative_exception if a weight is negative
+             * \throws zero_exception if weights is empty or the sum of the weights is zero
+             * \param weights weight of every index
+             */
+            explicit alias_table(const std::vector<double>& weights) : probability_(weights.size()),
+                                                                        alias_(weights.size()),
+                                                                        pdf_(weights.size())
+            {
+                double sum = 0;
+                for (const double weight : weights)
+                {
+                    if (weight < 0)
+                        throw exception::negative_exception("weights can't be negative");
+                    sum += weight;
+                }
+
+                if (sum <= 0)
+                    throw exception::zero_exception("sum of the weights must be greater than 0");
+
+                const std::size_t count = weights.size();
+                std::vector<std::uint32_t> small, large;
+                small.reserve(count);
+                large.reserve(count);
+
+                //scale the weights so the average bucket is exactly 1
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    pdf_[index] = weights[index] / sum;
+                    probability_[index] = pdf_[index] * static_cast<double>(count);
+                    alias_[index] = static_cast<std::uint32_t>(index);
+                    (probability_[index] < 1 ? small : large).push_back(static_cast<std::uint32_t>(index));
+                }
+
+                //fill every small bucket with a part of a large one
+                while (!small.empty() && !large.empty())
+                {
+                    const std::uint32_t less = small.back();
+                    const std::uint32_t more = large.back();
+                    small.pop_back();
+
+                    alias_[less] = more;
+                    probability_[more] -= 1 - probability_[less];
+                    if (probability_[more] < 1)
+                    {
+                        large.pop_back();
+                        small.push_back(more);
+                    }
+                }
+
+                //whatever is left is 1, up to rounding errors
+                for (const std::uint32_t index : small)
+                    probability_[index] = 1;
+                for (const std::uint32_t index : large)
+                    probability_[index] = 1;
+            }
+
+            /**
+             * \brief samples an index
+             * \param random uniform random number in [0, 1)
+             * \return sampled index
+             */
+            NODISCARD std::uint32_t sample(const double random) const noexcept
+            {
+                const double scaled = random * static_cast<double>(probability_.size());
+                std::size_t bucket = static_cast<std::size_t>(scaled);
+                bucket = bucket < probability_.size() ? bucket : probability_.size() - 1;
+
+                //the fraction within the bucket decides between the bucket and its alias
+                return scaled - static_cast<double>(bucket) < probability_[bucket]
+                           ? static_cast<std::uint32_t>(bucket)
+                           : alias_[bucket];
+            }
+
+            /**
+             * \brief samples an index for every random number
+             * \param random uniform random numbers in [0, 1)
+             * \param count amount of random numbers
+             * \param result sampled index of every random number
+             */
+            void sample(const double* random, const std::size_t count, std::uint32_t* result) const noexcept
+            {
+                const double size = static_cast<double>(probability_.size());
+                const std::size_t last = probability_.size() - 1;
+                const double* probability = probability_.data();
+                const std::uint32_t* alias = alias_.data();
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double scaled = random[index] * size;
+                    std::size_t bucket = static_cast<std::size_t>(scaled);
+                    bucket = bucket < last ? bucket : last;
+
+                    result[index] = scaled - static_cast<double>(bucket) < probability[bucket]
+                                        ? static_cast<std::uint32_t>(bucket)
+                                        : alias[bucket];
+                }
+            }
+
+            /**
+             * \brief samples an index for every random number, result is resized to the size of random
+             * \param random uniform random numbers in [0, 1)
+             * \param result sampled index of every random number
+             */
+            void sample(const std::vector<double>& random, std::vector<std::uint32_t>& result) const
+            {
+                result.resize(random.size());
+                sample(random.data(), random.size(), result.data());
+            }
+
+            /**
+             * \brief gets the probability of sampling an index
+             * \param index index to get the probability of
+             * \return weights[index] / sum(weights)
+             */
+            NODISCARD double pdf(const std::size_t index) const noexcept { return pdf_[index]; }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return pdf_.size(); }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -4,6 +4,8 @@
 #include <BardCore/math/vector3d.h>
 #include <BardCore/math/point3d.h>
 #include <BardCore/utility/ray.h>
+#include <BardCore/utility/ray_queue.h>
+#include <BardCore/utility/ray_differentials.h>
 
 namespace bardcore
 {
@@ -34,8 +36,8 @@ namespace bardcore
             constexpr void calculate_screen() noexcept
             {
                 vector3d arbitrary_vector = {1, 0, 0}; //random vector
-                if (direction_ == arbitrary_vector)
-                    //other random vector, if direction is the same as the first random vector
+                if (direction_ == arbitrary_vector || direction_ == vector3d(-1, 0, 0))
+                    //other random vector, if direction is parallel to the first random vector
                     arbitrary_vector = {0, 1, 0};
 
                 const vector3d cross_factor = direction_.cross(arbitrary_vector).normalize();
@@ -53,7 +55,145 @@ namespace bardcore
                 top_left_ = center - half_horizontal_ + half_vertical_;
             }
 
+            /**
+             * \brief constructor for a camera of which the screen is already calculated, e.g. by camera_path
+             * \param position position of the camera
+             * \param direction normalized direction of the camera
+             * \param top_left top left corner of the screen
+             * \param half_horizontal half of the horizontal screen vector
+             * \param half_vertical half of the vertical screen vector
+             * \param screen_width width of the camera
+             * \param screen_height height of the camera
+             * \param fov field of view
+             */
+            constexpr camera(const point3d& position, const vector3d& direction, const point3d& top_left,
+                             const vector3d& half_horizontal, const vector3d& half_vertical,
+                             const unsigned int screen_width, const unsigned int screen_height,
+                             const unsigned int fov) noexcept : position_(position), direction_(direction),
+                                                                top_left_(top_left),
+                                                                half_horizontal_(half_horizontal),
+                                                                half_vertical_(half_vertical),
+                                                                screen_width_(screen_width),
+                                                                screen_height_(screen_height), fov_(fov)
+            {
+            }
+
+            friend class camera_path;
+
         public:
+            /**
+             * \brief changes several properties of a camera and calculates the screen only once, when it is destroyed
+             * \note get one with camera::update(), e.g. camera.update().position(p).direction(d);
+             */
+            class updater
+            {
+            protected:
+                camera* camera_; // camera to update, nullptr after a move
+
+            public:
+                /**
+                 * \brief constructor for updater
+                 * \param camera camera to update
+                 */
+                explicit updater(camera& camera) noexcept : camera_(&camera)
+                {
+                }
+
+                updater(const updater&) = delete;
+
+                /**
+                 * \brief move constructor, only the new updater calculates the screen
+                 * \param other updater to move
+                 */
+                updater(updater&& other) noexcept : camera_(other.camera_)
+                {
+                    other.camera_ = nullptr;
+                }
+
+                /**
+                 * \brief destructor, calculates the screen of the camera
+                 */
+                ~updater()
+                {
+                    if (camera_ != nullptr)
+                        camera_->calculate_screen();
+                }
+
+                updater& operator=(const updater&) = delete;
+                updater& operator=(updater&&) = delete;
+
+                /**
+                 * \brief sets the position of the camera
+                 * \param position new position
+                 * \return this
+                 */
+                updater& position(const point3d& position) noexcept
+                {
+                    camera_->position_ = position;
+                    return *this;
+                }
+
+                /**
+                 * \brief sets the direction of the camera
+                 * \throws zero_exception if length of direction is zero, e.g if direction is {0, 0, 0}
+                 * \param direction new direction
+                 * \return this
+                 */
+                updater& direction(const vector3d& direction)
+                {
+                    camera_->direction_ = direction.normalize();
+                    return *this;
+                }
+
+                /**
+                 * \brief sets the width of the camera
+                 * \throws zero_exception if width is zero
+                 * \param width new width
+                 * \return this
+                 */
+                updater& width(const unsigned int width)
+                {
+                    if (width == 0)
+                        throw exception::zero_exception("width and height must be greater than 0");
+
+                    camera_->screen_width_ = width;
+                    return *this;
+                }
+
+                /**
+                 * \brief sets the height of the camera
+                 * \throws zero_exception if height is zero
+                 * \param height new height
+                 * \return this
+                 */
+                updater& height(const unsigned int height)
+                {
+                    if (height == 0)
+                        throw exception::zero_exception("width and height must be greater than 0");
+
+                    camera_->screen_height_ = height;
+                    return *this;
+                }
+
+                /**
+                 * \brief sets the fov of the camera
+                 * \throws zero_exception if fov is zero
+                 * \throws out_of_range_exception if fov is greater than 180
+                 * \param fov new fov
+                 * \return this
+                 */
+                updater& fov(const unsigned int fov)
+                {
+                    if (fov == 0)
+                        throw exception::zero_exception("fov must be greater than 0");
+                    if (fov >= 180)
+                        throw exception::out_of_range_exception("fov must be smaller than 180");
+
+                    camera_->fov_ = fov;
+                    return *this;
+                }
+            };
+
             /**
              * \brief constructor for camera (position, direction, width, height)
              * \throws zero_exception if width or height is zero
@@ -122,6 +262,8 @@ namespace bardcore
                     throw bardcore::exception::out_of_range_exception(
                         "x and y must be smaller than the screen width and height");
 
+                INSTRUMENT(rays);
+
                 //calculate the position on the screen
                 const double ratio_width = static_cast<double>(x) / static_cast<double>(screen_width_);
                 const double ratio_height = static_cast<double>(y) / static_cast<double>(screen_height_);
@@ -134,6 +276,150 @@ namespace bardcore
                 return {position_, position_.get_vector(top_left_ + horizontal - vertical), distance};
             }
 
+            /**
+             * \brief shoot a ray from the camera through a position inside a pixel, e.g. for antialiasing
+             * \note shoot_subpixel_ray(x, y, distance) is the same as shoot_ray(x, y, distance) for whole numbers
+             * \throws out_of_range_exception if x or y is negative, or not smaller than the screen width or height
+             * \param x x position on the screen, x + 0.5 is the center of pixel x
+             * \param y y position on the screen, y + 0.5 is the center of pixel y
+             * \param distance distance of the ray
+             */
+            NODISCARD constexpr ray shoot_subpixel_ray(const double x, const double y, const double distance) const
+            {
+                if (!(x >= 0 && y >= 0 && x < static_cast<double>(screen_width_) &&
+                    y < static_cast<double>(screen_height_)))
+                    throw bardcore::exception::out_of_range_exception(
+                        "x and y must be in the range [0, screen width) and [0, screen height)");
+
+                INSTRUMENT(rays);
+
+                const vector3d horizontal = half_horizontal_ * 2 * (x / static_cast<double>(screen_width_));
+                const vector3d vertical = half_vertical_ * 2 * (y / static_cast<double>(screen_height_));
+
+                return {position_, position_.get_vector(top_left_ + horizontal - vertical), distance};
+            }
+
+            /**
+             * \brief shoot a ray from the camera through every pixel on the screen, row by row
+             *
+             * the queue is overwritten, ray i goes through pixel (i % width, i / width) and has the same direction as
+             * shoot_ray(i % width, i / width, distance), the pixel array holds i
+             * \note this is a batch version of shoot_ray, the inner loop is branch free so it can be vectorized
+             * \throws negative_exception if distance is negative
+             * \param queue queue to write the rays to
+             * \param distance distance of the rays
+             */
+            void shoot_rays(ray_queue& queue, const double distance) const
+            {
+                if (distance < 0)
+                    throw exception::negative_exception("distance can't be negative");
+
+                queue.resize(static_cast<std::size_t>(screen_width_) * screen_height_);
+                INSTRUMENT_ADD(rays, queue.size());
+
+                //step from one pixel to the next on the screen
+                const vector3d step_horizontal = half_horizontal_ * 2 / static_cast<double>(screen_width_);
+                const vector3d step_vertical = half_vertical_ * 2 / static_cast<double>(screen_height_);
+                const vector3d corner = position_.get_vector(top_left_);
+
+                double* origin_x = queue.origin.x();
+                double* origin_y = queue.origin.y();
+                double* origin_z = queue.origin.z();
+                double* direction_x = queue.direction.x();
+                double* direction_y = queue.direction.y();
+                double* direction_z = queue.direction.z();
+                double* length = queue.distance.data();
+                std::uint32_t* pixel = queue.pixel.data();
+                double* throughput = queue.throughput.data();
+                std::uint32_t* depth = queue.depth.data();
+
+                for (unsigned int y = 0; y < screen_height_; ++y)
+                {
+                    const vector3d row = corner - step_vertical * static_cast<double>(y);
+                    const std::size_t offset = static_cast<std::size_t>(y) * screen_width_;
+
+                    VECTORIZE
+                    for (unsigned int x = 0; x < screen_width_; ++x)
+                    {
+                        const double vx = row.x + step_horizontal.x * static_cast<double>(x);
+                        const double vy = row.y + step_horizontal.y * static_cast<double>(x);
+                        const double vz = row.z + step_horizontal.z * static_cast<double>(x);
+                        const double inverse_length = 1. / std::sqrt(vx * vx + vy * vy + vz * vz);
+
+                        origin_x[offset + x] = position_.x;
+                        origin_y[offset + x] = position_.y;
+                        origin_z[offset + x] = position_.z;
+                        direction_x[offset + x] = vx * inverse_length;
+                        direction_y[offset + x] = vy * inverse_length;
+                        direction_z[offset + x] = vz * inverse_length;
+                        length[offset + x] = distance;
+                        pixel[offset + x] = static_cast<std::uint32_t>(offset + x);
+                        throughput[offset + x] = 1;
+                        depth[offset + x] = 0;
+                    }
+                }
+            }
+
+            /**
+             * \brief shoot a ray from the camera through every pixel on the screen, with the ray differentials of
+             * every ray, e.g. for texture filtering
+             *
+             * the rays are the same as shoot_rays(queue, distance), the origins don't change from pixel to pixel and
+             * the direction differentials are the change of the normalized direction per pixel
+             * \throws negative_exception if distance is negative
+             * \param queue queue to write the rays to
+             * \param differentials differentials to write the differentials of the rays to
+             * \param distance distance of the rays
+             */
+            void shoot_rays(ray_queue& queue, ray_differentials& differentials, const double distance) const
+            {
+                shoot_rays(queue, distance);
+
+                const std::size_t count = queue.size();
+                differentials.resize(count);
+
+                //the direction v is normalized by 1 / |v| = d . direction, because the screen is at distance 1, so
+                //the change of d = v / |v| per pixel is (step - (d . step) * d) * (d . direction)
+                const vector3d step_horizontal = half_horizontal_ * 2 / static_cast<double>(screen_width_);
+                const vector3d step_vertical = half_vertical_ * -2 / static_cast<double>(screen_height_);
+
+                const double* direction_x = queue.direction.x();
+                const double* direction_y = queue.direction.y();
+                const double* direction_z = queue.direction.z();
+                double* origin_dx_x = differentials.origin_dx.x();
+                double* origin_dx_y = differentials.origin_dx.y();
+                double* origin_dx_z = differentials.origin_dx.z();
+                double* origin_dy_x = differentials.origin_dy.x();
+                double* origin_dy_y = differentials.origin_dy.y();
+                double* origin_dy_z = differentials.origin_dy.z();
+                double* direction_dx_x = differentials.direction_dx.x();
+                double* direction_dx_y = differentials.direction_dx.y();
+                double* direction_dx_z = differentials.direction_dx.z();
+                double* direction_dy_x = differentials.direction_dy.x();
+                double* direction_dy_y = differentials.direction_dy.y();
+                double* direction_dy_z = differentials.direction_dy.z();
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double dx = direction_x[index];
+                    const double dy = direction_y[index];
+                    const double dz = direction_z[index];
+                    const double inverse_length = dx * direction_.x + dy * direction_.y + dz * direction_.z;
+                    const double along_x = dx * step_horizontal.x + dy * step_horizontal.y + dz * step_horizontal.z;
+                    const double along_y = dx * step_vertical.x + dy * step_vertical.y + dz * step_vertical.z;
+
+                    origin_dx_x[index] = origin_dx_y[index] = origin_dx_z[index] = 0;
+                    origin_dy_x[index] = origin_dy_y[index] = origin_dy_z[index] = 0;
+                    direction_dx_x[index] = (step_horizontal.x - along_x * dx) * inverse_length;
+                    direction_dx_y[index] = (step_horizontal.y - along_x * dy) * inverse_length;
+                    direction_dx_z[index] = (step_horizontal.z - along_x * dz) * inverse_length;
+                    direction_dy_x[index] = (step_vertical.x - along_y * dx) * inverse_length;
+                    direction_dy_y[index] = (step_vertical.y - along_y * dy) * inverse_length;
+                    direction_dy_z[index] = (step_vertical.z - along_y * dz) * inverse_length;
+                }
+            }
+
             ///////////////////////////////////////////////////////
             ///                 getters/setters                 ///
             ///////////////////////////////////////////////////////
@@ -145,6 +431,32 @@ namespace bardcore
             NODISCARD constexpr const vector3d& get_direction() const noexcept { return direction_; }
             NODISCARD constexpr unsigned int get_fov() const noexcept { return fov_; }
 
+            /**
+             * \brief gets the top left corner of the screen, the screen is at distance 1 in front of the camera
+             * \return top left corner of the screen
+             */
+            NODISCARD constexpr const point3d& get_top_left() const noexcept { return top_left_; }
+
+            /**
+             * \brief gets half of the horizontal screen vector, it points right and its length is tan(fov / 2)
+             * \return half of the horizontal screen vector
+             */
+            NODISCARD constexpr const vector3d& get_half_horizontal() const noexcept { return half_horizontal_; }
+
+            /**
+             * \brief gets half of the vertical screen vector, it points up and its length is tan(fov / 2)
+             * \return half of the vertical screen vector
+             */
+            NODISCARD constexpr const vector3d& get_half_vertical() const noexcept { return half_vertical_; }
+
+            /**
+             * \brief starts changing several properties at once, the screen is calculated once when the updater is
+             * destroyed, instead of once per setter
+             * \note the screen is out of date until then, e.g. camera.update().position(p).direction(d).fov(60);
+             * \return updater of this camera
+             */
+            NODISCARD updater update() noexcept { return updater(*this); }
+
             /**
              * \brief sets the position of the camera
              * \param position new position
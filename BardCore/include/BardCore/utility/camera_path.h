@@ -0,0 +1,182 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/camera.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief screens of a camera for every frame of an animation, calculated in one pass
+         *
+         * a camera calculates its screen (a tan, two cross products and three normalizations) every time it is
+         * changed, a camera_path calculates the screens of all frames at once in a loop that can be vectorized
+         * \note every frame has the same width, height and fov, only the position and direction change
+         */
+        class camera_path
+        {
+        protected:
+            dimension3_soa<point3d> position_{}; // position of every frame
+            dimension3_soa<vector3d> direction_{}; // normalized direction of every frame
+            dimension3_soa<point3d> top_left_{}; // top left corner of the screen of every frame
+            dimension3_soa<vector3d> half_horizontal_{}, half_vertical_{}; // half screen vectors of every frame
+
+            unsigned int screen_width_, screen_height_; // screen width and height
+            unsigned int fov_; // field of view
+
+        public:
+            /**
+             * \brief constructor for camera_path, calculates the screen of every frame
+             * \throws zero_exception if width, height or fov is zero
+             * \throws zero_exception if the length of a direction is zero
+             * \throws out_of_range_exception if fov is greater than 180
+             * \throws out_of_range_exception if positions and directions have a different size
+             * \param positions position of the camera in every frame
+             * \param directions direction of the camera in every frame (it will be normalized for you)
+             * \param screen_width width of the camera
+             * \param screen_height height of the camera
+             * \param fov field of view, default is 90
+             */
+            camera_path(const std::vector<point3d>& positions, const std::vector<vector3d>& directions,
+                        const unsigned int screen_width, const unsigned int screen_height,
+                        const unsigned int fov = 90) : position_(positions), direction_(directions.size()),
+                                                       screen_width_(screen_width), screen_height_(screen_height),
+                                                       fov_(fov)
+            {
+                if (screen_width == 0 || screen_height == 0)
+                    throw exception::zero_exception("width and height must be greater than 0");
+                if (fov == 0)
+                    throw exception::zero_exception("fov must be greater than 0");
+                if (fov >= 180)
+                    throw exception::out_of_range_exception("fov must be smaller than 180");
+                if (positions.size() != directions.size())
+                    throw exception::out_of_range_exception("positions and directions must have the same size");
+
+                for (std::size_t frame = 0; frame < directions.size(); ++frame)
+                    direction_.set(frame, directions[frame].normalize());
+
+                calculate_screens();
+            }
+
+            /**
+             * \brief gets the camera of a frame, without calculating its screen again
+             * \throws out_of_range_exception if frame is greater or equal to size()
+             * \param frame index of the frame
+             * \return camera of the frame
+             */
+            NODISCARD camera get_camera(const std::size_t frame) const
+            {
+                if (frame >= size())
+                    throw exception::out_of_range_exception("frame must be smaller than the amount of frames");
+
+                return {
+                    position_.get(frame), direction_.get(frame), top_left_.get(frame), half_horizontal_.get(frame),
+                    half_vertical_.get(frame), screen_width_, screen_height_, fov_
+                };
+            }
+
+        protected:
+            /**
+             * \brief calculates the screen of every frame, the same as camera::calculate_screen
+             */
+            void calculate_screens()
+            {
+                const std::size_t count = position_.size();
+                top_left_.resize(count);
+                half_horizontal_.resize(count);
+                half_vertical_.resize(count);
+
+                const double half_fov_tan = math::tan(math::degrees_to_radians(static_cast<double>(fov_) / 2));
+                const double epsilon = math::epsilon;
+
+                const double* position_x = position_.x();
+                const double* position_y = position_.y();
+                const double* position_z = position_.z();
+                const double* direction_x = direction_.x();
+                const double* direction_y = direction_.y();
+                const double* direction_z = direction_.z();
+                double* top_left_x = top_left_.x();
+                double* top_left_y = top_left_.y();
+                double* top_left_z = top_left_.z();
+                double* horizontal_x = half_horizontal_.x();
+                double* horizontal_y = half_horizontal_.y();
+                double* horizontal_z = half_horizontal_.z();
+                double* vertical_x = half_vertical_.x();
+                double* vertical_y = half_vertical_.y();
+                double* vertical_z = half_vertical_.z();
+
+                VECTORIZE
+                for (std::size_t frame = 0; frame < count; ++frame)
+                {
+                    const double dx = direction_x[frame], dy = direction_y[frame], dz = direction_z[frame];
+
+                    //arbitrary vector is {1, 0, 0}, or {0, 1, 0} if the direction is {1, 0, 0} or {-1, 0, 0}
+                    const bool along_x = (std::abs(std::abs(dx) - 1) <= epsilon) & (std::abs(dy) <= epsilon) &
+                        (std::abs(dz) <= epsilon);
+                    const double ax = along_x ? 0 : 1;
+                    const double ay = along_x ? 1 : 0;
+
+                    //cross factor, direction x arbitrary vector, normalized
+                    double cx = -dz * ay;
+                    double cy = dz * ax;
+                    double cz = dx * ay - dy * ax;
+                    const double inverse_cross = 1 / std::sqrt(cx * cx + cy * cy + cz * cz);
+                    cx *= inverse_cross;
+                    cy *= inverse_cross;
+                    cz *= inverse_cross;
+
+                    //horizontal, direction x cross factor, normalized and scaled by tan(fov / 2)
+                    double hx = dy * cz - dz * cy;
+                    double hy = dz * cx - dx * cz;
+                    double hz = dx * cy - dy * cx;
+                    const double horizontal_scale = half_fov_tan / std::sqrt(hx * hx + hy * hy + hz * hz);
+                    hx *= horizontal_scale;
+                    hy *= horizontal_scale;
+                    hz *= horizontal_scale;
+
+                    //vertical, horizontal x direction, normalized and scaled by tan(fov / 2)
+                    double vx = hy * dz - hz * dy;
+                    double vy = hz * dx - hx * dz;
+                    double vz = hx * dy - hy * dx;
+                    const double vertical_scale = half_fov_tan / std::sqrt(vx * vx + vy * vy + vz * vz);
+                    vx *= vertical_scale;
+                    vy *= vertical_scale;
+                    vz *= vertical_scale;
+
+                    horizontal_x[frame] = hx;
+                    horizontal_y[frame] = hy;
+                    horizontal_z[frame] = hz;
+                    vertical_x[frame] = vx;
+                    vertical_y[frame] = vy;
+                    vertical_z[frame] = vz;
+                    top_left_x[frame] = position_x[frame] + dx - hx + vx;
+                    top_left_y[frame] = position_y[frame] + dy - hy + vy;
+                    top_left_z[frame] = position_z[frame] + dz - hz + vz;
+                }
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return position_.size(); }
+            NODISCARD unsigned int get_screen_width() const noexcept { return screen_width_; }
+            NODISCARD unsigned int get_screen_height() const noexcept { return screen_height_; }
+            NODISCARD unsigned int get_fov() const noexcept { return fov_; }
+            NODISCARD const dimension3_soa<point3d>& get_positions() const noexcept { return position_; }
+            NODISCARD const dimension3_soa<vector3d>& get_directions() const noexcept { return direction_; }
+            NODISCARD const dimension3_soa<point3d>& get_top_lefts() const noexcept { return top_left_; }
+            NODISCARD const dimension3_soa<vector3d>& get_half_horizontals() const noexcept { return half_horizontal_; }
+            NODISCARD const dimension3_soa<vector3d>& get_half_verticals() const noexcept { return half_vertical_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/vector3d.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief hemisphere around a normal, maps uniform samples in [0, 1)^2 to cosine weighted directions
+         *
+         * the tangent and bitangent are calculated once without branches, the batch functions map a whole array of
+         * samples, e.g. from sobol_sequence, halton_sequence or r2_sequence
+         * \note read more at: https://jcgt.org/published/0006/01/01/
+         */
+        class hemisphere
+        {
+        protected:
+            INLINE static constexpr std::size_t block_size = 64; // amount of samples taken from a sequence at a time
+
+            vector3d normal_; // normalized normal
+            vector3d tangent_, bitangent_; // orthonormal basis around the normal
+
+        public:
+            /**
+             * \brief constructor for hemisphere
+             * \throws zero_exception if the length of normal is zero
+             * \param normal normal of the hemisphere (it will be normalized for you)
+             */
+            explicit hemisphere(const vector3d& normal) : normal_(normal.normalize())
+            {
+                const double sign = std::copysign(1., normal_.z);
+                const double a = -1. / (sign + normal_.z);
+                const double b = normal_.x * normal_.y * a;
+
+                tangent_ = vector3d(1 + sign * normal_.x * normal_.x * a, sign * b, -sign * normal_.x);
+                bitangent_ = vector3d(b, sign + normal_.y * normal_.y * a, -normal_.y);
+            }
+
+            /**
+             * \brief maps a sample to a cosine weighted direction
+             * \param u first dimension of the sample, in the range [0, 1)
+             * \param v second dimension of the sample, in the range [0, 1)
+             * \return normalized direction in the hemisphere
+             */
+            NODISCARD vector3d cosine_sample(const double u, const double v) const noexcept
+            {
+                const double radius = std::sqrt(u);
+                const double angle = math::_2pi * v;
+                const double x = radius * std::cos(angle);
+                const double y = radius * std::sin(angle);
+                const double z = std::sqrt(1 - u);
+
+                return tangent_ * x + bitangent_ * y + normal_ * z;
+            }
+
+            /**
+             * \brief probability density of a cosine weighted direction
+             * \param direction normalized direction
+             * \return cos(theta) / pi, 0 below the hemisphere
+             */
+            NODISCARD double cosine_pdf(const vector3d& direction) const noexcept
+            {
+                const double cosine = direction.dot(normal_);
+                return cosine > 0 ? cosine / math::pi : 0;
+            }
+
+            /**
+             * \brief maps a batch of samples to cosine weighted directions
+             * \param u first dimension of every sample
+             * \param v second dimension of every sample
+             * \param count amount of samples
+             * \param x x of every direction, must have room for count values
+             * \param y y of every direction, must have room for count values
+             * \param z z of every direction, must have room for count values
+             */
+            void cosine_samples(const double* u, const double* v, const std::size_t count, double* x, double* y,
+                                double* z) const noexcept
+            {
+                const double tx = tangent_.x, ty = tangent_.y, tz = tangent_.z;
+                const double bx = bitangent_.x, by = bitangent_.y, bz = bitangent_.z;
+                const double nx = normal_.x, ny = normal_.y, nz = normal_.z;
+                const double two_pi = math::_2pi;
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double radius = std::sqrt(u[index]);
+                    const double angle = two_pi * v[index];
+                    const double local_x = radius * std::cos(angle);
+                    const double local_y = radius * std::sin(angle);
+                    const double local_z = std::sqrt(1 - u[index]);
+
+                    x[index] = tx * local_x + bx * local_y + nx * local_z;
+                    y[index] = ty * local_x + by * local_y + ny * local_z;
+                    z[index] = tz * local_x + bz * local_y + nz * local_z;
+                }
+            }
+
+            /**
+             * \brief maps samples of a low discrepancy sequence to cosine weighted directions
+             * \note the samples are taken a block at a time into a buffer on the stack, so nothing is allocated per
+             * sample, directions is only resized
+             * \tparam Sequence sobol_sequence, halton_sequence or r2_sequence
+             * \param sequence sequence to take the samples from
+             * \param first index of the first sample
+             * \param count amount of samples
+             * \param directions normalized direction of every sample, resized to count
+             */
+            template <typename Sequence>
+            void cosine_samples(const Sequence& sequence, const std::uint32_t first, const std::size_t count,
+                                dimension3_soa<vector3d>& directions) const
+            {
+                directions.resize(count);
+
+                double u[block_size], v[block_size];
+                for (std::size_t begin = 0; begin < count; begin += block_size)
+                {
+                    const std::size_t size = count - begin < block_size ? count - begin : block_size;
+
+                    sequence.samples(first + static_cast<std::uint32_t>(begin), size, u, v);
+                    cosine_samples(u, v, size, directions.x() + begin, directions.y() + begin,
+                                   directions.z() + begin);
+                }
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD const vector3d& get_normal() const noexcept { return normal_; }
+            NODISCARD const vector3d& get_tangent() const noexcept { return tangent_; }
+            NODISCARD const vector3d& get_bitangent() const noexcept { return bitangent_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
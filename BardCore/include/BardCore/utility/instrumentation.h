@@ -0,0 +1,269 @@
+// bardcore.h includes this header before bard_exception, which counts itself, so bardcore.h has to be complete first
+// the include guard comes after it, a #pragma once would skip the nested include when this header is included first
+#include "BardCore/bardcore.h"
+
+#ifndef BARDCORE_INSTRUMENTATION_H
+#define BARDCORE_INSTRUMENTATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#if defined(BARDCORE_INSTRUMENTATION)
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#endif
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief counters of the hot paths, e.g. how many rays a frame shot and how many intersection tests it ran
+         *
+         * define BARDCORE_INSTRUMENTATION (for the whole program) to enable it, without it the INSTRUMENT macros are
+         * empty and end_frame returns zeros, so there is no cost at all. when enabled every thread counts in its own
+         * thread_local counters, without atomics or locks, and end_frame adds the counters of every thread into a
+         * snapshot and resets them
+         * \note end_frame must be called when no other thread is counting, e.g. after the workers of a frame joined
+         * \note the counters are not touched during compile time evaluation, constexpr functions stay constexpr
+         */
+        class instrumentation
+        {
+        public:
+            /**
+             * \brief counted events
+             */
+            enum class counter : std::size_t
+            {
+                rays, // rays shot by the camera
+                normalizations, // vector3d::normalize calls
+                exceptions, // bardcore exceptions constructed
+                intersection_tests, // ray and primitive tests
+                box_tests, // box tests, e.g. frustum culling
+                count // amount of counters
+            };
+
+            /**
+             * \brief amount of counters
+             */
+            INLINE static constexpr std::size_t counter_count = static_cast<std::size_t>(counter::count);
+
+#if defined(BARDCORE_INSTRUMENTATION)
+            /**
+             * \brief true if BARDCORE_INSTRUMENTATION is defined
+             */
+            INLINE static constexpr bool enabled = true;
+#else
+            /**
+             * \brief true if BARDCORE_INSTRUMENTATION is defined
+             */
+            INLINE static constexpr bool enabled = false;
+#endif
+
+            /**
+             * \brief counters of one frame, added over every thread
+             */
+            struct snapshot
+            {
+                std::uint64_t frame = 0; // index of the frame, starts at 0
+                double time = 0; // end of the frame in microseconds since the first counter was used
+                std::uint64_t values[counter_count] = {}; // value per counter
+
+                /**
+                 * \brief gets the value of a counter
+                 * \param counted counter
+                 * \return value of the counter in this frame
+                 */
+                NODISCARD std::uint64_t get(const counter counted) const noexcept
+                {
+                    return values[static_cast<std::size_t>(counted)];
+                }
+            };
+
+            /**
+             * \brief gets the name of a counter, e.g. "intersection_tests"
+             * \param counted counter
+             * \return name of the counter
+             */
+            NODISCARD static const char* name(const counter counted) noexcept
+            {
+                static const char* const names[counter_count] = {
+                    "rays", "normalizations", "exceptions", "intersection_tests", "box_tests"
+                };
+                return names[static_cast<std::size_t>(counted)];
+            }
+
+            /**
+             * \brief adds to a counter of the calling thread, use the INSTRUMENT macros instead so it compiles away
+             * \param counted counter
+             * \param amount amount to add
+             */
+            static void add(const counter counted, const std::uint64_t amount) noexcept
+            {
+#if defined(BARDCORE_INSTRUMENTATION)
+                local().values[static_cast<std::size_t>(counted)] += amount;
+#else
+                static_cast<void>(counted);
+                static_cast<void>(amount);
+#endif
+            }
+
+            /**
+             * \brief gets a counter of the calling thread since the last end_frame, e.g. to measure the cost of one call
+             * \param counted counter
+             * \return value of the counter in the calling thread, zero if instrumentation is disabled
+             */
+            NODISCARD static std::uint64_t thread_value(const counter counted) noexcept
+            {
+#if defined(BARDCORE_INSTRUMENTATION)
+                return local().values[static_cast<std::size_t>(counted)];
+#else
+                static_cast<void>(counted);
+                return 0;
+#endif
+            }
+
+            /**
+             * \brief ends a frame, adds the counters of every thread (also of threads that ended) and resets them
+             * \note no other thread may count while this runs
+             * \return counters of the frame, zeros if instrumentation is disabled
+             */
+            static snapshot end_frame()
+            {
+                snapshot result;
+#if defined(BARDCORE_INSTRUMENTATION)
+                registry& threads = get_registry();
+                const std::lock_guard<std::mutex> lock(threads.mutex);
+
+                for (std::size_t index = 0; index < counter_count; ++index)
+                {
+                    result.values[index] = threads.retired[index];
+                    threads.retired[index] = 0;
+                }
+                for (thread_counters* counters : threads.counters)
+                    for (std::size_t index = 0; index < counter_count; ++index)
+                    {
+                        result.values[index] += counters->values[index];
+                        counters->values[index] = 0;
+                    }
+
+                result.frame = threads.frame++;
+                const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - threads.start;
+                result.time = std::chrono::duration<double, std::micro>(elapsed).count();
+#endif
+                return result;
+            }
+
+            /**
+             * \brief writes a snapshot as a json object, e.g. {"frame": 0, "time": 16.6, "rays": 1024, ...}
+             * \param stream stream to write to
+             * \param frame snapshot to write
+             */
+            static void write_json(std::ostream& stream, const snapshot& frame)
+            {
+                stream << "{\"frame\": " << frame.frame << ", \"time\": " << frame.time;
+                for (std::size_t index = 0; index < counter_count; ++index)
+                    stream << ", \"" << name(static_cast<counter>(index)) << "\": " << frame.values[index];
+                stream << "}";
+            }
+
+            /**
+             * \brief writes snapshots in the chrome trace event format, open it in chrome://tracing or perfetto
+             * \note every snapshot is a counter event ("ph": "C") at its time, with one series per counter
+             * \param stream stream to write to
+             * \param frames snapshots to write, in order
+             */
+            static void write_trace(std::ostream& stream, const std::vector<snapshot>& frames)
+            {
+                stream << "{\"traceEvents\": [";
+                for (std::size_t frame = 0; frame < frames.size(); ++frame)
+                {
+                    stream << (frame == 0 ? "\n" : ",\n") << "{\"name\": \"bardcore\", \"ph\": \"C\", \"pid\": 0, "
+                        "\"tid\": 0, \"ts\": " << frames[frame].time << ", \"args\": ";
+                    write_json(stream, frames[frame]);
+                    stream << "}";
+                }
+                stream << "\n], \"displayTimeUnit\": \"ms\"}\n";
+            }
+
+#if defined(BARDCORE_INSTRUMENTATION)
+        protected:
+            /**
+             * \brief counters of one thread, registered while the thread lives
+             */
+            struct thread_counters
+            {
+                std::uint64_t values[counter_count] = {}; // counted since the last end_frame
+
+                thread_counters()
+                {
+                    registry& threads = get_registry();
+                    const std::lock_guard<std::mutex> lock(threads.mutex);
+                    threads.counters.push_back(this);
+                }
+
+                /**
+                 * \brief keeps the counts of an ended thread for the next end_frame
+                 */
+                ~thread_counters()
+                {
+                    registry& threads = get_registry();
+                    const std::lock_guard<std::mutex> lock(threads.mutex);
+                    for (std::size_t index = 0; index < counter_count; ++index)
+                        threads.retired[index] += values[index];
+                    threads.counters.erase(std::find(threads.counters.begin(), threads.counters.end(), this));
+                }
+
+                thread_counters(const thread_counters&) = delete;
+                thread_counters& operator=(const thread_counters&) = delete;
+            };
+
+            /**
+             * \brief counters of every living thread
+             */
+            struct registry
+            {
+                std::mutex mutex; // guards everything below, only locked when a thread starts, ends or by end_frame
+                std::vector<thread_counters*> counters; // counters of the living threads
+                std::uint64_t retired[counter_count] = {}; // counts of threads that ended since the last end_frame
+                std::uint64_t frame = 0; // index of the next frame
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now(); // time of first use
+            };
+
+            /**
+             * \brief gets the registry, created on first use
+             */
+            static registry& get_registry()
+            {
+                static registry threads;
+                return threads;
+            }
+
+            /**
+             * \brief gets the counters of the calling thread, created on first use
+             */
+            static thread_counters& local()
+            {
+                static thread_local thread_counters counters;
+                return counters;
+            }
+#endif
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
+
+// Hot path counters, e.g. INSTRUMENT(rays) or INSTRUMENT_ADD(intersection_tests, rays * spheres)
+// empty without BARDCORE_INSTRUMENTATION, and skipped during compile time evaluation so they fit in constexpr functions
+#if defined(BARDCORE_INSTRUMENTATION)
+    #define INSTRUMENT_ADD(COUNTER, AMOUNT) (IS_CONSTANT_EVALUATED() ? static_cast<void>(0) : \
+        ::bardcore::utility::instrumentation::add(::bardcore::utility::instrumentation::counter::COUNTER, \
+                                                   static_cast<std::uint64_t>(AMOUNT)))
+#else
+    #define INSTRUMENT_ADD(COUNTER, AMOUNT) static_cast<void>(0)
+#endif
+#define INSTRUMENT(COUNTER) INSTRUMENT_ADD(COUNTER, 1)
+
+#endif // BARDCORE_INSTRUMENTATION_H
@@ -0,0 +1,402 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/light_set.h"
+#include "BardCore/utility/parallel.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief clustered light culling, splits the view of a camera in froxels and stores the lights of each one
+         *
+         * the screen is split in tiles_x * tiles_y tiles, the depth between near and far in exponential slices.
+         * every light gets an effective radius, beyond it intensity / distance^2 is below the cutoff, and is added to
+         * every cluster its sphere may touch. a shading point then only iterates over the lights of its cluster
+         * \note lights are only assigned to clusters inside the view, points outside the view have no cluster
+         */
+        class light_clusters
+        {
+        protected:
+            unsigned int tiles_x_, tiles_y_, slices_; // amount of clusters per axis
+            double near_, far_; // depth range of the clusters
+            double cutoff_; // intensity below which a light is ignored
+            unsigned int threads_; // threads for build, 0 means parallel::hardware_threads()
+
+            // view of the camera of the last build
+            point3d position_{};
+            vector3d forward_{}, right_{}, up_{};
+            double tan_half_fov_ = 1;
+            unsigned int screen_width_ = 1, screen_height_ = 1;
+
+            std::vector<std::int32_t> min_x_{}, max_x_{}, min_y_{}, max_y_{}, min_z_{}, max_z_{}; // light ranges
+            std::vector<std::size_t> histograms_{}; // cluster counts per chunk
+            std::vector<std::size_t> offsets_{}; // lights of cluster c are indices_[offsets_[c], offsets_[c + 1])
+            std::vector<std::uint32_t> indices_{}; // light indices, sorted by cluster
+
+        public:
+            /**
+             * \brief cluster of a point outside the view
+             */
+            INLINE static constexpr std::size_t no_cluster = std::numeric_limits<std::size_t>::max();
+
+            /**
+             * \brief constructor for light_clusters
+             * \throws zero_exception if tiles_x, tiles_y, slices, near_plane or cutoff is zero or smaller
+             * \throws out_of_range_exception if far_plane is not greater than near_plane
+             * \param tiles_x amount of tiles from left to right
+             * \param tiles_y amount of tiles from top to bottom
+             * \param slices amount of depth slices
+             * \param near_plane depth of the first slice
+             * \param far_plane depth of the end of the last slice
+             * \param cutoff intensity below which a light doesn't affect a point
+             * \param threads threads for build, 0 means parallel::hardware_threads()
+             */
+            explicit light_clusters(const unsigned int tiles_x = 16, const unsigned int tiles_y = 9,
+                                    const unsigned int slices = 24, const double near_plane = 0.1,
+                                    const double far_plane = 1000, const double cutoff = 0.01,
+                                    const unsigned int threads = 0) :
+                tiles_x_(tiles_x), tiles_y_(tiles_y), slices_(slices), near_(near_plane), far_(far_plane),
+                cutoff_(cutoff), threads_(threads)
+            {
+                if (tiles_x == 0 || tiles_y == 0 || slices == 0)
+                    throw exception::zero_exception("tiles and slices must be greater than 0");
+                if (near_plane <= 0)
+                    throw exception::zero_exception("near plane must be greater than 0");
+                if (far_plane <= near_plane)
+                    throw exception::out_of_range_exception("far plane must be greater than near plane");
+                if (cutoff <= 0)
+                    throw exception::zero_exception("cutoff must be greater than 0");
+
+                offsets_.assign(cluster_count() + 1, 0);
+            }
+
+            /**
+             * \brief calculates the distance at which the intensity of a light drops below cutoff
+             * \param intensity intensity of the light
+             * \param cutoff intensity below which a light is ignored
+             * \return effective radius, sqrt(intensity / cutoff)
+             */
+            NODISCARD static double effective_radius(const double intensity, const double cutoff) noexcept
+            {
+                return std::sqrt((intensity > 0 ? intensity : 0) / cutoff);
+            }
+
+            /**
+             * \brief assigns every light to the clusters its effective sphere may touch
+             * \note the clusters follow the view of camera until the next build
+             * \param camera camera to build the clusters for
+             * \param lights lights to assign
+             */
+            void build(const camera& camera, const light_set& lights)
+            {
+                position_ = camera.get_position();
+                forward_ = camera.get_direction();
+                tan_half_fov_ = camera.get_half_horizontal().length();
+                right_ = camera.get_half_horizontal() / tan_half_fov_;
+                up_ = camera.get_half_vertical() / tan_half_fov_;
+                screen_width_ = camera.get_screen_width();
+                screen_height_ = camera.get_screen_height();
+
+                const std::size_t count = lights.size();
+                const std::size_t clusters = cluster_count();
+                const unsigned int chunks = parallel::thread_count(count, threads_);
+
+                min_x_.resize(count);
+                max_x_.resize(count);
+                min_y_.resize(count);
+                max_y_.resize(count);
+                min_z_.resize(count);
+                max_z_.resize(count);
+                histograms_.assign(static_cast<std::size_t>(chunks) * clusters, 0);
+
+                //find the cluster range of every light and count the clusters of every chunk
+                parallel::for_each_chunk(count, chunks,
+                                         [this, &lights, clusters](const unsigned int chunk, const std::size_t begin,
+                                                                   const std::size_t end)
+                                         {
+                                             compute_ranges(lights, begin, end);
+
+                                             std::size_t* histogram = histograms_.data() + chunk * clusters;
+                                             for (std::size_t light = begin; light < end; ++light)
+                                             {
+                                                 for_each_cluster(light, [histogram](const std::size_t cluster)
+                                                 {
+                                                     ++histogram[cluster];
+                                                 });
+                                             }
+                                         });
+
+                //exclusive prefix sum, cluster major and chunk minor so the lights of a cluster stay sorted
+                std::size_t offset = 0;
+                for (std::size_t cluster = 0; cluster < clusters; ++cluster)
+                {
+                    offsets_[cluster] = offset;
+                    for (unsigned int chunk = 0; chunk < chunks; ++chunk)
+                    {
+                        std::size_t& counter = histograms_[chunk * clusters + cluster];
+                        const std::size_t amount = counter;
+                        counter = offset;
+                        offset += amount;
+                    }
+                }
+                offsets_[clusters] = offset;
+                indices_.resize(offset);
+
+                //scatter every chunk to its own offsets
+                parallel::for_each_chunk(count, chunks,
+                                         [this, clusters](const unsigned int chunk, const std::size_t begin,
+                                                          const std::size_t end)
+                                         {
+                                             std::size_t* write = histograms_.data() + chunk * clusters;
+                                             for (std::size_t light = begin; light < end; ++light)
+                                             {
+                                                 for_each_cluster(light, [this, write, light](const std::size_t cluster)
+                                                 {
+                                                     indices_[write[cluster]++] = static_cast<std::uint32_t>(light);
+                                                 });
+                                             }
+                                         });
+            }
+
+            /**
+             * \brief gets the index of a cluster
+             * \param tile_x tile from left to right
+             * \param tile_y tile from top to bottom
+             * \param slice depth slice
+             * \return index of the cluster
+             */
+            NODISCARD std::size_t cluster_index(const unsigned int tile_x, const unsigned int tile_y,
+                                                const unsigned int slice) const noexcept
+            {
+                return (static_cast<std::size_t>(slice) * tiles_y_ + tile_y) * tiles_x_ + tile_x;
+            }
+
+            /**
+             * \brief gets the cluster of a point
+             * \param point point in the world
+             * \return index of the cluster, no_cluster if the point is outside the view
+             */
+            NODISCARD std::size_t cluster_of(const point3d& point) const noexcept
+            {
+                const vector3d offset = position_.get_vector(point);
+                const double depth = offset.dot(forward_);
+                if (depth < near_ || depth > far_)
+                    return no_cluster;
+
+                const double u = offset.dot(right_) / (depth * tan_half_fov_);
+                const double v = offset.dot(up_) / (depth * tan_half_fov_);
+                if (u < -1 || u > 1 || v < -1 || v > 1)
+                    return no_cluster;
+
+                return cluster_index(static_cast<unsigned int>(tile((u + 1) / 2 * tiles_x_, tiles_x_)),
+                                     static_cast<unsigned int>(tile((1 - v) / 2 * tiles_y_, tiles_y_)),
+                                     static_cast<unsigned int>(tile(slice(depth), slices_)));
+            }
+
+            /**
+             * \brief gets the cluster of a pixel at a view space depth, e.g. of the closest hit of camera::shoot_ray
+             * \note depth is the hit projected on the camera axis, not the distance along the ray. the slices are
+             * perpendicular to the camera direction, so the ray distance puts off centre pixels in a too far slice,
+             * project the hit instead: camera.get_position().get_vector(hit).dot(camera.get_direction())
+             * \param x x position on the screen
+             * \param y y position on the screen
+             * \param depth view space depth, (hit - camera position) . camera direction
+             * \return index of the cluster, no_cluster if depth is outside the slices or the pixel is off screen
+             */
+            NODISCARD std::size_t cluster_of(const unsigned int x, const unsigned int y, const double depth) const
+                noexcept
+            {
+                if (depth < near_ || depth > far_ || x >= screen_width_ || y >= screen_height_)
+                    return no_cluster;
+
+                return cluster_index(static_cast<unsigned int>(static_cast<std::size_t>(x) * tiles_x_ / screen_width_),
+                                     static_cast<unsigned int>(static_cast<std::size_t>(y) * tiles_y_ / screen_height_),
+                                     static_cast<unsigned int>(tile(slice(depth), slices_)));
+            }
+
+            /**
+             * \brief gets the amount of lights in a cluster
+             * \param cluster index of the cluster
+             * \return amount of lights
+             */
+            NODISCARD std::size_t light_count(const std::size_t cluster) const noexcept
+            {
+                return offsets_[cluster + 1] - offsets_[cluster];
+            }
+
+            /**
+             * \brief gets the lights of a cluster, light_count(cluster) indices in ascending order
+             * \param cluster index of the cluster
+             * \return pointer to the first light index
+             */
+            NODISCARD const std::uint32_t* lights(const std::size_t cluster) const noexcept
+            {
+                return indices_.data() + offsets_[cluster];
+            }
+
+            /**
+             * \brief calls function for every light that may affect point
+             * \param point point in the world
+             * \param function function to call, void(std::uint32_t light_index)
+             */
+            template <typename Function>
+            void for_each_light(const point3d& point, Function function) const
+            {
+                const std::size_t cluster = cluster_of(point);
+                if (cluster == no_cluster)
+                    return;
+
+                for (std::size_t index = offsets_[cluster]; index < offsets_[cluster + 1]; ++index)
+                    function(indices_[index]);
+            }
+
+        protected:
+            /**
+             * \brief calculates the continuous slice of a depth, slices grow exponentially from near to far
+             * \param depth depth between near and far
+             * \return slice, not clamped
+             */
+            NODISCARD double slice(const double depth) const noexcept
+            {
+                return std::log(depth / near_) * (slices_ / std::log(far_ / near_));
+            }
+
+            /**
+             * \brief clamps a continuous tile coordinate to [0, count - 1] and rounds it down
+             * \param value continuous coordinate
+             * \param count amount of tiles
+             * \return tile
+             */
+            NODISCARD static std::int32_t tile(const double value, const unsigned int count) noexcept
+            {
+                const double largest = static_cast<double>(count - 1);
+                const double clamped = value > 0 ? value : 0;
+                return static_cast<std::int32_t>(clamped < largest ? clamped : largest);
+            }
+
+            /**
+             * \brief calculates the cluster range of every light in [begin, end), empty if the light is not in view
+             * \note the range bounds the projection of the box around the sphere in view space, so it is conservative
+             * \param lights lights to calculate the range of
+             * \param begin first light
+             * \param end one past the last light
+             */
+            void compute_ranges(const light_set& lights, const std::size_t begin, const std::size_t end) noexcept
+            {
+                const double* light_x = lights.get_positions().x();
+                const double* light_y = lights.get_positions().y();
+                const double* light_z = lights.get_positions().z();
+                const double* intensity = lights.get_intensities().data();
+
+                const double px = position_.x, py = position_.y, pz = position_.z;
+                const double fx = forward_.x, fy = forward_.y, fz = forward_.z;
+                const double rx = right_.x, ry = right_.y, rz = right_.z;
+                const double ux = up_.x, uy = up_.y, uz = up_.z;
+                const double near_plane = near_, far_plane = far_, cutoff = cutoff_;
+                const double inverse_tan = 1 / tan_half_fov_;
+                const double slice_scale = slices_ / std::log(far_plane / near_plane);
+                const double tiles_x = tiles_x_, tiles_y = tiles_y_;
+                const unsigned int count_x = tiles_x_, count_y = tiles_y_, count_z = slices_;
+
+                VECTORIZE
+                for (std::size_t light = begin; light < end; ++light)
+                {
+                    const double vx = light_x[light] - px;
+                    const double vy = light_y[light] - py;
+                    const double vz = light_z[light] - pz;
+                    const double depth = vx * fx + vy * fy + vz * fz;
+                    const double x = vx * rx + vy * ry + vz * rz;
+                    const double y = vx * ux + vy * uy + vz * uz;
+                    const double radius = effective_radius(intensity[light], cutoff);
+
+                    //depth range of the sphere within near and far
+                    const double closest = depth - radius > near_plane ? depth - radius : near_plane;
+                    const double furthest_depth = depth + radius < far_plane ? depth + radius : far_plane;
+                    const double furthest = furthest_depth > closest ? furthest_depth : closest;
+
+                    //x / depth is smallest for the closest depth if x is negative, otherwise for the furthest
+                    const double left = (x - radius) / (x - radius < 0 ? closest : furthest) * inverse_tan;
+                    const double right = (x + radius) / (x + radius > 0 ? closest : furthest) * inverse_tan;
+                    const double bottom = (y - radius) / (y - radius < 0 ? closest : furthest) * inverse_tan;
+                    const double top = (y + radius) / (y + radius > 0 ? closest : furthest) * inverse_tan;
+
+                    const bool visible = (depth + radius >= near_plane) & (depth - radius <= far_plane) &
+                        (right >= -1) & (left <= 1) & (top >= -1) & (bottom <= 1);
+
+                    //an empty range (min > max) for lights that are not in view
+                    min_x_[light] = visible ? tile((left + 1) / 2 * tiles_x, count_x) : 1;
+                    max_x_[light] = visible ? tile((right + 1) / 2 * tiles_x, count_x) : 0;
+                    min_y_[light] = tile((1 - top) / 2 * tiles_y, count_y);
+                    max_y_[light] = tile((1 - bottom) / 2 * tiles_y, count_y);
+                    min_z_[light] = visible ? tile(std::log(closest / near_plane) * slice_scale, count_z) : 1;
+                    max_z_[light] = visible ? tile(std::log(furthest / near_plane) * slice_scale, count_z) : 0;
+                }
+            }
+
+            /**
+             * \brief calls function for every cluster in the range of a light
+             * \param light index of the light
+             * \param function function to call, void(std::size_t cluster)
+             */
+            template <typename Function>
+            void for_each_cluster(const std::size_t light, Function function) const
+            {
+                for (std::int32_t z = min_z_[light]; z <= max_z_[light]; ++z)
+                {
+                    for (std::int32_t y = min_y_[light]; y <= max_y_[light]; ++y)
+                    {
+                        for (std::int32_t x = min_x_[light]; x <= max_x_[light]; ++x)
+                            function(cluster_index(static_cast<unsigned int>(x), static_cast<unsigned int>(y),
+                                                   static_cast<unsigned int>(z)));
+                    }
+                }
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t cluster_count() const noexcept
+            {
+                return static_cast<std::size_t>(tiles_x_) * tiles_y_ * slices_;
+            }
+
+            NODISCARD unsigned int get_tiles_x() const noexcept { return tiles_x_; }
+            NODISCARD unsigned int get_tiles_y() const noexcept { return tiles_y_; }
+            NODISCARD unsigned int get_slices() const noexcept { return slices_; }
+            NODISCARD double get_near() const noexcept { return near_; }
+            NODISCARD double get_far() const noexcept { return far_; }
+            NODISCARD double get_cutoff() const noexcept { return cutoff_; }
+            NODISCARD unsigned int get_threads() const noexcept { return threads_; }
+
+            /**
+             * \brief gets the light indices of all clusters, see get_offsets
+             * \return light indices sorted by cluster
+             */
+            NODISCARD const std::vector<std::uint32_t>& get_indices() const noexcept { return indices_; }
+
+            /**
+             * \brief gets the offsets of all clusters, the lights of cluster c are in [offsets[c], offsets[c + 1])
+             * \return cluster_count() + 1 offsets
+             */
+            NODISCARD const std::vector<std::size_t>& get_offsets() const noexcept { return offsets_; }
+
+            /**
+             * \brief sets the amount of threads for build
+             * \param threads new amount of threads, 0 means parallel::hardware_threads()
+             */
+            void set_threads(const unsigned int threads) noexcept { threads_ = threads; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <vector>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/utility/light.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief set of lights in structure of arrays layout, evaluates many lights or many points in one call
+         * \note unlike light::inverse_square_law, a point on top of a light doesn't throw, it gets 0 from that light
+         */
+        class light_set
+        {
+        protected:
+            dimension3_soa<point3d> position_{}; // position of every light
+            std::vector<double> intensity_{}; // intensity of every light
+
+        public:
+            light_set() = default;
+
+            /**
+             * \brief constructor for light_set
+             * \param lights lights to add
+             */
+            explicit light_set(const std::vector<light>& lights)
+            {
+                reserve(lights.size());
+                for (const light& light : lights)
+                    add(light);
+            }
+
+            /**
+             * \brief adds a light
+             * \param light light to add
+             * \return index of the light
+             */
+            std::size_t add(const light& light)
+            {
+                position_.push_back(light.position);
+                intensity_.push_back(light.intensity);
+                return intensity_.size() - 1;
+            }
+
+            /**
+             * \brief reserves memory for lights
+             * \param count amount of lights to reserve
+             */
+            void reserve(const std::size_t count)
+            {
+                position_.reserve(count);
+                intensity_.reserve(count);
+            }
+
+            /**
+             * \brief inverse square law of every light at one point
+             * \note read more at: https://en.wikipedia.org/wiki/Inverse-square_law
+             * \param point point to calculate
+             * \param result intensity of every light at point, must have room for size() values
+             */
+            void inverse_square_law(const point3d& point, double* result) const noexcept
+            {
+                const std::size_t count = intensity_.size();
+                const double* x = position_.x();
+                const double* y = position_.y();
+                const double* z = position_.z();
+                const double* intensity = intensity_.data();
+                const double point_x = point.x, point_y = point.y, point_z = point.z;
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double dx = x[index] - point_x;
+                    const double dy = y[index] - point_y;
+                    const double dz = z[index] - point_z;
+                    result[index] = falloff(intensity[index], dx * dx + dy * dy + dz * dz);
+                }
+            }
+
+            /**
+             * \brief inverse square law of every light at one point, result is resized to size()
+             * \param point point to calculate
+             * \param result intensity of every light at point
+             */
+            void inverse_square_law(const point3d& point, std::vector<double>& result) const
+            {
+                result.resize(intensity_.size());
+                inverse_square_law(point, result.data());
+            }
+
+            /**
+             * \brief inverse square law of one light at every point
+             * \param light_index index of the light
+             * \param points points to calculate
+             * \param result intensity of the light at every point, must have room for points.size() values
+             */
+            void inverse_square_law(const std::size_t light_index, const dimension3_soa<point3d>& points,
+                                    double* result) const noexcept
+            {
+                const std::size_t count = points.size();
+                const double* x = points.x();
+                const double* y = points.y();
+                const double* z = points.z();
+                const double light_x = position_.x()[light_index];
+                const double light_y = position_.y()[light_index];
+                const double light_z = position_.z()[light_index];
+                const double intensity = intensity_[light_index];
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double dx = light_x - x[index];
+                    const double dy = light_y - y[index];
+                    const double dz = light_z - z[index];
+                    result[index] = falloff(intensity, dx * dx + dy * dy + dz * dz);
+                }
+            }
+
+            /**
+             * \brief inverse square law of one light at every point, result is resized to the size of points
+             * \param light_index index of the light
+             * \param points points to calculate
+             * \param result intensity of the light at every point
+             */
+            void inverse_square_law(const std::size_t light_index, const dimension3_soa<point3d>& points,
+                                    std::vector<double>& result) const
+            {
+                result.resize(points.size());
+                inverse_square_law(light_index, points, result.data());
+            }
+
+            /**
+             * \brief sum of the inverse square law of every light at one point
+             * \param point point to calculate
+             * \return total intensity at point
+             */
+            NODISCARD double total_intensity(const point3d& point) const noexcept
+            {
+                const std::size_t count = intensity_.size();
+                const double* x = position_.x();
+                const double* y = position_.y();
+                const double* z = position_.z();
+                const double* intensity = intensity_.data();
+                const double point_x = point.x, point_y = point.y, point_z = point.z;
+
+                double sum = 0;
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double dx = x[index] - point_x;
+                    const double dy = y[index] - point_y;
+                    const double dz = z[index] - point_z;
+                    sum += falloff(intensity[index], dx * dx + dy * dy + dz * dz);
+                }
+
+                return sum;
+            }
+
+            /**
+             * \brief intensity / length_squared, 0 if length_squared is zero
+             * \note written as a select so the loops that call it stay branch free and vectorize, other batch loops
+             * (e.g. wavefront) use it too so every path has the same falloff
+             * \param intensity intensity of the light
+             * \param length_squared length squared between the light and the point
+             * \return intensity across distance
+             */
+            NODISCARD static double falloff(const double intensity, const double length_squared) noexcept
+            {
+                const bool valid = length_squared > 0;
+                return valid ? intensity / length_squared : 0;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return intensity_.size(); }
+            NODISCARD bool empty() const noexcept { return intensity_.empty(); }
+            NODISCARD light get(const std::size_t index) const { return {position_.get(index), intensity_[index]}; }
+            NODISCARD const dimension3_soa<point3d>& get_positions() const noexcept { return position_; }
+            NODISCARD const std::vector<double>& get_intensities() const noexcept { return intensity_; }
+
+            /**
+             * \brief sets a light
+             * \param index index of the light
+             * \param light new light
+             */
+            void set(const std::size_t index, const light& light)
+            {
+                position_.set(index, light.position);
+                intensity_[index] = light.intensity;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
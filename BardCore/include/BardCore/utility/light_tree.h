@@ -0,0 +1,298 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/utility/alias_table.h"
+#include "BardCore/utility/light.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief many light sampler, picks one light per shading point instead of evaluating every light
+         *
+         * lights are stored in a bvh, every node bounds the positions of its lights and sums their intensity.
+         * sampling walks down the tree and picks a child by its estimated contribution (intensity / distance^2),
+         * so one sample costs O(log lights). sample_power() ignores the shading point and picks a light by its
+         * intensity with an alias table in O(1)
+         * \note divide the contribution of the sampled light by its pdf to keep the estimate unbiased
+         */
+        class light_tree
+        {
+        protected:
+            /**
+             * \brief node of the bvh, a leaf holds exactly one light
+             */
+            struct node
+            {
+                point3d min; // minimum corner of the bounds
+                point3d max; // maximum corner of the bounds
+                double power; // sum of the intensities
+                std::uint32_t parent; // index of the parent, the root is its own parent
+                std::uint32_t right; // index of the right child, the left child is the next node, 0 for a leaf
+                std::uint32_t light; // index of the light, only for a leaf
+            };
+
+            std::vector<light> lights_; // lights in the tree
+            std::vector<node> nodes_{}; // nodes in depth first order, nodes_[0] is the root
+            std::vector<std::uint32_t> leaves_{}; // node of every light
+            alias_table power_; // lights by intensity
+
+        public:
+            /**
+             * \brief constructor for light_tree, builds the tree
+             * \throws negative_exception if an intensity is negative
+             * \throws zero_exception if lights is empty or the sum of the intensities is zero
+             * \param lights lights to sample
+             */
+            explicit light_tree(std::vector<light> lights) : lights_(std::move(lights)),
+                                                             power_(intensities(lights_))
+            {
+                std::vector<std::uint32_t> order(lights_.size());
+                for (std::size_t index = 0; index < order.size(); ++index)
+                    order[index] = static_cast<std::uint32_t>(index);
+
+                nodes_.reserve(2 * lights_.size() - 1);
+                leaves_.resize(lights_.size());
+                build(order.data(), order.data() + order.size(), 0);
+            }
+
+            /**
+             * \brief samples a light for a shading point by its estimated contribution
+             * \param point shading point
+             * \param random uniform random number in [0, 1)
+             * \param pdf probability of the sampled light
+             * \return index of the sampled light
+             */
+            std::uint32_t sample(const point3d& point, double random, double& pdf) const noexcept
+            {
+                //the random number is rescaled at every node, so one number is enough for the whole walk
+                random = random < one_below ? random : one_below;
+                pdf = 1;
+
+                std::uint32_t index = 0;
+                while (nodes_[index].right != 0)
+                {
+                    const double left = left_probability(index, point);
+                    if (random < left)
+                    {
+                        random /= left;
+                        pdf *= left;
+                        ++index;
+                    }
+                    else
+                    {
+                        random = (random - left) / (1 - left);
+                        pdf *= 1 - left;
+                        index = nodes_[index].right;
+                    }
+
+                    random = random < one_below ? random : one_below;
+                }
+
+                return nodes_[index].light;
+            }
+
+            /**
+             * \brief samples a light for every shading point in [begin, end)
+             * \note light_index and pdf must already have the size of points
+             * \param points shading points
+             * \param random uniform random number in [0, 1) of every point
+             * \param begin first point
+             * \param end one past the last point
+             * \param light_index index of the sampled light of every point
+             * \param pdf probability of the sampled light of every point
+             */
+            void sample(const dimension3_soa<point3d>& points, const double* random, const std::size_t begin,
+                        const std::size_t end, std::uint32_t* light_index, double* pdf) const noexcept
+            {
+                for (std::size_t index = begin; index < end; ++index)
+                    light_index[index] = sample(points.get(index), random[index], pdf[index]);
+            }
+
+            /**
+             * \brief samples a light for every shading point, light_index and pdf are resized to the size of points
+             * \param points shading points
+             * \param random uniform random number in [0, 1) of every point
+             * \param light_index index of the sampled light of every point
+             * \param pdf probability of the sampled light of every point
+             */
+            void sample(const dimension3_soa<point3d>& points, const std::vector<double>& random,
+                        std::vector<std::uint32_t>& light_index, std::vector<double>& pdf) const
+            {
+                light_index.resize(points.size());
+                pdf.resize(points.size());
+                sample(points, random.data(), 0, points.size(), light_index.data(), pdf.data());
+            }
+
+            /**
+             * \brief gets the probability that sample() picks a light for a shading point
+             * \param point shading point
+             * \param light_index index of the light
+             * \return probability of the light
+             */
+            NODISCARD double pdf(const point3d& point, const std::size_t light_index) const noexcept
+            {
+                double probability = 1;
+                std::uint32_t index = leaves_[light_index];
+                while (index != 0)
+                {
+                    const std::uint32_t parent = nodes_[index].parent;
+                    const double left = left_probability(parent, point);
+                    probability *= index == parent + 1 ? left : 1 - left;
+                    index = parent;
+                }
+
+                return probability;
+            }
+
+            /**
+             * \brief samples a light by its intensity, independent of the shading point
+             * \param random uniform random number in [0, 1)
+             * \return index of the sampled light
+             */
+            NODISCARD std::uint32_t sample_power(const double random) const noexcept { return power_.sample(random); }
+
+            /**
+             * \brief samples a light by its intensity for every random number
+             * \param random uniform random numbers in [0, 1)
+             * \param light_index index of the sampled light of every random number
+             */
+            void sample_power(const std::vector<double>& random, std::vector<std::uint32_t>& light_index) const
+            {
+                power_.sample(random, light_index);
+            }
+
+            /**
+             * \brief gets the probability that sample_power() picks a light
+             * \param light_index index of the light
+             * \return intensity of the light / sum of all intensities
+             */
+            NODISCARD double pdf_power(const std::size_t light_index) const noexcept { return power_.pdf(light_index); }
+
+        protected:
+            /**
+             * \brief largest double below 1, random numbers are clamped to it
+             */
+            INLINE static constexpr double one_below = 1 - std::numeric_limits<double>::epsilon() / 2;
+
+            /**
+             * \brief collects the intensity of every light
+             * \param lights lights to collect
+             * \return intensity of every light
+             */
+            static std::vector<double> intensities(const std::vector<light>& lights)
+            {
+                std::vector<double> result;
+                result.reserve(lights.size());
+                for (const light& light : lights)
+                    result.push_back(light.intensity);
+
+                return result;
+            }
+
+            /**
+             * \brief estimates the contribution of a node to a point, intensity / distance^2
+             * \note the distance is clamped to the size of the node, inside a node every light could be close
+             * \param index index of the node
+             * \param point shading point
+             * \return estimated contribution
+             */
+            NODISCARD double importance(const std::uint32_t index, const point3d& point) const noexcept
+            {
+                const node& bounds = nodes_[index];
+                const double distance_squared = bounds.min.center(bounds.max).distance_squared(point);
+                const double radius_squared = bounds.min.distance_squared(bounds.max) / 4;
+                const double minimum = radius_squared > math::epsilon ? radius_squared : math::epsilon;
+
+                return bounds.power / (distance_squared > minimum ? distance_squared : minimum);
+            }
+
+            /**
+             * \brief gets the probability of going to the left child of a node
+             * \param index index of an inner node
+             * \param point shading point
+             * \return probability of the left child, 0.5 if neither child contributes anything
+             */
+            NODISCARD double left_probability(const std::uint32_t index, const point3d& point) const noexcept
+            {
+                const double left = importance(index + 1, point);
+                const double total = left + importance(nodes_[index].right, point);
+                return total > 0 ? left / total : 0.5;
+            }
+
+            /**
+             * \brief builds the nodes of the lights in [first, last), splits in the middle of the longest axis
+             * \param first first light index
+             * \param last one past the last light index
+             * \param parent index of the parent node
+             * \return index of the created node
+             */
+            std::uint32_t build(std::uint32_t* first, std::uint32_t* last, const std::uint32_t parent)
+            {
+                const std::uint32_t index = static_cast<std::uint32_t>(nodes_.size());
+                nodes_.push_back({lights_[*first].position, lights_[*first].position, 0, parent, 0, *first});
+
+                for (const std::uint32_t* light = first; light != last; ++light)
+                {
+                    const point3d& position = lights_[*light].position;
+                    node& current = nodes_[index];
+                    current.min = point3d(std::min(current.min.x, position.x), std::min(current.min.y, position.y),
+                                          std::min(current.min.z, position.z));
+                    current.max = point3d(std::max(current.max.x, position.x), std::max(current.max.y, position.y),
+                                          std::max(current.max.z, position.z));
+                    current.power += lights_[*light].intensity;
+                }
+
+                if (last - first == 1)
+                {
+                    leaves_[*first] = index;
+                    return index;
+                }
+
+                const vector3d extent = nodes_[index].min.get_vector(nodes_[index].max);
+                const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+                std::uint32_t* middle = first + (last - first) / 2;
+                std::nth_element(first, middle, last, [this, axis](const std::uint32_t left, const std::uint32_t right)
+                {
+                    const point3d& a = lights_[left].position;
+                    const point3d& b = lights_[right].position;
+                    return axis == 0 ? a.x < b.x : axis == 1 ? a.y < b.y : a.z < b.z;
+                });
+
+                build(first, middle, index);
+                const std::uint32_t right = build(middle, last, index);
+                nodes_[index].right = right;
+                return index;
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return lights_.size(); }
+            NODISCARD const std::vector<light>& get_lights() const noexcept { return lights_; }
+
+            /**
+             * \brief gets the amount of nodes, 2 * size() - 1
+             * \return amount of nodes
+             */
+            NODISCARD std::size_t node_count() const noexcept { return nodes_.size(); }
+
+            /**
+             * \brief gets the sum of all intensities
+             * \return total intensity
+             */
+            NODISCARD double get_power() const noexcept { return nodes_[0].power; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,481 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/math.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief Sobol sequence in 3 dimensions, optionally with Owen scrambling
+         *
+         * the direction numbers are calculated once, a sample is the xor of the direction numbers of the set bits of
+         * its index. the batch functions xor one bit of a whole block of indices at a time so the loops vectorize,
+         * they only use a fixed block on the stack and never allocate
+         * \note read more at: https://web.maths.unsw.edu.au/~fkuo/sobol/ and https://jcgt.org/published/0009/04/01/
+         */
+        class sobol_sequence
+        {
+        public:
+            /**
+             * \brief amount of dimensions
+             */
+            INLINE static constexpr unsigned int dimensions = 3;
+
+        protected:
+            INLINE static constexpr std::size_t block_size = 64; // amount of samples calculated at a time
+
+            std::array<std::array<std::uint32_t, 32>, dimensions> direction_{}; // direction numbers of every dimension
+            std::array<std::uint32_t, dimensions> seed_{}; // scramble seed of every dimension
+            bool scrambled_; // if the samples are Owen scrambled
+
+        public:
+            /**
+             * \brief constructor for an unscrambled sobol_sequence
+             */
+            sobol_sequence() : scrambled_(false) { calculate_directions(); }
+
+            /**
+             * \brief constructor for an Owen scrambled sobol_sequence, every seed gives a different randomization that
+             * keeps the stratification of the sequence
+             * \param seed seed of the scrambling
+             */
+            explicit sobol_sequence(const std::uint32_t seed) : scrambled_(true)
+            {
+                calculate_directions();
+                for (unsigned int dimension = 0; dimension < dimensions; ++dimension)
+                    seed_[dimension] = math::hash(seed + math::hash(dimension + 1));
+            }
+
+            /**
+             * \brief gets a sample as a 32 bit fraction
+             * \throws out_of_range_exception if dimension is greater or equal to dimensions
+             * \param index index of the sample
+             * \param dimension dimension of the sample
+             * \return sample / 2^32
+             */
+            NODISCARD std::uint32_t sample_bits(const std::uint32_t index, const unsigned int dimension) const
+            {
+                if (dimension >= dimensions)
+                    throw exception::out_of_range_exception("dimension must be smaller than the amount of dimensions");
+
+                std::uint32_t bits = 0;
+                for (unsigned int bit = 0; bit < 32; ++bit)
+                    bits ^= direction_[dimension][bit] & (0u - ((index >> bit) & 1u));
+
+                return scrambled_ ? owen_scramble(bits, seed_[dimension]) : bits;
+            }
+
+            /**
+             * \brief gets a sample
+             * \throws out_of_range_exception if dimension is greater or equal to dimensions
+             * \param index index of the sample
+             * \param dimension dimension of the sample
+             * \return sample in the range [0, 1)
+             */
+            NODISCARD double sample(const std::uint32_t index, const unsigned int dimension) const
+            {
+                return math::to_unit_interval(sample_bits(index, dimension));
+            }
+
+            /**
+             * \brief calculates a batch of 2D samples
+             * \param first index of the first sample
+             * \param count amount of samples
+             * \param x first dimension of every sample, must have room for count values
+             * \param y second dimension of every sample, must have room for count values
+             */
+            void samples(const std::uint32_t first, const std::size_t count, double* x, double* y) const noexcept
+            {
+                fill(0, first, count, x);
+                fill(1, first, count, y);
+            }
+
+            /**
+             * \brief calculates a batch of 3D samples
+             * \param first index of the first sample
+             * \param count amount of samples
+             * \param x first dimension of every sample, must have room for count values
+             * \param y second dimension of every sample, must have room for count values
+             * \param z third dimension of every sample, must have room for count values
+             */
+            void samples(const std::uint32_t first, const std::size_t count, double* x, double* y, double* z) const
+                noexcept
+            {
+                fill(0, first, count, x);
+                fill(1, first, count, y);
+                fill(2, first, count, z);
+            }
+
+            /**
+             * \brief Owen scrambling of a 32 bit fraction with a hash, every bit is flipped depending on the bits above
+             * \note read more at: https://psychopath.io/post/2021_01_30_building_a_better_lk_hash
+             * \param value fraction to scramble
+             * \param seed seed of the scrambling
+             * \return scrambled fraction
+             */
+            NODISCARD static std::uint32_t owen_scramble(std::uint32_t value, const std::uint32_t seed) noexcept
+            {
+                //the Laine-Karras permutation flips bits depending on the bits below, so it works on reversed bits
+                value = math::reverse_bits(value);
+                value ^= value * 0x3D20ADEAu;
+                value += seed;
+                value *= (seed >> 16) | 1u;
+                value ^= value * 0x05526C56u;
+                value ^= value * 0x53A22864u;
+                return math::reverse_bits(value);
+            }
+
+        protected:
+            /**
+             * \brief calculates the direction numbers, dimension 0 is the van der Corput sequence, the others use the
+             * primitive polynomials and initial numbers of Joe and Kuo
+             */
+            void calculate_directions() noexcept
+            {
+                //degree, coefficients and initial direction numbers of the primitive polynomial of every dimension
+                const unsigned int degree[dimensions] = {0, 1, 2};
+                const unsigned int coefficients[dimensions] = {0, 0, 1};
+                const unsigned int initial[dimensions][2] = {{0, 0}, {1, 0}, {1, 3}};
+
+                for (unsigned int bit = 0; bit < 32; ++bit)
+                    direction_[0][bit] = 1u << (31 - bit);
+
+                for (unsigned int dimension = 1; dimension < dimensions; ++dimension)
+                {
+                    const unsigned int s = degree[dimension];
+                    std::array<std::uint32_t, 32>& direction = direction_[dimension];
+
+                    for (unsigned int bit = 0; bit < s; ++bit)
+                        direction[bit] = initial[dimension][bit] << (31 - bit);
+
+                    for (unsigned int bit = s; bit < 32; ++bit)
+                    {
+                        direction[bit] = direction[bit - s] ^ (direction[bit - s] >> s);
+                        for (unsigned int k = 1; k < s; ++k)
+                            direction[bit] ^= ((coefficients[dimension] >> (s - 1 - k)) & 1u) * direction[bit - k];
+                    }
+                }
+            }
+
+            /**
+             * \brief calculates one dimension of a batch of samples, a block at a time
+             */
+            void fill(const unsigned int dimension, const std::uint32_t first, const std::size_t count, double* result)
+                const noexcept
+            {
+                const std::array<std::uint32_t, 32>& direction = direction_[dimension];
+                const std::uint32_t seed = seed_[dimension];
+                const bool scrambled = scrambled_;
+
+                std::uint32_t bits[block_size];
+                for (std::size_t begin = 0; begin < count; begin += block_size)
+                {
+                    const std::size_t size = count - begin < block_size ? count - begin : block_size;
+                    const std::uint32_t start = first + static_cast<std::uint32_t>(begin);
+
+                    for (std::size_t index = 0; index < size; ++index)
+                        bits[index] = 0;
+
+                    //one bit at a time for the whole block, so the inner loop is a branch free xor
+                    for (unsigned int bit = 0; bit < 32; ++bit)
+                    {
+                        const std::uint32_t number = direction[bit];
+
+                        VECTORIZE
+                        for (std::size_t index = 0; index < size; ++index)
+                        {
+                            const std::uint32_t sample = start + static_cast<std::uint32_t>(index);
+                            bits[index] ^= number & (0u - ((sample >> bit) & 1u));
+                        }
+                    }
+
+                    //the branch is outside the loops, a select inside them keeps gcc from vectorizing
+                    double* block = result + begin;
+                    if (scrambled)
+                    {
+                        VECTORIZE
+                        for (std::size_t index = 0; index < size; ++index)
+                            block[index] = math::to_unit_interval(owen_scramble(bits[index], seed));
+                    }
+                    else
+                    {
+                        VECTORIZE
+                        for (std::size_t index = 0; index < size; ++index)
+                            block[index] = math::to_unit_interval(bits[index]);
+                    }
+                }
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD bool is_scrambled() const noexcept { return scrambled_; }
+        };
+
+        /**
+         * \brief Halton sequence in 3 dimensions, the radical inverse in base 2, 3 and 5
+         *
+         * base 2 reverses the bits, base 3 and 5 look up the radical inverse of several digits at a time in a table,
+         * so every sample costs the same amount of lookups and the loops don't branch
+         * \note read more at: https://en.wikipedia.org/wiki/Halton_sequence
+         */
+        class halton_sequence
+        {
+        public:
+            /**
+             * \brief amount of dimensions
+             */
+            INLINE static constexpr unsigned int dimensions = 3;
+
+        protected:
+            INLINE static constexpr std::uint32_t table3_size = 729; // 3^6, 4 lookups cover 32 bit indices
+            INLINE static constexpr std::uint32_t table5_size = 625; // 5^4, 4 lookups cover 32 bit indices
+
+            std::array<double, table3_size> table3_{}; // radical inverse in base 3 of every 6 digit number
+            std::array<double, table5_size> table5_{}; // radical inverse in base 5 of every 4 digit number
+
+        public:
+            /**
+             * \brief constructor for halton_sequence, calculates the tables
+             */
+            halton_sequence()
+            {
+                fill_table(3, 6, table3_.data(), table3_size);
+                fill_table(5, 4, table5_.data(), table5_size);
+            }
+
+            /**
+             * \brief gets a sample
+             * \throws out_of_range_exception if dimension is greater or equal to dimensions
+             * \param index index of the sample
+             * \param dimension dimension of the sample, base 2, 3 or 5
+             * \return sample in the range [0, 1)
+             */
+            NODISCARD double sample(const std::uint32_t index, const unsigned int dimension) const
+            {
+                if (dimension >= dimensions)
+                    throw exception::out_of_range_exception("dimension must be smaller than the amount of dimensions");
+
+                if (dimension == 0)
+                    return math::to_unit_interval(math::reverse_bits(index));
+
+                return dimension == 1
+                           ? radical_inverse(index, table3_.data(), table3_size)
+                           : radical_inverse(index, table5_.data(), table5_size);
+            }
+
+            /**
+             * \brief calculates a batch of 2D samples
+             * \param first index of the first sample
+             * \param count amount of samples
+             * \param x first dimension of every sample, must have room for count values
+             * \param y second dimension of every sample, must have room for count values
+             */
+            void samples(const std::uint32_t first, const std::size_t count, double* x, double* y) const noexcept
+            {
+                fill_base2(first, count, x);
+                fill(first, count, y, table3_.data(), table3_size);
+            }
+
+            /**
+             * \brief calculates a batch of 3D samples
+             * \param first index of the first sample
+             * \param count amount of samples
+             * \param x first dimension of every sample, must have room for count values
+             * \param y second dimension of every sample, must have room for count values
+             * \param z third dimension of every sample, must have room for count values
+             */
+            void samples(const std::uint32_t first, const std::size_t count, double* x, double* y, double* z) const
+                noexcept
+            {
+                fill_base2(first, count, x);
+                fill(first, count, y, table3_.data(), table3_size);
+                fill(first, count, z, table5_.data(), table5_size);
+            }
+
+        protected:
+            /**
+             * \brief fills a table with the radical inverse of every number with a fixed amount of digits
+             */
+            static void fill_table(const std::uint32_t base, const unsigned int digits, double* table,
+                                   const std::uint32_t size) noexcept
+            {
+                for (std::uint32_t number = 0; number < size; ++number)
+                {
+                    double inverse = 0;
+                    double scale = 1. / base;
+                    std::uint32_t remaining = number;
+                    for (unsigned int digit = 0; digit < digits; ++digit)
+                    {
+                        inverse += static_cast<double>(remaining % base) * scale;
+                        remaining /= base;
+                        scale /= base;
+                    }
+                    table[number] = inverse;
+                }
+            }
+
+            /**
+             * \brief radical inverse, 4 lookups of several digits at a time
+             */
+            static double radical_inverse(std::uint32_t index, const double* table, const std::uint32_t size) noexcept
+            {
+                const double scale = 1. / size;
+
+                double inverse = table[index % size];
+                index /= size;
+                inverse += table[index % size] * scale;
+                index /= size;
+                inverse += table[index % size] * scale * scale;
+                index /= size;
+                inverse += table[index % size] * scale * scale * scale;
+                return inverse;
+            }
+
+            /**
+             * \brief calculates the base 2 dimension of a batch of samples
+             */
+            static void fill_base2(const std::uint32_t first, const std::size_t count, double* result) noexcept
+            {
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const std::uint32_t sample = first + static_cast<std::uint32_t>(index);
+                    result[index] = math::to_unit_interval(math::reverse_bits(sample));
+                }
+            }
+
+            /**
+             * \brief calculates the base 3 or 5 dimension of a batch of samples
+             */
+            static void fill(const std::uint32_t first, const std::size_t count, double* result, const double* table,
+                             const std::uint32_t size) noexcept
+            {
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                    result[index] = radical_inverse(first + static_cast<std::uint32_t>(index), table, size);
+            }
+        };
+
+        /**
+         * \brief R2 sequence, the additive recurrence of the generalized golden ratio, in 2 or 3 dimensions
+         *
+         * sample n is fraction(0.5 + n * alpha), alpha holds the powers of 1 / phi of the dimension. it is calculated
+         * in 32 bit fixed point, so there is no loss of precision for large indices and the loop vectorizes
+         * \note read more at: https://extremelearning.com.au/unreasonable-effectiveness-of-quasirandom-sequences/
+         */
+        class r2_sequence
+        {
+        protected:
+            unsigned int dimensions_; // amount of dimensions, 2 or 3
+            std::array<std::uint32_t, 3> alpha_{}; // alpha of every dimension as a 32 bit fraction
+
+        public:
+            /**
+             * \brief constructor for r2_sequence
+             * \throws out_of_range_exception if dimensions is not 2 or 3
+             * \param dimensions amount of dimensions, 2 by default
+             */
+            explicit r2_sequence(const unsigned int dimensions = 2) : dimensions_(dimensions)
+            {
+                if (dimensions != 2 && dimensions != 3)
+                    throw exception::out_of_range_exception("dimensions must be 2 or 3");
+
+                //phi is the root of x^(d + 1) = x + 1, the plastic number in 2 dimensions
+                const double phi = dimensions == 2 ? 1.3247179572447460 : 1.2207440846057595;
+                double alpha = 1;
+                for (unsigned int dimension = 0; dimension < dimensions; ++dimension)
+                {
+                    alpha /= phi;
+                    alpha_[dimension] = static_cast<std::uint32_t>(alpha * 4294967296.);
+                }
+            }
+
+            /**
+             * \brief gets a sample
+             * \throws out_of_range_exception if dimension is greater or equal to get_dimensions()
+             * \param index index of the sample
+             * \param dimension dimension of the sample
+             * \return sample in the range [0, 1)
+             */
+            NODISCARD double sample(const std::uint32_t index, const unsigned int dimension) const
+            {
+                if (dimension >= dimensions_)
+                    throw exception::out_of_range_exception("dimension must be smaller than the amount of dimensions");
+
+                return math::to_unit_interval(0x80000000u + index * alpha_[dimension]);
+            }
+
+            /**
+             * \brief calculates a batch of 2D samples
+             * \param first index of the first sample
+             * \param count amount of samples
+             * \param x first dimension of every sample, must have room for count values
+             * \param y second dimension of every sample, must have room for count values
+             */
+            void samples(const std::uint32_t first, const std::size_t count, double* x, double* y) const noexcept
+            {
+                fill(alpha_[0], first, count, x);
+                fill(alpha_[1], first, count, y);
+            }
+
+            /**
+             * \brief calculates a batch of 3D samples
+             * \throws out_of_range_exception if the sequence has 2 dimensions
+             * \param first index of the first sample
+             * \param count amount of samples
+             * \param x first dimension of every sample, must have room for count values
+             * \param y second dimension of every sample, must have room for count values
+             * \param z third dimension of every sample, must have room for count values
+             */
+            void samples(const std::uint32_t first, const std::size_t count, double* x, double* y, double* z) const
+            {
+                if (dimensions_ != 3)
+                    throw exception::out_of_range_exception("3D samples need a sequence with 3 dimensions");
+
+                fill(alpha_[0], first, count, x);
+                fill(alpha_[1], first, count, y);
+                fill(alpha_[2], first, count, z);
+            }
+
+        protected:
+            /**
+             * \brief calculates one dimension of a batch of samples
+             */
+            static void fill(const std::uint32_t alpha, const std::uint32_t first, const std::size_t count,
+                             double* result) noexcept
+            {
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const std::uint32_t sample = first + static_cast<std::uint32_t>(index);
+                    result[index] = math::to_unit_interval(0x80000000u + sample * alpha);
+                }
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD unsigned int get_dimensions() const noexcept { return dimensions_; }
+
+            /**
+             * \brief gets the alpha of a dimension, the step between two samples
+             * \param dimension dimension, smaller than 3
+             * \return alpha in the range [0, 1), zero for the third dimension of a 2D sequence
+             */
+            NODISCARD double get_alpha(const unsigned int dimension) const noexcept
+            {
+                return static_cast<double>(alpha_[dimension]) / 4294967296.;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
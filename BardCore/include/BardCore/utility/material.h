@@ -0,0 +1,101 @@
+#pragma once
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/math.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief material class, describes how a surface reacts to light, e.g. in raytracing
+         * \note albedo, reflectance and transmittance are fractions of the incoming light, usually between 0 and 1
+         */
+        class material
+        {
+        public:
+            /**
+             * \brief fraction of the light that is scattered diffusely (lambertian)
+             */
+            double albedo;
+
+            /**
+             * \brief fraction of the light that is reflected like a mirror
+             */
+            double reflectance;
+
+            /**
+             * \brief fraction of the light that is refracted into the surface
+             */
+            double transmittance;
+
+            /**
+             * \brief refractive index of the inside of the surface, e.g. 1.33 for water
+             */
+            double refractive_index;
+
+        public:
+            /**
+             * \brief constructor for material
+             * \throws negative_exception if albedo, reflectance or transmittance is negative
+             * \throws zero_exception if refractive_index is zero or smaller
+             * \param albedo fraction of the light that is scattered diffusely
+             * \param reflectance fraction of the light that is reflected
+             * \param transmittance fraction of the light that is refracted
+             * \param refractive_index refractive index of the inside of the surface, default is 1
+             */
+            constexpr material(const double albedo, const double reflectance = 0, const double transmittance = 0,
+                               const double refractive_index = 1) : albedo(albedo), reflectance(reflectance),
+                                                                    transmittance(transmittance),
+                                                                    refractive_index(refractive_index)
+            {
+                if (albedo < 0 || reflectance < 0 || transmittance < 0)
+                    throw exception::negative_exception("albedo, reflectance and transmittance can't be negative");
+                if (refractive_index <= 0)
+                    throw exception::zero_exception("refractive index must be greater than 0");
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                    operators                    ///
+            ///////////////////////////////////////////////////////
+
+            /**
+             * \brief output operator, prints "{albedo: a, reflectance: r, transmittance: t, refractive_index: n}"
+             * \param os output stream
+             * \param material material to output
+             * \return output stream "{albedo: a, reflectance: r, transmittance: t, refractive_index: n}"
+             */
+            friend std::ostream& operator<<(std::ostream& os, const material& material)
+            {
+                return os << "{albedo: " << material.albedo << ", reflectance: " << material.reflectance <<
+                    ", transmittance: " << material.transmittance << ", refractive_index: " << material.
+                    refractive_index << "}";
+            }
+
+            /**
+             * \brief equal operator (albedo, reflectance, transmittance and refractive index are equal)
+             * \param left left material
+             * \param right right material
+             * \return true if left == right
+             */
+            NODISCARD constexpr friend bool operator==(const material& left, const material& right) noexcept
+            {
+                return math::equals(left.albedo, right.albedo)
+                    && math::equals(left.reflectance, right.reflectance)
+                    && math::equals(left.transmittance, right.transmittance)
+                    && math::equals(left.refractive_index, right.refractive_index);
+            }
+
+            /**
+             * \brief not equal operator
+             * \param left left material
+             * \param right right material
+             * \return true if left != right
+             */
+            NODISCARD constexpr friend bool operator!=(const material& left, const material& right) noexcept
+            {
+                return !(left == right);
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
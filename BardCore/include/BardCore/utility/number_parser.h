@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "BardCore/bardcore.h"
+
+#if defined(CXX17)
+#include <charconv>
+#endif
+
+// std::from_chars and std::to_chars for floating point numbers, not every C++17 standard library has them
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define FLOAT_CHARCONV
+#endif
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief parses numbers in a range of characters that is not null terminated, e.g. a memory mapped file
+         *
+         * every function returns the character after the number, or nullptr if there is no valid number at first.
+         * leading spaces, tabs and carriage returns are skipped, a leading '+' is allowed
+         * \note with std::from_chars (C++17) a double is parsed without any copy, without it the number is copied to
+         * a small buffer for std::strtod, which depends on the C locale
+         */
+        class number_parser
+        {
+        public:
+            /**
+             * \brief longest number the fallback without std::from_chars can parse
+             */
+            INLINE static constexpr std::size_t max_length = 64;
+
+            /**
+             * \brief skips spaces, tabs and carriage returns
+             * \param first first character
+             * \param last one past the last character
+             * \return first character that is not skipped, or last
+             */
+            NODISCARD static const char* skip_spaces(const char* first, const char* last) noexcept
+            {
+                while (first != last && (*first == ' ' || *first == '\t' || *first == '\r'))
+                    ++first;
+                return first;
+            }
+
+            /**
+             * \brief skips to the first space, tab, carriage return or newline
+             * \param first first character
+             * \param last one past the last character
+             * \return first whitespace character, or last
+             */
+            NODISCARD static const char* skip_token(const char* first, const char* last) noexcept
+            {
+                while (first != last && *first != ' ' && *first != '\t' && *first != '\r' && *first != '\n')
+                    ++first;
+                return first;
+            }
+
+            /**
+             * \brief parses a floating point number
+             * \param first first character
+             * \param last one past the last character
+             * \param value parsed number, unchanged on failure
+             * \return character after the number, nullptr if there is no number
+             */
+            static const char* parse(const char* first, const char* last, double& value) noexcept
+            {
+                first = skip_plus(skip_spaces(first, last), last);
+                if (first == last)
+                    return nullptr;
+
+#if defined(FLOAT_CHARCONV)
+                const std::from_chars_result result = std::from_chars(first, last, value);
+                return result.ec == std::errc() ? result.ptr : nullptr;
+#else
+                char buffer[max_length];
+                const char* end = skip_token(first, last);
+                const std::size_t length = static_cast<std::size_t>(end - first);
+                if (length >= max_length)
+                    return nullptr;
+
+                std::memcpy(buffer, first, length);
+                buffer[length] = '\0';
+
+                char* parsed = nullptr;
+                const double number = std::strtod(buffer, &parsed);
+                if (parsed == buffer)
+                    return nullptr;
+
+                value = number;
+                return first + (parsed - buffer);
+#endif
+            }
+
+            /**
+             * \brief parses a floating point number in single precision
+             * \param first first character
+             * \param last one past the last character
+             * \param value parsed number, unchanged on failure
+             * \return character after the number, nullptr if there is no number
+             */
+            static const char* parse(const char* first, const char* last, float& value) noexcept
+            {
+                double number = 0;
+                const char* end = parse(first, last, number);
+                if (end != nullptr)
+                    value = static_cast<float>(number);
+                return end;
+            }
+
+            /**
+             * \brief parses a whole number in base 10
+             * \param first first character
+             * \param last one past the last character
+             * \param value parsed number, unchanged on failure
+             * \return character after the number, nullptr if there is no number or it doesn't fit in 64 bits
+             */
+            static const char* parse(const char* first, const char* last, std::int64_t& value) noexcept
+            {
+                first = skip_spaces(first, last);
+                const bool negative = first != last && *first == '-';
+                first = negative ? first + 1 : skip_plus(first, last);
+                if (first == last || *first < '0' || *first > '9')
+                    return nullptr;
+
+                std::uint64_t number = 0;
+                for (; first != last && *first >= '0' && *first <= '9'; ++first)
+                {
+                    const std::uint64_t digit = static_cast<std::uint64_t>(*first - '0');
+                    if (number > (UINT64_C(9223372036854775807) - digit) / 10)
+                        return nullptr;
+                    number = number * 10 + digit;
+                }
+
+                value = negative ? -static_cast<std::int64_t>(number) : static_cast<std::int64_t>(number);
+                return first;
+            }
+
+        protected:
+            /**
+             * \brief skips a leading '+', std::from_chars doesn't accept it
+             */
+            NODISCARD static const char* skip_plus(const char* first, const char* last) noexcept
+            {
+                return first != last && *first == '+' ? first + 1 : first;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
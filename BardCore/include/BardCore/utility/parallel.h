@@ -0,0 +1,95 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "BardCore/bardcore.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief small helper for splitting work over threads, the work is split into contiguous chunks
+         * \note chunk t always covers a lower range than chunk t + 1, algorithms can rely on this for stable output
+         */
+        class parallel
+        {
+        public:
+            /**
+             * \brief gets the amount of hardware threads, at least 1
+             * \return amount of hardware threads
+             */
+            NODISCARD static unsigned int hardware_threads() noexcept
+            {
+                const unsigned int threads = std::thread::hardware_concurrency();
+                return threads == 0
+                           ? 1
+                           : threads;
+            }
+
+            /**
+             * \brief calculates how many threads will be used for count elements
+             * \note 0 threads means hardware_threads(), there are never more threads than elements
+             * \param count amount of elements
+             * \param threads requested amount of threads
+             * \return amount of threads that will be used, at least 1
+             */
+            NODISCARD static unsigned int thread_count(const std::size_t count, const unsigned int threads) noexcept
+            {
+                const unsigned int requested = threads == 0
+                                                   ? hardware_threads()
+                                                   : threads;
+
+                return static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(requested, count)));
+            }
+
+            /**
+             * \brief gets the begin of a chunk
+             * \param count amount of elements
+             * \param chunks amount of chunks
+             * \param chunk chunk index
+             * \return begin index of the chunk
+             */
+            NODISCARD constexpr static std::size_t chunk_begin(const std::size_t count, const unsigned int chunks,
+                                                               const unsigned int chunk) noexcept
+            {
+                return count * chunk / chunks;
+            }
+
+            /**
+             * \brief calls function(thread_index, begin, end) for every chunk of [0, count)
+             * \note the calling thread handles chunk 0, with one thread no threads are created
+             * \note function must not throw, an exception on a worker thread terminates the program
+             * \tparam Function callable with (unsigned int, std::size_t, std::size_t)
+             * \param count amount of elements
+             * \param threads amount of threads, 0 means hardware_threads()
+             * \param function function to call for every chunk
+             * \return amount of threads used
+             */
+            template <typename Function>
+            static unsigned int for_each_chunk(const std::size_t count, const unsigned int threads,
+                                               Function&& function)
+            {
+                const unsigned int chunks = thread_count(count, threads);
+
+                std::vector<std::thread> workers;
+                workers.reserve(chunks - 1);
+
+                for (unsigned int chunk = 1; chunk < chunks; ++chunk)
+                    workers.emplace_back([&function, count, chunks, chunk]()
+                    {
+                        function(chunk, chunk_begin(count, chunks, chunk), chunk_begin(count, chunks, chunk + 1));
+                    });
+
+                function(0u, chunk_begin(count, chunks, 0), chunk_begin(count, chunks, 1));
+
+                for (std::thread& worker : workers)
+                    worker.join();
+
+                return chunks;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
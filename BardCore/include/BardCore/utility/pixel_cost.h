@@ -0,0 +1,320 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PIXEL_COST_RDTSC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define PIXEL_COST_RDTSC
+#else
+#include <chrono>
+#endif
+
+#include "BardCore/bardcore.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief cost of every pixel of an image, e.g. to find out where the render time of a scene goes
+         *
+         * every pixel has a value per channel, they are added up over all rays of the pixel. the channels can be
+         * written as a false colour ppm, blue for cheap and red for expensive pixels, or as a pfm with the raw values
+         * \note wavefront fills one when BARDCORE_PIXEL_COST is defined, without it the accounting is compiled out.
+         * BARDCORE_PIXEL_COST also defines BARDCORE_INSTRUMENTATION, the traversal steps and primitive tests are the
+         * box_tests and intersection_tests counters of utility::instrumentation
+         * \note traversal steps stay zero for a scene that runs no box tests, e.g. geometry::sphere_set tests every
+         * sphere directly, so only primitive tests, bounces and cycles show its cost
+         */
+        class pixel_cost
+        {
+        public:
+            /**
+             * \brief costs of a pixel
+             */
+            enum class channel : std::size_t
+            {
+                traversal_steps, // box tests of the scene, e.g. nodes of a bounding volume hierarchy, zero without them
+                primitive_tests, // ray and primitive intersection tests
+                bounces, // rays traced through the scene, one per bounce of every path
+                cycles, // time stamp counter cycles (rdtsc), nanoseconds on cpus without one
+                count // amount of channels
+            };
+
+            /**
+             * \brief amount of channels
+             */
+            INLINE static constexpr std::size_t channel_count = static_cast<std::size_t>(channel::count);
+
+#if defined(BARDCORE_PIXEL_COST)
+            /**
+             * \brief true if BARDCORE_PIXEL_COST is defined, so renderers fill a pixel_cost
+             */
+            INLINE static constexpr bool enabled = true;
+#else
+            /**
+             * \brief true if BARDCORE_PIXEL_COST is defined, so renderers fill a pixel_cost
+             */
+            INLINE static constexpr bool enabled = false;
+#endif
+
+        protected:
+            unsigned int width_ = 0;
+            unsigned int height_ = 0;
+            std::vector<std::uint64_t> values_[channel_count]{}; // per channel, pixel y * width + x
+
+        public:
+            /**
+             * \brief default constructor for pixel_cost, an empty image
+             */
+            pixel_cost() = default;
+
+            /**
+             * \brief constructor for pixel_cost, every value is zero
+             * \param width width of the image
+             * \param height height of the image
+             */
+            pixel_cost(const unsigned int width, const unsigned int height)
+            {
+                resize(width, height);
+            }
+
+            /**
+             * \brief changes the size of the image and sets every value to zero
+             * \param width width of the image
+             * \param height height of the image
+             */
+            void resize(const unsigned int width, const unsigned int height)
+            {
+                width_ = width;
+                height_ = height;
+                for (std::vector<std::uint64_t>& values : values_)
+                    values.assign(static_cast<std::size_t>(width) * height, 0);
+            }
+
+            /**
+             * \brief sets every value to zero
+             */
+            void clear() noexcept
+            {
+                for (std::vector<std::uint64_t>& values : values_)
+                    std::fill(values.begin(), values.end(), 0);
+            }
+
+            /**
+             * \brief adds to a pixel, e.g. the pixel of a ray_queue entry
+             * \param counted channel
+             * \param pixel index of the pixel, y * width + x, smaller than size()
+             * \param amount amount to add
+             */
+            void add(const channel counted, const std::size_t pixel, const std::uint64_t amount) noexcept
+            {
+                values_[static_cast<std::size_t>(counted)][pixel] += amount;
+            }
+
+            /**
+             * \brief gets the value of a pixel
+             * \throws out_of_range_exception if x or y is outside the image
+             * \param counted channel
+             * \param x x position of the pixel
+             * \param y y position of the pixel
+             * \return value of the pixel
+             */
+            NODISCARD std::uint64_t get(const channel counted, const unsigned int x, const unsigned int y) const
+            {
+                if (x >= width_ || y >= height_)
+                    throw exception::out_of_range_exception("x and y must be smaller than the width and height");
+
+                return values_[static_cast<std::size_t>(counted)][static_cast<std::size_t>(y) * width_ + x];
+            }
+
+            /**
+             * \brief gets the largest value of a channel
+             * \param counted channel
+             * \return largest value, zero for an empty image
+             */
+            NODISCARD std::uint64_t max(const channel counted) const noexcept
+            {
+                std::uint64_t result = 0;
+                for (const std::uint64_t value : values_[static_cast<std::size_t>(counted)])
+                    result = value > result ? value : result;
+                return result;
+            }
+
+            /**
+             * \brief gets the sum of a channel over every pixel
+             * \param counted channel
+             * \return sum of the channel
+             */
+            NODISCARD std::uint64_t total(const channel counted) const noexcept
+            {
+                std::uint64_t result = 0;
+                for (const std::uint64_t value : values_[static_cast<std::size_t>(counted)])
+                    result += value;
+                return result;
+            }
+
+            /**
+             * \brief writes a channel as a binary ppm (P6) in false colour, from blue (zero) over green and yellow to
+             * red (the largest value)
+             * \throws io_exception if the stream fails
+             * \param stream stream to write to, opened in binary mode
+             * \param counted channel to write
+             * \param logarithmic scale the values by log(1 + value), so a few very expensive pixels don't hide the rest
+             */
+            void write_ppm(std::ostream& stream, const channel counted, const bool logarithmic = false) const
+            {
+                const std::vector<std::uint64_t>& values = values_[static_cast<std::size_t>(counted)];
+                const double largest = scale(static_cast<double>(max(counted)), logarithmic);
+
+                stream << "P6\n" << width_ << " " << height_ << "\n255\n";
+
+                std::vector<unsigned char> row(static_cast<std::size_t>(width_) * 3);
+                for (unsigned int y = 0; y < height_; ++y)
+                {
+                    for (unsigned int x = 0; x < width_; ++x)
+                    {
+                        const std::uint64_t count = values[static_cast<std::size_t>(y) * width_ + x];
+                        const double value = scale(static_cast<double>(count), logarithmic);
+                        false_colour(largest > 0 ? value / largest : 0, &row[static_cast<std::size_t>(x) * 3]);
+                    }
+                    stream.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+                }
+
+                if (!stream)
+                    throw exception::io_exception("failed to write ppm");
+            }
+
+            /**
+             * \brief writes a channel as a ppm file, see write_ppm(std::ostream&, channel, bool)
+             * \throws io_exception if the file can't be written
+             * \param path path of the file
+             * \param counted channel to write
+             * \param logarithmic scale the values by log(1 + value)
+             */
+            void write_ppm(const std::string& path, const channel counted, const bool logarithmic = false) const
+            {
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                if (!file)
+                    throw exception::io_exception("failed to open " + path);
+                write_ppm(file, counted, logarithmic);
+            }
+
+            /**
+             * \brief writes a channel as a greyscale pfm (Pf) with the raw values as 32 bit floats, e.g. for a tone
+             * mapping or colour map of another tool
+             * \note the rows are written bottom to top and the floats in the byte order of the machine, as the format
+             * requires, a negative scale marks little endian
+             * \throws io_exception if the stream fails
+             * \param stream stream to write to, opened in binary mode
+             * \param counted channel to write
+             */
+            void write_pfm(std::ostream& stream, const channel counted) const
+            {
+                const std::vector<std::uint64_t>& values = values_[static_cast<std::size_t>(counted)];
+                const std::uint16_t one = 1;
+                unsigned char first_byte = 0;
+                std::memcpy(&first_byte, &one, 1);
+
+                stream << "Pf\n" << width_ << " " << height_ << "\n" << (first_byte == 1 ? "-1.0" : "1.0") << "\n";
+
+                std::vector<float> row(width_);
+                for (unsigned int y = height_; y-- > 0;)
+                {
+                    for (unsigned int x = 0; x < width_; ++x)
+                        row[x] = static_cast<float>(values[static_cast<std::size_t>(y) * width_ + x]);
+                    stream.write(reinterpret_cast<const char*>(row.data()),
+                                 static_cast<std::streamsize>(row.size() * sizeof(float)));
+                }
+
+                if (!stream)
+                    throw exception::io_exception("failed to write pfm");
+            }
+
+            /**
+             * \brief writes a channel as a pfm file, see write_pfm(std::ostream&, channel)
+             * \throws io_exception if the file can't be written
+             * \param path path of the file
+             * \param counted channel to write
+             */
+            void write_pfm(const std::string& path, const channel counted) const
+            {
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                if (!file)
+                    throw exception::io_exception("failed to open " + path);
+                write_pfm(file, counted);
+            }
+
+            /**
+             * \brief maps a value in [0, 1] to a colour, blue, cyan, green, yellow and red at 0, 0.25, 0.5, 0.75 and 1
+             * \param value value to map, clamped to [0, 1]
+             * \param rgb red, green and blue of the colour
+             */
+            static void false_colour(const double value, unsigned char* rgb) noexcept
+            {
+                const double t = value < 0 ? 0 : (value > 1 ? 1 : value);
+                const double red = t < 0.5 ? 0 : (t < 0.75 ? (t - 0.5) * 4 : 1);
+                const double green = t < 0.25 ? t * 4 : (t < 0.75 ? 1 : (1 - t) * 4);
+                const double blue = t < 0.25 ? 1 : (t < 0.5 ? (0.5 - t) * 4 : 0);
+
+                rgb[0] = static_cast<unsigned char>(red * 255 + 0.5);
+                rgb[1] = static_cast<unsigned char>(green * 255 + 0.5);
+                rgb[2] = static_cast<unsigned char>(blue * 255 + 0.5);
+            }
+
+            /**
+             * \brief reads the time stamp counter, the difference of two calls is the amount of cycles in between
+             * \note the time stamp counter runs at a constant rate on current cpus, not at the actual clock speed.
+             * without one (e.g. arm) this is std::chrono::steady_clock in nanoseconds
+             * \return current time stamp
+             */
+            static std::uint64_t timestamp() noexcept
+            {
+#if defined(PIXEL_COST_RDTSC)
+                return static_cast<std::uint64_t>(__rdtsc());
+#else
+                return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+            }
+
+        protected:
+            /**
+             * \brief value used for the colour of a pixel
+             */
+            static double scale(const double value, const bool logarithmic) noexcept
+            {
+                return logarithmic ? std::log1p(value) : value;
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD unsigned int get_width() const noexcept { return width_; }
+            NODISCARD unsigned int get_height() const noexcept { return height_; }
+            NODISCARD std::size_t size() const noexcept { return values_[0].size(); }
+            NODISCARD bool empty() const noexcept { return values_[0].empty(); }
+
+            /**
+             * \brief gets every value of a channel
+             * \param counted channel
+             * \return values, pixel y * width + x
+             */
+            NODISCARD const std::vector<std::uint64_t>& get_values(const channel counted) const noexcept
+            {
+                return values_[static_cast<std::size_t>(counted)];
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/low_discrepancy.h"
+#include "BardCore/utility/ray_queue.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief pattern of the samples inside a pixel
+         */
+        enum class sample_pattern
+        {
+            stratified, // center of every stratum, the same in every pixel
+            jittered, // random position inside every stratum, different in every pixel
+            blue_noise, // center of every stratum, shifted per pixel by a dither that spreads the error as blue noise
+            sobol, // Sobol sequence, Owen scrambled per pixel
+            halton, // Halton sequence in base 2 and 3, shifted per pixel by the blue noise dither
+            r2 // R2 sequence, shifted per pixel by the blue noise dither
+        };
+
+        /**
+         * \brief generates several primary rays per pixel at subpixel positions, for antialiasing
+         *
+         * the stratified patterns split the pixel in columns x rows strata, columns = ceil(sqrt(samples)) and
+         * rows = ceil(samples / columns), sample s lies in stratum (s % columns, s / columns). the sequence patterns
+         * use sample s of a low discrepancy sequence. the randomness per pixel is a hash of the pixel, the sample and
+         * a seed instead of a random number generator, so the rays are reproducible and the loops stay branch free
+         */
+        class pixel_sampler
+        {
+        protected:
+            unsigned int samples_per_pixel_; // amount of samples in every pixel
+            sample_pattern pattern_; // pattern of the samples
+            unsigned int columns_, rows_; // amount of strata in x and y
+
+            sobol_sequence sobol_{}; // unscrambled Sobol sequence, the scrambling is per pixel
+            halton_sequence halton_{}; // Halton sequence
+            r2_sequence r2_{}; // R2 sequence, its alpha is the dither of a pixel too
+
+        public:
+            /**
+             * \brief constructor for pixel_sampler
+             * \throws zero_exception if samples_per_pixel is zero
+             * \param samples_per_pixel amount of samples in every pixel
+             * \param pattern pattern of the samples, stratified by default
+             */
+            explicit pixel_sampler(const unsigned int samples_per_pixel,
+                                   const sample_pattern pattern = sample_pattern::stratified) :
+                samples_per_pixel_(samples_per_pixel), pattern_(pattern), columns_(0), rows_(0)
+            {
+                if (samples_per_pixel == 0)
+                    throw exception::zero_exception("samples per pixel must be greater than 0");
+
+                columns_ = static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<double>(samples_per_pixel))));
+                rows_ = (samples_per_pixel + columns_ - 1) / columns_;
+            }
+
+            /**
+             * \brief gets the position of a sample inside a pixel, the same position shoot_rays uses
+             * \param x x position of the pixel on the screen
+             * \param y y position of the pixel on the screen
+             * \param sample index of the sample
+             * \param seed seed of the randomness per pixel, e.g. the frame number
+             * \param offset_x x position inside the pixel, in the range [0, 1)
+             * \param offset_y y position inside the pixel, in the range [0, 1)
+             */
+            void sample_offset(const unsigned int x, const unsigned int y, const unsigned int sample,
+                               const std::uint32_t seed, double& offset_x, double& offset_y) const noexcept
+            {
+                double base_x = 0, base_y = 0;
+                sample_base(sample, base_x, base_y);
+
+                switch (pattern_)
+                {
+                case sample_pattern::stratified:
+                    offset_x = base_x;
+                    offset_y = base_y;
+                    break;
+                case sample_pattern::jittered:
+                    jitter(math::hash(row_key(y, sample, seed) + x), base_x, base_y, offset_x, offset_y);
+                    break;
+                case sample_pattern::sobol:
+                    scramble(math::hash(row_key(y, 0, seed) + x), sobol_.sample_bits(sample, 0),
+                             sobol_.sample_bits(sample, 1), offset_x, offset_y);
+                    break;
+                case sample_pattern::blue_noise:
+                case sample_pattern::halton:
+                case sample_pattern::r2:
+                    dither(static_cast<double>(x), static_cast<double>(y), seed, base_x, base_y, offset_x, offset_y);
+                    break;
+                }
+            }
+
+            /**
+             * \brief shoot samples_per_pixel rays from a camera through every pixel on the screen
+             *
+             * the queue is overwritten, ray i is sample i / (width * height) of pixel i % (width * height), so every
+             * sample forms a full screen of rays in the same order as camera::shoot_rays. the pixel array holds the
+             * pixel and the throughput is 1 / samples_per_pixel, so the samples of a pixel add up to its average
+             * \note the amount of pixels must fit in 32 bits
+             * \throws negative_exception if distance is negative
+             * \param camera camera to shoot the rays from
+             * \param queue queue to write the rays to
+             * \param distance distance of the rays
+             * \param seed seed of the randomness per pixel, e.g. the frame number
+             */
+            void shoot_rays(const camera& camera, ray_queue& queue, const double distance,
+                            const std::uint32_t seed = 0) const
+            {
+                if (distance < 0)
+                    throw exception::negative_exception("distance can't be negative");
+
+                const unsigned int width = camera.get_screen_width();
+                const unsigned int height = camera.get_screen_height();
+                const std::size_t pixel_count = static_cast<std::size_t>(width) * height;
+                queue.resize(pixel_count * samples_per_pixel_);
+
+                //step from one pixel to the next on the screen
+                const vector3d step_horizontal = camera.get_half_horizontal() * 2 / static_cast<double>(width);
+                const vector3d step_vertical = camera.get_half_vertical() * 2 / static_cast<double>(height);
+                const vector3d corner = camera.get_position().get_vector(camera.get_top_left());
+                const point3d& position = camera.get_position();
+                const double weight = 1. / samples_per_pixel_;
+
+                double* origin_x = queue.origin.x();
+                double* origin_y = queue.origin.y();
+                double* origin_z = queue.origin.z();
+                double* direction_x = queue.direction.x();
+                double* direction_y = queue.direction.y();
+                double* direction_z = queue.direction.z();
+                double* length = queue.distance.data();
+                std::uint32_t* pixel = queue.pixel.data();
+                double* throughput = queue.throughput.data();
+                std::uint32_t* depth = queue.depth.data();
+
+                //subpixel position of every pixel in a row, calculated per row so the ray loop doesn't branch
+                std::vector<double> offsets_x(width), offsets_y(width);
+                double* offset_x = offsets_x.data();
+                double* offset_y = offsets_y.data();
+
+                for (unsigned int sample = 0; sample < samples_per_pixel_; ++sample)
+                {
+                    for (unsigned int y = 0; y < height; ++y)
+                    {
+                        row_offsets(y, sample, seed, width, offset_x, offset_y);
+
+                        const vector3d row = corner - step_vertical * static_cast<double>(y);
+                        const std::size_t offset = sample * pixel_count + static_cast<std::size_t>(y) * width;
+                        const std::size_t pixel_offset = static_cast<std::size_t>(y) * width;
+
+                        VECTORIZE
+                        for (unsigned int x = 0; x < width; ++x)
+                        {
+                            const double fx = static_cast<double>(x) + offset_x[x];
+                            const double fy = offset_y[x];
+                            const double vx = row.x + step_horizontal.x * fx - step_vertical.x * fy;
+                            const double vy = row.y + step_horizontal.y * fx - step_vertical.y * fy;
+                            const double vz = row.z + step_horizontal.z * fx - step_vertical.z * fy;
+                            const double inverse_length = 1. / std::sqrt(vx * vx + vy * vy + vz * vz);
+
+                            origin_x[offset + x] = position.x;
+                            origin_y[offset + x] = position.y;
+                            origin_z[offset + x] = position.z;
+                            direction_x[offset + x] = vx * inverse_length;
+                            direction_y[offset + x] = vy * inverse_length;
+                            direction_z[offset + x] = vz * inverse_length;
+                            length[offset + x] = distance;
+                            pixel[offset + x] = static_cast<std::uint32_t>(pixel_offset + x);
+                            throughput[offset + x] = weight;
+                            depth[offset + x] = 0;
+                        }
+                    }
+                }
+            }
+
+        protected:
+            /**
+             * \brief calculates the subpixel position of one sample for every pixel in a row
+             */
+            void row_offsets(const unsigned int y, const unsigned int sample, const std::uint32_t seed,
+                             const unsigned int width, double* offset_x, double* offset_y) const noexcept
+            {
+                double base_x = 0, base_y = 0;
+                sample_base(sample, base_x, base_y);
+
+                switch (pattern_)
+                {
+                case sample_pattern::stratified:
+                    {
+                        for (unsigned int x = 0; x < width; ++x)
+                        {
+                            offset_x[x] = base_x;
+                            offset_y[x] = base_y;
+                        }
+                        break;
+                    }
+                case sample_pattern::jittered:
+                    {
+                        const std::uint32_t key = row_key(y, sample, seed);
+
+                        VECTORIZE
+                        for (unsigned int x = 0; x < width; ++x)
+                            jitter(math::hash(key + x), base_x, base_y, offset_x[x], offset_y[x]);
+                        break;
+                    }
+                case sample_pattern::sobol:
+                    {
+                        //the scramble of a pixel is the same for all of its samples, so they stay stratified
+                        const std::uint32_t key = row_key(y, 0, seed);
+                        const std::uint32_t bits_x = sobol_.sample_bits(sample, 0);
+                        const std::uint32_t bits_y = sobol_.sample_bits(sample, 1);
+
+                        VECTORIZE
+                        for (unsigned int x = 0; x < width; ++x)
+                            scramble(math::hash(key + x), bits_x, bits_y, offset_x[x], offset_y[x]);
+                        break;
+                    }
+                case sample_pattern::blue_noise:
+                case sample_pattern::halton:
+                case sample_pattern::r2:
+                    {
+                        const double pixel_y = static_cast<double>(y);
+
+                        VECTORIZE
+                        for (unsigned int x = 0; x < width; ++x)
+                            dither(static_cast<double>(x), pixel_y, seed, base_x, base_y, offset_x[x], offset_y[x]);
+                        break;
+                    }
+                }
+            }
+
+            /**
+             * \brief position of a sample before the randomization per pixel, the center of its stratum, the corner of
+             * its stratum for jittered patterns, or the sample of the sequence
+             */
+            void sample_base(const unsigned int sample, double& base_x, double& base_y) const noexcept
+            {
+                const double column = static_cast<double>(sample % columns_);
+                const double row = static_cast<double>(sample / columns_);
+                const double center = pattern_ == sample_pattern::jittered ? 0 : 0.5;
+
+                base_x = (column + center) / columns_;
+                base_y = (row + center) / rows_;
+
+                if (pattern_ == sample_pattern::halton)
+                {
+                    base_x = halton_.sample(sample, 0);
+                    base_y = halton_.sample(sample, 1);
+                }
+                else if (pattern_ == sample_pattern::r2)
+                {
+                    base_x = r2_.sample(sample, 0);
+                    base_y = r2_.sample(sample, 1);
+                }
+            }
+
+            /**
+             * \brief hash of a row, a sample and a seed, math::hash(row_key + x) is the randomness of pixel x
+             */
+            NODISCARD static std::uint32_t row_key(const unsigned int y, const unsigned int sample,
+                                                   const std::uint32_t seed) noexcept
+            {
+                //the golden ratio keeps the first pixel of seed 0 from hashing to 0
+                return math::hash(y + math::hash(sample + math::hash(seed ^ 0x9E3779B9u)));
+            }
+
+            /**
+             * \brief random position inside a stratum, the high and low 16 bits of the hash are the x and y position
+             */
+            void jitter(const std::uint32_t hash, const double corner_x, const double corner_y, double& offset_x,
+                        double& offset_y) const noexcept
+            {
+                //through int32 so the conversion to double can be vectorized
+                const double random_x = static_cast<double>(static_cast<std::int32_t>(hash >> 16)) / 65536.;
+                const double random_y = static_cast<double>(static_cast<std::int32_t>(hash & 0xFFFF)) / 65536.;
+
+                offset_x = corner_x + random_x / columns_;
+                offset_y = corner_y + random_y / rows_;
+            }
+
+            /**
+             * \brief Owen scrambles a Sobol sample with the hash of a pixel
+             */
+            static void scramble(const std::uint32_t hash, const std::uint32_t bits_x, const std::uint32_t bits_y,
+                                 double& offset_x, double& offset_y) noexcept
+            {
+                offset_x = math::to_unit_interval(sobol_sequence::owen_scramble(bits_x, hash));
+                offset_y = math::to_unit_interval(sobol_sequence::owen_scramble(bits_y, math::hash(hash)));
+            }
+
+            /**
+             * \brief shifts a sample (wrapped around the pixel) by the R2 dither of the pixel
+             * \note every sample of a pixel is shifted by the same amount, so the samples stay stratified
+             */
+            void dither(const double x, const double y, const std::uint32_t seed, const double base_x,
+                        const double base_y, double& offset_x, double& offset_y) const noexcept
+            {
+                const double r2_x = r2_.get_alpha(0);
+                const double r2_y = r2_.get_alpha(1);
+                const double shift_x = fraction(x * r2_x + y * r2_y + static_cast<double>(seed) * r2_x);
+                const double shift_y = fraction(x * r2_y + y * r2_x + static_cast<double>(seed) * r2_y);
+
+                offset_x = fraction(base_x + shift_x);
+                offset_y = fraction(base_y + shift_y);
+            }
+
+            /**
+             * \brief fractional part of a positive value
+             */
+            NODISCARD static double fraction(const double value) noexcept { return value - std::floor(value); }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD unsigned int get_samples_per_pixel() const noexcept { return samples_per_pixel_; }
+            NODISCARD sample_pattern get_pattern() const noexcept { return pattern_; }
+            NODISCARD unsigned int get_columns() const noexcept { return columns_; }
+            NODISCARD unsigned int get_rows() const noexcept { return rows_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/hemisphere.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief random number generator with several lanes of xoshiro128** side by side
+         *
+         * the state of every lane is stored as a structure of arrays, one step of all lanes is a loop of 32 bit
+         * shifts, xors and multiplications that vectorizes, so one call produces lanes numbers at about the cost of
+         * one. a seed and a stream number give a reproducible sequence, different streams are independent, e.g. use
+         * the thread index or the pixel index as stream
+         * \note read more at: https://prng.di.unimi.it/
+         * \note this is not a cryptographic random number generator
+         */
+        class random_stream
+        {
+        public:
+            /**
+             * \brief amount of numbers produced per step
+             */
+            INLINE static constexpr std::size_t lanes = 8;
+
+        protected:
+            std::array<std::uint32_t, lanes> s0_{}, s1_{}, s2_{}, s3_{}; // state of every lane
+            std::array<std::uint32_t, lanes> buffer_{}; // numbers of the last step, for the single number functions
+            std::size_t used_ = lanes; // amount of numbers in the buffer that are used
+
+        public:
+            /**
+             * \brief constructor for random_stream
+             * \param seed seed of the stream
+             * \param stream number of the stream, e.g. a thread or pixel index, every stream has its own sequence
+             */
+            explicit random_stream(const std::uint64_t seed, const std::uint64_t stream = 0)
+            {
+                //splitmix64 spreads the seed and stream over the state, different streams never share a state
+                std::uint64_t state = split_mix(seed) ^ split_mix(stream + 0x632BE59BD9B4E019ull);
+                for (std::size_t lane = 0; lane < lanes; ++lane)
+                {
+                    const std::uint64_t first = split_mix(state += 0x9E3779B97F4A7C15ull);
+                    const std::uint64_t second = split_mix(state += 0x9E3779B97F4A7C15ull);
+
+                    s0_[lane] = static_cast<std::uint32_t>(first);
+                    s1_[lane] = static_cast<std::uint32_t>(first >> 32);
+                    s2_[lane] = static_cast<std::uint32_t>(second);
+                    s3_[lane] = static_cast<std::uint32_t>(second >> 32) | 1u; //the state must not be all zero
+                }
+            }
+
+            /**
+             * \brief steps every lane once
+             * \param result random 32 bit number of every lane, must have room for lanes values
+             */
+            void next(std::uint32_t* result) noexcept
+            {
+                std::uint32_t* s0 = s0_.data();
+                std::uint32_t* s1 = s1_.data();
+                std::uint32_t* s2 = s2_.data();
+                std::uint32_t* s3 = s3_.data();
+
+                VECTORIZE
+                for (std::size_t lane = 0; lane < lanes; ++lane)
+                {
+                    result[lane] = rotate_left(s1[lane] * 5, 7) * 9;
+
+                    const std::uint32_t t = s1[lane] << 9;
+                    s2[lane] ^= s0[lane];
+                    s3[lane] ^= s1[lane];
+                    s1[lane] ^= s2[lane];
+                    s0[lane] ^= s3[lane];
+                    s2[lane] ^= t;
+                    s3[lane] = rotate_left(s3[lane], 11);
+                }
+            }
+
+            /**
+             * \brief uniform double
+             * \return random number in the range [0, 1), with 31 bits of precision
+             */
+            NODISCARD double uniform() noexcept { return math::to_unit_interval(next_single()); }
+
+            /**
+             * \brief uniform float
+             * \return random number in the range [0, 1), with 24 bits of precision
+             */
+            NODISCARD float uniform_float() noexcept { return to_float(next_single()); }
+
+            /**
+             * \brief fills an array with uniform doubles, lanes at a time
+             * \note a batch always uses whole steps, the numbers of the last step that don't fit are dropped
+             * \param result random numbers in the range [0, 1), must have room for count values
+             * \param count amount of numbers
+             */
+            void uniform(double* result, const std::size_t count) noexcept
+            {
+                std::uint32_t bits[lanes];
+                for (std::size_t begin = 0; begin < count; begin += lanes)
+                {
+                    next(bits);
+
+                    const std::size_t size = count - begin < lanes ? count - begin : lanes;
+                    double* block = result + begin;
+                    for (std::size_t index = 0; index < size; ++index)
+                        block[index] = math::to_unit_interval(bits[index]);
+                }
+            }
+
+            /**
+             * \brief fills an array with uniform floats, lanes at a time
+             * \note a batch always uses whole steps, the numbers of the last step that don't fit are dropped
+             * \param result random numbers in the range [0, 1), must have room for count values
+             * \param count amount of numbers
+             */
+            void uniform(float* result, const std::size_t count) noexcept
+            {
+                std::uint32_t bits[lanes];
+                for (std::size_t begin = 0; begin < count; begin += lanes)
+                {
+                    next(bits);
+
+                    const std::size_t size = count - begin < lanes ? count - begin : lanes;
+                    float* block = result + begin;
+                    for (std::size_t index = 0; index < size; ++index)
+                        block[index] = to_float(bits[index]);
+                }
+            }
+
+            /**
+             * \brief random direction, uniform on the unit sphere
+             * \return normalized direction
+             */
+            NODISCARD vector3d unit_vector() noexcept
+            {
+                const double u = uniform();
+                const double v = uniform();
+                const double z = 1 - 2 * u;
+                const double radius = std::sqrt(1 - z * z);
+                const double angle = math::_2pi * v;
+
+                return {radius * std::cos(angle), radius * std::sin(angle), z};
+            }
+
+            /**
+             * \brief random directions, uniform on the unit sphere
+             * \param count amount of directions
+             * \param directions normalized direction of every sample, resized to count
+             */
+            void unit_vectors(const std::size_t count, dimension3_soa<vector3d>& directions)
+            {
+                directions.resize(count);
+
+                double u[block_size], v[block_size];
+                const double two_pi = math::_2pi;
+                for (std::size_t begin = 0; begin < count; begin += block_size)
+                {
+                    const std::size_t size = count - begin < block_size ? count - begin : block_size;
+                    uniform(u, size);
+                    uniform(v, size);
+
+                    double* x = directions.x() + begin;
+                    double* y = directions.y() + begin;
+                    double* z = directions.z() + begin;
+
+                    VECTORIZE
+                    for (std::size_t index = 0; index < size; ++index)
+                    {
+                        const double height = 1 - 2 * u[index];
+                        const double radius = std::sqrt(1 - height * height);
+                        const double angle = two_pi * v[index];
+
+                        x[index] = radius * std::cos(angle);
+                        y[index] = radius * std::sin(angle);
+                        z[index] = height;
+                    }
+                }
+            }
+
+            /**
+             * \brief random direction, cosine weighted around the normal of a hemisphere
+             * \param hemisphere hemisphere to sample
+             * \return normalized direction
+             */
+            NODISCARD vector3d cosine_direction(const hemisphere& hemisphere) noexcept
+            {
+                const double u = uniform();
+                const double v = uniform();
+                return hemisphere.cosine_sample(u, v);
+            }
+
+            /**
+             * \brief random directions, cosine weighted around the normal of a hemisphere
+             * \param hemisphere hemisphere to sample
+             * \param count amount of directions
+             * \param directions normalized direction of every sample, resized to count
+             */
+            void cosine_directions(const hemisphere& hemisphere, const std::size_t count,
+                                   dimension3_soa<vector3d>& directions)
+            {
+                directions.resize(count);
+
+                double u[block_size], v[block_size];
+                for (std::size_t begin = 0; begin < count; begin += block_size)
+                {
+                    const std::size_t size = count - begin < block_size ? count - begin : block_size;
+                    uniform(u, size);
+                    uniform(v, size);
+
+                    hemisphere.cosine_samples(u, v, size, directions.x() + begin, directions.y() + begin,
+                                              directions.z() + begin);
+                }
+            }
+
+        protected:
+            INLINE static constexpr std::size_t block_size = 64; // amount of directions calculated at a time
+
+            /**
+             * \brief next number of the buffer, steps every lane when it is used up
+             */
+            std::uint32_t next_single() noexcept
+            {
+                if (used_ == lanes)
+                {
+                    next(buffer_.data());
+                    used_ = 0;
+                }
+
+                return buffer_[used_++];
+            }
+
+            /**
+             * \brief converts the upper 24 bits to a float in the range [0, 1)
+             */
+            NODISCARD static float to_float(const std::uint32_t value) noexcept
+            {
+                return static_cast<float>(static_cast<std::int32_t>(value >> 8)) / 16777216.f;
+            }
+
+            NODISCARD static std::uint32_t rotate_left(const std::uint32_t value, const int count) noexcept
+            {
+                return (value << count) | (value >> (32 - count));
+            }
+
+            /**
+             * \brief splitmix64 mix function, read more at: https://prng.di.unimi.it/splitmix64.c
+             */
+            NODISCARD static std::uint64_t split_mix(std::uint64_t value) noexcept
+            {
+                value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+                value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+                return value ^ (value >> 31);
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
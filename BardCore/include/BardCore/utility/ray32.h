@@ -0,0 +1,268 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/ray.h"
+#include "BardCore/utility/ray_queue.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief compact queue of rays in single precision, structure of arrays layout, used by traversal kernels
+         *
+         * a ray is 36 bytes: a float origin, a float normalized direction, a float tmin and tmax and an id with the
+         * pixel and the sample packed in 32 bits, ray_queue needs 72 bytes for a ray. the float origin is rounded,
+         * the conversions from ray and ray_queue add that rounding error to tmin, so a ray never hits anything behind
+         * its original origin
+         * \note a traversal kernel accepts a hit at t when tmin < t < tmax and shrinks tmax to the closest hit
+         */
+        class ray32_queue
+        {
+        public:
+            /**
+             * \brief amount of bits of the id used for the pixel, the other bits are the sample
+             */
+            INLINE static constexpr std::uint32_t pixel_bits = 24;
+
+            /**
+             * \brief largest pixel that fits in an id, 16777215 (e.g. 4096 x 4096 pixels)
+             */
+            INLINE static constexpr std::uint32_t max_pixel = (1u << pixel_bits) - 1;
+
+            /**
+             * \brief largest sample that fits in an id, 255
+             */
+            INLINE static constexpr std::uint32_t max_sample = (1u << (32 - pixel_bits)) - 1;
+
+            /**
+             * \brief position of every ray
+             */
+            std::vector<float> origin_x, origin_y, origin_z;
+
+            /**
+             * \brief normalized direction of every ray
+             */
+            std::vector<float> direction_x, direction_y, direction_z;
+
+            /**
+             * \brief hits closer than tmin are ignored, e.g. so a ray doesn't hit the surface it starts on
+             */
+            std::vector<float> tmin;
+
+            /**
+             * \brief hits further than tmax are ignored, traversal kernels shrink it to the closest hit
+             */
+            std::vector<float> tmax;
+
+            /**
+             * \brief pixel and sample of every ray, see pack_id
+             */
+            std::vector<std::uint32_t> id;
+
+        public:
+            NODISCARD std::size_t size() const noexcept { return tmax.size(); }
+            NODISCARD bool empty() const noexcept { return tmax.empty(); }
+
+            /**
+             * \brief resizes all arrays
+             * \param count new amount of rays
+             */
+            void resize(const std::size_t count)
+            {
+                origin_x.resize(count);
+                origin_y.resize(count);
+                origin_z.resize(count);
+                direction_x.resize(count);
+                direction_y.resize(count);
+                direction_z.resize(count);
+                tmin.resize(count);
+                tmax.resize(count);
+                id.resize(count);
+            }
+
+            /**
+             * \brief reserves memory in all arrays
+             * \param count amount of rays to reserve
+             */
+            void reserve(const std::size_t count)
+            {
+                origin_x.reserve(count);
+                origin_y.reserve(count);
+                origin_z.reserve(count);
+                direction_x.reserve(count);
+                direction_y.reserve(count);
+                direction_z.reserve(count);
+                tmin.reserve(count);
+                tmax.reserve(count);
+                id.reserve(count);
+            }
+
+            /**
+             * \brief removes all rays, memory is kept
+             */
+            void clear() noexcept
+            {
+                origin_x.clear();
+                origin_y.clear();
+                origin_z.clear();
+                direction_x.clear();
+                direction_y.clear();
+                direction_z.clear();
+                tmin.clear();
+                tmax.clear();
+                id.clear();
+            }
+
+            /**
+             * \brief converts a ray and adds it to the end of the queue
+             * \throws out_of_range_exception if pixel or sample doesn't fit in an id
+             * \param ray ray to add, tmax is its distance
+             * \param pixel pixel the ray contributes to
+             * \param sample sample of the pixel the ray belongs to
+             * \param min_distance hits closer than this are ignored, the rounding error of the origin is added to it
+             */
+            void push_back(const ray& ray, const std::uint32_t pixel = 0, const std::uint32_t sample = 0,
+                           const double min_distance = 0)
+            {
+                const point3d& position = ray.get_position();
+                const vector3d& direction = ray.get_direction();
+                const std::uint32_t packed = pack_id(pixel, sample);
+
+                origin_x.push_back(static_cast<float>(position.x));
+                origin_y.push_back(static_cast<float>(position.y));
+                origin_z.push_back(static_cast<float>(position.z));
+                direction_x.push_back(static_cast<float>(direction.x));
+                direction_y.push_back(static_cast<float>(direction.y));
+                direction_z.push_back(static_cast<float>(direction.z));
+                tmin.push_back(static_cast<float>(min_distance + rounding_error(position.x, position.y, position.z)));
+                tmax.push_back(static_cast<float>(ray.get_distance()));
+                id.push_back(packed);
+            }
+
+            /**
+             * \brief overwrites the queue with the rays of a ray_queue, converted to single precision
+             *
+             * ray i gets the origin, direction and distance (as tmax) of ray i of rays, and the id of its pixel and
+             * sample
+             * \note the conversion is one branch free loop, only the ids are checked
+             * \throws out_of_range_exception if a pixel or the sample doesn't fit in an id
+             * \param rays rays to convert, with normalized directions
+             * \param sample sample every ray belongs to, e.g. the sample of pixel_sampler
+             * \param min_distance hits closer than this are ignored, the rounding error of the origin is added to it
+             */
+            void assign(const ray_queue& rays, const std::uint32_t sample = 0, const double min_distance = 0)
+            {
+                const std::size_t count = rays.size();
+                for (std::size_t index = 0; index < count; ++index)
+                    if (rays.pixel[index] > max_pixel)
+                        throw exception::out_of_range_exception("pixel doesn't fit in the id of a ray32_queue");
+                if (sample > max_sample)
+                    throw exception::out_of_range_exception("sample doesn't fit in the id of a ray32_queue");
+
+                resize(count);
+
+                const double* source_origin_x = rays.origin.x();
+                const double* source_origin_y = rays.origin.y();
+                const double* source_origin_z = rays.origin.z();
+                const double* source_direction_x = rays.direction.x();
+                const double* source_direction_y = rays.direction.y();
+                const double* source_direction_z = rays.direction.z();
+                const double* distance = rays.distance.data();
+                const std::uint32_t* pixel = rays.pixel.data();
+                float* target_origin_x = origin_x.data();
+                float* target_origin_y = origin_y.data();
+                float* target_origin_z = origin_z.data();
+                float* target_direction_x = direction_x.data();
+                float* target_direction_y = direction_y.data();
+                float* target_direction_z = direction_z.data();
+                float* target_tmin = tmin.data();
+                float* target_tmax = tmax.data();
+                std::uint32_t* target_id = id.data();
+                const std::uint32_t sample_bits = sample << pixel_bits;
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double x = source_origin_x[index];
+                    const double y = source_origin_y[index];
+                    const double z = source_origin_z[index];
+
+                    target_origin_x[index] = static_cast<float>(x);
+                    target_origin_y[index] = static_cast<float>(y);
+                    target_origin_z[index] = static_cast<float>(z);
+                    target_direction_x[index] = static_cast<float>(source_direction_x[index]);
+                    target_direction_y[index] = static_cast<float>(source_direction_y[index]);
+                    target_direction_z[index] = static_cast<float>(source_direction_z[index]);
+                    target_tmin[index] = static_cast<float>(min_distance + rounding_error(x, y, z));
+                    target_tmax[index] = static_cast<float>(distance[index]);
+                    target_id[index] = sample_bits | pixel[index];
+                }
+            }
+
+            /**
+             * \brief gets a ray from the queue, converted back to double precision
+             * \throws zero_exception if the direction of the ray is zero
+             * \throws negative_exception if tmax of the ray is negative
+             * \param index index of the ray
+             * \return ray at index, its distance is tmax
+             */
+            NODISCARD ray get_ray(const std::size_t index) const
+            {
+                return {
+                    point3d(origin_x[index], origin_y[index], origin_z[index]),
+                    vector3d(direction_x[index], direction_y[index], direction_z[index]), tmax[index]
+                };
+            }
+
+            /**
+             * \brief packs a pixel and a sample in an id
+             * \throws out_of_range_exception if pixel is greater than max_pixel or sample is greater than max_sample
+             * \param pixel pixel (y * width + x)
+             * \param sample sample of the pixel
+             * \return id with the sample in the upper 8 bits and the pixel in the lower 24 bits
+             */
+            NODISCARD static std::uint32_t pack_id(const std::uint32_t pixel, const std::uint32_t sample)
+            {
+                if (pixel > max_pixel)
+                    throw exception::out_of_range_exception("pixel doesn't fit in the id of a ray32_queue");
+                if (sample > max_sample)
+                    throw exception::out_of_range_exception("sample doesn't fit in the id of a ray32_queue");
+
+                return sample << pixel_bits | pixel;
+            }
+
+            /**
+             * \brief gets the pixel of an id
+             * \param id id of a ray
+             * \return pixel (y * width + x)
+             */
+            NODISCARD static std::uint32_t get_pixel(const std::uint32_t id) noexcept { return id & max_pixel; }
+
+            /**
+             * \brief gets the sample of an id
+             * \param id id of a ray
+             * \return sample of the pixel
+             */
+            NODISCARD static std::uint32_t get_sample(const std::uint32_t id) noexcept { return id >> pixel_bits; }
+
+        protected:
+            /**
+             * \brief upper bound of the distance between an origin and its float version, half an ulp per coordinate
+             */
+            NODISCARD static double rounding_error(const double x, const double y, const double z) noexcept
+            {
+                const double largest_xy = std::abs(x) > std::abs(y) ? std::abs(x) : std::abs(y);
+                const double largest = largest_xy > std::abs(z) ? largest_xy : std::abs(z);
+                return largest * std::numeric_limits<float>::epsilon();
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,346 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/ray.h"
+#include "BardCore/utility/ray_queue.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief sorts rays so that neighbouring rays are coherent, e.g. they take similar paths through a bvh
+         *
+         * every ray gets a key: its direction octant in the highest bits, followed by the morton code of its
+         * quantized position within the bounds of the batch. the keys are sorted with a stable radix sort,
+         * every pass of which is a parallel counting sort over 8 bits
+         * \note this is independent of any integrator, it only needs positions and directions
+         */
+        class ray_binning
+        {
+        protected:
+            unsigned int origin_bits_; // bits per axis of the quantized position
+            unsigned int threads_; // threads for the sort, 0 means parallel::hardware_threads()
+
+            std::vector<std::uint32_t> keys_{}, scratch_keys_{};
+            std::vector<std::size_t> permutation_{}, scratch_permutation_{};
+            std::vector<std::size_t> histograms_{};
+            ray_queue scratch_rays_{};
+
+            /**
+             * \brief bits sorted per counting sort pass
+             */
+            INLINE static constexpr unsigned int digit_bits = 8;
+
+        public:
+            /**
+             * \brief maximum bits per axis, 3 octant bits + 3 * 9 position bits fit in 32 bits
+             */
+            INLINE static constexpr unsigned int max_origin_bits = 9;
+
+            /**
+             * \brief constructor for ray_binning
+             * \throws out_of_range_exception if origin_bits is greater than max_origin_bits
+             * \param origin_bits bits per axis of the quantized position, 0 only sorts by octant
+             * \param threads threads for the sort, 0 means parallel::hardware_threads()
+             */
+            explicit ray_binning(const unsigned int origin_bits = 6, const unsigned int threads = 0) :
+                origin_bits_(origin_bits), threads_(threads)
+            {
+                if (origin_bits > max_origin_bits)
+                    throw exception::out_of_range_exception("origin bits must be smaller or equal to 9");
+            }
+
+            /**
+             * \brief calculates the octant of a direction, bit 0, 1 and 2 are set if x, y or z is negative
+             * \param x direction x
+             * \param y direction y
+             * \param z direction z
+             * \return octant between 0 and 7
+             */
+            NODISCARD constexpr static std::uint32_t octant(const double x, const double y, const double z) noexcept
+            {
+                return static_cast<std::uint32_t>(x < 0)
+                    | static_cast<std::uint32_t>(y < 0) << 1
+                    | static_cast<std::uint32_t>(z < 0) << 2;
+            }
+
+            /**
+             * \brief spreads the lower 10 bits of value so there are two zero bits between every bit
+             * \param value value to spread
+             * \return spread value
+             */
+            NODISCARD constexpr static std::uint32_t spread_bits(std::uint32_t value) noexcept
+            {
+                value &= 0x3ffu;
+                value = (value | value << 16) & 0x030000ffu;
+                value = (value | value << 8) & 0x0300f00fu;
+                value = (value | value << 4) & 0x030c30c3u;
+                value = (value | value << 2) & 0x09249249u;
+                return value;
+            }
+
+            /**
+             * \brief calculates the morton code (z-order curve) of a quantized position
+             * \note read more at: https://en.wikipedia.org/wiki/Z-order_curve
+             * \param x quantized x, 10 bits at most
+             * \param y quantized y, 10 bits at most
+             * \param z quantized z, 10 bits at most
+             * \return morton code, bits interleaved as ...zyxzyx
+             */
+            NODISCARD constexpr static std::uint32_t morton(const std::uint32_t x, const std::uint32_t y,
+                                                            const std::uint32_t z) noexcept
+            {
+                return spread_bits(x) | spread_bits(y) << 1 | spread_bits(z) << 2;
+            }
+
+            /**
+             * \brief calculates the key of every ray
+             * \param rays rays to calculate the keys of
+             * \return key of every ray
+             */
+            const std::vector<std::uint32_t>& compute_keys(const ray_queue& rays)
+            {
+                compute_keys(rays.size(), rays.origin.x(), rays.origin.y(), rays.origin.z(), rays.direction.x(),
+                             rays.direction.y(), rays.direction.z());
+                return keys_;
+            }
+
+            /**
+             * \brief calculates the key of every ray
+             * \param rays rays to calculate the keys of
+             * \return key of every ray
+             */
+            const std::vector<std::uint32_t>& compute_keys(const std::vector<ray>& rays)
+            {
+                dimension3_soa<point3d> origins(rays.size());
+                dimension3_soa<vector3d> directions(rays.size());
+                for (std::size_t index = 0; index < rays.size(); ++index)
+                {
+                    origins.set(index, rays[index].get_position());
+                    directions.set(index, rays[index].get_direction());
+                }
+
+                compute_keys(rays.size(), origins.x(), origins.y(), origins.z(), directions.x(), directions.y(),
+                             directions.z());
+                return keys_;
+            }
+
+            /**
+             * \brief calculates the coherent order of rays
+             * \param rays rays to sort
+             * \return permutation, the i-th ray of the coherent order is rays[permutation[i]]
+             */
+            const std::vector<std::size_t>& sort(const ray_queue& rays)
+            {
+                compute_keys(rays);
+                radix_sort();
+                return permutation_;
+            }
+
+            /**
+             * \brief calculates the coherent order of rays
+             * \param rays rays to sort
+             * \return permutation, the i-th ray of the coherent order is rays[permutation[i]]
+             */
+            const std::vector<std::size_t>& sort(const std::vector<ray>& rays)
+            {
+                compute_keys(rays);
+                radix_sort();
+                return permutation_;
+            }
+
+            /**
+             * \brief reorders rays into the coherent order
+             * \param rays rays to reorder
+             */
+            void apply(ray_queue& rays)
+            {
+                sort(rays);
+                scratch_rays_.gather(rays, permutation_.data(), permutation_.size());
+                rays.swap(scratch_rays_);
+            }
+
+            /**
+             * \brief reorders rays into the coherent order
+             * \param rays rays to reorder
+             */
+            void apply(std::vector<ray>& rays)
+            {
+                sort(rays);
+
+                std::vector<ray> sorted;
+                sorted.reserve(rays.size());
+                for (const std::size_t index : permutation_)
+                    sorted.push_back(rays[index]);
+
+                rays.swap(sorted);
+            }
+
+            /**
+             * \brief measures how coherent a batch is, the average dot product of the directions of neighbouring rays
+             * \note 1 means all neighbours have the same direction, -1 means all neighbours are opposite
+             * \param rays rays with normalized directions
+             * \return average dot product of neighbouring directions, 1 if there are less than 2 rays
+             */
+            NODISCARD static double coherence(const ray_queue& rays) noexcept
+            {
+                if (rays.size() < 2)
+                    return 1;
+
+                const double* x = rays.direction.x();
+                const double* y = rays.direction.y();
+                const double* z = rays.direction.z();
+
+                double sum = 0;
+                for (std::size_t index = 1; index < rays.size(); ++index)
+                    sum += x[index - 1] * x[index] + y[index - 1] * y[index] + z[index - 1] * z[index];
+
+                return sum / static_cast<double>(rays.size() - 1);
+            }
+
+        protected:
+            /**
+             * \brief calculates the keys, the position is quantized within the bounds of all positions
+             */
+            void compute_keys(const std::size_t count, const double* origin_x, const double* origin_y,
+                              const double* origin_z, const double* direction_x, const double* direction_y,
+                              const double* direction_z)
+            {
+                keys_.resize(count);
+                if (count == 0)
+                    return;
+
+                double min_x = origin_x[0], min_y = origin_y[0], min_z = origin_z[0];
+                double max_x = min_x, max_y = min_y, max_z = min_z;
+                for (std::size_t index = 1; index < count; ++index)
+                {
+                    min_x = std::min(min_x, origin_x[index]);
+                    min_y = std::min(min_y, origin_y[index]);
+                    min_z = std::min(min_z, origin_z[index]);
+                    max_x = std::max(max_x, origin_x[index]);
+                    max_y = std::max(max_y, origin_y[index]);
+                    max_z = std::max(max_z, origin_z[index]);
+                }
+
+                //scale positions to [0, 2^bits), a flat axis is always 0
+                const double cells = static_cast<double>(1u << origin_bits_);
+                const double largest = cells - 1;
+                const double scale_x = max_x > min_x ? cells / (max_x - min_x) : 0;
+                const double scale_y = max_y > min_y ? cells / (max_y - min_y) : 0;
+                const double scale_z = max_z > min_z ? cells / (max_z - min_z) : 0;
+                const unsigned int octant_shift = 3 * origin_bits_;
+
+                std::uint32_t* keys = keys_.data();
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double x = std::min((origin_x[index] - min_x) * scale_x, largest);
+                    const double y = std::min((origin_y[index] - min_y) * scale_y, largest);
+                    const double z = std::min((origin_z[index] - min_z) * scale_z, largest);
+
+                    keys[index] = octant(direction_x[index], direction_y[index], direction_z[index]) << octant_shift
+                        | morton(static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y),
+                                 static_cast<std::uint32_t>(z));
+                }
+            }
+
+            /**
+             * \brief stable lsd radix sort of keys_, every pass is a parallel counting sort over digit_bits
+             * \note writes the sorted order to permutation_, keys_ ends up sorted
+             */
+            void radix_sort()
+            {
+                const std::size_t count = keys_.size();
+                const std::size_t buckets = std::size_t{1} << digit_bits;
+                const unsigned int key_bits = 3 + 3 * origin_bits_;
+                const unsigned int chunks = parallel::thread_count(count, threads_);
+
+                permutation_.resize(count);
+                for (std::size_t index = 0; index < count; ++index)
+                    permutation_[index] = index;
+
+                scratch_keys_.resize(count);
+                scratch_permutation_.resize(count);
+
+                for (unsigned int shift = 0; shift < key_bits; shift += digit_bits)
+                {
+                    histograms_.assign(chunks * buckets, 0);
+
+                    //count the digits of every chunk
+                    parallel::for_each_chunk(count, chunks,
+                                             [this, shift, buckets](const unsigned int chunk, const std::size_t begin,
+                                                                    const std::size_t end)
+                                             {
+                                                 std::size_t* histogram = histograms_.data() + chunk * buckets;
+                                                 for (std::size_t index = begin; index < end; ++index)
+                                                     ++histogram[keys_[index] >> shift & (buckets - 1)];
+                                             });
+
+                    //exclusive prefix sum, digit major and chunk minor so the sort stays stable
+                    std::size_t offset = 0;
+                    for (std::size_t digit = 0; digit < buckets; ++digit)
+                    {
+                        for (unsigned int chunk = 0; chunk < chunks; ++chunk)
+                        {
+                            std::size_t& counter = histograms_[chunk * buckets + digit];
+                            const std::size_t amount = counter;
+                            counter = offset;
+                            offset += amount;
+                        }
+                    }
+
+                    //scatter every chunk to its own offsets
+                    parallel::for_each_chunk(count, chunks,
+                                             [this, shift, buckets](const unsigned int chunk, const std::size_t begin,
+                                                                    const std::size_t end)
+                                             {
+                                                 std::size_t* write = histograms_.data() + chunk * buckets;
+                                                 for (std::size_t index = begin; index < end; ++index)
+                                                 {
+                                                     const std::size_t position = write[keys_[index] >> shift & (
+                                                         buckets - 1)]++;
+                                                     scratch_keys_[position] = keys_[index];
+                                                     scratch_permutation_[position] = permutation_[index];
+                                                 }
+                                             });
+
+                    keys_.swap(scratch_keys_);
+                    permutation_.swap(scratch_permutation_);
+                }
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            /**
+             * \brief gets the keys of the last sort, in sorted order after sort() or apply()
+             * \return keys
+             */
+            NODISCARD const std::vector<std::uint32_t>& get_keys() const noexcept { return keys_; }
+
+            /**
+             * \brief gets the permutation of the last sort
+             * \return permutation, the i-th ray of the coherent order is rays[permutation[i]]
+             */
+            NODISCARD const std::vector<std::size_t>& get_permutation() const noexcept { return permutation_; }
+
+            NODISCARD unsigned int get_origin_bits() const noexcept { return origin_bits_; }
+            NODISCARD unsigned int get_threads() const noexcept { return threads_; }
+
+            /**
+             * \brief sets the amount of threads for the sort
+             * \param threads new amount of threads, 0 means parallel::hardware_threads()
+             */
+            void set_threads(const unsigned int threads) noexcept { threads_ = threads; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
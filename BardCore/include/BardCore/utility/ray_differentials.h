@@ -0,0 +1,324 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/ray_queue.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief ray differentials of a ray_queue, how the origin and direction of every ray change from one pixel to
+         * the next in x and y, e.g. to estimate the footprint of a ray for texture filtering or tessellation
+         *
+         * ray i of the queue has differentials i, they are kept in their own stream so rays that don't need them
+         * don't pay for them. camera::shoot_rays creates them, transfer, reflect and refract propagate them the way
+         * a hit, vector3d::reflection and vector3d::refraction move the ray itself
+         * \note read more at: https://graphics.stanford.edu/papers/trd/
+         */
+        class ray_differentials
+        {
+        public:
+            /**
+             * \brief change of the origin of every ray per pixel in x and y
+             */
+            dimension3_soa<vector3d> origin_dx, origin_dy;
+
+            /**
+             * \brief change of the normalized direction of every ray per pixel in x and y
+             */
+            dimension3_soa<vector3d> direction_dx, direction_dy;
+
+        public:
+            NODISCARD std::size_t size() const noexcept { return origin_dx.size(); }
+            NODISCARD bool empty() const noexcept { return origin_dx.empty(); }
+
+            /**
+             * \brief resizes all arrays, new differentials are zero
+             * \param count new amount of rays
+             */
+            void resize(const std::size_t count)
+            {
+                origin_dx.resize(count);
+                origin_dy.resize(count);
+                direction_dx.resize(count);
+                direction_dy.resize(count);
+            }
+
+            /**
+             * \brief removes all differentials, memory is kept
+             */
+            void clear() noexcept
+            {
+                origin_dx.clear();
+                origin_dy.clear();
+                direction_dx.clear();
+                direction_dy.clear();
+            }
+
+            /**
+             * \brief moves the origin differentials of every ray to its hit, the directions stay the same
+             * \note rays that hit nothing are not moved
+             * \throws out_of_range_exception if rays, hits and this have a different size
+             * \param rays rays the differentials belong to
+             * \param hits hit of every ray
+             */
+            void transfer(const ray_queue& rays, const hit_queue& hits)
+            {
+                check_size(rays, hits);
+                transfer_axis(rays, hits, origin_dx, direction_dx);
+                transfer_axis(rays, hits, origin_dy, direction_dy);
+            }
+
+            /**
+             * \brief changes the direction differentials of every ray to those of its reflection on a flat surface
+             * \note call transfer first, the reflection is d - 2 (d . n) n with the normal facing the ray
+             * \throws out_of_range_exception if rays, hits and this have a different size
+             * \param rays rays the differentials belong to, with their incoming direction
+             * \param hits hit of every ray
+             */
+            void reflect(const ray_queue& rays, const hit_queue& hits)
+            {
+                check_size(rays, hits);
+                bend<false, false>(rays, hits, nullptr, nullptr, nullptr);
+            }
+
+            /**
+             * \brief changes the direction differentials of every ray to those of its reflection on a curved surface
+             * \note call transfer first, the reflection is d - 2 (d . n) n with the normal facing the ray
+             * \throws out_of_range_exception if rays, hits, normal_dx, normal_dy and this have a different size
+             * \param rays rays the differentials belong to, with their incoming direction
+             * \param hits hit of every ray
+             * \param normal_dx change of the normal at every hit per pixel in x
+             * \param normal_dy change of the normal at every hit per pixel in y
+             */
+            void reflect(const ray_queue& rays, const hit_queue& hits, const dimension3_soa<vector3d>& normal_dx,
+                         const dimension3_soa<vector3d>& normal_dy)
+            {
+                check_size(rays, hits, normal_dx, normal_dy);
+                bend<false, true>(rays, hits, &normal_dx, &normal_dy, nullptr);
+            }
+
+            /**
+             * \brief changes the direction differentials of every ray to those of its refraction on a flat surface
+             * \note call transfer first, the refraction is the same as in wavefront: the ratio is 1 / refractive
+             * index when the ray enters the surface and the refractive index when it leaves it, total internal
+             * reflection gives the reflected differentials
+             * \throws out_of_range_exception if rays, hits and this have a different size
+             * \param rays rays the differentials belong to, with their incoming direction
+             * \param hits hit of every ray
+             * \param refractive_index refractive index of the surface of every hit, must have room for size() values
+             */
+            void refract(const ray_queue& rays, const hit_queue& hits, const double* refractive_index)
+            {
+                check_size(rays, hits);
+                bend<true, false>(rays, hits, nullptr, nullptr, refractive_index);
+            }
+
+            /**
+             * \brief changes the direction differentials of every ray to those of its refraction on a curved surface
+             * \note call transfer first, see refract(rays, hits, refractive_index)
+             * \throws out_of_range_exception if rays, hits, normal_dx, normal_dy and this have a different size
+             * \param rays rays the differentials belong to, with their incoming direction
+             * \param hits hit of every ray
+             * \param normal_dx change of the normal at every hit per pixel in x
+             * \param normal_dy change of the normal at every hit per pixel in y
+             * \param refractive_index refractive index of the surface of every hit, must have room for size() values
+             */
+            void refract(const ray_queue& rays, const hit_queue& hits, const dimension3_soa<vector3d>& normal_dx,
+                         const dimension3_soa<vector3d>& normal_dy, const double* refractive_index)
+            {
+                check_size(rays, hits, normal_dx, normal_dy);
+                bend<true, true>(rays, hits, &normal_dx, &normal_dy, refractive_index);
+            }
+
+            /**
+             * \brief width of the footprint of every ray at its origin, the longest origin differential
+             * \note after transfer this is the size of a pixel on the surface that was hit, e.g. to pick a mip level
+             * \param result footprint of every ray, resized to size()
+             */
+            void footprints(std::vector<double>& result) const
+            {
+                const std::size_t count = size();
+                result.resize(count);
+
+                const double* dx_x = origin_dx.x();
+                const double* dx_y = origin_dx.y();
+                const double* dx_z = origin_dx.z();
+                const double* dy_x = origin_dy.x();
+                const double* dy_y = origin_dy.y();
+                const double* dy_z = origin_dy.z();
+                double* footprint = result.data();
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double length_x = dx_x[index] * dx_x[index] + dx_y[index] * dx_y[index] + dx_z[index] *
+                        dx_z[index];
+                    const double length_y = dy_x[index] * dy_x[index] + dy_y[index] * dy_y[index] + dy_z[index] *
+                        dy_z[index];
+                    footprint[index] = std::sqrt(length_x > length_y ? length_x : length_y);
+                }
+            }
+
+        protected:
+            /**
+             * \brief checks that rays, hits and the differentials have the same size
+             */
+            void check_size(const ray_queue& rays, const hit_queue& hits) const
+            {
+                if (rays.size() != size() || hits.size() != size())
+                    throw exception::out_of_range_exception("rays, hits and differentials must have the same size");
+            }
+
+            void check_size(const ray_queue& rays, const hit_queue& hits, const dimension3_soa<vector3d>& normal_dx,
+                            const dimension3_soa<vector3d>& normal_dy) const
+            {
+                check_size(rays, hits);
+                if (normal_dx.size() != size() || normal_dy.size() != size())
+                    throw exception::out_of_range_exception("normal differentials must have the same size as the rays");
+            }
+
+            /**
+             * \brief moves one pair of origin and direction differentials to the hits
+             *
+             * the hit moves along the ray by dt = -((do + t * dd) . n) / (d . n), so do' = do + t * dd + dt * d
+             */
+            static void transfer_axis(const ray_queue& rays, const hit_queue& hits,
+                                      dimension3_soa<vector3d>& origins, const dimension3_soa<vector3d>& directions)
+            {
+                const std::size_t count = rays.size();
+                const std::uint32_t no_hit = hit_queue::no_hit;
+
+                const double* ray_x = rays.direction.x();
+                const double* ray_y = rays.direction.y();
+                const double* ray_z = rays.direction.z();
+                const double* hit_distance = hits.distance.data();
+                const std::uint32_t* primitive = hits.primitive.data();
+                const double* normal_x = hits.normal.x();
+                const double* normal_y = hits.normal.y();
+                const double* normal_z = hits.normal.z();
+                double* origin_x = origins.x();
+                double* origin_y = origins.y();
+                double* origin_z = origins.z();
+                const double* direction_x = directions.x();
+                const double* direction_y = directions.y();
+                const double* direction_z = directions.z();
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    //misses may have an infinite distance, don't move them
+                    const double t = primitive[index] != no_hit ? hit_distance[index] : 0;
+
+                    const double x = origin_x[index] + t * direction_x[index];
+                    const double y = origin_y[index] + t * direction_y[index];
+                    const double z = origin_z[index] + t * direction_z[index];
+
+                    //a ray parallel to the surface has no footprint on it, leave it on the ray
+                    const double cosine = ray_x[index] * normal_x[index] + ray_y[index] * normal_y[index] + ray_z[
+                        index] * normal_z[index];
+                    const double safe_cosine = cosine != 0 ? cosine : 1;
+                    const double projection = x * normal_x[index] + y * normal_y[index] + z * normal_z[index];
+                    const double dt = cosine != 0 ? -projection / safe_cosine : 0;
+
+                    origin_x[index] = x + dt * ray_x[index];
+                    origin_y[index] = y + dt * ray_y[index];
+                    origin_z[index] = z + dt * ray_z[index];
+                }
+            }
+
+            /**
+             * \brief changes both direction differentials to those of the reflection or refraction
+             *
+             * with the normal n facing the ray, c = -(d . n) and its change dc = -(dd . n + d . dn):
+             * the reflection d + 2c * n changes by dd + 2 (c * dn + dc * n), the refraction
+             * r * d + (r * c - sqrt(k)) * n with k = 1 - r^2 (1 - c^2) changes by
+             * r * dd + (r * c - sqrt(k)) * dn + (r - r^2 * c / sqrt(k)) * dc * n
+             * \tparam Refract true for the refraction, false for the reflection
+             * \tparam Curved true if the normal differentials are given, false for a flat surface
+             */
+            template <bool Refract, bool Curved>
+            void bend(const ray_queue& rays, const hit_queue& hits, const dimension3_soa<vector3d>* normal_dx,
+                      const dimension3_soa<vector3d>* normal_dy, const double* refractive_index)
+            {
+                bend_axis<Refract, Curved>(rays, hits, normal_dx, refractive_index, direction_dx);
+                bend_axis<Refract, Curved>(rays, hits, normal_dy, refractive_index, direction_dy);
+            }
+
+            /**
+             * \brief changes one direction differential to that of the reflection or refraction
+             */
+            template <bool Refract, bool Curved>
+            static void bend_axis(const ray_queue& rays, const hit_queue& hits,
+                                  const dimension3_soa<vector3d>* normals, const double* refractive_index,
+                                  dimension3_soa<vector3d>& directions)
+            {
+                const std::size_t count = rays.size();
+
+                const double* ray_x = rays.direction.x();
+                const double* ray_y = rays.direction.y();
+                const double* ray_z = rays.direction.z();
+                const double* hit_normal_x = hits.normal.x();
+                const double* hit_normal_y = hits.normal.y();
+                const double* hit_normal_z = hits.normal.z();
+                const double* normal_change_x = Curved ? normals->x() : nullptr;
+                const double* normal_change_y = Curved ? normals->y() : nullptr;
+                const double* normal_change_z = Curved ? normals->z() : nullptr;
+                double* direction_x = directions.x();
+                double* direction_y = directions.y();
+                double* direction_z = directions.z();
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double x = ray_x[index], y = ray_y[index], z = ray_z[index];
+                    const double ddx = direction_x[index], ddy = direction_y[index], ddz = direction_z[index];
+
+                    //flip the normal (and its change) to the side of the ray, like wavefront
+                    const double facing = x * hit_normal_x[index] + y * hit_normal_y[index] + z * hit_normal_z[index];
+                    const double side = facing > 0 ? -1. : 1.;
+                    const double nx = hit_normal_x[index] * side;
+                    const double ny = hit_normal_y[index] * side;
+                    const double nz = hit_normal_z[index] * side;
+                    const double dnx = Curved ? normal_change_x[index] * side : 0;
+                    const double dny = Curved ? normal_change_y[index] * side : 0;
+                    const double dnz = Curved ? normal_change_z[index] * side : 0;
+
+                    const double cosine = -(x * nx + y * ny + z * nz);
+                    const double cosine_change = -(ddx * nx + ddy * ny + ddz * nz + x * dnx + y * dny + z * dnz);
+
+                    //reflection
+                    double rx = ddx + 2 * (cosine * dnx + cosine_change * nx);
+                    double ry = ddy + 2 * (cosine * dny + cosine_change * ny);
+                    double rz = ddz + 2 * (cosine * dnz + cosine_change * nz);
+
+                    if (Refract)
+                    {
+                        const double ratio = facing > 0 ? refractive_index[index] : 1. / refractive_index[index];
+                        const double k = 1 - ratio * ratio * (1 - cosine * cosine);
+                        const double root = std::sqrt(k > 0 ? k : 0);
+                        const double safe_root = k > 0 ? root : 1;
+                        const double normal_factor = ratio * cosine - root;
+                        const double change_factor = (ratio - ratio * ratio * cosine / safe_root) * cosine_change;
+
+                        //total internal reflection keeps the reflection
+                        rx = k > 0 ? ratio * ddx + normal_factor * dnx + change_factor * nx : rx;
+                        ry = k > 0 ? ratio * ddy + normal_factor * dny + change_factor * ny : ry;
+                        rz = k > 0 ? ratio * ddz + normal_factor * dnz + change_factor * nz : rz;
+                    }
+
+                    direction_x[index] = rx;
+                    direction_y[index] = ry;
+                    direction_z[index] = rz;
+                }
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
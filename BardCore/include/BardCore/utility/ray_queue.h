@@ -0,0 +1,347 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/ray.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief queue of rays in structure of arrays layout, used by batch kernels
+         * \note unlike ray, the directions are not normalized for you, batch producers write normalized directions
+         */
+        class ray_queue
+        {
+        public:
+            /**
+             * \brief position of every ray
+             */
+            dimension3_soa<point3d> origin;
+
+            /**
+             * \brief normalized direction of every ray
+             */
+            dimension3_soa<vector3d> direction;
+
+            /**
+             * \brief distance of every ray, hits further away are ignored
+             */
+            std::vector<double> distance;
+
+            /**
+             * \brief pixel (y * width + x) every ray contributes to
+             */
+            std::vector<std::uint32_t> pixel;
+
+            /**
+             * \brief weight of every ray, e.g. the fraction of light that is left after bounces
+             */
+            std::vector<double> throughput;
+
+            /**
+             * \brief amount of bounces every ray has made
+             */
+            std::vector<std::uint32_t> depth;
+
+        public:
+            NODISCARD std::size_t size() const noexcept { return distance.size(); }
+            NODISCARD bool empty() const noexcept { return distance.empty(); }
+
+            /**
+             * \brief resizes all arrays
+             * \param count new amount of rays
+             */
+            void resize(const std::size_t count)
+            {
+                origin.resize(count);
+                direction.resize(count);
+                distance.resize(count);
+                pixel.resize(count);
+                throughput.resize(count);
+                depth.resize(count);
+            }
+
+            /**
+             * \brief reserves memory in all arrays
+             * \param count amount of rays to reserve
+             */
+            void reserve(const std::size_t count)
+            {
+                origin.reserve(count);
+                direction.reserve(count);
+                distance.reserve(count);
+                pixel.reserve(count);
+                throughput.reserve(count);
+                depth.reserve(count);
+            }
+
+            /**
+             * \brief removes all rays, memory is kept
+             */
+            void clear() noexcept
+            {
+                origin.clear();
+                direction.clear();
+                distance.clear();
+                pixel.clear();
+                throughput.clear();
+                depth.clear();
+            }
+
+            /**
+             * \brief adds a ray to the end of the queue
+             * \param ray ray to add, its direction is already normalized
+             * \param pixel_index pixel the ray contributes to
+             * \param weight throughput of the ray
+             * \param bounces depth of the ray
+             */
+            void push_back(const ray& ray, const std::uint32_t pixel_index = 0, const double weight = 1,
+                           const std::uint32_t bounces = 0)
+            {
+                push_back(ray.get_position(), ray.get_direction(), ray.get_distance(), pixel_index, weight, bounces);
+            }
+
+            /**
+             * \brief adds a ray to the end of the queue
+             * \param position position of the ray
+             * \param normalized_direction normalized direction of the ray
+             * \param length distance of the ray
+             * \param pixel_index pixel the ray contributes to
+             * \param weight throughput of the ray
+             * \param bounces depth of the ray
+             */
+            void push_back(const point3d& position, const vector3d& normalized_direction, const double length,
+                           const std::uint32_t pixel_index = 0, const double weight = 1,
+                           const std::uint32_t bounces = 0)
+            {
+                origin.push_back(position);
+                direction.push_back(normalized_direction);
+                distance.push_back(length);
+                pixel.push_back(pixel_index);
+                throughput.push_back(weight);
+                depth.push_back(bounces);
+            }
+
+            /**
+             * \brief adds a segment from start_point to end_point, e.g. a shadow ray from a surface to a light
+             * \note same as push_back(ray(start_point, end_point))
+             * \throws zero_exception if points are on the same position
+             * \param start_point starting point, position of the ray
+             * \param end_point ending point, distance will be calculated from the start to this point
+             * \param pixel_index pixel the ray contributes to
+             * \param weight throughput of the ray
+             * \param bounces depth of the ray
+             */
+            void push_segment(const point3d& start_point, const point3d& end_point,
+                              const std::uint32_t pixel_index = 0, const double weight = 1,
+                              const std::uint32_t bounces = 0)
+            {
+                push_back(ray(start_point, end_point), pixel_index, weight, bounces);
+            }
+
+            /**
+             * \brief overwrites the origin, direction and distance with the segments from starts[i] to ends[i]
+             *
+             * the same as push_segment for every pair, but branch free, a segment of length zero doesn't throw,
+             * it gets a zero direction and distance so it never hits anything
+             * \note the pixel, throughput and depth of rays already in the queue are kept, e.g. shadow rays that were
+             * keyed to their pixels first. rays beyond the old size get pixel index, throughput 1 and depth 0
+             * \throws out_of_range_exception if starts and ends have a different size
+             * \param starts starting points
+             * \param ends ending points
+             */
+            void assign_segments(const dimension3_soa<point3d>& starts, const dimension3_soa<point3d>& ends)
+            {
+                if (starts.size() != ends.size())
+                    throw exception::out_of_range_exception("starts and ends must have the same size");
+
+                const std::size_t count = starts.size();
+                const std::size_t kept = std::min(size(), count);
+                resize(count);
+
+                const double* start_x = starts.x();
+                const double* start_y = starts.y();
+                const double* start_z = starts.z();
+                const double* end_x = ends.x();
+                const double* end_y = ends.y();
+                const double* end_z = ends.z();
+                double* origin_x = origin.x();
+                double* origin_y = origin.y();
+                double* origin_z = origin.z();
+                double* direction_x = direction.x();
+                double* direction_y = direction.y();
+                double* direction_z = direction.z();
+                double* length = distance.data();
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double x = end_x[index] - start_x[index];
+                    const double y = end_y[index] - start_y[index];
+                    const double z = end_z[index] - start_z[index];
+                    const double segment_length = std::sqrt(x * x + y * y + z * z);
+                    const double inverse_length = segment_length > 0 ? 1. / segment_length : 0;
+
+                    origin_x[index] = start_x[index];
+                    origin_y[index] = start_y[index];
+                    origin_z[index] = start_z[index];
+                    direction_x[index] = x * inverse_length;
+                    direction_y[index] = y * inverse_length;
+                    direction_z[index] = z * inverse_length;
+                    length[index] = segment_length;
+                }
+
+                for (std::size_t index = kept; index < count; ++index)
+                {
+                    pixel[index] = static_cast<std::uint32_t>(index);
+                    throughput[index] = 1;
+                    depth[index] = 0;
+                }
+            }
+
+            /**
+             * \brief gets a ray from the queue
+             * \throws zero_exception if the direction of the ray is zero
+             * \throws negative_exception if the distance of the ray is negative
+             * \param index index of the ray
+             * \return ray at index
+             */
+            NODISCARD ray get_ray(const std::size_t index) const
+            {
+                return {origin.get(index), direction.get(index), distance[index]};
+            }
+
+            /**
+             * \brief gathers rays from another queue, this[i] = source[indices[i]]
+             * \param source queue to gather from, must not be this
+             * \param indices indices in source
+             * \param count amount of indices
+             */
+            void gather(const ray_queue& source, const std::size_t* indices, const std::size_t count)
+            {
+                origin.gather(source.origin, indices, count);
+                direction.gather(source.direction, indices, count);
+                distance.resize(count);
+                pixel.resize(count);
+                throughput.resize(count);
+                depth.resize(count);
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    distance[index] = source.distance[indices[index]];
+                    pixel[index] = source.pixel[indices[index]];
+                    throughput[index] = source.throughput[indices[index]];
+                    depth[index] = source.depth[indices[index]];
+                }
+            }
+
+            /**
+             * \brief swaps the content with another queue
+             * \param other other queue
+             */
+            void swap(ray_queue& other) noexcept
+            {
+                origin.swap(other.origin);
+                direction.swap(other.direction);
+                distance.swap(other.distance);
+                pixel.swap(other.pixel);
+                throughput.swap(other.throughput);
+                depth.swap(other.depth);
+            }
+        };
+
+        /**
+         * \brief closest hits of a ray_queue in structure of arrays layout, hit i belongs to ray i
+         */
+        class hit_queue
+        {
+        public:
+            /**
+             * \brief material (and primitive) value of a ray that hit nothing
+             */
+            INLINE static constexpr std::uint32_t no_hit = std::numeric_limits<std::uint32_t>::max();
+
+            /**
+             * \brief distance from the ray position to the hit
+             */
+            std::vector<double> distance;
+
+            /**
+             * \brief normalized surface normal at the hit, pointing outwards
+             */
+            dimension3_soa<vector3d> normal;
+
+            /**
+             * \brief index of the primitive that was hit, no_hit if nothing was hit
+             */
+            std::vector<std::uint32_t> primitive;
+
+            /**
+             * \brief material of the primitive that was hit, no_hit if nothing was hit
+             */
+            std::vector<std::uint32_t> material;
+
+        public:
+            NODISCARD std::size_t size() const noexcept { return distance.size(); }
+
+            /**
+             * \brief checks if ray index hit something
+             * \param index index of the ray
+             * \return true if the ray hit something
+             */
+            NODISCARD bool is_hit(const std::size_t index) const noexcept { return primitive[index] != no_hit; }
+
+            /**
+             * \brief resizes all arrays
+             * \param count new amount of hits
+             */
+            void resize(const std::size_t count)
+            {
+                distance.resize(count);
+                normal.resize(count);
+                primitive.resize(count);
+                material.resize(count);
+            }
+
+            /**
+             * \brief gathers hits from another queue, this[i] = source[indices[i]]
+             * \param source queue to gather from, must not be this
+             * \param indices indices in source
+             * \param count amount of indices
+             */
+            void gather(const hit_queue& source, const std::size_t* indices, const std::size_t count)
+            {
+                normal.gather(source.normal, indices, count);
+                distance.resize(count);
+                primitive.resize(count);
+                material.resize(count);
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    distance[index] = source.distance[indices[index]];
+                    primitive[index] = source.primitive[indices[index]];
+                    material[index] = source.material[indices[index]];
+                }
+            }
+
+            /**
+             * \brief swaps the content with another queue
+             * \param other other queue
+             */
+            void swap(hit_queue& other) noexcept
+            {
+                distance.swap(other.distance);
+                normal.swap(other.normal);
+                primitive.swap(other.primitive);
+                material.swap(other.material);
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
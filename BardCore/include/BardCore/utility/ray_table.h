@@ -0,0 +1,349 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/ray.h"
+#include "BardCore/utility/ray_queue.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief normalized primary ray directions of a camera, calculated at compile time for a fixed resolution
+         *
+         * e.g. constexpr ray_table<64, 48> table(camera); generating a primary ray is then a load from the table
+         * \note every pixel costs a constexpr sqrt, for large resolutions the compiler may need a higher constexpr
+         * step limit (e.g. /constexpr:steps or -fconstexpr-ops-limit), use ray_cache for those instead
+         * \tparam Width screen width of the camera
+         * \tparam Height screen height of the camera
+         */
+        template <unsigned int Width, unsigned int Height>
+        class ray_table
+        {
+            static_assert(Width > 0 && Height > 0, "width and height must be greater than 0");
+
+        public:
+            /**
+             * \brief amount of rays in the table
+             */
+            INLINE static constexpr std::size_t count = static_cast<std::size_t>(Width) * Height;
+
+        protected:
+            point3d position_{}; // position of the camera
+            double x_[count]{}, y_[count]{}, z_[count]{}; // normalized direction of every pixel, row by row
+
+        public:
+            /**
+             * \brief constructor for ray_table, calculates the direction of every pixel like camera::shoot_ray
+             * \throws out_of_range_exception if the camera doesn't have a screen of Width by Height
+             * \param camera camera to calculate the directions of
+             */
+            constexpr explicit ray_table(const camera& camera) : position_(camera.get_position())
+            {
+                if (camera.get_screen_width() != Width || camera.get_screen_height() != Height)
+                    throw exception::out_of_range_exception("camera screen must be the same size as the table");
+
+                const vector3d corner = position_.get_vector(camera.get_top_left());
+                const vector3d step_horizontal = camera.get_half_horizontal() * 2 / static_cast<double>(Width);
+                const vector3d step_vertical = camera.get_half_vertical() * 2 / static_cast<double>(Height);
+
+                for (unsigned int y = 0; y < Height; ++y)
+                {
+                    for (unsigned int x = 0; x < Width; ++x)
+                    {
+                        const vector3d direction = (corner + step_horizontal * static_cast<double>(x) - step_vertical *
+                            static_cast<double>(y)).normalize();
+
+                        const std::size_t index = static_cast<std::size_t>(y) * Width + x;
+                        x_[index] = direction.x;
+                        y_[index] = direction.y;
+                        z_[index] = direction.z;
+                    }
+                }
+            }
+
+            /**
+             * \brief gets the normalized direction of a pixel
+             * \throws out_of_range_exception if x or y is greater or equal to the width or height
+             * \param x x position on the screen
+             * \param y y position on the screen
+             * \return normalized direction
+             */
+            NODISCARD constexpr vector3d get_direction(const unsigned int x, const unsigned int y) const
+            {
+                if (x >= Width || y >= Height)
+                    throw exception::out_of_range_exception("x and y must be smaller than the width and height");
+
+                const std::size_t index = static_cast<std::size_t>(y) * Width + x;
+                return {x_[index], y_[index], z_[index]};
+            }
+
+            /**
+             * \brief shoot a ray from the camera through a pixel on the screen, the same as camera::shoot_ray
+             * \throws out_of_range_exception if x or y is greater or equal to the width or height
+             * \throws negative_exception if distance is negative
+             * \param x x position on the screen
+             * \param y y position on the screen
+             * \param distance distance of the ray
+             * \return ray through the pixel
+             */
+            NODISCARD constexpr ray shoot_ray(const unsigned int x, const unsigned int y, const double distance) const
+            {
+                return {position_, get_direction(x, y), distance};
+            }
+
+            /**
+             * \brief writes a ray through every pixel to a queue, the same as camera::shoot_rays
+             * \throws negative_exception if distance is negative
+             * \param queue queue to write the rays to
+             * \param distance distance of the rays
+             */
+            void shoot_rays(ray_queue& queue, const double distance) const
+            {
+                if (distance < 0)
+                    throw exception::negative_exception("distance can't be negative");
+
+                queue.resize(count);
+                std::copy(x_, x_ + count, queue.direction.x());
+                std::copy(y_, y_ + count, queue.direction.y());
+                std::copy(z_, z_ + count, queue.direction.z());
+                std::fill(queue.origin.x(), queue.origin.x() + count, position_.x);
+                std::fill(queue.origin.y(), queue.origin.y() + count, position_.y);
+                std::fill(queue.origin.z(), queue.origin.z() + count, position_.z);
+                std::fill(queue.distance.begin(), queue.distance.end(), distance);
+                std::fill(queue.throughput.begin(), queue.throughput.end(), 1.);
+                std::fill(queue.depth.begin(), queue.depth.end(), 0u);
+                for (std::size_t index = 0; index < count; ++index)
+                    queue.pixel[index] = static_cast<std::uint32_t>(index);
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD constexpr const point3d& get_position() const noexcept { return position_; }
+            NODISCARD constexpr unsigned int get_width() const noexcept { return Width; }
+            NODISCARD constexpr unsigned int get_height() const noexcept { return Height; }
+        };
+
+        /**
+         * \brief normalized primary ray directions of a camera, calculated once at runtime and stored as a binary blob
+         *
+         * for resolutions that are too large to calculate at compile time, the blob can be saved after the first
+         * run and loaded in the next instead of calculating the directions again
+         * \note the blob is written in the byte order of the machine, it is a cache and not an exchange format
+         */
+        class ray_cache
+        {
+        protected:
+            point3d position_{}; // position of the camera
+            vector3d direction_{}; // direction of the camera
+            unsigned int screen_width_ = 0, screen_height_ = 0, fov_ = 0; // screen of the camera
+            dimension3_soa<vector3d> directions_{}; // normalized direction of every pixel, row by row
+
+            ray_cache() = default;
+
+        public:
+            /**
+             * \brief constructor for ray_cache, calculates the direction of every pixel with camera::shoot_rays
+             * \param camera camera to calculate the directions of
+             */
+            explicit ray_cache(const camera& camera) : position_(camera.get_position()),
+                                                       direction_(camera.get_direction()),
+                                                       screen_width_(camera.get_screen_width()),
+                                                       screen_height_(camera.get_screen_height()),
+                                                       fov_(camera.get_fov())
+            {
+                ray_queue queue;
+                camera.shoot_rays(queue, 0);
+                directions_.swap(queue.direction);
+            }
+
+            /**
+             * \brief checks if the cache belongs to a camera, e.g. after loading it
+             * \param camera camera to check
+             * \return true if position, direction, screen width, height and fov are equal
+             */
+            NODISCARD bool matches(const camera& camera) const noexcept
+            {
+                return position_ == camera.get_position()
+                    && direction_ == camera.get_direction()
+                    && screen_width_ == camera.get_screen_width()
+                    && screen_height_ == camera.get_screen_height()
+                    && fov_ == camera.get_fov();
+            }
+
+            /**
+             * \brief writes a ray through every pixel to a queue, the same as camera::shoot_rays
+             * \throws negative_exception if distance is negative
+             * \param queue queue to write the rays to
+             * \param distance distance of the rays
+             */
+            void shoot_rays(ray_queue& queue, const double distance) const
+            {
+                if (distance < 0)
+                    throw exception::negative_exception("distance can't be negative");
+
+                const std::size_t count = directions_.size();
+                queue.resize(count);
+                std::copy(directions_.x(), directions_.x() + count, queue.direction.x());
+                std::copy(directions_.y(), directions_.y() + count, queue.direction.y());
+                std::copy(directions_.z(), directions_.z() + count, queue.direction.z());
+                std::fill(queue.origin.x(), queue.origin.x() + count, position_.x);
+                std::fill(queue.origin.y(), queue.origin.y() + count, position_.y);
+                std::fill(queue.origin.z(), queue.origin.z() + count, position_.z);
+                std::fill(queue.distance.begin(), queue.distance.end(), distance);
+                std::fill(queue.throughput.begin(), queue.throughput.end(), 1.);
+                std::fill(queue.depth.begin(), queue.depth.end(), 0u);
+                for (std::size_t index = 0; index < count; ++index)
+                    queue.pixel[index] = static_cast<std::uint32_t>(index);
+            }
+
+            /**
+             * \brief writes the cache as a binary blob
+             * \throws io_exception if the stream fails
+             * \param os output stream, opened in binary mode
+             */
+            void save(std::ostream& os) const
+            {
+                const char magic[4] = {'B', 'R', 'T', '1'};
+                const std::uint32_t screen[3] = {screen_width_, screen_height_, fov_};
+                const double view[6] = {position_.x, position_.y, position_.z, direction_.x, direction_.y, direction_.z};
+                const std::size_t bytes = directions_.size() * sizeof(double);
+
+                os.write(magic, sizeof(magic));
+                os.write(reinterpret_cast<const char*>(screen), sizeof(screen));
+                os.write(reinterpret_cast<const char*>(view), sizeof(view));
+                os.write(reinterpret_cast<const char*>(directions_.x()), static_cast<std::streamsize>(bytes));
+                os.write(reinterpret_cast<const char*>(directions_.y()), static_cast<std::streamsize>(bytes));
+                os.write(reinterpret_cast<const char*>(directions_.z()), static_cast<std::streamsize>(bytes));
+
+                if (!os)
+                    throw exception::io_exception("failed to write ray cache");
+            }
+
+            /**
+             * \brief reads a cache from a binary blob written by save
+             * \note the screen size of the header is checked against the bytes left in the stream before anything is
+             * allocated, for a stream that can't seek the directions are read in blocks, so a corrupt header fails as a
+             * short read instead of a huge allocation
+             * \throws io_exception if the stream fails or doesn't contain a ray cache
+             * \param is input stream, opened in binary mode
+             * \return cache
+             */
+            NODISCARD static ray_cache load(std::istream& is)
+            {
+                const char magic[4] = {'B', 'R', 'T', '1'};
+                char header[sizeof(magic)] = {};
+                std::uint32_t screen[3] = {};
+                double view[6] = {};
+
+                is.read(header, sizeof(header));
+                if (!is || !std::equal(header, header + sizeof(header), magic))
+                    throw exception::io_exception("stream doesn't contain a ray cache");
+
+                is.read(reinterpret_cast<char*>(screen), sizeof(screen));
+                is.read(reinterpret_cast<char*>(view), sizeof(view));
+                if (!is)
+                    throw exception::io_exception("failed to read ray cache");
+
+                ray_cache cache;
+                cache.screen_width_ = screen[0];
+                cache.screen_height_ = screen[1];
+                cache.fov_ = screen[2];
+                cache.position_ = point3d(view[0], view[1], view[2]);
+                cache.direction_ = vector3d(view[3], view[4], view[5]);
+
+                // both are below 2^32, the product only overflows the byte count, not the uint64
+                const std::uint64_t count = static_cast<std::uint64_t>(screen[0]) * screen[1];
+                const std::uint64_t max_count = static_cast<std::uint64_t>(
+                    std::min<std::uintmax_t>(std::numeric_limits<std::streamsize>::max(),
+                                             std::numeric_limits<std::size_t>::max()) / (3 * sizeof(double)));
+                const std::streamoff left = bytes_left(is);
+                if (count > max_count || (left >= 0 && static_cast<std::uint64_t>(left) < count * 3 * sizeof(double)))
+                    throw exception::io_exception("screen size of the ray cache doesn't fit the stream");
+
+                const std::size_t size = static_cast<std::size_t>(count);
+                const std::streamsize bytes = static_cast<std::streamsize>(size * sizeof(double));
+                if (left >= 0)
+                {
+                    cache.directions_.resize(size);
+                    is.read(reinterpret_cast<char*>(cache.directions_.x()), bytes);
+                    is.read(reinterpret_cast<char*>(cache.directions_.y()), bytes);
+                    is.read(reinterpret_cast<char*>(cache.directions_.z()), bytes);
+                    if (!is)
+                        throw exception::io_exception("failed to read ray cache");
+                    return cache;
+                }
+
+                // the size of the stream is unknown, the buffer only grows with data that was actually read
+                std::vector<double> values;
+                const std::size_t block = std::size_t{1} << 16;
+                while (values.size() < size * 3)
+                {
+                    const std::size_t offset = values.size();
+                    const std::size_t amount = std::min(block, size * 3 - offset);
+                    values.resize(offset + amount);
+                    is.read(reinterpret_cast<char*>(values.data() + offset),
+                            static_cast<std::streamsize>(amount * sizeof(double)));
+                    if (!is)
+                        throw exception::io_exception("failed to read ray cache");
+                }
+
+                cache.directions_.resize(size);
+                std::copy(values.begin(), values.begin() + size, cache.directions_.x());
+                std::copy(values.begin() + size, values.begin() + size * 2, cache.directions_.y());
+                std::copy(values.begin() + size * 2, values.end(), cache.directions_.z());
+
+                return cache;
+            }
+
+        protected:
+            /**
+             * \brief gets the amount of bytes between the read position and the end of a stream
+             * \param is input stream
+             * \return amount of bytes left, -1 if the stream can't seek
+             */
+            static std::streamoff bytes_left(std::istream& is)
+            {
+                const std::istream::pos_type position = is.tellg();
+                if (position == std::istream::pos_type(-1))
+                    return -1;
+
+                is.seekg(0, std::ios::end);
+                const std::istream::pos_type end = is.tellg();
+                is.seekg(position);
+                if (!is || end == std::istream::pos_type(-1))
+                {
+                    is.clear();
+                    is.seekg(position);
+                    return -1;
+                }
+
+                return end - position;
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return directions_.size(); }
+            NODISCARD const point3d& get_position() const noexcept { return position_; }
+            NODISCARD unsigned int get_screen_width() const noexcept { return screen_width_; }
+            NODISCARD unsigned int get_screen_height() const noexcept { return screen_height_; }
+            NODISCARD const dimension3_soa<vector3d>& get_directions() const noexcept { return directions_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,568 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <ostream>
+#include <type_traits>
+
+#ifdef _WIN32
+// the kernel32 functions mapped_file needs, declared exactly like <Windows.h> does so both can be included. including
+// <Windows.h> itself would leak its macros (near, far, min, max, ...) into every header that uses a scene cache
+struct _SECURITY_ATTRIBUTES;
+union _LARGE_INTEGER;
+
+extern "C" {
+__declspec(dllimport) void* __stdcall CreateFileA(const char* file_name, unsigned long desired_access,
+                                                  unsigned long share_mode, _SECURITY_ATTRIBUTES* security_attributes,
+                                                  unsigned long creation_disposition,
+                                                  unsigned long flags_and_attributes, void* template_file);
+__declspec(dllimport) int __stdcall GetFileSizeEx(void* file, _LARGE_INTEGER* file_size);
+__declspec(dllimport) void* __stdcall CreateFileMappingA(void* file, _SECURITY_ATTRIBUTES* file_mapping_attributes,
+                                                         unsigned long protect, unsigned long maximum_size_high,
+                                                         unsigned long maximum_size_low, const char* name);
+#ifdef _WIN64
+__declspec(dllimport) void* __stdcall MapViewOfFile(void* file_mapping_object, unsigned long desired_access,
+                                                    unsigned long file_offset_high, unsigned long file_offset_low,
+                                                    unsigned __int64 number_of_bytes_to_map);
+#else
+__declspec(dllimport) void* __stdcall MapViewOfFile(void* file_mapping_object, unsigned long desired_access,
+                                                    unsigned long file_offset_high, unsigned long file_offset_low,
+                                                    unsigned long number_of_bytes_to_map);
+#endif
+__declspec(dllimport) int __stdcall UnmapViewOfFile(const void* base_address);
+__declspec(dllimport) int __stdcall CloseHandle(void* object);
+}
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        //the arrays of a scene cache are used in place, so the math types must be plain data
+        static_assert(std::is_trivially_copyable<point3d>::value && std::is_standard_layout<point3d>::value,
+                      "point3d must be trivially copyable to be stored in a scene cache");
+        static_assert(std::is_trivially_copyable<vector3d>::value && std::is_standard_layout<vector3d>::value,
+                      "vector3d must be trivially copyable to be stored in a scene cache");
+        static_assert(sizeof(point3d) == 3 * sizeof(double) && sizeof(vector3d) == 3 * sizeof(double),
+                      "point3d and vector3d must be three doubles without padding");
+
+        /**
+         * \brief layout of a scene cache file, shared by scene_writer and scene_view
+         *
+         * a header, a table of sections and the data of every section. a section is an array of plain data (e.g.
+         * the x of every sphere center or the nodes of a bvh) with a tag, the table stores offsets from the start of
+         * the file, so the file can be used wherever it is loaded or mapped without fixing up any pointers
+         * \note the data of every section starts at a multiple of alignment bytes, a memory mapped file starts at a
+         * page boundary so the arrays can be used in place with aligned vector loads
+         * \note the file is written in the byte order of the machine, it is a cache and not an exchange format
+         */
+        class scene_format
+        {
+        public:
+            /**
+             * \brief version of the layout, a file with another version is rejected
+             */
+            INLINE static constexpr std::uint32_t version = 1;
+
+            /**
+             * \brief every section starts at a multiple of this, the size of a cache line
+             */
+            INLINE static constexpr std::uint64_t alignment = 64;
+
+            /**
+             * \brief written as is, a file from a machine with another byte order reads it differently
+             */
+            INLINE static constexpr std::uint32_t byte_order = 0x01020304;
+
+            /**
+             * \brief start of the file
+             */
+            struct header
+            {
+                char magic[4]; // 'B', 'S', 'C', '1'
+                std::uint32_t version; // scene_format::version
+                std::uint32_t byte_order; // scene_format::byte_order
+                std::uint32_t section_count; // amount of entries in the table after the header
+                std::uint64_t size; // size of the whole file in bytes
+            };
+
+            /**
+             * \brief entry of the section table
+             */
+            struct section
+            {
+                std::uint32_t tag; // name of the section, see make_tag
+                std::uint32_t element_size; // size of an element in bytes
+                std::uint64_t offset; // start of the data from the start of the file
+                std::uint64_t count; // amount of elements
+            };
+
+            /**
+             * \brief makes a tag from four characters, e.g. make_tag('S', 'P', 'C', 'X')
+             * \return tag with a in the lowest byte
+             */
+            NODISCARD constexpr static std::uint32_t make_tag(const char a, const char b, const char c,
+                                                              const char d) noexcept
+            {
+                return static_cast<std::uint32_t>(static_cast<unsigned char>(a)) |
+                    static_cast<std::uint32_t>(static_cast<unsigned char>(b)) << 8 |
+                    static_cast<std::uint32_t>(static_cast<unsigned char>(c)) << 16 |
+                    static_cast<std::uint32_t>(static_cast<unsigned char>(d)) << 24;
+            }
+
+            /**
+             * \brief rounds an offset up to the next multiple of alignment
+             */
+            NODISCARD constexpr static std::uint64_t align(const std::uint64_t offset) noexcept
+            {
+                return (offset + alignment - 1) / alignment * alignment;
+            }
+
+            /**
+             * \brief checks the magic of a header
+             */
+            NODISCARD static bool has_magic(const header& header) noexcept
+            {
+                return header.magic[0] == 'B' && header.magic[1] == 'S' && header.magic[2] == 'C' &&
+                    header.magic[3] == '1';
+            }
+        };
+
+        /**
+         * \brief collects arrays and writes them as a scene cache, see scene_format
+         * \note the writer only keeps pointers to the arrays, they must stay alive and unchanged until write is called
+         */
+        class scene_writer
+        {
+        protected:
+            /**
+             * \brief array to write
+             */
+            struct entry
+            {
+                std::uint32_t tag;
+                std::uint32_t element_size;
+                const char* data;
+                std::uint64_t count;
+            };
+
+            std::vector<entry> entries_{}; // arrays in the order they were added
+
+        public:
+            /**
+             * \brief adds an array to the cache
+             * \throws same_object_exception if a section with tag was already added
+             * \tparam T type of an element, must be trivially copyable
+             * \param tag name of the section, see scene_format::make_tag
+             * \param data first element
+             * \param count amount of elements
+             */
+            template <typename T>
+            void add(const std::uint32_t tag, const T* data, const std::size_t count)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "a scene cache can only store plain data");
+
+                if (contains(tag))
+                    throw exception::same_object_exception("a section with this tag was already added");
+
+                entries_.push_back({tag, static_cast<std::uint32_t>(sizeof(T)), reinterpret_cast<const char*>(data),
+                                    static_cast<std::uint64_t>(count)});
+            }
+
+            /**
+             * \brief adds an array to the cache
+             * \throws same_object_exception if a section with tag was already added
+             * \tparam T type of an element, must be trivially copyable
+             * \param tag name of the section, see scene_format::make_tag
+             * \param data elements
+             */
+            template <typename T>
+            void add(const std::uint32_t tag, const std::vector<T>& data)
+            {
+                add(tag, data.data(), data.size());
+            }
+
+            /**
+             * \brief checks if a section was added
+             * \param tag name of the section
+             * \return true if a section with tag was added
+             */
+            NODISCARD bool contains(const std::uint32_t tag) const noexcept
+            {
+                for (const entry& entry : entries_)
+                    if (entry.tag == tag)
+                        return true;
+
+                return false;
+            }
+
+            /**
+             * \brief writes the cache
+             * \throws io_exception if the stream fails
+             * \param os output stream, opened in binary mode, the file starts at the current position
+             */
+            void write(std::ostream& os) const
+            {
+                scene_format::header header{{'B', 'S', 'C', '1'}, scene_format::version, scene_format::byte_order,
+                                            static_cast<std::uint32_t>(entries_.size()), 0};
+
+                std::vector<scene_format::section> table;
+                std::uint64_t offset = scene_format::align(sizeof(scene_format::header) +
+                    entries_.size() * sizeof(scene_format::section));
+                for (const entry& entry : entries_)
+                {
+                    table.push_back({entry.tag, entry.element_size, offset, entry.count});
+                    offset = scene_format::align(offset + entry.count * entry.element_size);
+                }
+                header.size = offset;
+
+                os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                os.write(reinterpret_cast<const char*>(table.data()),
+                         static_cast<std::streamsize>(table.size() * sizeof(scene_format::section)));
+
+                std::uint64_t written = sizeof(header) + table.size() * sizeof(scene_format::section);
+                const char padding[scene_format::alignment] = {};
+                for (std::size_t index = 0; index < entries_.size(); ++index)
+                {
+                    os.write(padding, static_cast<std::streamsize>(table[index].offset - written));
+                    const std::uint64_t bytes = entries_[index].count * entries_[index].element_size;
+                    os.write(entries_[index].data, static_cast<std::streamsize>(bytes));
+                    written = table[index].offset + bytes;
+                }
+                os.write(padding, static_cast<std::streamsize>(header.size - written));
+
+                if (!os)
+                    throw exception::io_exception("failed to write scene cache");
+            }
+
+            /**
+             * \brief writes the cache to a file
+             * \throws io_exception if the file can't be written
+             * \param path path of the file, overwritten if it exists
+             */
+            void write(const std::string& path) const
+            {
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                if (!file)
+                    throw exception::io_exception("failed to open " + path);
+
+                write(file);
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD std::size_t size() const noexcept { return entries_.size(); }
+        };
+
+        /**
+         * \brief array inside a scene cache, it points into the memory of the cache
+         * \tparam T type of an element
+         */
+        template <typename T>
+        class scene_array
+        {
+        protected:
+            const T* data_ = nullptr; // first element
+            std::size_t size_ = 0; // amount of elements
+
+        public:
+            scene_array() = default;
+            scene_array(const T* data, const std::size_t size) : data_(data), size_(size) {}
+
+            NODISCARD const T& operator[](const std::size_t index) const noexcept { return data_[index]; }
+            NODISCARD const T* begin() const noexcept { return data_; }
+            NODISCARD const T* end() const noexcept { return data_ + size_; }
+
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD const T* data() const noexcept { return data_; }
+            NODISCARD std::size_t size() const noexcept { return size_; }
+            NODISCARD bool empty() const noexcept { return size_ == 0; }
+        };
+
+        /**
+         * \brief read only view of a scene cache in memory, e.g. a mapped_file, nothing is copied
+         *
+         * the header and the section table are checked once in the constructor, after that a section is a lookup in
+         * the table and its data is used where it is
+         * \note the memory must stay alive as long as the view and the arrays taken from it
+         */
+        class scene_view
+        {
+        protected:
+            const char* data_ = nullptr; // start of the cache
+            std::size_t size_ = 0; // size of the cache in bytes
+            std::uint32_t section_count_ = 0; // amount of sections
+
+        public:
+            /**
+             * \brief constructor for scene_view, checks the header and the section table
+             * \throws io_exception if the memory doesn't contain a scene cache of this version and byte order, or a
+             * section lies outside the memory
+             * \param data start of the cache
+             * \param size size of the memory in bytes
+             */
+            scene_view(const void* data, const std::size_t size) : data_(static_cast<const char*>(data)), size_(size)
+            {
+                scene_format::header header{};
+                if (data_ == nullptr || size_ < sizeof(header))
+                    throw exception::io_exception("memory doesn't contain a scene cache");
+
+                std::memcpy(&header, data_, sizeof(header));
+                if (!scene_format::has_magic(header))
+                    throw exception::io_exception("memory doesn't contain a scene cache");
+                if (header.version != scene_format::version)
+                    throw exception::io_exception("unsupported scene cache version");
+                if (header.byte_order != scene_format::byte_order)
+                    throw exception::io_exception("scene cache was written with another byte order");
+                if (header.size > size_ || (size_ - sizeof(header)) / sizeof(scene_format::section) <
+                    header.section_count)
+                    throw exception::io_exception("scene cache is truncated");
+
+                section_count_ = header.section_count;
+                for (std::uint32_t index = 0; index < section_count_; ++index)
+                {
+                    const scene_format::section section = get_section(index);
+                    if (section.element_size == 0 || section.offset > header.size ||
+                        section.count > (header.size - section.offset) / section.element_size)
+                        throw exception::io_exception("scene cache section lies outside the file");
+                }
+            }
+
+            /**
+             * \brief checks if the cache has a section
+             * \param tag name of the section
+             * \return true if there is a section with tag
+             */
+            NODISCARD bool contains(const std::uint32_t tag) const noexcept
+            {
+                for (std::uint32_t index = 0; index < section_count_; ++index)
+                    if (get_section(index).tag == tag)
+                        return true;
+
+                return false;
+            }
+
+            /**
+             * \brief gets a section as an array, without copying
+             * \throws io_exception if there is no section with tag, its elements are not the size of T or its data is
+             * not aligned for T
+             * \tparam T type of an element, must be the type the section was written with
+             * \param tag name of the section
+             * \return array pointing into the cache
+             */
+            template <typename T>
+            NODISCARD scene_array<T> get(const std::uint32_t tag) const
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "a scene cache can only store plain data");
+
+                for (std::uint32_t index = 0; index < section_count_; ++index)
+                {
+                    const scene_format::section section = get_section(index);
+                    if (section.tag != tag)
+                        continue;
+
+                    if (section.element_size != sizeof(T))
+                        throw exception::io_exception("scene cache section has another element type");
+
+                    const char* data = data_ + section.offset;
+                    if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0)
+                        throw exception::io_exception("scene cache section is not aligned");
+
+                    return {reinterpret_cast<const T*>(data), static_cast<std::size_t>(section.count)};
+                }
+
+                throw exception::io_exception("scene cache has no such section");
+            }
+
+        protected:
+            /**
+             * \brief reads entry index of the section table
+             */
+            NODISCARD scene_format::section get_section(const std::uint32_t index) const noexcept
+            {
+                scene_format::section section{};
+                std::memcpy(&section, data_ + sizeof(scene_format::header) + index * sizeof(scene_format::section),
+                            sizeof(section));
+                return section;
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD const void* data() const noexcept { return data_; }
+            NODISCARD std::size_t size() const noexcept { return size_; }
+            NODISCARD std::size_t get_section_count() const noexcept { return section_count_; }
+        };
+
+        /**
+         * \brief read only memory mapping of a whole file, the pages are loaded by the os when they are touched
+         */
+        class mapped_file
+        {
+        protected:
+            const char* data_ = nullptr; // start of the mapping, nullptr for an empty file
+            std::size_t size_ = 0; // size of the file in bytes
+
+#ifdef _WIN32
+            // values of the <Windows.h> constants
+            INLINE static constexpr unsigned long generic_read = 0x80000000ul; // GENERIC_READ
+            INLINE static constexpr unsigned long file_share_read = 0x1; // FILE_SHARE_READ
+            INLINE static constexpr unsigned long open_existing = 3; // OPEN_EXISTING
+            INLINE static constexpr unsigned long file_attribute_normal = 0x80; // FILE_ATTRIBUTE_NORMAL
+            INLINE static constexpr unsigned long page_readonly = 0x02; // PAGE_READONLY
+            INLINE static constexpr unsigned long file_map_read = 0x0004; // FILE_MAP_READ
+#endif
+
+        public:
+            /**
+             * \brief constructor for mapped_file, maps the whole file
+             * \throws io_exception if the file can't be opened or mapped
+             * \param path path of the file
+             */
+            explicit mapped_file(const std::string& path)
+            {
+#ifdef _WIN32
+                void* const file = CreateFileA(path.c_str(), generic_read, file_share_read, nullptr, open_existing,
+                                               file_attribute_normal, nullptr);
+                if (file == reinterpret_cast<void*>(static_cast<std::intptr_t>(-1))) // INVALID_HANDLE_VALUE
+                    throw exception::io_exception("failed to open " + path);
+
+                std::int64_t size = 0; // LARGE_INTEGER
+                if (!GetFileSizeEx(file, reinterpret_cast<_LARGE_INTEGER*>(&size)))
+                {
+                    CloseHandle(file);
+                    throw exception::io_exception("failed to read the size of " + path);
+                }
+
+                size_ = static_cast<std::size_t>(size);
+                if (size_ > 0)
+                {
+                    //the view keeps the mapping alive, both handles can be closed right away
+                    void* const mapping = CreateFileMappingA(file, nullptr, page_readonly, 0, 0, nullptr);
+                    const void* view = mapping != nullptr ? MapViewOfFile(mapping, file_map_read, 0, 0, 0) : nullptr;
+                    if (mapping != nullptr)
+                        CloseHandle(mapping);
+                    CloseHandle(file);
+                    if (view == nullptr)
+                        throw exception::io_exception("failed to map " + path);
+
+                    data_ = static_cast<const char*>(view);
+                }
+                else
+                    CloseHandle(file);
+#else
+                const int file = open(path.c_str(), O_RDONLY);
+                if (file < 0)
+                    throw exception::io_exception("failed to open " + path);
+
+                struct stat status{};
+                if (fstat(file, &status) != 0)
+                {
+                    close(file);
+                    throw exception::io_exception("failed to read the size of " + path);
+                }
+
+                size_ = static_cast<std::size_t>(status.st_size);
+                if (size_ > 0)
+                {
+                    //the mapping stays valid after the file is closed
+                    void* view = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+                    close(file);
+                    if (view == MAP_FAILED)
+                        throw exception::io_exception("failed to map " + path);
+
+                    data_ = static_cast<const char*>(view);
+                }
+                else
+                    close(file);
+#endif
+            }
+
+            ~mapped_file() { unmap(); }
+
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            /**
+             * \brief move constructor, other no longer owns the mapping
+             * \param other other mapped_file
+             */
+            mapped_file(mapped_file&& other) noexcept : data_(other.data_), size_(other.size_)
+            {
+                other.data_ = nullptr;
+                other.size_ = 0;
+            }
+
+            /**
+             * \brief move assignment, the current mapping is released, other no longer owns its mapping
+             * \param other other mapped_file
+             * \return this
+             */
+            mapped_file& operator=(mapped_file&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    unmap();
+                    data_ = other.data_;
+                    size_ = other.size_;
+                    other.data_ = nullptr;
+                    other.size_ = 0;
+                }
+
+                return *this;
+            }
+
+            /**
+             * \brief gets a view of the mapping as a scene cache
+             * \throws io_exception if the file doesn't contain a scene cache, see scene_view
+             * \return view of the whole file
+             */
+            NODISCARD scene_view view() const { return {data_, size_}; }
+
+        protected:
+            /**
+             * \brief releases the mapping
+             */
+            void unmap() noexcept
+            {
+                if (data_ == nullptr)
+                    return;
+
+#ifdef _WIN32
+                UnmapViewOfFile(data_);
+#else
+                munmap(const_cast<char*>(data_), size_);
+#endif
+                data_ = nullptr;
+                size_ = 0;
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD const void* data() const noexcept { return data_; }
+            NODISCARD std::size_t size() const noexcept { return size_; }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/utility/parallel.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief hashed uniform grid over point3d, useful for particles and photons with a roughly uniform density
+         *
+         * the grid is built with a counting sort, the points are stored sorted by bucket in one flat array,
+         * so there are no per-cell vectors and building it again reuses all memory
+         * \note cells are hashed into a table, so two far away cells can share a bucket, queries filter on distance
+         */
+        class spatial_hash
+        {
+        protected:
+            double cell_size_{}; // size of one cell
+            double inverse_cell_size_{}; // 1 / cell_size_
+
+            std::size_t table_size_{}; // amount of buckets, always a power of two
+
+            std::vector<std::size_t> bucket_start_; // prefix sum, bucket b holds [start[b], start[b + 1])
+            std::vector<point3d> points_; // points sorted by bucket
+            std::vector<std::size_t> indices_; // original index of every sorted point
+
+            std::vector<std::size_t> bucket_of_; // scratch, bucket of every input point
+            std::vector<std::size_t> histograms_; // scratch, one histogram per thread
+
+            /**
+             * \brief maximum amount of cells a radius query visits before it scans all points
+             */
+            INLINE static constexpr std::size_t max_query_cells = 64;
+
+        public:
+            /**
+             * \brief largest cell coordinate, cell_coordinate clamps to [-max_cell, max_cell]
+             * \note small enough that neighbour cells and the size of a cell range don't overflow std::int64_t
+             */
+            INLINE static constexpr std::int64_t max_cell = std::int64_t{1} << 61;
+
+            /**
+             * \brief constructor for spatial_hash
+             * \throws zero_exception if cell_size or table_size is zero
+             * \throws negative_exception if cell_size is negative
+             * \param cell_size size of one cell, a good value is the most common query radius
+             * \param table_size amount of buckets, will be rounded up to a power of two
+             */
+            spatial_hash(const double cell_size, const std::size_t table_size) : cell_size_(cell_size)
+            {
+                if (cell_size == 0 || table_size == 0)
+                    throw exception::zero_exception("cell size and table size must be greater than 0");
+                if (cell_size < 0)
+                    throw exception::negative_exception("cell size can't be negative");
+
+                inverse_cell_size_ = 1. / cell_size_;
+
+                table_size_ = 1;
+                while (table_size_ < table_size)
+                    table_size_ <<= 1;
+
+                bucket_start_.assign(table_size_ + 1, 0);
+            }
+
+            /**
+             * \brief calculates the cell coordinate of a single axis
+             * \note coordinates outside of [-max_cell, max_cell] cells (also infinities) are clamped to it and nan goes
+             * to -max_cell, so such points still land in a bucket instead of overflowing the conversion
+             * \param value coordinate on the axis
+             * \return cell coordinate
+             */
+            NODISCARD std::int64_t cell_coordinate(const double value) const noexcept
+            {
+                const double cell = std::floor(value * inverse_cell_size_);
+                if (!(cell > static_cast<double>(-max_cell)))
+                    return -max_cell;
+                if (cell >= static_cast<double>(max_cell))
+                    return max_cell;
+
+                return static_cast<std::int64_t>(cell);
+            }
+
+            /**
+             * \brief hashes a cell to a bucket
+             * \note hash by Teschner et al, "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+             * \param x cell x
+             * \param y cell y
+             * \param z cell z
+             * \return bucket of the cell
+             */
+            NODISCARD std::size_t hash(const std::int64_t x, const std::int64_t y, const std::int64_t z) const noexcept
+            {
+                return static_cast<std::size_t>(
+                    (static_cast<std::uint64_t>(x) * 73856093u)
+                    ^ (static_cast<std::uint64_t>(y) * 19349663u)
+                    ^ (static_cast<std::uint64_t>(z) * 83492791u)) & (table_size_ - 1);
+            }
+
+            /**
+             * \brief calculates the bucket a point falls in
+             * \param point point
+             * \return bucket of the point
+             */
+            NODISCARD std::size_t bucket(const point3d& point) const noexcept
+            {
+                return hash(cell_coordinate(point.x), cell_coordinate(point.y), cell_coordinate(point.z));
+            }
+
+            /**
+             * \brief (re)builds the grid from points, all memory of the previous build is reused
+             * \note the order within a bucket is the input order, also when built with multiple threads
+             * \param points points to insert
+             * \param count amount of points
+             * \param threads amount of threads to build with, 0 means parallel::hardware_threads()
+             */
+            void build(const point3d* points, const std::size_t count, const unsigned int threads = 0)
+            {
+                const unsigned int chunks = parallel::thread_count(count, threads);
+
+                points_.resize(count);
+                indices_.resize(count);
+                bucket_of_.resize(count);
+                histograms_.assign(static_cast<std::size_t>(chunks) * table_size_, 0);
+
+                // pass 1: calculate the bucket of every point and count them per thread
+                parallel::for_each_chunk(count, chunks,
+                                         [this, points](const unsigned int chunk, const std::size_t begin,
+                                                        const std::size_t end)
+                                         {
+                                             std::size_t* histogram = histograms_.data() + chunk * table_size_;
+                                             for (std::size_t index = begin; index < end; ++index)
+                                             {
+                                                 bucket_of_[index] = bucket(points[index]);
+                                                 ++histogram[bucket_of_[index]];
+                                             }
+                                         });
+
+                // pass 2: exclusive prefix sum over buckets, every thread gets its own write offset within a bucket
+                std::size_t offset = 0;
+                for (std::size_t bucket_index = 0; bucket_index < table_size_; ++bucket_index)
+                {
+                    bucket_start_[bucket_index] = offset;
+                    for (unsigned int chunk = 0; chunk < chunks; ++chunk)
+                    {
+                        std::size_t& counter = histograms_[chunk * table_size_ + bucket_index];
+                        const std::size_t amount = counter;
+                        counter = offset;
+                        offset += amount;
+                    }
+                }
+                bucket_start_[table_size_] = offset;
+
+                // pass 3: scatter the points to their sorted position
+                parallel::for_each_chunk(count, chunks,
+                                         [this, points](const unsigned int chunk, const std::size_t begin,
+                                                        const std::size_t end)
+                                         {
+                                             std::size_t* write = histograms_.data() + chunk * table_size_;
+                                             for (std::size_t index = begin; index < end; ++index)
+                                             {
+                                                 const std::size_t position = write[bucket_of_[index]]++;
+                                                 points_[position] = points[index];
+                                                 indices_[position] = index;
+                                             }
+                                         });
+            }
+
+            /**
+             * \brief (re)builds the grid from points, all memory of the previous build is reused
+             * \param points points to insert
+             * \param threads amount of threads to build with, 0 means parallel::hardware_threads()
+             */
+            void build(const std::vector<point3d>& points, const unsigned int threads = 0)
+            {
+                build(points.data(), points.size(), threads);
+            }
+
+            /**
+             * \brief calls function(index, point) for every point in the same bucket as the given cell
+             * \note this can include points of other cells that share the bucket
+             * \tparam Function callable with (std::size_t, const point3d&)
+             * \param x cell x
+             * \param y cell y
+             * \param z cell z
+             * \param function function to call, index is the index in the original input
+             */
+            template <typename Function>
+            void for_each_in_cell(const std::int64_t x, const std::int64_t y, const std::int64_t z,
+                                  Function&& function) const
+            {
+                for_each_in_bucket(hash(x, y, z), function);
+            }
+
+            /**
+             * \brief calls function(index, point) for every point in the 27 cells around (and including) the cell of point
+             * \note buckets that are shared by several of those cells are only visited once
+             * \tparam Function callable with (std::size_t, const point3d&)
+             * \param point point to find the neighbour cells of
+             * \param function function to call, index is the index in the original input
+             */
+            template <typename Function>
+            void for_each_neighbour(const point3d& point, Function&& function) const
+            {
+                const std::int64_t x = cell_coordinate(point.x);
+                const std::int64_t y = cell_coordinate(point.y);
+                const std::int64_t z = cell_coordinate(point.z);
+
+                for_each_in_cells(x - 1, y - 1, z - 1, x + 1, y + 1, z + 1, function);
+            }
+
+            /**
+             * \brief calls function(index, point, distance_squared) for every point within radius of center
+             * \throws negative_exception if radius is negative
+             * \tparam Function callable with (std::size_t, const point3d&, double)
+             * \param center center of the query
+             * \param radius radius of the query
+             * \param function function to call, index is the index in the original input
+             */
+            template <typename Function>
+            void for_each_in_radius(const point3d& center, const double radius, Function&& function) const
+            {
+                if (radius < 0)
+                    throw exception::negative_exception("radius can't be negative");
+
+                const double radius_squared = radius * radius;
+
+                for_each_in_cells(cell_coordinate(center.x - radius), cell_coordinate(center.y - radius),
+                                  cell_coordinate(center.z - radius), cell_coordinate(center.x + radius),
+                                  cell_coordinate(center.y + radius), cell_coordinate(center.z + radius),
+                                  [&center, radius_squared, &function](const std::size_t index, const point3d& point)
+                                  {
+                                      const double distance_squared = center.distance_squared(point);
+                                      if (distance_squared <= radius_squared)
+                                          function(index, point, distance_squared);
+                                  });
+            }
+
+            /**
+             * \brief collects the original indices of all points within radius of center
+             * \throws negative_exception if radius is negative
+             * \param center center of the query
+             * \param radius radius of the query
+             * \param result indices will be appended to this
+             */
+            void query_radius(const point3d& center, const double radius, std::vector<std::size_t>& result) const
+            {
+                for_each_in_radius(center, radius, [&result](const std::size_t index, const point3d&, double)
+                {
+                    result.push_back(index);
+                });
+            }
+
+        protected:
+            /**
+             * \brief calls function(index, point) for every point in a bucket
+             * \param bucket_index bucket
+             * \param function function to call
+             */
+            template <typename Function>
+            void for_each_in_bucket(const std::size_t bucket_index, Function& function) const
+            {
+                for (std::size_t position = bucket_start_[bucket_index];
+                     position < bucket_start_[bucket_index + 1];
+                     ++position)
+                    function(indices_[position], points_[position]);
+            }
+
+            /**
+             * \brief calls function(index, point) for every point in the buckets of an inclusive range of cells
+             * \note every bucket is visited at most once, if the range is too big all points are visited
+             * \param min_x min cell x
+             * \param min_y min cell y
+             * \param min_z min cell z
+             * \param max_x max cell x
+             * \param max_y max cell y
+             * \param max_z max cell z
+             * \param function function to call
+             */
+            template <typename Function>
+            void for_each_in_cells(const std::int64_t min_x, const std::int64_t min_y, const std::int64_t min_z,
+                                   const std::int64_t max_x, const std::int64_t max_y, const std::int64_t max_z,
+                                   Function&& function) const
+            {
+                const std::uint64_t span_x = static_cast<std::uint64_t>(max_x - min_x + 1);
+                const std::uint64_t span_y = static_cast<std::uint64_t>(max_y - min_y + 1);
+                const std::uint64_t span_z = static_cast<std::uint64_t>(max_z - min_z + 1);
+
+                // every span is checked before multiplying, the product of big spans could wrap around
+                const bool small = span_x <= max_query_cells && span_y <= max_query_cells && span_z <= max_query_cells;
+                const std::uint64_t cells = small ? span_x * span_y * span_z : max_query_cells + 1;
+
+                // big ranges touch (almost) every bucket anyway, just visit every point
+                if (cells > max_query_cells || cells >= table_size_)
+                {
+                    for (std::size_t position = 0; position < points_.size(); ++position)
+                        function(indices_[position], points_[position]);
+                    return;
+                }
+
+                std::array<std::size_t, max_query_cells> buckets{};
+                std::size_t bucket_count = 0;
+
+                for (std::int64_t z = min_z; z <= max_z; ++z)
+                    for (std::int64_t y = min_y; y <= max_y; ++y)
+                        for (std::int64_t x = min_x; x <= max_x; ++x)
+                            buckets[bucket_count++] = hash(x, y, z);
+
+                // different cells can hash to the same bucket, visit those only once
+                std::sort(buckets.begin(), buckets.begin() + bucket_count);
+                const auto last = std::unique(buckets.begin(), buckets.begin() + bucket_count);
+
+                for (auto bucket_index = buckets.begin(); bucket_index != last; ++bucket_index)
+                    for_each_in_bucket(*bucket_index, function);
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD double get_cell_size() const noexcept { return cell_size_; }
+            NODISCARD std::size_t get_table_size() const noexcept { return table_size_; }
+            NODISCARD std::size_t size() const noexcept { return points_.size(); }
+
+            /**
+             * \brief gets the points sorted by bucket
+             * \return points sorted by bucket
+             */
+            NODISCARD const std::vector<point3d>& get_points() const noexcept { return points_; }
+
+            /**
+             * \brief gets the original index of every sorted point
+             * \return original index of every sorted point
+             */
+            NODISCARD const std::vector<std::size_t>& get_indices() const noexcept { return indices_; }
+
+            /**
+             * \brief gets the amount of points in a bucket
+             * \throws out_of_range_exception if bucket_index is greater or equal to the table size
+             * \param bucket_index bucket
+             * \return amount of points in the bucket
+             */
+            NODISCARD std::size_t bucket_size(const std::size_t bucket_index) const
+            {
+                if (bucket_index >= table_size_)
+                    throw exception::out_of_range_exception("bucket must be smaller than the table size");
+
+                return bucket_start_[bucket_index + 1] - bucket_start_[bucket_index];
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,420 @@
+#pragma once
+
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/interfaces/dimension4.h"
+#include "BardCore/utility/number_parser.h"
+#include "BardCore/utility/scene_cache.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief writes arrays of dimension3 and dimension4 types as text, one element per line, e.g. "1 2.5 -3\n"
+         *
+         * numbers are formatted into a large buffer with std::to_chars, the shortest text that reads back to the
+         * same double, and the buffer is written to a file descriptor in one call when it is full. no stream is
+         * involved, so dumping millions of points is bound by the disk and not by formatting
+         * \note without std::to_chars (C++14) numbers are formatted with "%.17g", which also reads back to the same
+         * double but isn't always the shortest text
+         * \note the text is read back by text_parser
+         */
+        class text_writer
+        {
+        public:
+            /**
+             * \brief default size of the buffer, 1 mb
+             */
+            INLINE static constexpr std::size_t default_buffer_size = 1 << 20;
+
+            /**
+             * \brief longest text of a double, e.g. "-2.2250738585072014e-308" is 24 characters
+             */
+            INLINE static constexpr std::size_t max_number_length = 32;
+
+            /**
+             * \brief smallest buffer, one dimension4 with its separators
+             */
+            INLINE static constexpr std::size_t min_buffer_size = max_number_length * 4 + 4;
+
+        protected:
+            int fd_ = -1; // file descriptor to write to
+            bool owns_fd_ = false; // true if the file was opened by the writer
+            std::vector<char> buffer_; // formatted text that isn't written yet
+            std::size_t used_ = 0; // amount of characters in the buffer
+
+        public:
+            /**
+             * \brief constructor for text_writer, writes to a file descriptor that stays open after the writer
+             * \param fd file descriptor, e.g. 1 for stdout
+             * \param buffer_size size of the buffer in bytes, at least room for one dimension4
+             */
+            explicit text_writer(const int fd, const std::size_t buffer_size = default_buffer_size) : fd_(fd),
+                buffer_(buffer_size > min_buffer_size ? buffer_size : min_buffer_size)
+            {
+            }
+
+            /**
+             * \brief constructor for text_writer, creates or overwrites a file
+             * \throws io_exception if the file can't be opened
+             * \param path path of the file
+             * \param buffer_size size of the buffer in bytes, at least room for one dimension4
+             */
+            explicit text_writer(const std::string& path, const std::size_t buffer_size = default_buffer_size)
+                : text_writer(open_file(path), buffer_size)
+            {
+                owns_fd_ = true;
+            }
+
+            /**
+             * \brief destructor, writes what is left in the buffer and closes the file if the writer opened it
+             * \note an error while writing is lost here, call flush first to get it as an exception
+             */
+            ~text_writer()
+            {
+                write_buffer();
+                if (owns_fd_)
+                    close_file(fd_);
+            }
+
+            text_writer(const text_writer&) = delete;
+            text_writer& operator=(const text_writer&) = delete;
+
+            /**
+             * \brief writes the elements of an array, one per line
+             * \throws io_exception if writing fails
+             * \tparam T implementation of dimension3 or dimension4, e.g. point3d or quaternion
+             * \param values first element
+             * \param count amount of elements
+             */
+            template <typename T>
+            void write(const T* values, const std::size_t count)
+            {
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    reserve(min_buffer_size);
+                    append_values(values[index]);
+                }
+            }
+
+            /**
+             * \brief writes the elements of an array, one per line
+             * \throws io_exception if writing fails
+             * \tparam T implementation of dimension3 or dimension4, e.g. point3d or quaternion
+             * \param values elements to write
+             */
+            template <typename T>
+            void write(const std::vector<T>& values)
+            {
+                write(values.data(), values.size());
+            }
+
+            /**
+             * \brief writes the elements of a structure of arrays, one per line
+             * \throws io_exception if writing fails
+             * \tparam T implementation of dimension3, e.g. point3d
+             * \param values elements to write
+             */
+            template <typename T>
+            void write(const dimension3_soa<T>& values)
+            {
+                const double* x = values.x();
+                const double* y = values.y();
+                const double* z = values.z();
+                for (std::size_t index = 0; index < values.size(); ++index)
+                {
+                    reserve(max_number_length * 3 + 3);
+                    append(x[index], ' ');
+                    append(y[index], ' ');
+                    append(z[index], '\n');
+                }
+            }
+
+            /**
+             * \brief writes everything in the buffer to the file descriptor
+             * \throws io_exception if writing fails
+             */
+            void flush()
+            {
+                if (!write_buffer())
+                    throw exception::io_exception("failed to write text");
+            }
+
+            /**
+             * \brief formats a double as the shortest text that reads back to the same double
+             * \param first first character of the output
+             * \param last one past the last character of the output, at least max_number_length after first
+             * \param value value to format
+             * \return one past the last written character
+             */
+            static char* format(char* first, char* last, const double value) noexcept
+            {
+#if defined(FLOAT_CHARCONV)
+                return std::to_chars(first, last, value).ptr;
+#else
+                const int length = std::snprintf(first, static_cast<std::size_t>(last - first), "%.17g", value);
+                return first + (length > 0 ? length : 0);
+#endif
+            }
+
+        protected:
+            /**
+             * \brief makes room for count characters, writes the buffer if needed
+             */
+            void reserve(const std::size_t count)
+            {
+                if (buffer_.size() - used_ < count)
+                    flush();
+            }
+
+            /**
+             * \brief appends a number and a separator, there must be room for them
+             */
+            void append(const double value, const char separator) noexcept
+            {
+                char* first = buffer_.data() + used_;
+                char* end = format(first, first + max_number_length, value);
+                *end = separator;
+                used_ += static_cast<std::size_t>(end - first) + 1;
+            }
+
+            /**
+             * \brief appends the components of a dimension3 on one line
+             */
+            template <typename T>
+            void append_values(const dimension3<T>& value) noexcept
+            {
+                append(value.x, ' ');
+                append(value.y, ' ');
+                append(value.z, '\n');
+            }
+
+            /**
+             * \brief appends the components of a dimension4 on one line
+             */
+            template <typename T>
+            void append_values(const dimension4<T>& value) noexcept
+            {
+                append(value.x, ' ');
+                append(value.y, ' ');
+                append(value.z, ' ');
+                append(value.w, '\n');
+            }
+
+            /**
+             * \brief writes the buffer in as few calls as the os allows
+             * \return false if writing fails, the buffer is emptied anyway
+             */
+            bool write_buffer() noexcept
+            {
+                const char* data = buffer_.data();
+                std::size_t left = used_;
+                used_ = 0;
+
+                while (left > 0)
+                {
+#ifdef _WIN32
+                    const unsigned int part = static_cast<unsigned int>(left < 0x40000000 ? left : 0x40000000);
+                    const int written = _write(fd_, data, part);
+#else
+                    const ssize_t written = ::write(fd_, data, left);
+                    if (written < 0 && errno == EINTR)
+                        continue;
+#endif
+                    if (written <= 0)
+                        return false;
+
+                    data += written;
+                    left -= static_cast<std::size_t>(written);
+                }
+
+                return true;
+            }
+
+            /**
+             * \brief creates or truncates a file for writing
+             */
+            static int open_file(const std::string& path)
+            {
+#ifdef _WIN32
+                const int fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+                const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+                if (fd < 0)
+                    throw exception::io_exception("failed to open " + path);
+                return fd;
+            }
+
+            /**
+             * \brief closes a file opened by open_file
+             */
+            static void close_file(const int fd) noexcept
+            {
+#ifdef _WIN32
+                _close(fd);
+#else
+                ::close(fd);
+#endif
+            }
+        };
+
+        /**
+         * \brief reads arrays of dimension3 and dimension4 types from text, the counterpart of text_writer
+         *
+         * the text is a list of numbers, separated by spaces, tabs, newlines, commas or parentheses, so both the
+         * output of text_writer ("1 2 3") and of operator<< ("(1, 2, 3)") can be read. every 3 (or 4) numbers are one
+         * element
+         */
+        class text_parser
+        {
+        public:
+            /**
+             * \brief parses text into a structure of arrays, the elements are appended
+             * \throws io_exception if the text has something that isn't a number or the amount of numbers isn't a
+             * multiple of 3
+             * \tparam T implementation of dimension3, e.g. point3d
+             * \param first first character
+             * \param last one past the last character
+             * \param values parsed elements
+             */
+            template <typename T>
+            static void parse(const char* first, const char* last, dimension3_soa<T>& values)
+            {
+                values.reserve(values.size() + estimate(first, last));
+
+                double components[3] = {};
+                while (next(first, last, components, 3))
+                    values.push_back(T(components[0], components[1], components[2]));
+            }
+
+            /**
+             * \brief parses text into an array, the elements are appended
+             * \throws io_exception if the text has something that isn't a number or the amount of numbers isn't a
+             * multiple of the components of T
+             * \tparam T implementation of dimension3 or dimension4, e.g. point3d or quaternion
+             * \param first first character
+             * \param last one past the last character
+             * \param values parsed elements
+             */
+            template <typename T>
+            static void parse(const char* first, const char* last, std::vector<T>& values)
+            {
+                values.reserve(values.size() + estimate(first, last));
+                parse_values(first, last, values, static_cast<T*>(nullptr));
+            }
+
+            /**
+             * \brief parses a text file, the file is memory mapped
+             * \throws io_exception if the file can't be read or has something that isn't a number or the amount of
+             * numbers isn't a multiple of the components of T
+             * \tparam Values dimension3_soa or std::vector of a dimension3 or dimension4 type
+             * \param path path of the file
+             * \param values parsed elements, appended
+             */
+            template <typename Values>
+            static void load(const std::string& path, Values& values)
+            {
+                const mapped_file file(path);
+                const char* data = static_cast<const char*>(file.data());
+                parse(data, data + file.size(), values);
+            }
+
+        protected:
+            /**
+             * \brief parses dimension3 elements
+             */
+            template <typename T>
+            static auto parse_values(const char* first, const char* last, std::vector<T>& values, T*)
+                -> typename std::enable_if<std::is_base_of<dimension3<T>, T>::value>::type
+            {
+                double components[3] = {};
+                while (next(first, last, components, 3))
+                    values.push_back(T(components[0], components[1], components[2]));
+            }
+
+            /**
+             * \brief parses dimension4 elements
+             */
+            template <typename T>
+            static auto parse_values(const char* first, const char* last, std::vector<T>& values, T*)
+                -> typename std::enable_if<std::is_base_of<dimension4<T>, T>::value>::type
+            {
+                double components[4] = {};
+                while (next(first, last, components, 4))
+                    values.push_back(T(components[0], components[1], components[2], components[3]));
+            }
+
+            /**
+             * \brief parses the next count numbers
+             * \throws io_exception if there is something that isn't a number or less than count numbers are left
+             * \return false if the end of the text is reached before the first number
+             */
+            static bool next(const char*& first, const char* last, double* components, const std::size_t count)
+            {
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    first = skip_separators(first, last);
+                    if (first == last)
+                    {
+                        if (index == 0)
+                            return false;
+                        throw exception::io_exception("text ends in the middle of an element");
+                    }
+
+                    first = number_parser::parse(first, last, components[index]);
+                    if (first == nullptr)
+                        throw exception::io_exception("text has something that isn't a number");
+                }
+
+                return true;
+            }
+
+            /**
+             * \brief skips spaces, tabs, newlines, commas and parentheses
+             */
+            NODISCARD static const char* skip_separators(const char* first, const char* last) noexcept
+            {
+                while (first != last && (*first == ' ' || *first == '\t' || *first == '\r' || *first == '\n' ||
+                    *first == ',' || *first == '(' || *first == ')'))
+                    ++first;
+                return first;
+            }
+
+            /**
+             * \brief estimates the amount of elements as the amount of lines
+             */
+            NODISCARD static std::size_t estimate(const char* first, const char* last) noexcept
+            {
+                std::size_t lines = 0;
+                while (first != last)
+                {
+                    const void* newline = std::memchr(first, '\n', static_cast<std::size_t>(last - first));
+                    if (newline == nullptr)
+                        break;
+                    first = static_cast<const char*>(newline) + 1;
+                    ++lines;
+                }
+                return lines;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/math/math.h"
+#include "BardCore/math/vector3d.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/ray.h"
+#include "BardCore/utility/ray_queue.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief thin lens in front of a camera, generates primary rays with depth of field
+         *
+         * a ray starts at a point on the lens disk around the camera position, in the plane of the screen, and goes
+         * through the point where the pinhole ray of its pixel hits the focal plane, so everything at the focal
+         * distance is sharp and everything else is blurred by the size of the aperture. the lens sample of a pixel
+         * is a hash of the pixel and a seed, use a different seed for every sample or frame to average the blur
+         * \note an aperture of zero gives the same rays as the pinhole camera
+         */
+        class thin_lens
+        {
+        protected:
+            double aperture_; // radius of the lens
+            double focal_distance_; // distance along the camera direction of the plane that is in focus
+
+        public:
+            /**
+             * \brief constructor for thin_lens
+             * \throws negative_exception if aperture or focal_distance is negative
+             * \throws zero_exception if focal_distance is zero
+             * \param aperture radius of the lens, 0 is a pinhole camera
+             * \param focal_distance distance along the camera direction of the plane that is in focus
+             */
+            thin_lens(const double aperture, const double focal_distance) : aperture_(aperture),
+                                                                            focal_distance_(focal_distance)
+            {
+                if (aperture < 0)
+                    throw exception::negative_exception("aperture can't be negative");
+                if (focal_distance < 0)
+                    throw exception::negative_exception("focal distance can't be negative");
+                if (focal_distance == 0)
+                    throw exception::zero_exception("focal distance must be greater than 0");
+            }
+
+            /**
+             * \brief maps a sample in [0, 1)^2 to a point on the lens, with the concentric mapping so a stratified
+             * sample stays stratified on the disk
+             * \param u first dimension of the sample, in the range [0, 1)
+             * \param v second dimension of the sample, in the range [0, 1)
+             * \param lens_x position on the lens along the horizontal screen vector
+             * \param lens_y position on the lens along the vertical screen vector
+             */
+            void lens_sample(const double u, const double v, double& lens_x, double& lens_y) const noexcept
+            {
+                const double a = 2 * u - 1;
+                const double b = 2 * v - 1;
+                const double pi_4 = math::pi_4;
+                const double pi_2 = math::pi_2;
+
+                //selects instead of branches, the division by zero of the other side is never selected
+                const bool horizontal = std::abs(a) > std::abs(b);
+                const double safe_a = a != 0 ? a : 1;
+                const double safe_b = b != 0 ? b : 1;
+                const double radius = (horizontal ? a : b) * aperture_;
+                const double angle = horizontal ? pi_4 * (b / safe_a) : pi_2 - pi_4 * (a / safe_b);
+
+                lens_x = radius * std::cos(angle);
+                lens_y = radius * std::sin(angle);
+            }
+
+            /**
+             * \brief shoot a ray from a point on the lens through a position on the screen
+             * \note shoot_ray(camera, x, y, u, v, distance) with an aperture of zero is the same as
+             * camera.shoot_subpixel_ray(x, y, distance)
+             * \throws out_of_range_exception if x or y is negative, or not smaller than the screen width or height
+             * \param camera camera the lens is in front of
+             * \param x x position on the screen, x + 0.5 is the center of pixel x
+             * \param y y position on the screen, y + 0.5 is the center of pixel y
+             * \param u first dimension of the lens sample, in the range [0, 1)
+             * \param v second dimension of the lens sample, in the range [0, 1)
+             * \param distance distance of the ray
+             * \return ray from the lens through the focal point of the screen position
+             */
+            NODISCARD ray shoot_ray(const camera& camera, const double x, const double y, const double u,
+                                    const double v, const double distance) const
+            {
+                const double width = static_cast<double>(camera.get_screen_width());
+                const double height = static_cast<double>(camera.get_screen_height());
+                if (!(x >= 0 && y >= 0 && x < width && y < height))
+                    throw exception::out_of_range_exception(
+                        "x and y must be in the range [0, screen width) and [0, screen height)");
+
+                //the screen is at distance 1 along the camera direction, so scaling the pinhole vector by the focal
+                //distance gives the focal point
+                const vector3d pinhole = camera.get_position().get_vector(camera.get_top_left())
+                    + camera.get_half_horizontal() * 2 * (x / width) - camera.get_half_vertical() * 2 * (y / height);
+
+                double lens_x = 0, lens_y = 0;
+                lens_sample(u, v, lens_x, lens_y);
+                const vector3d lens = camera.get_half_horizontal().normalize() * lens_x
+                    + camera.get_half_vertical().normalize() * lens_y;
+
+                return {camera.get_position() + lens, pinhole * focal_distance_ - lens, distance};
+            }
+
+            /**
+             * \brief shoot a ray from the lens through every pixel on the screen, row by row
+             *
+             * the queue is overwritten, ray i goes through pixel (i % width, i / width) and is the same as
+             * shoot_ray(camera, i % width, i / width, u, v, distance) with the lens sample of lens_hash(i, seed), the
+             * pixel array holds i
+             * \note the lens sample, the focal point and the normalization are one branch free loop per row
+             * \throws negative_exception if distance is negative
+             * \param camera camera the lens is in front of
+             * \param queue queue to write the rays to
+             * \param distance distance of the rays
+             * \param seed seed of the lens samples, e.g. the sample or frame number
+             */
+            void shoot_rays(const camera& camera, ray_queue& queue, const double distance,
+                            const std::uint32_t seed = 0) const
+            {
+                if (distance < 0)
+                    throw exception::negative_exception("distance can't be negative");
+
+                const unsigned int width = camera.get_screen_width();
+                const unsigned int height = camera.get_screen_height();
+                queue.resize(static_cast<std::size_t>(width) * height);
+
+                //step from one pixel to the next on the focal plane instead of the screen
+                const vector3d step_horizontal = camera.get_half_horizontal() * 2 * focal_distance_ /
+                    static_cast<double>(width);
+                const vector3d step_vertical = camera.get_half_vertical() * 2 * focal_distance_ /
+                    static_cast<double>(height);
+                const vector3d corner = camera.get_position().get_vector(camera.get_top_left()) * focal_distance_;
+                const vector3d right = camera.get_half_horizontal().normalize();
+                const vector3d up = camera.get_half_vertical().normalize();
+                const point3d& position = camera.get_position();
+
+                double* origin_x = queue.origin.x();
+                double* origin_y = queue.origin.y();
+                double* origin_z = queue.origin.z();
+                double* direction_x = queue.direction.x();
+                double* direction_y = queue.direction.y();
+                double* direction_z = queue.direction.z();
+                double* length = queue.distance.data();
+                std::uint32_t* pixel = queue.pixel.data();
+                double* throughput = queue.throughput.data();
+                std::uint32_t* depth = queue.depth.data();
+
+                const std::uint32_t key = seed_key(seed);
+                for (unsigned int y = 0; y < height; ++y)
+                {
+                    const vector3d row = corner - step_vertical * static_cast<double>(y);
+                    const std::size_t offset = static_cast<std::size_t>(y) * width;
+
+                    VECTORIZE
+                    for (unsigned int x = 0; x < width; ++x)
+                    {
+                        double u = 0, v = 0, lens_x = 0, lens_y = 0;
+                        lens_hash_keyed(static_cast<std::uint32_t>(offset + x), key, u, v);
+                        lens_sample(u, v, lens_x, lens_y);
+
+                        const double lx = right.x * lens_x + up.x * lens_y;
+                        const double ly = right.y * lens_x + up.y * lens_y;
+                        const double lz = right.z * lens_x + up.z * lens_y;
+
+                        const double vx = row.x + step_horizontal.x * static_cast<double>(x) - lx;
+                        const double vy = row.y + step_horizontal.y * static_cast<double>(x) - ly;
+                        const double vz = row.z + step_horizontal.z * static_cast<double>(x) - lz;
+                        const double inverse_length = 1. / std::sqrt(vx * vx + vy * vy + vz * vz);
+
+                        origin_x[offset + x] = position.x + lx;
+                        origin_y[offset + x] = position.y + ly;
+                        origin_z[offset + x] = position.z + lz;
+                        direction_x[offset + x] = vx * inverse_length;
+                        direction_y[offset + x] = vy * inverse_length;
+                        direction_z[offset + x] = vz * inverse_length;
+                        length[offset + x] = distance;
+                        pixel[offset + x] = static_cast<std::uint32_t>(offset + x);
+                        throughput[offset + x] = 1;
+                        depth[offset + x] = 0;
+                    }
+                }
+            }
+
+            /**
+             * \brief gets the lens sample shoot_rays uses for a pixel
+             * \param pixel pixel (y * width + x)
+             * \param seed seed of the lens samples
+             * \param u first dimension of the lens sample, in the range [0, 1)
+             * \param v second dimension of the lens sample, in the range [0, 1)
+             */
+            static void lens_hash(const std::uint32_t pixel, const std::uint32_t seed, double& u, double& v) noexcept
+            {
+                lens_hash_keyed(pixel, seed_key(seed), u, v);
+            }
+
+        protected:
+            /**
+             * \brief hash of a seed, math::hash(seed_key + pixel) is the randomness of a pixel
+             */
+            NODISCARD static std::uint32_t seed_key(const std::uint32_t seed) noexcept
+            {
+                //the golden ratio keeps the first pixel of seed 0 from hashing to 0
+                return math::hash(seed ^ 0x9E3779B9u);
+            }
+
+            /**
+             * \brief lens sample of a pixel with an already hashed seed
+             */
+            static void lens_hash_keyed(const std::uint32_t pixel, const std::uint32_t key, double& u,
+                                        double& v) noexcept
+            {
+                const std::uint32_t hash = math::hash(key + pixel);
+                u = math::to_unit_interval(hash);
+                v = math::to_unit_interval(math::hash(hash));
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD double get_aperture() const noexcept { return aperture_; }
+            NODISCARD double get_focal_distance() const noexcept { return focal_distance_; }
+
+            /**
+             * \brief sets the radius of the lens
+             * \throws negative_exception if aperture is negative
+             * \param aperture new radius of the lens, 0 is a pinhole camera
+             */
+            void set_aperture(const double aperture)
+            {
+                if (aperture < 0)
+                    throw exception::negative_exception("aperture can't be negative");
+
+                aperture_ = aperture;
+            }
+
+            /**
+             * \brief sets the distance of the plane that is in focus
+             * \throws negative_exception if focal_distance is negative
+             * \throws zero_exception if focal_distance is zero
+             * \param focal_distance new distance along the camera direction of the plane that is in focus
+             */
+            void set_focal_distance(const double focal_distance)
+            {
+                if (focal_distance < 0)
+                    throw exception::negative_exception("focal distance can't be negative");
+                if (focal_distance == 0)
+                    throw exception::zero_exception("focal distance must be greater than 0");
+
+                focal_distance_ = focal_distance;
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
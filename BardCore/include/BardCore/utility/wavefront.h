@@ -0,0 +1,579 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "BardCore/bardcore.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/math.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/light.h"
+#include "BardCore/utility/light_set.h"
+#include "BardCore/utility/material.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/utility/pixel_cost.h"
+#include "BardCore/utility/ray_binning.h"
+#include "BardCore/utility/ray_queue.h"
+
+namespace bardcore
+{
+    namespace utility
+    {
+        /**
+         * \brief wavefront ray tracer, every bounce is handled by a few stages that each run over a whole queue of rays
+         *
+         * the stages are:
+         *  - generate: primary rays from a camera
+         *  - extend: closest hit of every ray
+         *  - shade: shadow rays to every light and reflected/refracted rays for the next bounce
+         *  - connect: any hit test of the shadow rays, adds the light of the unoccluded ones to the image
+         *
+         * between the stages the rays are reordered, by direction octant and position (ray_binning) before extend and
+         * by material before shade, so neighbouring rays take similar paths through the scene and the shading code
+         * \note Scene must have void intersect(const ray_queue&, std::size_t, std::size_t, hit_queue&) const, which
+         * writes the closest hit of the rays in [begin, end), and an any hit query for the shadow rays:
+         * void occluded(const ray_queue&, std::size_t, std::size_t, std::vector<std::uint8_t>&) const,
+         * e.g. geometry::sphere_set
+         * \note the image holds one intensity per pixel, lights and materials have no colour
+         * \note with BARDCORE_PIXEL_COST defined every render also fills a pixel_cost (get_pixel_cost), extend and
+         * connect then call the scene one ray at a time so the cost of every ray can be measured, which makes them
+         * slower and leaves out what tracing a whole chunk at once gains. without it the accounting is compiled out
+         * \tparam Scene scene to trace the rays through
+         */
+        template <typename Scene>
+        class wavefront
+        {
+        protected:
+            const Scene& scene_;
+            std::vector<light> lights_;
+            std::vector<material> materials_;
+
+            unsigned int max_depth_ = 4; // maximum amount of bounces
+            double min_throughput_ = 0.001; // rays with a smaller throughput are not traced
+            unsigned int threads_ = 0; // threads for extend and connect, 0 means parallel::hardware_threads()
+
+            ray_queue paths_{}, next_paths_{}, shadows_{}, scratch_rays_{};
+            hit_queue hits_{}, scratch_hits_{};
+            std::vector<std::uint8_t> occluded_{};
+
+            // per ray shading values of the current bounce
+            dimension3_soa<point3d> points_{};
+            dimension3_soa<vector3d> normals_{}, reflected_{}, refracted_{}, to_light_{};
+            std::vector<double> albedo_{}, reflected_weight_{}, refracted_weight_{}, refractive_ratio_{};
+            std::vector<double> light_distance_{}, light_weight_{};
+
+            ray_binning binning_{};
+
+            // counting sort
+            std::vector<std::uint32_t> keys_{};
+            std::vector<std::size_t> counts_{}, permutation_{};
+
+            std::vector<double> image_{};
+
+            pixel_cost cost_{}; // per pixel cost of the last render, empty without BARDCORE_PIXEL_COST
+
+#if defined(BARDCORE_PIXEL_COST)
+            /**
+             * \brief cost of one ray in the scene
+             */
+            struct ray_cost
+            {
+                std::uint64_t traversal_steps = 0;
+                std::uint64_t primitive_tests = 0;
+                std::uint64_t cycles = 0;
+            };
+
+            std::vector<ray_cost> ray_costs_{}; // per ray of the current trace or connect
+#endif
+
+        public:
+            /**
+             * \brief offset along the normal for new rays, this prevents a ray from hitting the surface it starts on
+             */
+            INLINE static constexpr double bias = math::epsilon;
+
+            /**
+             * \brief constructor for wavefront
+             * \param scene scene to trace the rays through, it must outlive the wavefront
+             * \param lights lights in the scene
+             * \param materials materials, hit_queue::material indexes into this
+             */
+            wavefront(const Scene& scene, std::vector<light> lights, std::vector<material> materials) :
+                scene_(scene), lights_(std::move(lights)), materials_(std::move(materials))
+            {
+            }
+
+            /**
+             * \brief renders an image, runs all stages until there are no rays left or max depth is reached
+             * \throws out_of_range_exception if the scene returns a material that does not exist
+             * \param camera camera to shoot the primary rays from
+             * \return intensity of every pixel (y * width + x)
+             */
+            const std::vector<double>& render(const camera& camera)
+            {
+                generate(camera);
+
+                for (unsigned int depth = 0; depth < max_depth_ && !paths_.empty(); ++depth)
+                {
+                    sort_by_octant();
+                    extend();
+                    sort_by_material();
+                    shade();
+                    connect();
+                    paths_.swap(next_paths_);
+                }
+
+                return image_;
+            }
+
+            ///////////////////////////////////////////////////////
+            ///                      stages                     ///
+            ///////////////////////////////////////////////////////
+
+            /**
+             * \brief generate stage, shoots a ray through every pixel and clears the image
+             * \param camera camera to shoot the rays from
+             */
+            void generate(const camera& camera)
+            {
+                image_.assign(static_cast<std::size_t>(camera.get_screen_width()) * camera.get_screen_height(), 0);
+#if defined(BARDCORE_PIXEL_COST)
+                cost_.resize(camera.get_screen_width(), camera.get_screen_height());
+#endif
+                camera.shoot_rays(paths_, math::inf);
+            }
+
+            /**
+             * \brief extend stage, finds the closest hit of every path
+             */
+            void extend()
+            {
+                trace(paths_, hits_);
+#if defined(BARDCORE_PIXEL_COST)
+                add_ray_costs(paths_, true);
+#endif
+            }
+
+            /**
+             * \brief shade stage, creates shadow rays to every light and the rays of the next bounce
+             * \throws out_of_range_exception if the scene returns a material that does not exist
+             */
+            void shade()
+            {
+                const std::size_t count = paths_.size();
+
+                prepare_shading(count);
+                compute_surfaces(count);
+
+                next_paths_.clear();
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const std::uint32_t depth = paths_.depth[index] + 1;
+                    if (depth >= max_depth_)
+                        continue;
+
+                    if (reflected_weight_[index] > min_throughput_)
+                        next_paths_.push_back(points_.get(index) + normals_.get(index) * bias, reflected_.get(index),
+                                              math::inf, paths_.pixel[index], reflected_weight_[index], depth);
+
+                    if (refracted_weight_[index] > min_throughput_)
+                        next_paths_.push_back(points_.get(index) - normals_.get(index) * bias, refracted_.get(index),
+                                              math::inf, paths_.pixel[index], refracted_weight_[index], depth);
+                }
+
+                shadows_.clear();
+                for (const light& light : lights_)
+                    compute_shadow_rays(count, light);
+            }
+
+            /**
+             * \brief connect stage, checks which shadow rays are occluded and adds the unoccluded ones to the image
+             * \note this uses the any hit query of the scene, a shadow ray only needs to know if something is in the way
+             */
+            void connect()
+            {
+                occluded_.resize(shadows_.size());
+#if defined(BARDCORE_PIXEL_COST)
+                ray_costs_.resize(shadows_.size());
+                parallel::for_each_chunk(shadows_.size(), threads_,
+                                         [this](unsigned int, const std::size_t begin, const std::size_t end)
+                                         {
+                                             for (std::size_t index = begin; index < end; ++index)
+                                             {
+                                                 const ray_cost start = measure();
+                                                 scene_.occluded(shadows_, index, index + 1, occluded_);
+                                                 record(index, start);
+                                             }
+                                         });
+                add_ray_costs(shadows_, false);
+#else
+                parallel::for_each_chunk(shadows_.size(), threads_,
+                                         [this](unsigned int, const std::size_t begin, const std::size_t end)
+                                         {
+                                             scene_.occluded(shadows_, begin, end, occluded_);
+                                         });
+#endif
+
+                for (std::size_t index = 0; index < shadows_.size(); ++index)
+                    if (occluded_[index] == 0)
+                        image_[shadows_.pixel[index]] += shadows_.throughput[index];
+            }
+
+            /**
+             * \brief reorders the paths by direction octant (sign of x, y and z) and then by position, see ray_binning
+             */
+            void sort_by_octant()
+            {
+                binning_.apply(paths_);
+            }
+
+            /**
+             * \brief reorders the paths and their hits by material, misses go last, keeps the order within a material
+             */
+            void sort_by_material()
+            {
+                const std::size_t count = paths_.size();
+                const std::uint32_t miss = static_cast<std::uint32_t>(materials_.size());
+                keys_.resize(count);
+
+                for (std::size_t index = 0; index < count; ++index)
+                    keys_[index] = std::min(hits_.material[index], miss);
+
+                counting_sort(static_cast<std::size_t>(miss) + 1);
+
+                scratch_rays_.gather(paths_, permutation_.data(), count);
+                paths_.swap(scratch_rays_);
+                scratch_hits_.gather(hits_, permutation_.data(), count);
+                hits_.swap(scratch_hits_);
+            }
+
+        protected:
+            /**
+             * \brief finds the closest hit of every ray, split over threads
+             * \param rays rays to trace
+             * \param hits closest hit of every ray
+             */
+            void trace(const ray_queue& rays, hit_queue& hits)
+            {
+                hits.resize(rays.size());
+#if defined(BARDCORE_PIXEL_COST)
+                ray_costs_.resize(rays.size());
+                parallel::for_each_chunk(rays.size(), threads_,
+                                         [this, &rays, &hits](unsigned int, const std::size_t begin,
+                                                              const std::size_t end)
+                                         {
+                                             for (std::size_t index = begin; index < end; ++index)
+                                             {
+                                                 const ray_cost start = measure();
+                                                 scene_.intersect(rays, index, index + 1, hits);
+                                                 record(index, start);
+                                             }
+                                         });
+#else
+                parallel::for_each_chunk(rays.size(), threads_,
+                                         [this, &rays, &hits](unsigned int, const std::size_t begin,
+                                                              const std::size_t end)
+                                         {
+                                             scene_.intersect(rays, begin, end, hits);
+                                         });
+#endif
+            }
+
+#if defined(BARDCORE_PIXEL_COST)
+            /**
+             * \brief reads the instrumentation counters of the calling thread and the time stamp counter
+             * \return counters and time stamp before a ray
+             */
+            static ray_cost measure() noexcept
+            {
+                ray_cost result;
+                result.traversal_steps = instrumentation::thread_value(instrumentation::counter::box_tests);
+                result.primitive_tests = instrumentation::thread_value(instrumentation::counter::intersection_tests);
+                result.cycles = pixel_cost::timestamp();
+                return result;
+            }
+
+            /**
+             * \brief stores the cost of a ray since measure, every thread writes only the rays of its own chunk
+             * \param index index of the ray
+             * \param start result of measure before the ray
+             */
+            void record(const std::size_t index, const ray_cost& start) noexcept
+            {
+                ray_cost& cost = ray_costs_[index];
+                cost.cycles = pixel_cost::timestamp() - start.cycles;
+                cost.traversal_steps = instrumentation::thread_value(instrumentation::counter::box_tests) -
+                    start.traversal_steps;
+                cost.primitive_tests = instrumentation::thread_value(instrumentation::counter::intersection_tests) -
+                    start.primitive_tests;
+            }
+
+            /**
+             * \brief adds the cost of every ray to its pixel, after the threads joined
+             * \param rays rays that were measured
+             * \param bounce true if the rays are paths, they count as a bounce of their pixel
+             */
+            void add_ray_costs(const ray_queue& rays, const bool bounce) noexcept
+            {
+                for (std::size_t index = 0; index < rays.size(); ++index)
+                {
+                    const std::size_t pixel = rays.pixel[index];
+                    const ray_cost& cost = ray_costs_[index];
+                    cost_.add(pixel_cost::channel::traversal_steps, pixel, cost.traversal_steps);
+                    cost_.add(pixel_cost::channel::primitive_tests, pixel, cost.primitive_tests);
+                    cost_.add(pixel_cost::channel::cycles, pixel, cost.cycles);
+                    if (bounce)
+                        cost_.add(pixel_cost::channel::bounces, pixel, 1);
+                }
+            }
+#endif
+
+            /**
+             * \brief stable counting sort of keys_, writes the sorted order to permutation_
+             * \param key_count every key is smaller than this
+             */
+            void counting_sort(const std::size_t key_count)
+            {
+                counts_.assign(key_count + 1, 0);
+                for (const std::uint32_t key : keys_)
+                    ++counts_[key + 1];
+
+                for (std::size_t key = 1; key <= key_count; ++key)
+                    counts_[key] += counts_[key - 1];
+
+                permutation_.resize(keys_.size());
+                for (std::size_t index = 0; index < keys_.size(); ++index)
+                    permutation_[counts_[keys_[index]]++] = index;
+            }
+
+            /**
+             * \brief looks up the material of every path, misses get a black material
+             * \throws out_of_range_exception if a material does not exist
+             * \param count amount of paths
+             */
+            void prepare_shading(const std::size_t count)
+            {
+                albedo_.resize(count);
+                reflected_weight_.resize(count);
+                refracted_weight_.resize(count);
+                refractive_ratio_.resize(count);
+
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const std::uint32_t id = hits_.material[index];
+                    if (id == hit_queue::no_hit)
+                    {
+                        albedo_[index] = reflected_weight_[index] = refracted_weight_[index] = 0;
+                        refractive_ratio_[index] = 1;
+                        continue;
+                    }
+
+                    if (id >= materials_.size())
+                        throw exception::out_of_range_exception("material of a hit does not exist");
+
+                    const material& material = materials_[id];
+                    albedo_[index] = material.albedo * paths_.throughput[index];
+                    reflected_weight_[index] = material.reflectance * paths_.throughput[index];
+                    refracted_weight_[index] = material.transmittance * paths_.throughput[index];
+                    refractive_ratio_[index] = material.refractive_index;
+                }
+            }
+
+            /**
+             * \brief calculates the hit point, facing normal, reflection and refraction of every path
+             * \note total internal reflection moves the refracted weight to the reflection
+             * \param count amount of paths
+             */
+            void compute_surfaces(const std::size_t count)
+            {
+                points_.resize(count);
+                normals_.resize(count);
+                reflected_.resize(count);
+                refracted_.resize(count);
+
+                const double* origin_x = paths_.origin.x();
+                const double* origin_y = paths_.origin.y();
+                const double* origin_z = paths_.origin.z();
+                const double* direction_x = paths_.direction.x();
+                const double* direction_y = paths_.direction.y();
+                const double* direction_z = paths_.direction.z();
+                const double* hit_distance = hits_.distance.data();
+                const double* hit_normal_x = hits_.normal.x();
+                const double* hit_normal_y = hits_.normal.y();
+                const double* hit_normal_z = hits_.normal.z();
+
+                double* point_x = points_.x();
+                double* point_y = points_.y();
+                double* point_z = points_.z();
+                double* normal_x = normals_.x();
+                double* normal_y = normals_.y();
+                double* normal_z = normals_.z();
+                double* reflected_x = reflected_.x();
+                double* reflected_y = reflected_.y();
+                double* reflected_z = reflected_.z();
+                double* refracted_x = refracted_.x();
+                double* refracted_y = refracted_.y();
+                double* refracted_z = refracted_.z();
+                const double* albedo = albedo_.data();
+                double* reflected_weight = reflected_weight_.data();
+                double* refracted_weight = refracted_weight_.data();
+                const double* refractive_index = refractive_ratio_.data();
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double dx = direction_x[index];
+                    const double dy = direction_y[index];
+                    const double dz = direction_z[index];
+
+                    //misses have a zero weight and may have an infinite distance, don't move them
+                    const double t = albedo[index] + reflected_weight[index] + refracted_weight[index] > 0
+                                         ? hit_distance[index]
+                                         : 0;
+                    point_x[index] = origin_x[index] + dx * t;
+                    point_y[index] = origin_y[index] + dy * t;
+                    point_z[index] = origin_z[index] + dz * t;
+
+                    //flip the normal to the side of the ray, leaving the surface inverts the refractive ratio
+                    const double facing = dx * hit_normal_x[index] + dy * hit_normal_y[index] + dz * hit_normal_z[
+                        index];
+                    const double side = facing > 0 ? -1. : 1.;
+                    const double nx = hit_normal_x[index] * side;
+                    const double ny = hit_normal_y[index] * side;
+                    const double nz = hit_normal_z[index] * side;
+                    normal_x[index] = nx;
+                    normal_y[index] = ny;
+                    normal_z[index] = nz;
+
+                    //reflection of an incoming direction: d - 2 (d . n) n, see vector3d::reflection
+                    const double cos_incoming = -(dx * nx + dy * ny + dz * nz);
+                    reflected_x[index] = dx + 2 * cos_incoming * nx;
+                    reflected_y[index] = dy + 2 * cos_incoming * ny;
+                    reflected_z[index] = dz + 2 * cos_incoming * nz;
+
+                    //refraction via snell's law: r*d + (r*c - sqrt(1 - r^2 * (1 - c^2))) * n, see vector3d::refraction
+                    const double ratio = facing > 0 ? refractive_index[index] : 1. / refractive_index[index];
+                    const double k = 1 - ratio * ratio * (1 - cos_incoming * cos_incoming);
+                    const double root = std::sqrt(k > 0 ? k : 0);
+                    refracted_x[index] = ratio * dx + (ratio * cos_incoming - root) * nx;
+                    refracted_y[index] = ratio * dy + (ratio * cos_incoming - root) * ny;
+                    refracted_z[index] = ratio * dz + (ratio * cos_incoming - root) * nz;
+
+                    //total internal reflection, everything is reflected
+                    reflected_weight[index] += k < 0 ? refracted_weight[index] : 0;
+                    refracted_weight[index] = k < 0 ? 0 : refracted_weight[index];
+                }
+            }
+
+            /**
+             * \brief creates a shadow ray from every diffuse hit to a light, weighted by lambert and the inverse square law
+             * \note the falloff is light_set::falloff, a hit on the light gets 0 from it instead of throwing
+             * \param count amount of paths
+             * \param light light to create the shadow rays to
+             */
+            void compute_shadow_rays(const std::size_t count, const light& light)
+            {
+                to_light_.resize(count);
+                light_distance_.resize(count);
+                light_weight_.resize(count);
+
+                const double* point_x = points_.x();
+                const double* point_y = points_.y();
+                const double* point_z = points_.z();
+                const double* normal_x = normals_.x();
+                const double* normal_y = normals_.y();
+                const double* normal_z = normals_.z();
+                const double* albedo = albedo_.data();
+
+                double* direction_x = to_light_.x();
+                double* direction_y = to_light_.y();
+                double* direction_z = to_light_.z();
+                double* length = light_distance_.data();
+                double* weight = light_weight_.data();
+                const double min_length_squared = math::epsilon;
+
+                VECTORIZE
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    const double lx = light.position.x - point_x[index];
+                    const double ly = light.position.y - point_y[index];
+                    const double lz = light.position.z - point_z[index];
+                    const double length_squared = lx * lx + ly * ly + lz * lz;
+                    const double inverse_length = 1. / std::sqrt(std::max(length_squared, min_length_squared));
+
+                    direction_x[index] = lx * inverse_length;
+                    direction_y[index] = ly * inverse_length;
+                    direction_z[index] = lz * inverse_length;
+                    length[index] = length_squared * inverse_length - bias;
+
+                    const double lambert = (lx * normal_x[index] + ly * normal_y[index] + lz * normal_z[index]) *
+                        inverse_length;
+                    weight[index] = lambert > 0
+                                        ? albedo[index] * lambert * light_set::falloff(light.intensity, length_squared)
+                                        : 0;
+                }
+
+                for (std::size_t index = 0; index < count; ++index)
+                    if (weight[index] > 0)
+                        shadows_.push_back(points_.get(index) + normals_.get(index) * bias, to_light_.get(index),
+                                           std::max(length[index], 0.), paths_.pixel[index], weight[index],
+                                           paths_.depth[index]);
+            }
+
+        public:
+            ///////////////////////////////////////////////////////
+            ///                 getters/setters                 ///
+            ///////////////////////////////////////////////////////
+
+            NODISCARD const std::vector<double>& get_image() const noexcept { return image_; }
+            NODISCARD const ray_queue& get_paths() const noexcept { return paths_; }
+            NODISCARD const hit_queue& get_hits() const noexcept { return hits_; }
+            NODISCARD const ray_queue& get_shadow_rays() const noexcept { return shadows_; }
+            NODISCARD unsigned int get_max_depth() const noexcept { return max_depth_; }
+            NODISCARD double get_min_throughput() const noexcept { return min_throughput_; }
+            NODISCARD unsigned int get_threads() const noexcept { return threads_; }
+
+            /**
+             * \brief gets the per pixel cost of the last render, empty without BARDCORE_PIXEL_COST
+             */
+            NODISCARD const pixel_cost& get_pixel_cost() const noexcept { return cost_; }
+
+            /**
+             * \brief sets the maximum amount of bounces
+             * \throws zero_exception if max_depth is zero
+             * \param max_depth new maximum amount of bounces
+             */
+            void set_max_depth(const unsigned int max_depth)
+            {
+                if (max_depth == 0)
+                    throw exception::zero_exception("max depth must be greater than 0");
+
+                max_depth_ = max_depth;
+            }
+
+            /**
+             * \brief sets the minimum throughput of a ray, rays with a smaller throughput are not traced
+             * \throws negative_exception if min_throughput is negative
+             * \param min_throughput new minimum throughput
+             */
+            void set_min_throughput(const double min_throughput)
+            {
+                if (min_throughput < 0)
+                    throw exception::negative_exception("min throughput can't be negative");
+
+                min_throughput_ = min_throughput;
+            }
+
+            /**
+             * \brief sets the amount of threads for extend, connect and the ray binning
+             * \param threads new amount of threads, 0 means parallel::hardware_threads()
+             */
+            void set_threads(const unsigned int threads) noexcept
+            {
+                threads_ = threads;
+                binning_.set_threads(threads);
+            }
+        };
+    } // namespace bardcore::utility
+} // namespace bardcore
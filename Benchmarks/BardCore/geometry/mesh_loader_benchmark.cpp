@@ -0,0 +1,91 @@
+#include "pch.h"
+#include "BardCore/geometry/mesh_loader.h"
+
+#include <string>
+
+namespace benchmarking
+{
+    /**
+     * \brief obj grid of size x size vertices and (size - 1)^2 quads
+     */
+    std::string mesh_loader_benchmark_grid(const int size)
+    {
+        std::string obj = "o grid\n";
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+                obj += "v " + std::to_string(x * 0.5) + " " + std::to_string(y * 0.25) + " -1.5e-1\n";
+        obj += "vn 0 0 1\n";
+        for (int y = 0; y + 1 < size; ++y)
+            for (int x = 0; x + 1 < size; ++x)
+            {
+                const int corner = y * size + x + 1;
+                obj += "f " + std::to_string(corner) + "//1 " + std::to_string(corner + 1) + "//1 " +
+                    std::to_string(corner + size + 1) + "//1 " + std::to_string(corner + size) + "//1\n";
+            }
+        return obj;
+    }
+
+    /**
+     * \brief binary little endian ply of the same grid, float positions and quads as uchar/int lists
+     */
+    std::string mesh_loader_benchmark_ply_grid(const int size)
+    {
+        const int quads = (size - 1) * (size - 1);
+        std::string ply = "ply\nformat binary_little_endian 1.0\nelement vertex " + std::to_string(size * size) +
+            "\nproperty float x\nproperty float y\nproperty float z\nelement face " + std::to_string(quads) +
+            "\nproperty list uchar int vertex_indices\nend_header\n";
+        ply.reserve(ply.size() + static_cast<std::size_t>(size) * size * 3 * sizeof(float) +
+                    static_cast<std::size_t>(quads) * (1 + 4 * sizeof(std::int32_t)));
+
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+            {
+                const float position[3] = {x * 0.5f, y * 0.25f, -1.5e-1f};
+                ply.append(reinterpret_cast<const char*>(position), sizeof(position));
+            }
+        for (int y = 0; y + 1 < size; ++y)
+            for (int x = 0; x + 1 < size; ++x)
+            {
+                const char corners = 4;
+                const std::int32_t corner = y * size + x;
+                const std::int32_t face[4] = {corner, corner + 1, corner + size + 1, corner + size};
+                ply.append(&corners, 1);
+                ply.append(reinterpret_cast<const char*>(face), sizeof(face));
+            }
+        return ply;
+    }
+
+    void mesh_loader_benchmark_obj(benchmark::State& state)
+    {
+        //about 45 mb of text, reported as mb/s
+        static const std::string obj = mesh_loader_benchmark_grid(1000);
+        const unsigned int threads = static_cast<unsigned int>(state.range(0));
+
+        const perf_scope perf(state, static_cast<std::int64_t>(obj.size()));
+        for (auto _ : state)
+        {
+            const geometry::mesh_buffers mesh = geometry::mesh_loader::load(obj.data(), obj.size(), threads);
+            benchmark::DoNotOptimize(mesh.indices.data());
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(obj.size()));
+    }
+
+    BENCHMARK(mesh_loader_benchmark_obj)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+    void mesh_loader_benchmark_ply_binary(benchmark::State& state)
+    {
+        //about 29 mb of binary data, reported as mb/s
+        static const std::string ply = mesh_loader_benchmark_ply_grid(1000);
+        const unsigned int threads = static_cast<unsigned int>(state.range(0));
+
+        const perf_scope perf(state, static_cast<std::int64_t>(ply.size()));
+        for (auto _ : state)
+        {
+            const geometry::mesh_buffers mesh = geometry::mesh_loader::load(ply.data(), ply.size(), threads);
+            benchmark::DoNotOptimize(mesh.indices.data());
+        }
+        state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(ply.size()));
+    }
+
+    BENCHMARK(mesh_loader_benchmark_ply_binary)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+} // namespace benchmarking
@@ -0,0 +1,104 @@
+#include "pch.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+
+namespace benchmarking
+{
+    /**
+     * \brief batch of vectors with components in [-10, 10)
+     */
+    std::vector<vector3d> dimension3_benchmark_vectors()
+    {
+        const std::vector<double> values = make_values(BENCHMARK_BATCH * 3, -10, 10);
+        std::vector<vector3d> vectors(BENCHMARK_BATCH);
+        for (std::size_t index = 0; index < vectors.size(); ++index)
+            vectors[index] = {values[index * 3], values[index * 3 + 1], values[index * 3 + 2]};
+        return vectors;
+    }
+
+    void dimension3_benchmark_add(benchmark::State& state)
+    {
+        const std::vector<vector3d> vectors = dimension3_benchmark_vectors();
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            vector3d sum{0, 0, 0};
+            for (const vector3d& vector : vectors)
+                sum += vector;
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(dimension3_benchmark_add);
+
+    void dimension3_benchmark_multiply_add(benchmark::State& state)
+    {
+        const std::vector<vector3d> vectors = dimension3_benchmark_vectors();
+        std::vector<vector3d> results(vectors.size());
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            for (std::size_t index = 0; index < vectors.size(); ++index)
+                results[index] = vectors[index] * 0.5 + vectors[vectors.size() - 1 - index];
+            benchmark::DoNotOptimize(results.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(dimension3_benchmark_multiply_add);
+
+    void dimension3_benchmark_divide(benchmark::State& state)
+    {
+        const std::vector<vector3d> vectors = dimension3_benchmark_vectors();
+        std::vector<vector3d> results(vectors.size());
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            for (std::size_t index = 0; index < vectors.size(); ++index)
+                results[index] = vectors[index] / 3;
+            benchmark::DoNotOptimize(results.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(dimension3_benchmark_divide);
+
+    void dimension3_benchmark_dot(benchmark::State& state)
+    {
+        const std::vector<vector3d> vectors = dimension3_benchmark_vectors();
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (std::size_t index = 0; index < vectors.size(); ++index)
+                sum += vectors[index].dot(vectors[vectors.size() - 1 - index]);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(dimension3_benchmark_dot);
+
+    void dimension3_benchmark_distance(benchmark::State& state)
+    {
+        const std::vector<vector3d> vectors = dimension3_benchmark_vectors();
+        std::vector<point3d> points(vectors.size());
+        for (std::size_t index = 0; index < vectors.size(); ++index)
+            points[index] = {vectors[index].x, vectors[index].y, vectors[index].z};
+
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (std::size_t index = 0; index < points.size(); ++index)
+                sum += points[index].distance(points[points.size() - 1 - index]);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(dimension3_benchmark_distance);
+} // namespace benchmarking
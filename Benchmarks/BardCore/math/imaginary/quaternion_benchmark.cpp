@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "BardCore/math/imaginary/quaternion.h"
+#include "BardCore/math/point3d.h"
+
+namespace benchmarking
+{
+    void quaternion_benchmark_rotate_radians(benchmark::State& state)
+    {
+        const std::vector<double> values = make_values(BENCHMARK_BATCH * 3, 1, 10);
+        const std::vector<double> angles = make_values(BENCHMARK_BATCH, -math::pi, math::pi);
+        std::vector<point3d> points(BENCHMARK_BATCH);
+        for (std::size_t index = 0; index < points.size(); ++index)
+            points[index] = {values[index * 3], values[index * 3 + 1], values[index * 3 + 2]};
+
+        const vector3d axis = vector3d(1, 2, 3).normalize();
+        std::vector<point3d> results(points.size());
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            for (std::size_t index = 0; index < points.size(); ++index)
+                results[index] = quaternion::rotate_radians(points[index], axis, angles[index]);
+            benchmark::DoNotOptimize(results.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(quaternion_benchmark_rotate_radians);
+
+    void quaternion_benchmark_multiply(benchmark::State& state)
+    {
+        const std::vector<double> values = make_values(BENCHMARK_BATCH * 4, -1, 1);
+        std::vector<quaternion> quaternions(BENCHMARK_BATCH);
+        for (std::size_t index = 0; index < quaternions.size(); ++index)
+            quaternions[index] = {values[index * 4], values[index * 4 + 1], values[index * 4 + 2],
+                                  values[index * 4 + 3]};
+
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            quaternion product{1, 0, 0, 0};
+            for (const quaternion& value : quaternions)
+                product = product.multiply(value).normalize();
+            benchmark::DoNotOptimize(product);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(quaternion_benchmark_multiply);
+} // namespace benchmarking
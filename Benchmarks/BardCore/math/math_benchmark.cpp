@@ -0,0 +1,134 @@
+#include "pch.h"
+
+namespace benchmarking
+{
+    /**
+     * \brief amount of values in a compile time table
+     */
+    constexpr std::size_t math_benchmark_table_size = 64;
+
+    /**
+     * \brief table of function values, filled at compile time by the constexpr path of the math functions
+     * \tparam Function math function, e.g. math::sin
+     */
+    template <double (*Function)(double)>
+    struct math_benchmark_table
+    {
+        double values[math_benchmark_table_size] = {};
+
+        constexpr math_benchmark_table(const double min, const double max)
+        {
+            for (std::size_t index = 0; index < math_benchmark_table_size; ++index)
+                values[index] = Function(min + (max - min) * static_cast<double>(index) / math_benchmark_table_size);
+        }
+    };
+
+    /**
+     * \brief runtime path of a math function, a batch of values in [min, max)
+     * \note the function is a lambda so it is inlined, a function pointer would be an indirect call
+     */
+    template <typename Function>
+    void math_benchmark_runtime(benchmark::State& state, const Function function, const double min, const double max)
+    {
+        const std::vector<double> values = make_values(BENCHMARK_BATCH, min, max);
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (const double value : values)
+                sum += function(value);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK_CAPTURE(math_benchmark_runtime, sqrt, [](const double x) { return math::sqrt(x); }, 0., 1e6);
+    BENCHMARK_CAPTURE(math_benchmark_runtime, sin, [](const double x) { return math::sin(x); }, -10., 10.);
+    BENCHMARK_CAPTURE(math_benchmark_runtime, cos, [](const double x) { return math::cos(x); }, -10., 10.);
+    BENCHMARK_CAPTURE(math_benchmark_runtime, tan, [](const double x) { return math::tan(x); }, -1.5, 1.5);
+    BENCHMARK_CAPTURE(math_benchmark_runtime, arcsin, [](const double x) { return math::arcsin(x); }, -1., 1.);
+    BENCHMARK_CAPTURE(math_benchmark_runtime, arccos, [](const double x) { return math::arccos(x); }, -1., 1.);
+    BENCHMARK_CAPTURE(math_benchmark_runtime, arctan, [](const double x) { return math::arctan(x); }, -10., 10.);
+    BENCHMARK_CAPTURE(math_benchmark_runtime, abs, [](const double x) { return math::abs(x); }, -10., 10.);
+
+    void math_benchmark_runtime_pow(benchmark::State& state)
+    {
+        const std::vector<double> values = make_values(BENCHMARK_BATCH, -2, 2);
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (std::size_t index = 0; index < values.size(); ++index)
+                sum += math::pow(values[index], static_cast<int>(index % 16) - 8);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(math_benchmark_runtime_pow);
+
+    void math_benchmark_runtime_mod(benchmark::State& state)
+    {
+        const std::vector<double> values = make_values(BENCHMARK_BATCH, -100, 100);
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (const double value : values)
+                sum += math::mod(value, math::_2pi);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(math_benchmark_runtime_mod);
+
+    void math_benchmark_runtime_hash(benchmark::State& state)
+    {
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (std::uint32_t index = 0; index < BENCHMARK_BATCH; ++index)
+                sum += math::to_unit_interval(math::hash(index));
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(math_benchmark_runtime_hash);
+
+    /**
+     * \brief constexpr path of a math function, the table is filled by the compiler so only the lookups are left
+     * \note if a function stops being constexpr the table doesn't compile, so this catches that regression too
+     */
+    template <typename Table>
+    void math_benchmark_constexpr(benchmark::State& state, const Table& table)
+    {
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (std::size_t index = 0; index < BENCHMARK_BATCH; ++index)
+                sum += table.values[index % math_benchmark_table_size];
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    constexpr math_benchmark_table<&math::sqrt> math_benchmark_sqrt_table{0, 1e6};
+    constexpr math_benchmark_table<&math::sin> math_benchmark_sin_table{-10, 10};
+    constexpr math_benchmark_table<&math::cos> math_benchmark_cos_table{-10, 10};
+    constexpr math_benchmark_table<&math::tan> math_benchmark_tan_table{-1.5, 1.5};
+    constexpr math_benchmark_table<&math::arcsin> math_benchmark_arcsin_table{-1, 1};
+    constexpr math_benchmark_table<&math::arccos> math_benchmark_arccos_table{-1, 1};
+    constexpr math_benchmark_table<&math::arctan> math_benchmark_arctan_table{-10, 10};
+
+    BENCHMARK_CAPTURE(math_benchmark_constexpr, sqrt, math_benchmark_sqrt_table);
+    BENCHMARK_CAPTURE(math_benchmark_constexpr, sin, math_benchmark_sin_table);
+    BENCHMARK_CAPTURE(math_benchmark_constexpr, cos, math_benchmark_cos_table);
+    BENCHMARK_CAPTURE(math_benchmark_constexpr, tan, math_benchmark_tan_table);
+    BENCHMARK_CAPTURE(math_benchmark_constexpr, arcsin, math_benchmark_arcsin_table);
+    BENCHMARK_CAPTURE(math_benchmark_constexpr, arccos, math_benchmark_arccos_table);
+    BENCHMARK_CAPTURE(math_benchmark_constexpr, arctan, math_benchmark_arctan_table);
+} // namespace benchmarking
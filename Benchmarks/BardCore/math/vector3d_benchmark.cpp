@@ -0,0 +1,90 @@
+#include "pch.h"
+#include "BardCore/math/vector3d.h"
+
+namespace benchmarking
+{
+    /**
+     * \brief batch of vectors with components in [-10, 10), none of them is (0, 0, 0)
+     */
+    std::vector<vector3d> vector3d_benchmark_vectors()
+    {
+        const std::vector<double> values = make_values(BENCHMARK_BATCH * 3, -10, 10);
+        std::vector<vector3d> vectors(BENCHMARK_BATCH);
+        for (std::size_t index = 0; index < vectors.size(); ++index)
+            vectors[index] = {values[index * 3] + 0.5, values[index * 3 + 1], values[index * 3 + 2]};
+        return vectors;
+    }
+
+    void vector3d_benchmark_normalize(benchmark::State& state)
+    {
+        const std::vector<vector3d> vectors = vector3d_benchmark_vectors();
+        std::vector<vector3d> results(vectors.size());
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            for (std::size_t index = 0; index < vectors.size(); ++index)
+                results[index] = vectors[index].normalize();
+            benchmark::DoNotOptimize(results.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(vector3d_benchmark_normalize);
+
+    void vector3d_benchmark_cross(benchmark::State& state)
+    {
+        const std::vector<vector3d> vectors = vector3d_benchmark_vectors();
+        std::vector<vector3d> results(vectors.size());
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            for (std::size_t index = 0; index < vectors.size(); ++index)
+                results[index] = vectors[index].cross(vectors[vectors.size() - 1 - index]);
+            benchmark::DoNotOptimize(results.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(vector3d_benchmark_cross);
+
+    void vector3d_benchmark_refraction(benchmark::State& state)
+    {
+        //air to water, some of the rays are reflected internally
+        const std::vector<vector3d> vectors = vector3d_benchmark_vectors();
+        const vector3d normal{0, 1, 0};
+
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            std::size_t refracted = 0;
+            for (const vector3d& vector : vectors)
+            {
+                const auto refraction = vector.refraction(normal, 1.0, 1.33);
+                refracted += refraction ? 1 : 0;
+                benchmark::DoNotOptimize(refraction);
+            }
+            benchmark::DoNotOptimize(refracted);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(vector3d_benchmark_refraction);
+
+    void vector3d_benchmark_angle_radians(benchmark::State& state)
+    {
+        const std::vector<vector3d> vectors = vector3d_benchmark_vectors();
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (std::size_t index = 0; index < vectors.size(); ++index)
+                sum += vectors[index].angle_radians(vectors[vectors.size() - 1 - index]);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(vector3d_benchmark_angle_radians);
+} // namespace benchmarking
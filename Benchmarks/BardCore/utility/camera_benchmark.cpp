@@ -0,0 +1,47 @@
+#include "pch.h"
+#include "BardCore/utility/camera.h"
+
+namespace benchmarking
+{
+    void camera_benchmark_shoot_ray(benchmark::State& state)
+    {
+        //one row of pixels per iteration
+        const utility::camera camera{{0, 0, 0}, {1, 0.5, 0.25}, BENCHMARK_BATCH, BENCHMARK_BATCH};
+        unsigned int y = 0;
+
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            for (unsigned int x = 0; x < BENCHMARK_BATCH; ++x)
+            {
+                const utility::ray ray = camera.shoot_ray(x, y, 100);
+                benchmark::DoNotOptimize(ray);
+            }
+            y = (y + 1) % BENCHMARK_BATCH;
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(camera_benchmark_shoot_ray);
+
+    void camera_benchmark_shoot_subpixel_ray(benchmark::State& state)
+    {
+        const utility::camera camera{{0, 0, 0}, {1, 0.5, 0.25}, BENCHMARK_BATCH, BENCHMARK_BATCH};
+        const std::vector<double> offsets = make_values(BENCHMARK_BATCH, 0, 1);
+        unsigned int y = 0;
+
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            for (unsigned int x = 0; x < BENCHMARK_BATCH; ++x)
+            {
+                const utility::ray ray = camera.shoot_subpixel_ray(x + offsets[x], y + offsets[y], 100);
+                benchmark::DoNotOptimize(ray);
+            }
+            y = (y + 1) % BENCHMARK_BATCH;
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(camera_benchmark_shoot_subpixel_ray);
+} // namespace benchmarking
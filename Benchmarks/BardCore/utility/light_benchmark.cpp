@@ -0,0 +1,43 @@
+#include "pch.h"
+#include "BardCore/utility/light.h"
+
+namespace benchmarking
+{
+    void light_benchmark_inverse_square_law(benchmark::State& state)
+    {
+        const std::vector<double> values = make_values(BENCHMARK_BATCH * 3, 1, 10);
+        std::vector<point3d> points(BENCHMARK_BATCH);
+        for (std::size_t index = 0; index < points.size(); ++index)
+            points[index] = {values[index * 3], values[index * 3 + 1], values[index * 3 + 2]};
+
+        const utility::light light{{0, 0, 0}, 100};
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (const point3d& point : points)
+                sum += light.inverse_square_law(point);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(light_benchmark_inverse_square_law);
+
+    void light_benchmark_inverse_square_law_length(benchmark::State& state)
+    {
+        const std::vector<double> lengths = make_values(BENCHMARK_BATCH, 1, 10);
+        const utility::light light{{0, 0, 0}, 100};
+        const perf_scope perf(state, BENCHMARK_BATCH);
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (const double length : lengths)
+                sum += light.inverse_square_law(length);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * BENCHMARK_BATCH);
+    }
+
+    BENCHMARK(light_benchmark_inverse_square_law_length);
+} // namespace benchmarking
@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "BardCore/utility/ray_binning.h"
+#include "BardCore/utility/ray_queue.h"
+
+namespace benchmarking
+{
+    /**
+     * \brief incoherent rays, like secondary rays after a diffuse bounce: random origins in a box and random directions
+     * \param count amount of rays
+     * \return rays in the order they were made
+     */
+    utility::ray_queue make_incoherent_rays(const std::size_t count)
+    {
+        const std::vector<double> values = make_values(count * 6, -1, 1);
+
+        utility::ray_queue rays;
+        rays.reserve(count);
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            const double* value = values.data() + index * 6;
+            vector3d direction{value[3], value[4], value[5]};
+            if (direction.length_squared() == 0)
+                direction = {0, 0, 1};
+
+            rays.push_back({value[0] * 10, value[1] * 10, value[2] * 10}, direction.normalize(), math::inf,
+                           static_cast<std::uint32_t>(index));
+        }
+        return rays;
+    }
+
+    /**
+     * \brief times sorting a batch into the coherent order, reports the coherence (average dot product of the
+     * directions of neighbouring rays) before and after reordering
+     */
+    void ray_binning_benchmark_sort(benchmark::State& state)
+    {
+        const std::size_t count = static_cast<std::size_t>(state.range(0));
+        const utility::ray_queue rays = make_incoherent_rays(count);
+        utility::ray_binning binning(6, 1);
+
+        const perf_scope perf(state, static_cast<std::int64_t>(count));
+        for (auto _ : state)
+            benchmark::DoNotOptimize(binning.sort(rays).data());
+
+        utility::ray_queue sorted = rays;
+        binning.apply(sorted);
+        state.counters["coherence_before"] = utility::ray_binning::coherence(rays);
+        state.counters["coherence_after"] = utility::ray_binning::coherence(sorted);
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(count));
+    }
+
+    BENCHMARK(ray_binning_benchmark_sort)->Arg(BENCHMARK_BATCH)->Arg(1 << 16);
+
+    /**
+     * \brief times reordering a batch in place (sort and gather), what wavefront does before every extend
+     */
+    void ray_binning_benchmark_apply(benchmark::State& state)
+    {
+        const std::size_t count = static_cast<std::size_t>(state.range(0));
+        const utility::ray_queue rays = make_incoherent_rays(count);
+        utility::ray_queue sorted = rays;
+        utility::ray_binning binning(6, 1);
+
+        const perf_scope perf(state, static_cast<std::int64_t>(count));
+        for (auto _ : state)
+        {
+            // after the first iteration the rays are already sorted, the radix sort and gather do the same work
+            binning.apply(sorted);
+            benchmark::DoNotOptimize(sorted.direction.x());
+        }
+
+        state.counters["coherence_before"] = utility::ray_binning::coherence(rays);
+        state.counters["coherence_after"] = utility::ray_binning::coherence(sorted);
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(count));
+    }
+
+    BENCHMARK(ray_binning_benchmark_apply)->Arg(BENCHMARK_BATCH)->Arg(1 << 16);
+} // namespace benchmarking
@@ -0,0 +1,9 @@
+//
+// main.cpp
+//
+// run with --benchmark_out=results.json --benchmark_out_format=json to track regressions
+//
+
+#include "pch.h"
+
+BENCHMARK_MAIN();
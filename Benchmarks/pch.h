@@ -0,0 +1,40 @@
+//
+// pch.h
+//
+
+#pragma once
+
+// amount of elements every batch benchmark works on, small enough to stay in the l1/l2 cache
+#define BENCHMARK_BATCH 1024
+
+// C++ libraries
+#include "benchmark/benchmark.h" //google benchmark
+
+#include <BardCore/bardcore.h>
+#include <BardCore/math/math.h>
+
+#include "perf_counters.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace bardcore;
+
+namespace benchmarking
+{
+    /**
+     * \brief fills an array with values from math::hash, the same values on every run
+     * \param count amount of values
+     * \param min smallest value
+     * \param max largest value
+     * \return values in [min, max)
+     */
+    inline std::vector<double> make_values(const std::size_t count, const double min, const double max)
+    {
+        std::vector<double> values(count);
+        for (std::size_t index = 0; index < count; ++index)
+            values[index] = min + (max - min) * math::to_unit_interval(math::hash(static_cast<std::uint32_t>(index)));
+        return values;
+    }
+} // namespace benchmarking
@@ -0,0 +1,259 @@
+//
+// perf_counters.h
+//
+
+#pragma once
+
+#include "benchmark/benchmark.h" //google benchmark
+
+#include <BardCore/bardcore.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace benchmarking
+{
+    /**
+     * \brief hardware counters of the calling thread and the threads it starts, read with linux perf_event_open
+     *
+     * counts cycles, instructions, l1 data cache read misses, last level cache read misses and branch misses. an
+     * event the cpu or the vm doesn't have is left out, if none can be opened (not linux, perf_event_paranoid above 2
+     * or no pmu) the counters are unavailable and every value is zero
+     * \note only user space is counted, so it works with the default perf_event_paranoid of 2
+     * \note if there are more events than hardware counters the kernel multiplexes them, the values are scaled by the
+     * time the event was running
+     */
+    class perf_counters
+    {
+    public:
+        /**
+         * \brief counted events
+         */
+        enum event : std::size_t
+        {
+            cycles,
+            instructions,
+            l1d_misses,
+            llc_misses,
+            branch_misses,
+            event_count
+        };
+
+        /**
+         * \brief names of the events, in the order of event
+         */
+        static const char* name(const event counted) noexcept
+        {
+            static const char* const names[event_count] = {
+                "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+            };
+            return names[counted];
+        }
+
+    protected:
+        int fds_[event_count] = {-1, -1, -1, -1, -1}; // file descriptor per event, -1 if it isn't available
+        double values_[event_count] = {}; // counted values of the last start/stop
+
+    public:
+        /**
+         * \brief opens the counters, they don't count until start
+         */
+        perf_counters() noexcept
+        {
+#if defined(__linux__)
+            fds_[cycles] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+            fds_[instructions] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+            fds_[l1d_misses] = open(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D));
+            fds_[llc_misses] = open(PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL));
+            fds_[branch_misses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+        }
+
+        ~perf_counters()
+        {
+#if defined(__linux__)
+            for (const int fd : fds_)
+                if (fd >= 0)
+                    close(fd);
+#endif
+        }
+
+        perf_counters(const perf_counters&) = delete;
+        perf_counters& operator=(const perf_counters&) = delete;
+
+        /**
+         * \brief resets and starts counting
+         */
+        void start() noexcept
+        {
+#if defined(__linux__)
+            for (const int fd : fds_)
+                if (fd >= 0)
+                    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            for (const int fd : fds_)
+                if (fd >= 0)
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+        }
+
+        /**
+         * \brief stops counting and reads the values
+         */
+        void stop() noexcept
+        {
+#if defined(__linux__)
+            for (const int fd : fds_)
+                if (fd >= 0)
+                    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+            for (std::size_t index = 0; index < event_count; ++index)
+            {
+                // value, time enabled and time running
+                std::uint64_t data[3] = {};
+                values_[index] = 0;
+                if (fds_[index] < 0 || read(fds_[index], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+                    continue;
+
+                values_[index] = data[2] == 0
+                                     ? 0
+                                     : static_cast<double>(data[0]) * (static_cast<double>(data[1]) /
+                                         static_cast<double>(data[2]));
+            }
+#endif
+        }
+
+        ///////////////////////////////////////////////////////
+        ///                 getters/setters                 ///
+        ///////////////////////////////////////////////////////
+
+        /**
+         * \brief checks if an event could be opened
+         */
+        NODISCARD bool available(const event counted) const noexcept { return fds_[counted] >= 0; }
+
+        /**
+         * \brief checks if any event could be opened
+         */
+        NODISCARD bool available() const noexcept
+        {
+            for (const int fd : fds_)
+                if (fd >= 0)
+                    return true;
+            return false;
+        }
+
+        /**
+         * \brief counted value of the last start/stop, zero if the event isn't available
+         */
+        NODISCARD double get(const event counted) const noexcept { return values_[counted]; }
+
+    protected:
+#if defined(__linux__)
+        /**
+         * \brief config of a read miss in a cache
+         */
+        static std::uint64_t cache_miss(const std::uint64_t cache) noexcept
+        {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        }
+
+        /**
+         * \brief opens a disabled counter of user space in this thread and the threads it starts
+         * \return file descriptor, -1 on failure
+         */
+        static int open(const std::uint32_t type, const std::uint64_t config) noexcept
+        {
+            perf_event_attr attributes;
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.size = sizeof(attributes);
+            attributes.type = type;
+            attributes.config = config;
+            attributes.disabled = 1;
+            attributes.inherit = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+        }
+#endif
+    };
+
+    /**
+     * \brief counts the hardware events of a benchmark loop and reports them as counters, they end up in the json
+     * output next to the time
+     *
+     * create it right before the loop, the counters are read when it goes out of scope after the loop. reported are
+     * the events per element, e.g. "cycles_per_element" and "llc_misses_per_element", and "ipc", instructions per
+     * cycle. a benchmark without counters gets the label "no perf counters"
+     * \note the counters are opened once and reused by every benchmark
+     */
+    class perf_scope
+    {
+    protected:
+        benchmark::State& state_; // benchmark to report to
+        std::int64_t elements_; // amount of elements in one iteration
+
+    public:
+        /**
+         * \brief starts counting
+         * \param state benchmark state, the loop must not have started
+         * \param elements amount of elements one iteration of the loop works on, e.g. the batch size or bytes
+         */
+        perf_scope(benchmark::State& state, const std::int64_t elements) : state_(state), elements_(elements)
+        {
+            counters().start();
+        }
+
+        /**
+         * \brief stops counting and reports the counters
+         */
+        ~perf_scope()
+        {
+            perf_counters& counters = perf_scope::counters();
+            counters.stop();
+
+            if (!counters.available())
+            {
+                state_.SetLabel("no perf counters");
+                return;
+            }
+
+            const double elements = static_cast<double>(state_.iterations()) * static_cast<double>(elements_);
+            for (std::size_t index = 0; index < perf_counters::event_count; ++index)
+            {
+                const perf_counters::event counted = static_cast<perf_counters::event>(index);
+                if (counters.available(counted) && elements > 0)
+                    state_.counters[std::string(perf_counters::name(counted)) + "_per_element"] =
+                        counters.get(counted) / elements;
+            }
+
+            if (counters.available(perf_counters::cycles) && counters.available(perf_counters::instructions) &&
+                counters.get(perf_counters::cycles) > 0)
+                state_.counters["ipc"] = counters.get(perf_counters::instructions) / counters.get(
+                    perf_counters::cycles);
+        }
+
+        perf_scope(const perf_scope&) = delete;
+        perf_scope& operator=(const perf_scope&) = delete;
+
+    protected:
+        /**
+         * \brief counters shared by every benchmark, opened on first use
+         */
+        static perf_counters& counters()
+        {
+            static perf_counters counters;
+            return counters;
+        }
+    };
+} // namespace benchmarking
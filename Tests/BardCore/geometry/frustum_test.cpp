@@ -0,0 +1,135 @@
+#include "pch.h"
+#include "BardCore/geometry/frustum.h"
+
+#include <vector>
+
+namespace testing
+{
+    TEST(frustum_test, constructor)
+    {
+        const utility::camera camera(point3d(0, 0, 0), vector3d(0, 0, 1), 10, 10, 90);
+        const geometry::frustum frustum(camera, 1, 100);
+
+        // every plane faces the view, the near and far planes are at the given distance
+        for (std::size_t plane = 0; plane < geometry::frustum::plane_count; ++plane)
+        {
+            EXPECT_NEAR(frustum.get_normal(plane).length(), 1, ROUND_EPSILON);
+            EXPECT_GE(frustum.get_normal(plane).dot(camera.get_direction()), -1);
+        }
+        EXPECT_EQ(frustum.get_normal(4), camera.get_direction());
+        EXPECT_NEAR(frustum.get_offset(4), -1, ROUND_EPSILON);
+        EXPECT_NEAR(frustum.get_offset(5), 100, ROUND_EPSILON);
+
+        EXPECT_THROW(geometry::frustum(camera, -1), exception::negative_exception);
+        EXPECT_THROW(geometry::frustum(camera, 5, 5), exception::out_of_range_exception);
+    }
+
+    TEST(frustum_test, contains)
+    {
+        const utility::camera camera(point3d(1, 2, 3), vector3d(1, 0, 0), 10, 10, 90);
+        const geometry::frustum frustum(camera, 0.5, 50);
+
+        EXPECT_TRUE(frustum.contains(point3d(10, 2, 3)));
+        EXPECT_TRUE(frustum.contains(point3d(10, 10, 10)));
+        EXPECT_FALSE(frustum.contains(point3d(10, 14, 3))); // outside the 90 degree view
+        EXPECT_FALSE(frustum.contains(point3d(-10, 2, 3))); // behind
+        EXPECT_FALSE(frustum.contains(point3d(1.2, 2, 3))); // before near
+        EXPECT_FALSE(frustum.contains(point3d(60, 2, 3))); // after far
+
+        // every pixel ray stays inside the frustum, the first row and column are on its edge
+        for (unsigned int x = 0; x < 10; ++x)
+        {
+            for (unsigned int y = 0; y < 10; ++y)
+            {
+                const utility::ray ray = camera.shoot_ray(x, y, 1);
+                EXPECT_TRUE(frustum.intersects_sphere(ray.get_position() + ray.get_direction() * 20, ROUND_EPSILON));
+            }
+        }
+    }
+
+    TEST(frustum_test, intersects)
+    {
+        const utility::camera camera(point3d(0, 0, 0), vector3d(0, 0, 1), 10, 10, 90);
+        const geometry::frustum frustum(camera);
+
+        EXPECT_TRUE(frustum.intersects_sphere(point3d(0, 0, 10), 1));
+        EXPECT_TRUE(frustum.intersects_sphere(point3d(11, 0, 10), 1.5)); // sticks into the view
+        EXPECT_FALSE(frustum.intersects_sphere(point3d(13, 0, 10), 1));
+        EXPECT_FALSE(frustum.intersects_sphere(point3d(0, 0, -5), 1));
+
+        EXPECT_TRUE(frustum.intersects_box(point3d(-1, -1, 5), point3d(1, 1, 6)));
+        EXPECT_TRUE(frustum.intersects_box(point3d(9, -1, 9), point3d(12, 1, 10)));
+        EXPECT_FALSE(frustum.intersects_box(point3d(12, -1, 9), point3d(14, 1, 10)));
+        EXPECT_FALSE(frustum.intersects_box(point3d(-1, -1, -6), point3d(1, 1, -5)));
+    }
+
+    TEST(frustum_test, cull_spheres)
+    {
+        const utility::camera camera(point3d(0, 0, 0), vector3d(0, 0, 1), 10, 10, 60);
+        const geometry::frustum frustum(camera, 0, 100);
+
+        geometry::sphere_set spheres;
+        for (int x = -20; x <= 20; x += 2)
+        {
+            for (int z = -20; z <= 120; z += 4)
+                spheres.add(point3d(x, (x + z) % 5, z), 0.5 + (x * x) % 3);
+        }
+
+        std::vector<std::uint32_t> visible;
+        const std::size_t count = frustum.cull_spheres(spheres, visible);
+
+        ASSERT_EQ(count, visible.size());
+        EXPECT_GT(count, 0u);
+        EXPECT_LT(count, spheres.size());
+
+        // the batch matches the single sphere test and is in ascending order
+        std::size_t next = 0;
+        for (std::uint32_t sphere = 0; sphere < spheres.size(); ++sphere)
+        {
+            if (frustum.intersects_sphere(spheres.get_center(sphere), spheres.get_radius(sphere)))
+            {
+                ASSERT_LT(next, visible.size());
+                EXPECT_EQ(visible[next++], sphere);
+            }
+        }
+        EXPECT_EQ(next, visible.size());
+    }
+
+    TEST(frustum_test, cull_boxes)
+    {
+        const utility::camera camera(point3d(5, 5, 5), vector3d(-1, -1, -1), 10, 10, 90);
+        const geometry::frustum frustum(camera);
+
+        dimension3_soa<point3d> min;
+        dimension3_soa<point3d> max;
+        for (int x = -10; x <= 10; x += 2)
+        {
+            for (int y = -10; y <= 10; y += 2)
+            {
+                for (int z = -10; z <= 10; z += 2)
+                {
+                    min.push_back(point3d(x, y, z));
+                    max.push_back(point3d(x + 1, y + 1.5, z + 0.5));
+                }
+            }
+        }
+
+        std::vector<std::uint32_t> visible;
+        const std::size_t count = frustum.cull_boxes(min, max, visible);
+
+        ASSERT_EQ(count, visible.size());
+        EXPECT_GT(count, 0u);
+        EXPECT_LT(count, min.size());
+
+        std::size_t next = 0;
+        for (std::uint32_t box = 0; box < min.size(); ++box)
+        {
+            if (frustum.intersects_box(min.get(box), max.get(box)))
+            {
+                ASSERT_LT(next, visible.size());
+                EXPECT_EQ(visible[next++], box);
+            }
+        }
+        EXPECT_EQ(next, visible.size());
+    }
+} // namespace testing
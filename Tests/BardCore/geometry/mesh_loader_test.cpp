@@ -0,0 +1,260 @@
+#include "pch.h"
+#include "BardCore/geometry/mesh_loader.h"
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace testing
+{
+    /**
+     * \brief obj grid of size x size vertices and (size - 1)^2 quads, big enough to be split over several threads
+     */
+    std::string mesh_loader_test_grid(const int size)
+    {
+        std::string obj = "# grid\no grid\n";
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+                obj += "v " + std::to_string(x * 0.5) + " " + std::to_string(y * 0.25) + " -1.5e-1\n";
+        obj += "vn 0 0 1\n";
+        for (int y = 0; y + 1 < size; ++y)
+            for (int x = 0; x + 1 < size; ++x)
+            {
+                const int corner = y * size + x + 1;
+                obj += "f " + std::to_string(corner) + "//1 " + std::to_string(corner + 1) + "//1 " +
+                    std::to_string(corner + size + 1) + "//1 " + std::to_string(corner + size) + "//1\n";
+            }
+        return obj;
+    }
+
+    TEST(mesh_loader_test, obj)
+    {
+        const std::string obj = "# triangle and quad\n"
+            "v 0 0 0\n"
+            "v 1 0 0\r\n"
+            "  v 1 1 0 1.0\n"
+            "vt 0.5 0.5\n"
+            "vn 0 0 +1\n"
+            "v -1 2.5e1 -3\n"
+            "usemtl red\n"
+            "f 1 2 3\n"
+            "f 1/1/1 2/1/1 -2/1/1 -1/1/1 # comment\n"
+            "s off";
+
+        const geometry::mesh_buffers mesh = geometry::mesh_loader::load(obj.data(), obj.size());
+
+        ASSERT_EQ(mesh.vertex_count(), 4u);
+        EXPECT_EQ(mesh.positions.get(2), point3d(1, 1, 0));
+        EXPECT_EQ(mesh.positions.get(3), point3d(-1, 25, -3));
+        ASSERT_EQ(mesh.normals.size(), 1u);
+        EXPECT_EQ(mesh.normals.get(0), vector3d(0, 0, 1));
+
+        ASSERT_EQ(mesh.triangle_count(), 3u);
+        const std::vector<std::uint32_t> expected = {0, 1, 2, 0, 1, 2, 0, 2, 3};
+        EXPECT_EQ(mesh.indices, expected);
+    }
+
+    TEST(mesh_loader_test, obj_invalid)
+    {
+        const std::string missing = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n";
+        const std::string zero = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 0 1 2\n";
+        const std::string corners = "v 0 0 0\nv 1 0 0\nf 1 2\n";
+        const std::string number = "v 0 x 0\n";
+
+        EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(missing.data(), missing.size())),
+                     exception::io_exception);
+        EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(zero.data(), zero.size())),
+                     exception::io_exception);
+        EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(corners.data(), corners.size())),
+                     exception::io_exception);
+        EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(number.data(), number.size())),
+                     exception::io_exception);
+    }
+
+    TEST(mesh_loader_test, obj_parallel)
+    {
+        //about 4 mb, the same result with 1 and 8 threads
+        const std::string obj = mesh_loader_test_grid(300);
+        const geometry::mesh_buffers single = geometry::mesh_loader::load(obj.data(), obj.size(), 1);
+        const geometry::mesh_buffers parallel = geometry::mesh_loader::load(obj.data(), obj.size(), 8);
+
+        ASSERT_EQ(single.vertex_count(), 300u * 300u);
+        ASSERT_EQ(single.triangle_count(), 2u * 299u * 299u);
+        EXPECT_EQ(single.positions.get(300 * 2 + 5), point3d(2.5, 0.5, -0.15));
+
+        ASSERT_EQ(parallel.vertex_count(), single.vertex_count());
+        EXPECT_EQ(parallel.indices, single.indices);
+        for (std::size_t index = 0; index < single.vertex_count(); ++index)
+            EXPECT_EQ(parallel.positions.get(index), single.positions.get(index));
+    }
+
+    TEST(mesh_loader_test, ply_ascii)
+    {
+        const std::string ply = "ply\n"
+            "format ascii 1.0\n"
+            "comment made by hand\n"
+            "element vertex 4\n"
+            "property float x\n"
+            "property float y\n"
+            "property float z\n"
+            "property uchar red\n"
+            "property float nx\n"
+            "property float ny\n"
+            "property float nz\n"
+            "element face 2\n"
+            "property uchar flags\n"
+            "property list uchar int vertex_indices\n"
+            "element edge 1\n"
+            "property int vertex1\n"
+            "property int vertex2\n"
+            "end_header\n"
+            "0 0 0 255 0 0 1\n"
+            "1 0 0 255 0 0 1\n"
+            "1 1 0 255 0 0 1\n"
+            "0 1 0.5 255 0 1 0\n"
+            "7 3 0 1 2\n"
+            "7 4 0 1 2 3\n"
+            "0 1\n";
+
+        const geometry::mesh_buffers mesh = geometry::mesh_loader::load(ply.data(), ply.size());
+
+        ASSERT_EQ(mesh.vertex_count(), 4u);
+        EXPECT_EQ(mesh.positions.get(3), point3d(0, 1, 0.5));
+        ASSERT_EQ(mesh.normals.size(), 4u);
+        EXPECT_EQ(mesh.normals.get(3), vector3d(0, 1, 0));
+
+        const std::vector<std::uint32_t> expected = {0, 1, 2, 0, 1, 2, 0, 2, 3};
+        EXPECT_EQ(mesh.indices, expected);
+    }
+
+    TEST(mesh_loader_test, ply_binary)
+    {
+        const char header[] = "ply\n"
+            "format binary_little_endian 1.0\n"
+            "element vertex 3\n"
+            "property float x\n"
+            "property float y\n"
+            "property double z\n"
+            "element face 1\n"
+            "property list uchar uint vertex_indices\n"
+            "end_header\n";
+
+        std::string ply(header);
+        const float xy[3][2] = {{0, 0}, {1, 0}, {0, 1}};
+        for (int vertex = 0; vertex < 3; ++vertex)
+        {
+            const double z = vertex * 0.5;
+            ply.append(reinterpret_cast<const char*>(xy[vertex]), sizeof(xy[vertex]));
+            ply.append(reinterpret_cast<const char*>(&z), sizeof(z));
+        }
+
+        const unsigned char corners = 3;
+        const std::uint32_t face[3] = {2, 1, 0};
+        ply.append(reinterpret_cast<const char*>(&corners), 1);
+        ply.append(reinterpret_cast<const char*>(face), sizeof(face));
+
+        const geometry::mesh_buffers mesh = geometry::mesh_loader::load(ply.data(), ply.size());
+
+        ASSERT_EQ(mesh.vertex_count(), 3u);
+        EXPECT_EQ(mesh.positions.get(1), point3d(1, 0, 0.5));
+        EXPECT_EQ(mesh.positions.get(2), point3d(0, 1, 1));
+        EXPECT_TRUE(mesh.normals.empty());
+
+        const std::vector<std::uint32_t> expected = {2, 1, 0};
+        EXPECT_EQ(mesh.indices, expected);
+
+        //truncated
+        EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(ply.data(), ply.size() - 1)),
+                     exception::io_exception);
+        EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(ply.data(), sizeof(header) + 10)),
+                     exception::io_exception);
+    }
+
+    TEST(mesh_loader_test, ply_binary_float_count)
+    {
+        //a list count stored as a float, used for the faces and for an element that is skipped
+        const std::string header = "ply\n"
+            "format binary_little_endian 1.0\n"
+            "element vertex 3\n"
+            "property float x\n"
+            "property float y\n"
+            "property float z\n"
+            "element face 1\n"
+            "property list float uint vertex_indices\n"
+            "element extra 1\n"
+            "property list float uchar values\n"
+            "end_header\n";
+
+        const auto make_ply = [&header](const float face_count, const float extra_count)
+        {
+            std::string ply(header);
+            const float positions[9] = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+            ply.append(reinterpret_cast<const char*>(positions), sizeof(positions));
+
+            const std::uint32_t face[3] = {0, 1, 2};
+            ply.append(reinterpret_cast<const char*>(&face_count), sizeof(face_count));
+            ply.append(reinterpret_cast<const char*>(face), sizeof(face));
+
+            ply.append(reinterpret_cast<const char*>(&extra_count), sizeof(extra_count));
+            ply.append(2, '\0');
+            return ply;
+        };
+
+        const std::string valid = make_ply(3, 2);
+        const geometry::mesh_buffers mesh = geometry::mesh_loader::load(valid.data(), valid.size());
+        EXPECT_EQ(mesh.indices, std::vector<std::uint32_t>({0, 1, 2}));
+
+        const float invalid[] = {std::nanf(""), -3, 2.5f, 1e30f, std::numeric_limits<float>::infinity()};
+        for (const float count : invalid)
+        {
+            const std::string faces = make_ply(count, 2);
+            EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(faces.data(), faces.size())),
+                         exception::io_exception);
+
+            const std::string extra = make_ply(3, count);
+            EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(extra.data(), extra.size())),
+                         exception::io_exception);
+        }
+    }
+
+    TEST(mesh_loader_test, ply_invalid)
+    {
+        const std::string format = "ply\nformat utf8 1.0\nend_header\n";
+        const std::string no_end = "ply\nformat ascii 1.0\nelement vertex 0\n";
+        const std::string no_z = "ply\nformat ascii 1.0\nelement vertex 1\nproperty float x\nproperty float y\n"
+            "end_header\n0 0\n";
+        const std::string index = "ply\nformat ascii 1.0\nelement vertex 1\nproperty float x\nproperty float y\n"
+            "property float z\nelement face 1\nproperty list uchar int vertex_indices\nend_header\n0 0 0\n3 0 0 1\n";
+
+        EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(format.data(), format.size())),
+                     exception::io_exception);
+        EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(no_end.data(), no_end.size())),
+                     exception::io_exception);
+        EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(no_z.data(), no_z.size())),
+                     exception::io_exception);
+        EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(index.data(), index.size())),
+                     exception::io_exception);
+
+        geometry::mesh_buffers mesh;
+        EXPECT_THROW(geometry::mesh_loader::load_ply(index.data(), 2, mesh), exception::io_exception);
+    }
+
+    TEST(mesh_loader_test, file)
+    {
+        const std::string path = "mesh_loader_test.obj";
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+        }
+
+        const geometry::mesh_buffers mesh = geometry::mesh_loader::load(path);
+        std::remove(path.c_str());
+
+        EXPECT_EQ(mesh.vertex_count(), 3u);
+        EXPECT_EQ(mesh.triangle_count(), 1u);
+        EXPECT_THROW(static_cast<void>(geometry::mesh_loader::load(path)), exception::io_exception);
+    }
+} // namespace testing
@@ -0,0 +1,195 @@
+#include "pch.h"
+#include "BardCore/geometry/quantized_points.h"
+#include "BardCore/geometry/sphere_set.h"
+
+#include <vector>
+
+namespace testing
+{
+    /**
+     * \brief points spread over a box from (-10, -2, 0) to (30, 5, 0.5), the corners included
+     */
+    dimension3_soa<point3d> quantized_points_test_points()
+    {
+        dimension3_soa<point3d> points;
+        points.push_back(point3d(-10, -2, 0));
+        points.push_back(point3d(30, 5, 0.5));
+        for (int index = 0; index < 1000; ++index)
+        {
+            const double t = index / 1000.;
+            points.push_back(point3d(-10 + 40 * t, -2 + 7 * std::fmod(t * 17, 1), 0.5 * std::fmod(t * 31, 1)));
+        }
+
+        return points;
+    }
+
+    /**
+     * \brief checks every decoded point is at most half a step away from its original
+     */
+    template <unsigned Bits>
+    void quantized_points_test_error(const geometry::quantized_points<Bits>& quantized,
+                                     const dimension3_soa<point3d>& points)
+    {
+        ASSERT_EQ(quantized.size(), points.size());
+
+        const vector3d& step = quantized.get_step();
+        for (std::size_t index = 0; index < points.size(); ++index)
+        {
+            const point3d decoded = quantized.get(index);
+            const point3d& original = points.get(index);
+            EXPECT_LE(std::abs(decoded.x - original.x), step.x * 0.5 + 1e-12);
+            EXPECT_LE(std::abs(decoded.y - original.y), step.y * 0.5 + 1e-12);
+            EXPECT_LE(std::abs(decoded.z - original.z), step.z * 0.5 + 1e-12);
+        }
+    }
+
+    TEST(quantized_points_test, constructor)
+    {
+        const geometry::quantized_points16 points({0, -1, 2}, {65535, 1, 2});
+
+        EXPECT_TRUE(points.empty());
+        EXPECT_EQ(points.get_min(), point3d(0, -1, 2));
+        EXPECT_EQ(points.get_max(), point3d(65535, 1, 2));
+        EXPECT_NEAR(points.get_step().x, 1, ROUND_EPSILON);
+        EXPECT_NEAR(points.get_step().y, 2. / 65535, 1e-12);
+        EXPECT_EQ(points.get_step().z, 0);
+
+        EXPECT_THROW(geometry::quantized_points16({1, 0, 0}, {0, 1, 1}), exception::out_of_range_exception);
+        EXPECT_THROW(geometry::quantized_points21({0, 0, 2}, {1, 1, 1}), exception::out_of_range_exception);
+    }
+
+    TEST(quantized_points_test, add)
+    {
+        geometry::quantized_points16 points({0, 0, 0}, {10, 10, 10});
+
+        EXPECT_EQ(points.add({0, 0, 0}), 0u);
+        EXPECT_EQ(points.add({10, 10, 10}), 1u);
+        EXPECT_EQ(points.add({5, 2.5, 7.5}), 2u);
+
+        EXPECT_EQ(points.get(0), point3d(0, 0, 0));
+        EXPECT_EQ(points.get(1), point3d(10, 10, 10));
+        EXPECT_NEAR(points.get(2).x, 5, points.get_step().x);
+        EXPECT_NEAR(points.get(2).y, 2.5, points.get_step().y);
+        EXPECT_NEAR(points.get(2).z, 7.5, points.get_step().z);
+
+        EXPECT_THROW(points.add({-1, 0, 0}), exception::out_of_range_exception);
+        EXPECT_THROW(points.add({0, 0, 10.5}), exception::out_of_range_exception);
+
+        //a batch with a point outside adds nothing
+        dimension3_soa<point3d> batch;
+        batch.push_back(point3d(1, 1, 1));
+        batch.push_back(point3d(1, 11, 1));
+        EXPECT_THROW(points.add(batch), exception::out_of_range_exception);
+        EXPECT_EQ(points.size(), 3u);
+    }
+
+    TEST(quantized_points_test, error16)
+    {
+        const dimension3_soa<point3d> points = quantized_points_test_points();
+        const geometry::quantized_points16 quantized = geometry::quantized_points16::from_points(points);
+
+        EXPECT_EQ(quantized.get_min(), point3d(-10, -2, 0));
+        EXPECT_EQ(quantized.get_max(), point3d(30, 5, 0.5));
+        quantized_points_test_error(quantized, points);
+    }
+
+    TEST(quantized_points_test, error21)
+    {
+        const dimension3_soa<point3d> points = quantized_points_test_points();
+        const geometry::quantized_points21 quantized = geometry::quantized_points21::from_points(points);
+
+        EXPECT_NEAR(quantized.get_step().x, 40. / 2097151, 1e-12);
+        quantized_points_test_error(quantized, points);
+
+        EXPECT_THROW(static_cast<void>(geometry::quantized_points21::from_points(dimension3_soa<point3d>())),
+                     exception::zero_exception);
+    }
+
+    TEST(quantized_points_test, dequantize)
+    {
+        const geometry::quantized_points21 quantized =
+            geometry::quantized_points21::from_points(quantized_points_test_points());
+
+        dimension3_soa<point3d> decoded;
+        quantized.dequantize(decoded);
+        ASSERT_EQ(decoded.size(), quantized.size());
+
+        std::vector<float> x(10), y(10), z(10);
+        quantized.dequantize(100, 110, x.data(), y.data(), z.data());
+
+        for (std::size_t index = 0; index < quantized.size(); ++index)
+            EXPECT_EQ(decoded.get(index), quantized.get(index));
+
+        for (std::size_t index = 0; index < 10; ++index)
+        {
+            EXPECT_EQ(x[index], static_cast<float>(decoded.get(100 + index).x));
+            EXPECT_EQ(y[index], static_cast<float>(decoded.get(100 + index).y));
+            EXPECT_EQ(z[index], static_cast<float>(decoded.get(100 + index).z));
+        }
+    }
+
+    TEST(quantized_points_test, intersect)
+    {
+        geometry::quantized_points16 points({-10, -10, 0}, {10, 10, 20});
+        points.add({0, 0, 10});
+        points.add({0, 0, 5});
+        points.add({5, 0, 0});
+
+        utility::ray_queue rays;
+        rays.push_back(utility::ray({0, 0, 0}, {0, 0, 1}, 100)); // hits both, closest is point 1
+        rays.push_back(utility::ray({0, 0, 0}, {0, 1, 0}, 100)); // misses
+        rays.push_back(utility::ray({0, 0, 0}, {1, 0, 0}, 3)); // too short
+        rays.push_back(utility::ray({0, 0, 5}, {0, 0, 1}, 100)); // starts inside point 1
+
+        utility::hit_queue hits;
+        points.intersect(rays, hits, 1, 7);
+
+        ASSERT_EQ(hits.size(), 4u);
+
+        EXPECT_EQ(hits.primitive[0], 1u);
+        EXPECT_EQ(hits.material[0], 7u);
+        EXPECT_NEAR(hits.distance[0], 4, ROUND_EPSILON);
+        EXPECT_NEAR(hits.normal.get(0).z, -1, ROUND_EPSILON);
+
+        EXPECT_FALSE(hits.is_hit(1));
+        EXPECT_EQ(hits.material[1], std::uint32_t{utility::hit_queue::no_hit});
+        EXPECT_FALSE(hits.is_hit(2));
+
+        EXPECT_EQ(hits.primitive[3], 1u);
+        EXPECT_NEAR(hits.distance[3], 1, ROUND_EPSILON);
+        EXPECT_NEAR(hits.normal.get(3).z, 1, ROUND_EPSILON);
+
+        EXPECT_THROW(points.intersect(rays, hits, 0), exception::zero_exception);
+        EXPECT_THROW(points.intersect(rays, hits, -1), exception::negative_exception);
+    }
+
+    TEST(quantized_points_test, intersect_sphere_set)
+    {
+        //the same as a sphere_set with a sphere at every decoded point
+        const geometry::quantized_points16 quantized =
+            geometry::quantized_points16::from_points(quantized_points_test_points());
+
+        geometry::sphere_set spheres;
+        for (std::size_t index = 0; index < quantized.size(); ++index)
+            spheres.add(quantized.get(index), 0.05);
+
+        utility::ray_queue rays;
+        for (int index = 0; index < 200; ++index)
+            rays.push_back(utility::ray({-10 + index * 0.2, 1.5, -5}, vector3d(0.01 * (index % 7), 0, 1).normalize(),
+                                        100));
+
+        utility::hit_queue quantized_hits, sphere_hits;
+        quantized.intersect(rays, quantized_hits, 0.05);
+        spheres.intersect(rays, sphere_hits);
+
+        std::size_t hit_count = 0;
+        for (std::size_t index = 0; index < rays.size(); ++index)
+        {
+            EXPECT_EQ(quantized_hits.primitive[index], sphere_hits.primitive[index]);
+            EXPECT_EQ(quantized_hits.distance[index], sphere_hits.distance[index]);
+            hit_count += quantized_hits.is_hit(index) ? 1 : 0;
+        }
+
+        EXPECT_GT(hit_count, 0u);
+    }
+} // namespace testing
@@ -0,0 +1,232 @@
+#include "pch.h"
+#include "BardCore/geometry/sphere_set.h"
+
+#include <vector>
+
+namespace testing
+{
+    //min_distance of sphere_set as tmin of the single precision rays
+    constexpr double sphere_set_test_min_distance = 0.00001;
+
+    TEST(sphere_set_test, add)
+    {
+        geometry::sphere_set spheres;
+
+        EXPECT_EQ(spheres.add({1, 2, 3}, 4, 5), 0u);
+        EXPECT_EQ(spheres.add({0, 0, 0}, 1), 1u);
+
+        EXPECT_EQ(spheres.size(), 2u);
+        EXPECT_EQ(spheres.get_center(0), point3d(1, 2, 3));
+        EXPECT_EQ(spheres.get_radius(0), 4);
+        EXPECT_EQ(spheres.get_material(0), 5u);
+    }
+
+    TEST(sphere_set_test, add_exceptions)
+    {
+        geometry::sphere_set spheres;
+
+        EXPECT_THROW(spheres.add({0, 0, 0}, 0), exception::zero_exception);
+        EXPECT_THROW(spheres.add({0, 0, 0}, -1), exception::negative_exception);
+    }
+
+    TEST(sphere_set_test, intersect_closest)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 10}, 1, 0);
+        spheres.add({0, 0, 5}, 1, 1);
+        spheres.add({5, 0, 0}, 1, 2);
+
+        utility::ray_queue rays;
+        rays.push_back(utility::ray({0, 0, 0}, {0, 0, 1}, 100)); // hits both, closest is sphere 1
+        rays.push_back(utility::ray({0, 0, 0}, {0, 1, 0}, 100)); // misses
+        rays.push_back(utility::ray({0, 0, 0}, {1, 0, 0}, 3)); // too short
+        rays.push_back(utility::ray({0, 0, 5}, {0, 0, 1}, 100)); // starts inside sphere 1
+
+        utility::hit_queue hits;
+        spheres.intersect(rays, hits);
+
+        ASSERT_EQ(hits.size(), 4u);
+
+        EXPECT_EQ(hits.primitive[0], 1u);
+        EXPECT_EQ(hits.material[0], 1u);
+        EXPECT_NEAR(hits.distance[0], 4, ROUND_EPSILON);
+        EXPECT_EQ(hits.normal.get(0), vector3d(0, 0, -1));
+
+        EXPECT_FALSE(hits.is_hit(1));
+        EXPECT_EQ(hits.material[1], std::uint32_t{utility::hit_queue::no_hit});
+        EXPECT_FALSE(hits.is_hit(2));
+
+        EXPECT_EQ(hits.primitive[3], 1u);
+        EXPECT_NEAR(hits.distance[3], 1, ROUND_EPSILON);
+        EXPECT_EQ(hits.normal.get(3), vector3d(0, 0, 1));
+    }
+
+    TEST(sphere_set_test, intersect_range)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1);
+
+        utility::ray_queue rays;
+        rays.push_back(utility::ray({0, 0, 0}, {0, 0, 1}, 100));
+        rays.push_back(utility::ray({0, 0, 0}, {0, 0, 1}, 100));
+
+        utility::hit_queue hits;
+        hits.resize(rays.size());
+        hits.primitive[0] = 42; // untouched, outside the range
+        spheres.intersect(rays, 1, 2, hits);
+
+        EXPECT_EQ(hits.primitive[0], 42u);
+        EXPECT_EQ(hits.primitive[1], 0u);
+    }
+
+    TEST(sphere_set_test, occluded)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1);
+        spheres.add({0, 0, 8}, 1);
+
+        utility::ray_queue segments;
+        segments.push_segment({0, 0, 0}, {0, 0, 10}); // through both spheres
+        segments.push_segment({0, 0, 0}, {0, 0, 3}); // ends before the first sphere
+        segments.push_segment({0, 0, 0}, {0, 10, 0}); // misses
+        segments.push_segment({0, 0, 5}, {0, 0, 5.5}); // starts and ends inside
+        segments.push_segment({0, 0, 5}, {0, 0, 7}); // starts inside, leaves the sphere
+
+        std::vector<std::uint8_t> result;
+        spheres.occluded(segments, result);
+
+        ASSERT_EQ(result.size(), 5u);
+        EXPECT_EQ(result[0], 1);
+        EXPECT_EQ(result[1], 0);
+        EXPECT_EQ(result[2], 0);
+        EXPECT_EQ(result[3], 0);
+        EXPECT_EQ(result[4], 1);
+    }
+
+    TEST(sphere_set_test, occluded_matches_intersect)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1);
+        spheres.add({2, 1, 4}, 0.5);
+        spheres.add({-1, 2, 6}, 1.5);
+
+        dimension3_soa<point3d> starts;
+        dimension3_soa<point3d> ends;
+        for (int x = -4; x <= 4; ++x)
+        {
+            for (int y = -4; y <= 4; ++y)
+            {
+                starts.push_back({0, 0, 0});
+                ends.push_back({x * 0.5, y * 0.5, 10});
+            }
+        }
+
+        utility::ray_queue segments;
+        segments.assign_segments(starts, ends);
+
+        std::vector<std::uint8_t> result;
+        utility::hit_queue hits;
+        spheres.occluded(segments, result);
+        spheres.intersect(segments, hits);
+
+        for (std::size_t index = 0; index < segments.size(); ++index)
+        {
+            EXPECT_EQ(result[index] != 0, hits.is_hit(index));
+            EXPECT_EQ(result[index] != 0, spheres.occluded(segments.get_ray(index)));
+        }
+    }
+
+    TEST(sphere_set_test, intersect_ray32)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1);
+        spheres.add({2, 1, 4}, 0.5);
+        spheres.add({-1, 2, 6}, 1.5);
+
+        utility::ray_queue rays;
+        for (int x = -4; x <= 4; ++x)
+            for (int y = -4; y <= 4; ++y)
+                rays.push_back(utility::ray({0, 0, 0}, {x * 0.5, y * 0.5, 10}, 100));
+        rays.push_back(utility::ray({0, 0, 5}, {0, 0, 1}, 100)); // starts inside sphere 0
+
+        //the same closest hits as in double precision
+        utility::ray32_queue compact;
+        compact.assign(rays, 0, sphere_set_test_min_distance);
+        std::vector<std::uint32_t> primitive;
+        spheres.intersect(compact, primitive);
+
+        utility::hit_queue hits;
+        spheres.intersect(rays, hits);
+
+        ASSERT_EQ(primitive.size(), rays.size());
+        for (std::size_t index = 0; index < rays.size(); ++index)
+        {
+            EXPECT_EQ(primitive[index], hits.primitive[index]);
+            EXPECT_NEAR(compact.tmax[index], hits.distance[index], ROUND_EPSILON);
+        }
+        EXPECT_EQ(primitive.back(), 0u);
+        EXPECT_NEAR(compact.tmax.back(), 1, ROUND_EPSILON);
+
+        //a short ray keeps its tmax
+        utility::ray32_queue short_ray;
+        short_ray.push_back(utility::ray({0, 0, 0}, {0, 0, 1}, 3));
+        spheres.intersect(short_ray, primitive);
+        EXPECT_EQ(primitive[0], std::uint32_t{utility::hit_queue::no_hit});
+        EXPECT_EQ(short_ray.tmax[0], 3);
+    }
+
+    TEST(sphere_set_test, ray32_far_sphere)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 10000}, 1);
+
+        //b^2 and c are about 1e8 here, more than float can hold without losing the radius
+        utility::ray_queue rays;
+        rays.push_back(utility::ray({0, 0, 0}, {0, 0, 1}, 20000));
+        rays.push_back(utility::ray({0, 0, 0}, {0.5, 0, 10000}, 20000));
+        rays.push_back(utility::ray({0, 0, 0}, {0, 0.9, 10000}, 20000));
+        rays.push_back(utility::ray({0, 0, 0}, {0, 1.2, 10000}, 20000));
+
+        utility::ray32_queue compact;
+        compact.assign(rays, 0, sphere_set_test_min_distance);
+        std::vector<std::uint32_t> primitive;
+        spheres.intersect(compact, primitive);
+        EXPECT_NEAR(compact.tmax[0], 9999, 0.01);
+
+        std::vector<std::uint8_t> result;
+        compact.assign(rays, 0, sphere_set_test_min_distance);
+        spheres.occluded(compact, result);
+
+        const std::uint8_t expected[4] = {1, 1, 1, 0};
+        for (std::size_t index = 0; index < 4; ++index)
+        {
+            EXPECT_EQ(primitive[index] == 0, expected[index] == 1);
+            EXPECT_EQ(result[index], expected[index]);
+        }
+    }
+
+    TEST(sphere_set_test, occluded_ray32)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1);
+        spheres.add({0, 0, 8}, 1);
+
+        utility::ray_queue segments;
+        segments.push_segment({0, 0, 0}, {0, 0, 10}); // through both spheres
+        segments.push_segment({0, 0, 0}, {0, 0, 3}); // ends before the first sphere
+        segments.push_segment({0, 0, 0}, {0, 10, 0}); // misses
+        segments.push_segment({0, 0, 5}, {0, 0, 5.5}); // starts and ends inside
+        segments.push_segment({0, 0, 5}, {0, 0, 7}); // starts inside, leaves the sphere
+
+        utility::ray32_queue compact;
+        compact.assign(segments, 0, sphere_set_test_min_distance);
+
+        std::vector<std::uint8_t> expected, result;
+        spheres.occluded(segments, expected);
+        spheres.occluded(compact, result);
+
+        ASSERT_EQ(result.size(), 5u);
+        for (std::size_t index = 0; index < result.size(); ++index)
+            EXPECT_EQ(result[index], expected[index]);
+    }
+} // namespace testing
@@ -0,0 +1,67 @@
+#include "pch.h"
+#include "BardCore/interfaces/dimension3_soa.h"
+#include "BardCore/math/point3d.h"
+#include "BardCore/math/vector3d.h"
+
+#include <vector>
+
+namespace testing
+{
+    TEST(dimension3_soa_test, constructor)
+    {
+        const dimension3_soa<point3d> empty;
+        const dimension3_soa<point3d> sized(3);
+        const dimension3_soa<vector3d> copied(std::vector<vector3d>{{1, 2, 3}, {4, 5, 6}});
+
+        EXPECT_TRUE(empty.empty());
+        EXPECT_EQ(sized.size(), 3u);
+        EXPECT_EQ(sized.get(2), point3d::zero());
+        ASSERT_EQ(copied.size(), 2u);
+        EXPECT_EQ(copied.get(1), vector3d(4, 5, 6));
+    }
+
+    TEST(dimension3_soa_test, separate_arrays)
+    {
+        dimension3_soa<point3d> points;
+        points.push_back({1, 2, 3});
+        points.push_back({4, 5, 6});
+
+        EXPECT_EQ(points.x()[0], 1);
+        EXPECT_EQ(points.x()[1], 4);
+        EXPECT_EQ(points.y()[1], 5);
+        EXPECT_EQ(points.z()[0], 3);
+
+        points.set(0, {7, 8, 9});
+        EXPECT_EQ(points.get(0), point3d(7, 8, 9));
+    }
+
+    TEST(dimension3_soa_test, gather)
+    {
+        const dimension3_soa<vector3d> source(std::vector<vector3d>{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}});
+        const std::vector<std::size_t> indices = {2, 0, 2, 1};
+
+        dimension3_soa<vector3d> result;
+        result.gather(source, indices.data(), indices.size());
+
+        ASSERT_EQ(result.size(), 4u);
+        EXPECT_EQ(result.get(0), vector3d(0, 0, 1));
+        EXPECT_EQ(result.get(1), vector3d(1, 0, 0));
+        EXPECT_EQ(result.get(2), vector3d(0, 0, 1));
+        EXPECT_EQ(result.get(3), vector3d(0, 1, 0));
+    }
+
+    TEST(dimension3_soa_test, resize_clear_swap)
+    {
+        dimension3_soa<point3d> first(std::vector<point3d>{{1, 1, 1}});
+        dimension3_soa<point3d> second(4);
+
+        first.swap(second);
+        EXPECT_EQ(first.size(), 4u);
+        EXPECT_EQ(second.get(0), point3d(1, 1, 1));
+
+        first.resize(2);
+        EXPECT_EQ(first.size(), 2u);
+        first.clear();
+        EXPECT_TRUE(first.empty());
+    }
+} // namespace testing
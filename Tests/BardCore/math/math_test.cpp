@@ -85,6 +85,20 @@ namespace testing
         ASSERT_TRUE(math::equals(3162.27766, math::sqrt(10000000))) << math::sqrt(10000000);
     }
 
+    //test sqrt constexpr over a wide range of values
+    TEST(math_test, sqrt_range_test)
+    {
+        constexpr double large = math::sqrt(1e300);
+        constexpr double small = math::sqrt(1e-300);
+        constexpr double two = math::sqrt(2);
+        constexpr double zero = math::sqrt(0);
+
+        ASSERT_NEAR(1e150, large, 1e150 * ROUND_EPSILON);
+        ASSERT_NEAR(1e-150, small, 1e-150 * ROUND_EPSILON);
+        ASSERT_NEAR(std::sqrt(2), two, ROUND_EPSILON);
+        ASSERT_EQ(0, zero);
+    }
+
     //test euclidean_gcd constexpr
     TEST(math_test, euclidean_gcd_test)
     {
@@ -561,4 +575,36 @@ namespace testing
         ASSERT_TRUE(math::equals(6, math::factorial(3)));
         ASSERT_TRUE(math::equals(3628800, math::factorial(10)));
     }
+
+    //test hash constexpr
+    TEST(math_test, hash_test)
+    {
+        constexpr std::uint32_t result = math::hash(1);
+
+        ASSERT_EQ(result, math::hash(1));
+        ASSERT_NE(math::hash(1), math::hash(2));
+        ASSERT_NE(math::hash(1), 1u);
+    }
+
+    //test reverse_bits constexpr
+    TEST(math_test, reverse_bits_test)
+    {
+        constexpr std::uint32_t result = math::reverse_bits(1);
+
+        ASSERT_EQ(result, 0x80000000u);
+        ASSERT_EQ(math::reverse_bits(0x80000000u), 1u);
+        ASSERT_EQ(math::reverse_bits(0x0000FFFFu), 0xFFFF0000u);
+        ASSERT_EQ(math::reverse_bits(0x12345678u), 0x1E6A2C48u);
+    }
+
+    //test to_unit_interval constexpr
+    TEST(math_test, to_unit_interval_test)
+    {
+        constexpr double result = math::to_unit_interval(0x80000000u);
+
+        ASSERT_EQ(result, 0.5);
+        ASSERT_EQ(math::to_unit_interval(0), 0);
+        ASSERT_EQ(math::to_unit_interval(0x40000000u), 0.25);
+        ASSERT_LT(math::to_unit_interval(0xFFFFFFFFu), 1);
+    }
 } // namespace testing
@@ -0,0 +1,144 @@
+#include "pch.h"
+#include "BardCore/math/octahedral.h"
+
+namespace testing
+{
+    /**
+     * \brief directions spread over the whole sphere, a fibonacci spiral plus the axes and the diagonals
+     */
+    dimension3_soa<vector3d> octahedral_test_directions()
+    {
+        dimension3_soa<vector3d> directions;
+        const int count = 20000;
+        for (int index = 0; index < count; ++index)
+        {
+            const double z = 1 - (2 * index + 1) / static_cast<double>(count);
+            const double radius = std::sqrt(1 - z * z);
+            const double angle = index * 2.399963229728653;
+            directions.push_back(vector3d(radius * std::cos(angle), radius * std::sin(angle), z));
+        }
+
+        for (int x = -1; x <= 1; ++x)
+            for (int y = -1; y <= 1; ++y)
+                for (int z = -1; z <= 1; ++z)
+                    if (x != 0 || y != 0 || z != 0)
+                        directions.push_back(vector3d(x, y, z).normalize());
+
+        return directions;
+    }
+
+    /**
+     * \brief largest angle in degrees between the directions and their decoded encoding
+     */
+    double octahedral_test_max_error(const dimension3_soa<vector3d>& directions,
+                                     const dimension3_soa<vector3d>& decoded)
+    {
+        double largest = 0;
+        for (std::size_t index = 0; index < directions.size(); ++index)
+        {
+            EXPECT_NEAR(decoded.get(index).length(), 1, 1e-12);
+
+            const double cosine = directions.get(index).dot(decoded.get(index));
+            const double angle = std::acos(cosine < 1 ? cosine : 1) * 180 / 3.14159265358979323846;
+            largest = angle > largest ? angle : largest;
+        }
+
+        return largest;
+    }
+
+    TEST(octahedral_test, size)
+    {
+        EXPECT_EQ(sizeof(octahedral32), 4u);
+        EXPECT_EQ(sizeof(octahedral48), 6u);
+    }
+
+    TEST(octahedral_test, default_constructor)
+    {
+        EXPECT_EQ(octahedral32(), octahedral32(vector3d(0, 0, 1)));
+        EXPECT_EQ(octahedral48(), octahedral48(vector3d(0, 0, 1)));
+        EXPECT_NEAR(octahedral32().decode().z, 1, 1e-8);
+        EXPECT_NEAR(octahedral48().decode().z, 1, 1e-12);
+    }
+
+    TEST(octahedral_test, round_trip)
+    {
+        const vector3d vectors[6] = {{1, 0, 0}, {0, -1, 0}, {0, 0, -1}, {3, 4, 0}, {-1, 2, -3}, {0.5, -0.5, 0.1}};
+        for (const vector3d& vector : vectors)
+        {
+            const vector3d normalized = vector.normalize();
+            const vector3d decoded32 = octahedral32(vector).decode();
+            const vector3d decoded48 = octahedral48(vector).decode();
+
+            EXPECT_NEAR(decoded32.x, normalized.x, ROUND_EPSILON);
+            EXPECT_NEAR(decoded32.y, normalized.y, ROUND_EPSILON);
+            EXPECT_NEAR(decoded32.z, normalized.z, ROUND_EPSILON);
+            EXPECT_NEAR(decoded48.x, normalized.x, 1e-6);
+            EXPECT_NEAR(decoded48.y, normalized.y, 1e-6);
+            EXPECT_NEAR(decoded48.z, normalized.z, 1e-6);
+        }
+
+        EXPECT_THROW(octahedral32(vector3d(0, 0, 0)), exception::zero_exception);
+        EXPECT_THROW(octahedral48(vector3d(0, 0, 0)), exception::zero_exception);
+    }
+
+    TEST(octahedral_test, bits)
+    {
+        const octahedral32 value(vector3d(-1, 2, -3));
+        EXPECT_EQ(octahedral32::from_bits(value.get_bits()), value);
+        EXPECT_NE(octahedral32(vector3d(1, 0, 0)), value);
+        EXPECT_NE(octahedral48(vector3d(1, 0, 0)), octahedral48(vector3d(-1, 2, -3)));
+    }
+
+    TEST(octahedral_test, error32)
+    {
+        const dimension3_soa<vector3d> directions = octahedral_test_directions();
+
+        std::vector<octahedral32> encoded;
+        dimension3_soa<vector3d> decoded;
+        octahedral32::encode(directions, encoded);
+        octahedral32::decode(encoded, decoded);
+
+        ASSERT_EQ(encoded.size(), directions.size());
+        ASSERT_EQ(decoded.size(), directions.size());
+        EXPECT_LT(octahedral_test_max_error(directions, decoded), 0.005);
+
+        //the batch is the same as one at a time
+        for (std::size_t index = 0; index < directions.size(); ++index)
+        {
+            EXPECT_EQ(encoded[index], octahedral32(directions.get(index)));
+            EXPECT_EQ(decoded.get(index), encoded[index].decode());
+        }
+    }
+
+    TEST(octahedral_test, error48)
+    {
+        const dimension3_soa<vector3d> directions = octahedral_test_directions();
+
+        std::vector<octahedral48> encoded;
+        dimension3_soa<vector3d> decoded;
+        octahedral48::encode(directions, encoded);
+        octahedral48::decode(encoded, decoded);
+
+        ASSERT_EQ(decoded.size(), directions.size());
+        EXPECT_LT(octahedral_test_max_error(directions, decoded), 0.00002);
+
+        for (std::size_t index = 0; index < directions.size(); ++index)
+        {
+            EXPECT_EQ(encoded[index], octahedral48(directions.get(index)));
+            EXPECT_EQ(decoded.get(index), encoded[index].decode());
+        }
+    }
+
+    TEST(octahedral_test, batch_zero)
+    {
+        //a zero vector doesn't throw in a batch, it becomes (0, 0, 1)
+        const double zero = 0;
+        octahedral32 value32 = octahedral32::from_bits(0);
+        octahedral48 value48(vector3d(1, 0, 0));
+        octahedral32::encode(&zero, &zero, &zero, 1, &value32);
+        octahedral48::encode(&zero, &zero, &zero, 1, &value48);
+
+        EXPECT_EQ(value32, octahedral32());
+        EXPECT_EQ(value48, octahedral48());
+    }
+} // namespace testing
@@ -0,0 +1,55 @@
+#include "pch.h"
+#include "BardCore/utility/alias_table.h"
+
+#include <vector>
+
+namespace testing
+{
+    TEST(alias_table_test, constructor)
+    {
+        EXPECT_THROW(utility::alias_table(std::vector<double>{}), exception::zero_exception);
+        EXPECT_THROW(utility::alias_table(std::vector<double>{0, 0}), exception::zero_exception);
+        EXPECT_THROW(utility::alias_table(std::vector<double>{1, -1}), exception::negative_exception);
+
+        const utility::alias_table table(std::vector<double>{1, 3, 0, 4});
+        EXPECT_EQ(table.size(), 4u);
+        EXPECT_DOUBLE_EQ(table.pdf(0), 0.125);
+        EXPECT_DOUBLE_EQ(table.pdf(1), 0.375);
+        EXPECT_DOUBLE_EQ(table.pdf(2), 0);
+        EXPECT_DOUBLE_EQ(table.pdf(3), 0.5);
+    }
+
+    TEST(alias_table_test, sample)
+    {
+        const std::vector<double> weights{1, 3, 0, 4};
+        const utility::alias_table table(weights);
+
+        //stratified random numbers hit every bucket equally, so the counts match the weights exactly
+        constexpr std::size_t samples = 8000;
+        std::vector<std::size_t> counts(weights.size(), 0);
+        for (std::size_t index = 0; index < samples; ++index)
+            ++counts[table.sample((static_cast<double>(index) + 0.5) / samples)];
+
+        EXPECT_EQ(counts[0], 1000u);
+        EXPECT_EQ(counts[1], 3000u);
+        EXPECT_EQ(counts[2], 0u);
+        EXPECT_EQ(counts[3], 4000u);
+        EXPECT_LT(table.sample(0.9999999999), weights.size());
+    }
+
+    TEST(alias_table_test, sample_batch)
+    {
+        const utility::alias_table table(std::vector<double>{5, 1, 2, 2, 7});
+
+        std::vector<double> random;
+        for (std::size_t index = 0; index < 100; ++index)
+            random.push_back(static_cast<double>(index) / 100);
+
+        std::vector<std::uint32_t> result;
+        table.sample(random, result);
+
+        ASSERT_EQ(result.size(), random.size());
+        for (std::size_t index = 0; index < random.size(); ++index)
+            EXPECT_EQ(result[index], table.sample(random[index]));
+    }
+} // namespace testing
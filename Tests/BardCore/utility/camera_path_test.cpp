@@ -0,0 +1,64 @@
+#include "pch.h"
+#include "BardCore/utility/camera_path.h"
+
+#include <cmath>
+#include <vector>
+
+namespace testing
+{
+    TEST(camera_path_test, constructor)
+    {
+        const std::vector<point3d> positions{{0, 0, 0}, {1, 2, 3}};
+        const std::vector<vector3d> directions{{0, 0, 2}, {1, 1, 0}};
+        const utility::camera_path path(positions, directions, 64, 32, 70);
+
+        EXPECT_EQ(path.size(), 2u);
+        EXPECT_EQ(path.get_screen_width(), 64u);
+        EXPECT_EQ(path.get_screen_height(), 32u);
+        EXPECT_EQ(path.get_fov(), 70u);
+        EXPECT_EQ(path.get_directions().get(0), vector3d(0, 0, 1));
+
+        EXPECT_THROW(utility::camera_path(positions, directions, 0, 32), exception::zero_exception);
+        EXPECT_THROW(utility::camera_path(positions, directions, 64, 32, 0), exception::zero_exception);
+        EXPECT_THROW(utility::camera_path(positions, directions, 64, 32, 180), exception::out_of_range_exception);
+        EXPECT_THROW(utility::camera_path(positions, {{0, 0, 1}}, 64, 32), exception::out_of_range_exception);
+        EXPECT_THROW(utility::camera_path(positions, {{0, 0, 1}, {0, 0, 0}}, 64, 32), exception::zero_exception);
+    }
+
+    TEST(camera_path_test, get_camera)
+    {
+        std::vector<point3d> positions;
+        std::vector<vector3d> directions;
+        for (int frame = 0; frame < 37; ++frame)
+        {
+            const double angle = frame * 0.17;
+            positions.emplace_back(std::cos(angle) * 10, frame * 0.1, std::sin(angle) * 10);
+            directions.emplace_back(-std::cos(angle), -0.2, -std::sin(angle));
+        }
+        positions.emplace_back(0, 0, 0);
+        directions.emplace_back(1, 0, 0); // the direction camera handles separately
+        positions.emplace_back(0, 0, 0);
+        directions.emplace_back(-1, 0, 0); // parallel to the arbitrary vector as well
+
+        const utility::camera_path path(positions, directions, 40, 30, 75);
+
+        for (std::size_t frame = 0; frame < path.size(); ++frame)
+        {
+            const utility::camera expected(positions[frame], directions[frame], 40, 30, 75);
+            const utility::camera camera = path.get_camera(frame);
+
+            EXPECT_EQ(camera, expected);
+            EXPECT_EQ(camera.get_top_left(), expected.get_top_left());
+            EXPECT_EQ(camera.get_half_horizontal(), expected.get_half_horizontal());
+            EXPECT_EQ(camera.get_half_vertical(), expected.get_half_vertical());
+            EXPECT_EQ(camera.shoot_ray(7, 21, 5), expected.shoot_ray(7, 21, 5));
+        }
+
+        const utility::camera backwards = path.get_camera(path.size() - 1);
+        EXPECT_TRUE(std::isfinite(backwards.get_top_left().x));
+        EXPECT_TRUE(std::isfinite(backwards.get_half_horizontal().length()));
+        EXPECT_TRUE(std::isfinite(backwards.get_half_vertical().length()));
+
+        EXPECT_THROW(static_cast<void>(path.get_camera(path.size())), exception::out_of_range_exception);
+    }
+} // namespace testing
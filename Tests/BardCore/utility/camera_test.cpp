@@ -60,6 +60,32 @@ namespace testing
         EXPECT_EQ(cam.get_fov(), new_fov);
     }
 
+    TEST(camera_test, update)
+    {
+        utility::camera cam(point3d(0, 0, 0), vector3d(0, 0, 1), 10, 10, 90);
+        cam.update().position(point3d(1, 2, 3)).direction(vector3d(0, 3, 4)).width(20).height(30).fov(60);
+
+        const utility::camera expected(point3d(1, 2, 3), vector3d(0, 3, 4), 20, 30, 60);
+        EXPECT_EQ(cam, expected);
+        EXPECT_EQ(cam.get_top_left(), expected.get_top_left());
+        EXPECT_EQ(cam.get_half_horizontal(), expected.get_half_horizontal());
+        EXPECT_EQ(cam.get_half_vertical(), expected.get_half_vertical());
+
+        // the screen is calculated once the updater is destroyed
+        {
+            utility::camera::updater updater = cam.update();
+            updater.position(point3d(5, 5, 5));
+            EXPECT_EQ(cam.get_top_left(), expected.get_top_left());
+        }
+        EXPECT_EQ(cam.get_top_left(), expected.get_top_left() + vector3d(4, 3, 2));
+
+        EXPECT_THROW(cam.update().width(0), exception::zero_exception);
+        EXPECT_THROW(cam.update().height(0), exception::zero_exception);
+        EXPECT_THROW(cam.update().fov(0), exception::zero_exception);
+        EXPECT_THROW(cam.update().fov(180), exception::out_of_range_exception);
+        EXPECT_THROW(cam.update().direction(vector3d(0, 0, 0)), exception::zero_exception);
+    }
+
     TEST(camera_test, setters_exceptions)
     {
         constexpr point3d position{0, 0, 0};
@@ -79,6 +105,21 @@ namespace testing
         EXPECT_THROW(cam.set_height(new_screen_height), exception::zero_exception);
     }
 
+    TEST(camera_test, screen)
+    {
+        const utility::camera cam(point3d(1, 2, 3), vector3d(0, 0, 1), 40, 20, 90);
+
+        // with a fov of 90 the half vectors have length tan(45) = 1 and are perpendicular to the direction
+        EXPECT_NEAR(cam.get_half_horizontal().length(), 1, ROUND_EPSILON);
+        EXPECT_NEAR(cam.get_half_vertical().length(), 1, ROUND_EPSILON);
+        EXPECT_NEAR(cam.get_half_horizontal().dot(cam.get_direction()), 0, ROUND_EPSILON);
+        EXPECT_NEAR(cam.get_half_vertical().dot(cam.get_direction()), 0, ROUND_EPSILON);
+
+        // the first pixel goes through the top left corner
+        const vector3d corner = cam.get_position().get_vector(cam.get_top_left()).normalize();
+        EXPECT_EQ(cam.shoot_ray(0, 0, 1).get_direction(), corner);
+    }
+
     TEST(camera_test, shoot_ray)
     {
         constexpr point3d position{-1, 2, 0};
@@ -132,4 +173,62 @@ namespace testing
         EXPECT_NO_THROW(cam.shoot_ray(0, 0, distance));
         EXPECT_NO_THROW(cam.shoot_ray(screen_width - 1, screen_height - 1, distance));
     }
+
+    TEST(camera_test, shoot_rays)
+    {
+        constexpr point3d position{-1, 2, 0};
+        constexpr vector3d direction{9, 65, 24};
+        constexpr unsigned int screen_width = 30;
+        constexpr unsigned int screen_height = 20;
+        constexpr double distance = 7;
+        constexpr unsigned int fov = 120;
+
+        const utility::camera cam(position, direction, screen_width, screen_height, fov);
+
+        utility::ray_queue queue;
+        cam.shoot_rays(queue, distance);
+
+        ASSERT_EQ(queue.size(), screen_width * screen_height);
+        for (unsigned int y = 0; y < screen_height; ++y)
+        {
+            for (unsigned int x = 0; x < screen_width; ++x)
+            {
+                const std::size_t index = y * screen_width + x;
+
+                EXPECT_EQ(queue.get_ray(index), cam.shoot_ray(x, y, distance));
+                EXPECT_EQ(queue.pixel[index], index);
+                EXPECT_EQ(queue.throughput[index], 1);
+                EXPECT_EQ(queue.depth[index], 0u);
+            }
+        }
+
+        EXPECT_THROW(cam.shoot_rays(queue, -1), exception::negative_exception);
+    }
+
+    TEST(camera_test, shoot_subpixel_ray)
+    {
+        const utility::camera cam(point3d(1, 2, 3), vector3d(1, 1, 0), 40, 20, 70);
+
+        //whole numbers are the same as shoot_ray
+        const utility::ray whole = cam.shoot_subpixel_ray(7, 3, 10);
+        const utility::ray expected = cam.shoot_ray(7, 3, 10);
+        EXPECT_NEAR(whole.get_direction().x, expected.get_direction().x, ROUND_EPSILON);
+        EXPECT_NEAR(whole.get_direction().y, expected.get_direction().y, ROUND_EPSILON);
+        EXPECT_NEAR(whole.get_direction().z, expected.get_direction().z, ROUND_EPSILON);
+
+        //on the screen, the center of a pixel lies halfway between the pixel and the next one
+        const auto on_screen = [&cam](const utility::ray& ray)
+        {
+            return ray.get_direction() / ray.get_direction().dot(cam.get_direction());
+        };
+        const vector3d center = on_screen(cam.shoot_subpixel_ray(7.5, 3.5, 10));
+        const vector3d between = (on_screen(cam.shoot_ray(7, 3, 10)) + on_screen(cam.shoot_ray(8, 4, 10))) / 2;
+        EXPECT_NEAR(center.x, between.x, ROUND_EPSILON);
+        EXPECT_NEAR(center.y, between.y, ROUND_EPSILON);
+        EXPECT_NEAR(center.z, between.z, ROUND_EPSILON);
+
+        EXPECT_THROW(cam.shoot_subpixel_ray(-0.5, 0, 10), exception::out_of_range_exception);
+        EXPECT_THROW(cam.shoot_subpixel_ray(0, 20, 10), exception::out_of_range_exception);
+        EXPECT_THROW(cam.shoot_subpixel_ray(40, 0, 10), exception::out_of_range_exception);
+    }
 } // namespace testing
@@ -0,0 +1,81 @@
+#include "pch.h"
+#include "BardCore/utility/hemisphere.h"
+#include "BardCore/utility/low_discrepancy.h"
+
+#include <vector>
+
+namespace testing
+{
+    TEST(hemisphere_test, constructor)
+    {
+        for (const vector3d& normal : {vector3d(0, 0, 1), vector3d(0, 0, -1), vector3d(1, 2, 3), vector3d(-1, 0, 0)})
+        {
+            const utility::hemisphere hemisphere(normal);
+            const vector3d& n = hemisphere.get_normal();
+            const vector3d& t = hemisphere.get_tangent();
+            const vector3d& b = hemisphere.get_bitangent();
+
+            EXPECT_NEAR(n.length(), 1, ROUND_EPSILON);
+            EXPECT_NEAR(t.length(), 1, ROUND_EPSILON);
+            EXPECT_NEAR(b.length(), 1, ROUND_EPSILON);
+            EXPECT_NEAR(n.dot(t), 0, ROUND_EPSILON);
+            EXPECT_NEAR(n.dot(b), 0, ROUND_EPSILON);
+            EXPECT_NEAR(t.dot(b), 0, ROUND_EPSILON);
+        }
+
+        EXPECT_THROW(utility::hemisphere(vector3d(0, 0, 0)), exception::zero_exception);
+    }
+
+    TEST(hemisphere_test, cosine_sample)
+    {
+        const utility::hemisphere hemisphere(vector3d(1, 2, 3));
+        const vector3d normal = vector3d(1, 2, 3).normalize();
+
+        //u = 0 is the normal
+        const vector3d top = hemisphere.cosine_sample(0, 0.3);
+        EXPECT_NEAR(top.x, normal.x, ROUND_EPSILON);
+        EXPECT_NEAR(top.y, normal.y, ROUND_EPSILON);
+        EXPECT_NEAR(top.z, normal.z, ROUND_EPSILON);
+
+        const vector3d direction = hemisphere.cosine_sample(0.75, 0.6);
+        EXPECT_NEAR(direction.length(), 1, ROUND_EPSILON);
+        EXPECT_NEAR(direction.dot(normal), 0.5, ROUND_EPSILON);
+        EXPECT_NEAR(hemisphere.cosine_pdf(direction), 0.5 / math::pi, ROUND_EPSILON);
+        EXPECT_EQ(hemisphere.cosine_pdf(normal * -1), 0);
+    }
+
+    TEST(hemisphere_test, cosine_samples)
+    {
+        const utility::hemisphere hemisphere(vector3d(0, -1, 1));
+        const utility::sobol_sequence sobol(7);
+
+        //more than one block
+        dimension3_soa<vector3d> directions;
+        hemisphere.cosine_samples(sobol, 10, 150, directions);
+        ASSERT_EQ(directions.size(), 150u);
+
+        double mean_cosine = 0;
+        for (std::uint32_t index = 0; index < 150; ++index)
+        {
+            const vector3d expected = hemisphere.cosine_sample(sobol.sample(index + 10, 0), sobol.sample(index + 10, 1));
+            const vector3d actual = directions.get(index);
+
+            EXPECT_NEAR(actual.x, expected.x, ROUND_EPSILON);
+            EXPECT_NEAR(actual.y, expected.y, ROUND_EPSILON);
+            EXPECT_NEAR(actual.z, expected.z, ROUND_EPSILON);
+            EXPECT_GE(actual.dot(hemisphere.get_normal()), 0);
+            mean_cosine += actual.dot(hemisphere.get_normal()) / 150;
+        }
+
+        //the mean cosine of a cosine weighted hemisphere is 2 / 3
+        EXPECT_NEAR(mean_cosine, 2. / 3, 0.01);
+
+        const utility::halton_sequence halton;
+        hemisphere.cosine_samples(halton, 0, 20, directions);
+        EXPECT_EQ(directions.size(), 20u);
+
+        const utility::r2_sequence r2;
+        hemisphere.cosine_samples(r2, 0, 0, directions);
+        EXPECT_EQ(directions.size(), 0u);
+    }
+} // namespace testing
@@ -0,0 +1,97 @@
+#include "pch.h"
+#include "BardCore/utility/instrumentation.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/parallel.h"
+#include "BardCore/geometry/frustum.h"
+
+#include <sstream>
+#include <string>
+
+namespace testing
+{
+    using counter = utility::instrumentation::counter;
+
+    TEST(instrumentation_test, count)
+    {
+        const utility::camera camera{{0, 0, 0}, {1, 0, 0}, 10, 10};
+        static_cast<void>(utility::instrumentation::end_frame());
+
+        static_cast<void>(vector3d(1, 2, 3).normalize());
+        EXPECT_THROW(static_cast<void>(vector3d(0, 0, 0).normalize()), exception::zero_exception);
+
+        //compile time evaluation isn't counted
+        constexpr vector3d normalized = vector3d(0, 3, 4).normalize();
+        EXPECT_EQ(normalized, vector3d(0, 0.6, 0.8));
+
+        const utility::instrumentation::snapshot first = utility::instrumentation::end_frame();
+
+        static_cast<void>(camera.shoot_ray(1, 2, 10));
+        static_cast<void>(camera.shoot_subpixel_ray(1.5, 2.5, 10));
+
+        const utility::instrumentation::snapshot second = utility::instrumentation::end_frame();
+        const utility::instrumentation::snapshot third = utility::instrumentation::end_frame();
+
+        if (utility::instrumentation::enabled)
+        {
+            EXPECT_EQ(first.get(counter::normalizations), 1u);
+            EXPECT_EQ(first.get(counter::exceptions), 1u);
+            EXPECT_EQ(first.get(counter::rays), 0u);
+            EXPECT_EQ(second.get(counter::rays), 2u);
+            EXPECT_EQ(second.frame, first.frame + 1);
+            EXPECT_GE(second.time, first.time);
+        }
+        else
+        {
+            EXPECT_EQ(first.get(counter::normalizations), 0u);
+            EXPECT_EQ(first.get(counter::exceptions), 0u);
+            EXPECT_EQ(second.get(counter::rays), 0u);
+        }
+
+        //end_frame resets the counters
+        for (std::size_t index = 0; index < utility::instrumentation::counter_count; ++index)
+            EXPECT_EQ(third.values[index], 0u);
+    }
+
+    TEST(instrumentation_test, threads)
+    {
+        static_cast<void>(utility::instrumentation::end_frame());
+
+        //every thread counts on its own, the counts of the threads that ended are kept for end_frame
+        utility::parallel::for_each_chunk(1000, 4, [](unsigned int, const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t index = begin; index < end; ++index)
+                INSTRUMENT(box_tests);
+        });
+        INSTRUMENT_ADD(intersection_tests, 7);
+
+        const utility::instrumentation::snapshot frame = utility::instrumentation::end_frame();
+        EXPECT_EQ(frame.get(counter::box_tests), utility::instrumentation::enabled ? 1000u : 0u);
+        EXPECT_EQ(frame.get(counter::intersection_tests), utility::instrumentation::enabled ? 7u : 0u);
+    }
+
+    TEST(instrumentation_test, write)
+    {
+        utility::instrumentation::snapshot first;
+        first.frame = 3;
+        first.time = 16.5;
+        first.values[static_cast<std::size_t>(counter::rays)] = 1024;
+
+        std::ostringstream json;
+        utility::instrumentation::write_json(json, first);
+        EXPECT_EQ(json.str(), "{\"frame\": 3, \"time\": 16.5, \"rays\": 1024, \"normalizations\": 0, "
+                  "\"exceptions\": 0, \"intersection_tests\": 0, \"box_tests\": 0}");
+
+        utility::instrumentation::snapshot second = first;
+        second.frame = 4;
+
+        std::ostringstream trace;
+        utility::instrumentation::write_trace(trace, {first, second});
+        const std::string text = trace.str();
+        EXPECT_EQ(text.find("{\"traceEvents\": [\n{\"name\": \"bardcore\", \"ph\": \"C\""), 0u);
+        EXPECT_NE(text.find("},\n{\"name\""), std::string::npos);
+        EXPECT_NE(text.find("\"frame\": 4"), std::string::npos);
+        EXPECT_EQ(text.substr(text.find("\n]")), "\n], \"displayTimeUnit\": \"ms\"}\n");
+
+        EXPECT_STREQ(utility::instrumentation::name(counter::intersection_tests), "intersection_tests");
+    }
+} // namespace testing
@@ -0,0 +1,158 @@
+#include "pch.h"
+#include "BardCore/utility/light_clusters.h"
+
+#include <vector>
+#include <algorithm>
+
+namespace testing
+{
+    /**
+     * \brief creates a grid of lights around and behind a camera at the origin looking forward
+     */
+    static utility::light_set light_clusters_test_lights()
+    {
+        utility::light_set lights;
+        for (int x = -10; x <= 10; ++x)
+        {
+            for (int z = -5; z <= 40; ++z)
+                lights.add({point3d(x * 4., (x + z) % 3 - 1., z * 4.), 0.5 + (x * x + z) % 4});
+        }
+
+        return lights;
+    }
+
+    TEST(light_clusters_test, constructor)
+    {
+        const utility::light_clusters clusters(4, 3, 8);
+        EXPECT_EQ(clusters.cluster_count(), 96u);
+        EXPECT_EQ(clusters.get_offsets().size(), 97u);
+
+        EXPECT_THROW(utility::light_clusters(0, 1, 1), exception::zero_exception);
+        EXPECT_THROW(utility::light_clusters(1, 1, 0), exception::zero_exception);
+        EXPECT_THROW(utility::light_clusters(1, 1, 1, 0), exception::zero_exception);
+        EXPECT_THROW(utility::light_clusters(1, 1, 1, 1, 1), exception::out_of_range_exception);
+        EXPECT_THROW(utility::light_clusters(1, 1, 1, 1, 10, 0), exception::zero_exception);
+    }
+
+    TEST(light_clusters_test, effective_radius)
+    {
+        EXPECT_DOUBLE_EQ(utility::light_clusters::effective_radius(4, 0.01), 20);
+        EXPECT_DOUBLE_EQ(utility::light_clusters::effective_radius(-4, 0.01), 0);
+    }
+
+    TEST(light_clusters_test, cluster_of)
+    {
+        const utility::camera camera(point3d(0, 0, 0), vector3d(0, 0, 1), 100, 100);
+        utility::light_clusters clusters(4, 4, 4, 1, 100);
+        clusters.build(camera, utility::light_set());
+
+        EXPECT_EQ(clusters.cluster_of(point3d(0, 0, -5)), std::size_t{utility::light_clusters::no_cluster});
+        EXPECT_EQ(clusters.cluster_of(point3d(0, 0, 200)), std::size_t{utility::light_clusters::no_cluster});
+        EXPECT_EQ(clusters.cluster_of(point3d(20, 0, 10)), std::size_t{utility::light_clusters::no_cluster});
+
+        // top left and bottom right pixel of the screen, in the first and last slice
+        const vector3d top_left = camera.shoot_ray(0, 0, 1).get_direction();
+        const vector3d bottom_right = camera.shoot_ray(99, 99, 1).get_direction();
+        EXPECT_EQ(clusters.cluster_of(point3d() + top_left * 2), clusters.cluster_index(0, 0, 0));
+        EXPECT_EQ(clusters.cluster_of(point3d() + bottom_right * 150), clusters.cluster_index(3, 3, 3));
+
+        // the pixel of a point is in the same cluster as the point
+        const point3d point(3, -2, 30);
+        const utility::ray ray(camera.get_position(), point);
+        for (unsigned int x = 0; x < camera.get_screen_width(); ++x)
+        {
+            for (unsigned int y = 0; y < camera.get_screen_height(); ++y)
+            {
+                if (camera.shoot_ray(x, y, 1).get_direction().dot(ray.get_direction()) > 0.99999)
+                {
+                    EXPECT_EQ(clusters.cluster_of(x, y, point.z), clusters.cluster_of(point));
+                }
+            }
+        }
+    }
+
+    TEST(light_clusters_test, build_is_conservative)
+    {
+        const utility::camera camera(point3d(1, 2, -3), vector3d(0.1, -0.05, 1), 64, 36, 70);
+        const utility::light_set lights = light_clusters_test_lights();
+        constexpr double cutoff = 0.05;
+
+        utility::light_clusters clusters(8, 6, 12, 0.5, 200, cutoff, 4);
+        clusters.build(camera, lights);
+
+        //every light that is brighter than the cutoff at a point must be in the cluster of the point
+        std::size_t checked = 0;
+        for (double x = -30; x <= 30; x += 1.7)
+        {
+            for (double y = -4; y <= 4; y += 1.3)
+            {
+                for (double z = -2; z <= 150; z += 2.3)
+                {
+                    const point3d point(x, y, z);
+                    const std::size_t cluster = clusters.cluster_of(point);
+                    if (cluster == utility::light_clusters::no_cluster)
+                        continue;
+
+                    std::vector<double> intensity;
+                    lights.inverse_square_law(point, intensity);
+                    const std::uint32_t* begin = clusters.lights(cluster);
+                    const std::uint32_t* end = begin + clusters.light_count(cluster);
+
+                    for (std::uint32_t light = 0; light < lights.size(); ++light)
+                    {
+                        if (intensity[light] >= cutoff)
+                        {
+                            EXPECT_TRUE(std::binary_search(begin, end, light));
+                            ++checked;
+                        }
+                    }
+                }
+            }
+        }
+
+        EXPECT_GT(checked, 100u);
+
+        //culling removes most lights from most clusters
+        EXPECT_LT(clusters.get_indices().size(), lights.size() * clusters.cluster_count() / 10);
+    }
+
+    TEST(light_clusters_test, threads)
+    {
+        const utility::camera camera(point3d(0, 1, -5), vector3d(0, 0, 1), 32, 32);
+        const utility::light_set lights = light_clusters_test_lights();
+
+        utility::light_clusters single(8, 8, 8, 0.5, 200, 0.05, 1);
+        utility::light_clusters multiple(8, 8, 8, 0.5, 200, 0.05, 7);
+        single.build(camera, lights);
+        multiple.build(camera, lights);
+
+        EXPECT_EQ(single.get_offsets(), multiple.get_offsets());
+        EXPECT_EQ(single.get_indices(), multiple.get_indices());
+
+        //every cluster is sorted by light index
+        for (std::size_t cluster = 0; cluster < multiple.cluster_count(); ++cluster)
+        {
+            const std::uint32_t* begin = multiple.lights(cluster);
+            EXPECT_TRUE(std::is_sorted(begin, begin + multiple.light_count(cluster)));
+        }
+    }
+
+    TEST(light_clusters_test, for_each_light)
+    {
+        const utility::camera camera(point3d(0, 0, 0), vector3d(0, 0, 1), 16, 16);
+        utility::light_set lights;
+        lights.add({point3d(0, 0, 10), 1}); // radius 10
+        lights.add({point3d(0, 0, -50), 1}); // behind the camera
+
+        utility::light_clusters clusters(4, 4, 4, 1, 100, 0.01);
+        clusters.build(camera, lights);
+
+        std::vector<std::uint32_t> found;
+        clusters.for_each_light(point3d(0.5, 0.5, 12), [&found](const std::uint32_t light) { found.push_back(light); });
+        EXPECT_EQ(found, std::vector<std::uint32_t>{0});
+
+        found.clear();
+        clusters.for_each_light(point3d(0, 0, -40), [&found](const std::uint32_t light) { found.push_back(light); });
+        EXPECT_TRUE(found.empty());
+    }
+} // namespace testing
@@ -0,0 +1,72 @@
+#include "pch.h"
+#include "BardCore/utility/light_set.h"
+
+#include <vector>
+
+namespace testing
+{
+    TEST(light_set_test, constructor)
+    {
+        const utility::light_set empty;
+        EXPECT_TRUE(empty.empty());
+
+        const std::vector<utility::light> lights{{point3d(1, 2, 3), 4}, {point3d(-1, 0, 5), 2}};
+        const utility::light_set set(lights);
+
+        ASSERT_EQ(set.size(), 2u);
+        EXPECT_EQ(set.get(0), lights[0]);
+        EXPECT_EQ(set.get(1), lights[1]);
+    }
+
+    TEST(light_set_test, add_set)
+    {
+        utility::light_set set;
+        EXPECT_EQ(set.add({point3d(1, 1, 1), 3}), 0u);
+        EXPECT_EQ(set.add({point3d(2, 2, 2), 5}), 1u);
+
+        set.set(0, {point3d(0, 4, 0), 9});
+        EXPECT_EQ(set.get(0), utility::light(point3d(0, 4, 0), 9));
+        EXPECT_DOUBLE_EQ(set.get_intensities()[1], 5);
+    }
+
+    TEST(light_set_test, inverse_square_law_point)
+    {
+        const std::vector<utility::light> lights{
+            {point3d(0, 2, 0), 8}, {point3d(3, 0, 4), 50}, {point3d(-1, -1, -1), 6}, {point3d(0, 0, 0), 10}
+        };
+        const utility::light_set set(lights);
+        const point3d point(0, 0, 0);
+
+        std::vector<double> result;
+        set.inverse_square_law(point, result);
+
+        ASSERT_EQ(result.size(), lights.size());
+        for (std::size_t index = 0; index + 1 < lights.size(); ++index)
+            EXPECT_DOUBLE_EQ(result[index], lights[index].inverse_square_law(point));
+
+        // light on top of the point doesn't throw
+        EXPECT_DOUBLE_EQ(result[3], 0);
+        EXPECT_DOUBLE_EQ(set.total_intensity(point), 2 + 2 + 2);
+    }
+
+    TEST(light_set_test, inverse_square_law_points)
+    {
+        const utility::light light(point3d(1, 1, 1), 12);
+        utility::light_set set;
+        set.add({point3d(9, 9, 9), 1});
+        set.add(light);
+
+        dimension3_soa<point3d> points;
+        points.push_back(point3d(1, 3, 1));
+        points.push_back(point3d(4, 5, 1));
+        points.push_back(point3d(1, 1, 1));
+
+        std::vector<double> result;
+        set.inverse_square_law(1, points, result);
+
+        ASSERT_EQ(result.size(), 3u);
+        EXPECT_DOUBLE_EQ(result[0], light.inverse_square_law(points.get(0)));
+        EXPECT_DOUBLE_EQ(result[1], light.inverse_square_law(points.get(1)));
+        EXPECT_DOUBLE_EQ(result[2], 0);
+    }
+} // namespace testing
@@ -0,0 +1,126 @@
+#include "pch.h"
+#include "BardCore/utility/light_tree.h"
+
+#include <vector>
+
+namespace testing
+{
+    /**
+     * \brief creates a grid of lights with different intensities
+     */
+    static std::vector<utility::light> light_tree_test_lights()
+    {
+        std::vector<utility::light> lights;
+        for (int x = 0; x < 8; ++x)
+        {
+            for (int z = 0; z < 8; ++z)
+                lights.emplace_back(point3d(x * 10., 5, z * 10.), 1. + (x + z) % 3);
+        }
+
+        return lights;
+    }
+
+    TEST(light_tree_test, constructor)
+    {
+        EXPECT_THROW(utility::light_tree(std::vector<utility::light>{}), exception::zero_exception);
+        EXPECT_THROW(utility::light_tree({utility::light(point3d(), -1)}), exception::negative_exception);
+
+        const utility::light_tree tree(light_tree_test_lights());
+        EXPECT_EQ(tree.size(), 64u);
+        EXPECT_EQ(tree.node_count(), 127u);
+        EXPECT_DOUBLE_EQ(tree.get_power(), 128);
+    }
+
+    TEST(light_tree_test, single_light)
+    {
+        const utility::light_tree tree({utility::light(point3d(1, 2, 3), 10)});
+
+        double pdf = 0;
+        EXPECT_EQ(tree.sample(point3d(), 0.7, pdf), 0u);
+        EXPECT_DOUBLE_EQ(pdf, 1);
+        EXPECT_DOUBLE_EQ(tree.pdf(point3d(), 0), 1);
+        EXPECT_EQ(tree.sample_power(0.3), 0u);
+    }
+
+    TEST(light_tree_test, pdf)
+    {
+        const utility::light_tree tree(light_tree_test_lights());
+        const point3d point(12, 0, 31);
+
+        //the pdf of all lights sums to 1 and matches the pdf returned by sample
+        double sum = 0;
+        for (std::size_t light = 0; light < tree.size(); ++light)
+            sum += tree.pdf(point, light);
+        EXPECT_NEAR(sum, 1, ROUND_EPSILON);
+
+        for (std::size_t index = 0; index < 100; ++index)
+        {
+            double pdf = 0;
+            const std::uint32_t light = tree.sample(point, static_cast<double>(index) / 100, pdf);
+            EXPECT_NEAR(pdf, tree.pdf(point, light), ROUND_EPSILON);
+        }
+    }
+
+    TEST(light_tree_test, sample_prefers_close_lights)
+    {
+        const std::vector<utility::light> lights = light_tree_test_lights();
+        const utility::light_tree tree(lights);
+        const point3d point(0, 0, 0);
+
+        std::size_t close = 0;
+        constexpr std::size_t samples = 1000;
+        for (std::size_t index = 0; index < samples; ++index)
+        {
+            double pdf = 0;
+            const std::uint32_t light = tree.sample(point, (static_cast<double>(index) + 0.5) / samples, pdf);
+            if (lights[light].position.distance(point) < 30)
+                ++close;
+        }
+
+        //the 9 lights within 30 of the point are 14% of the lights, but get most of the samples
+        EXPECT_GT(close, samples / 2);
+    }
+
+    TEST(light_tree_test, sample_batch)
+    {
+        const utility::light_tree tree(light_tree_test_lights());
+
+        dimension3_soa<point3d> points;
+        std::vector<double> random;
+        for (std::size_t index = 0; index < 50; ++index)
+        {
+            points.push_back(point3d(index * 1.5, 0, 70 - index * 1.5));
+            random.push_back(static_cast<double>(index) / 50);
+        }
+
+        std::vector<std::uint32_t> lights;
+        std::vector<double> pdf;
+        tree.sample(points, random, lights, pdf);
+
+        ASSERT_EQ(lights.size(), points.size());
+        ASSERT_EQ(pdf.size(), points.size());
+        for (std::size_t index = 0; index < points.size(); ++index)
+        {
+            double expected_pdf = 0;
+            EXPECT_EQ(lights[index], tree.sample(points.get(index), random[index], expected_pdf));
+            EXPECT_DOUBLE_EQ(pdf[index], expected_pdf);
+        }
+    }
+
+    TEST(light_tree_test, sample_power)
+    {
+        const utility::light_tree tree({utility::light(point3d(), 1), utility::light(point3d(1, 0, 0), 3)});
+
+        EXPECT_DOUBLE_EQ(tree.pdf_power(0), 0.25);
+        EXPECT_DOUBLE_EQ(tree.pdf_power(1), 0.75);
+
+        std::vector<std::uint32_t> lights;
+        tree.sample_power({0.125, 0.375, 0.625, 0.875}, lights);
+
+        ASSERT_EQ(lights.size(), 4u);
+        std::size_t first = 0;
+        for (const std::uint32_t light : lights)
+            first += light == 0;
+        EXPECT_EQ(first, 1u);
+    }
+} // namespace testing
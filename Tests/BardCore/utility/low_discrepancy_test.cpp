@@ -0,0 +1,153 @@
+#include "pch.h"
+#include "BardCore/utility/low_discrepancy.h"
+
+#include <vector>
+
+namespace testing
+{
+    /**
+     * \brief checks that the first count samples (a power of 2) of two dimensions form a (0, m, 2)-net, every one of
+     * the count intervals of 1D and every square cell of a sqrt(count) grid holds exactly one sample
+     */
+    static void low_discrepancy_test_net(const std::vector<double>& x, const std::vector<double>& y, const std::size_t grid)
+    {
+        const std::size_t count = x.size();
+        std::vector<int> intervals_x(count), intervals_y(count), cells(grid * grid);
+
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            ASSERT_GE(x[index], 0);
+            ASSERT_LT(x[index], 1);
+            ASSERT_GE(y[index], 0);
+            ASSERT_LT(y[index], 1);
+
+            ++intervals_x[static_cast<std::size_t>(x[index] * count)];
+            ++intervals_y[static_cast<std::size_t>(y[index] * count)];
+            ++cells[static_cast<std::size_t>(y[index] * grid) * grid + static_cast<std::size_t>(x[index] * grid)];
+        }
+
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            EXPECT_EQ(intervals_x[index], 1);
+            EXPECT_EQ(intervals_y[index], 1);
+            EXPECT_EQ(cells[index], 1);
+        }
+    }
+
+    TEST(low_discrepancy_test, sobol_sample)
+    {
+        const utility::sobol_sequence sobol;
+        EXPECT_FALSE(sobol.is_scrambled());
+
+        const double expected_x[8] = {0, 0.5, 0.25, 0.75, 0.125, 0.625, 0.375, 0.875};
+        const double expected_y[8] = {0, 0.5, 0.75, 0.25, 0.625, 0.125, 0.375, 0.875};
+        for (std::uint32_t index = 0; index < 8; ++index)
+        {
+            EXPECT_DOUBLE_EQ(sobol.sample(index, 0), expected_x[index]);
+            EXPECT_DOUBLE_EQ(sobol.sample(index, 1), expected_y[index]);
+        }
+
+        EXPECT_THROW(static_cast<void>(sobol.sample(0, 3)), exception::out_of_range_exception);
+    }
+
+    TEST(low_discrepancy_test, sobol_samples)
+    {
+        const utility::sobol_sequence sobol;
+        const utility::sobol_sequence scrambled(42);
+        EXPECT_TRUE(scrambled.is_scrambled());
+
+        //more than one block, starting at an offset
+        for (const utility::sobol_sequence* sequence : {&sobol, &scrambled})
+        {
+            std::vector<double> x(200), y(200), z(200);
+            sequence->samples(5, 200, x.data(), y.data(), z.data());
+
+            for (std::uint32_t index = 0; index < 200; ++index)
+            {
+                EXPECT_EQ(x[index], sequence->sample(index + 5, 0));
+                EXPECT_EQ(y[index], sequence->sample(index + 5, 1));
+                EXPECT_EQ(z[index], sequence->sample(index + 5, 2));
+            }
+        }
+    }
+
+    TEST(low_discrepancy_test, sobol_stratification)
+    {
+        //scrambling changes the samples but keeps the stratification
+        for (const std::uint32_t seed : {0u, 1u, 12345u})
+        {
+            const utility::sobol_sequence sobol(seed);
+
+            std::vector<double> x(64), y(64), z(64);
+            sobol.samples(0, 64, x.data(), y.data(), z.data());
+            low_discrepancy_test_net(x, y, 8);
+
+            EXPECT_NE(x[0], 0);
+        }
+
+        EXPECT_NE(utility::sobol_sequence(1).sample(3, 0), utility::sobol_sequence(2).sample(3, 0));
+    }
+
+    TEST(low_discrepancy_test, halton)
+    {
+        const utility::halton_sequence halton;
+
+        const double expected_x[5] = {0, 1. / 2, 1. / 4, 3. / 4, 1. / 8};
+        const double expected_y[5] = {0, 1. / 3, 2. / 3, 1. / 9, 4. / 9};
+        const double expected_z[5] = {0, 1. / 5, 2. / 5, 3. / 5, 4. / 5};
+        for (std::uint32_t index = 0; index < 5; ++index)
+        {
+            EXPECT_NEAR(halton.sample(index, 0), expected_x[index], ROUND_EPSILON);
+            EXPECT_NEAR(halton.sample(index, 1), expected_y[index], ROUND_EPSILON);
+            EXPECT_NEAR(halton.sample(index, 2), expected_z[index], ROUND_EPSILON);
+        }
+
+        //large indices use every lookup
+        EXPECT_NEAR(halton.sample(1000000, 1), 0.361066, ROUND_EPSILON);
+        EXPECT_NEAR(halton.sample(4000000000u, 1), 0.450411, ROUND_EPSILON);
+
+        std::vector<double> x(100), y(100), z(100);
+        halton.samples(999950, 100, x.data(), y.data(), z.data());
+        for (std::uint32_t index = 0; index < 100; ++index)
+        {
+            EXPECT_EQ(x[index], halton.sample(999950 + index, 0));
+            EXPECT_EQ(y[index], halton.sample(999950 + index, 1));
+            EXPECT_EQ(z[index], halton.sample(999950 + index, 2));
+        }
+
+        EXPECT_THROW(static_cast<void>(halton.sample(0, 3)), exception::out_of_range_exception);
+    }
+
+    TEST(low_discrepancy_test, r2)
+    {
+        const utility::r2_sequence r2;
+        EXPECT_EQ(r2.get_dimensions(), 2u);
+
+        //sample n is fraction(0.5 + n * alpha)
+        const double alpha_x = 1 / 1.3247179572447460, alpha_y = alpha_x * alpha_x;
+        for (std::uint32_t index = 0; index < 10; ++index)
+        {
+            const double x = 0.5 + index * alpha_x, y = 0.5 + index * alpha_y;
+            EXPECT_NEAR(r2.sample(index, 0), x - std::floor(x), ROUND_EPSILON);
+            EXPECT_NEAR(r2.sample(index, 1), y - std::floor(y), ROUND_EPSILON);
+        }
+        EXPECT_NEAR(r2.get_alpha(0), alpha_x, ROUND_EPSILON);
+        EXPECT_NEAR(r2.get_alpha(1), alpha_y, ROUND_EPSILON);
+
+        std::vector<double> x(70), y(70), z(70);
+        r2.samples(3, 70, x.data(), y.data());
+        for (std::uint32_t index = 0; index < 70; ++index)
+        {
+            EXPECT_EQ(x[index], r2.sample(index + 3, 0));
+            EXPECT_EQ(y[index], r2.sample(index + 3, 1));
+        }
+
+        const utility::r2_sequence r3(3);
+        r3.samples(0, 70, x.data(), y.data(), z.data());
+        EXPECT_EQ(z[5], r3.sample(5, 2));
+
+        EXPECT_THROW(static_cast<void>(r2.sample(0, 2)), exception::out_of_range_exception);
+        EXPECT_THROW(r2.samples(0, 70, x.data(), y.data(), z.data()), exception::out_of_range_exception);
+        EXPECT_THROW(utility::r2_sequence(4), exception::out_of_range_exception);
+    }
+} // namespace testing
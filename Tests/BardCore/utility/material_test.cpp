@@ -0,0 +1,44 @@
+#include "pch.h"
+#include "BardCore/utility/material.h"
+
+#include <sstream>
+
+namespace testing
+{
+    TEST(material_test, constructor)
+    {
+        constexpr utility::material material(0.5, 0.25, 0.125, 1.33);
+
+        EXPECT_EQ(material.albedo, 0.5);
+        EXPECT_EQ(material.reflectance, 0.25);
+        EXPECT_EQ(material.transmittance, 0.125);
+        EXPECT_EQ(material.refractive_index, 1.33);
+
+        constexpr utility::material diffuse(0.8);
+        EXPECT_EQ(diffuse.reflectance, 0);
+        EXPECT_EQ(diffuse.transmittance, 0);
+        EXPECT_EQ(diffuse.refractive_index, 1);
+    }
+
+    TEST(material_test, constructor_exceptions)
+    {
+        EXPECT_THROW(utility::material(-1), exception::negative_exception);
+        EXPECT_THROW(utility::material(1, -1), exception::negative_exception);
+        EXPECT_THROW(utility::material(1, 0, -1), exception::negative_exception);
+        EXPECT_THROW(utility::material(1, 0, 0, 0), exception::zero_exception);
+    }
+
+    TEST(material_test, operators)
+    {
+        constexpr utility::material material(0.5, 0.25);
+        constexpr utility::material same(0.5, 0.25);
+        constexpr utility::material other(0.5, 0.5);
+
+        EXPECT_TRUE(material == same);
+        EXPECT_TRUE(material != other);
+
+        std::stringstream stream;
+        stream << material;
+        EXPECT_EQ(stream.str(), "{albedo: 0.5, reflectance: 0.25, transmittance: 0, refractive_index: 1}");
+    }
+} // namespace testing
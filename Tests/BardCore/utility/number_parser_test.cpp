@@ -0,0 +1,74 @@
+#include "pch.h"
+#include "BardCore/utility/number_parser.h"
+
+#include <string>
+
+namespace testing
+{
+    TEST(number_parser_test, parse_double)
+    {
+        const std::string text = "  1.5 -2e3\t+0.25\r\nx";
+        const char* last = text.data() + text.size();
+
+        double value = 0;
+        const char* next = utility::number_parser::parse(text.data(), last, value);
+        ASSERT_NE(next, nullptr);
+        EXPECT_EQ(value, 1.5);
+
+        next = utility::number_parser::parse(next, last, value);
+        ASSERT_NE(next, nullptr);
+        EXPECT_EQ(value, -2000);
+
+        float single = 0;
+        next = utility::number_parser::parse(next, last, single);
+        ASSERT_NE(next, nullptr);
+        EXPECT_EQ(single, 0.25f);
+
+        //the newline is not skipped, there is no number at it
+        EXPECT_EQ(utility::number_parser::parse(next, last, value), nullptr);
+        EXPECT_EQ(value, -2000);
+    }
+
+    TEST(number_parser_test, parse_range)
+    {
+        //the number ends at last, even if more digits follow
+        const std::string text = "12345";
+        double value = 0;
+        EXPECT_EQ(utility::number_parser::parse(text.data(), text.data() + 3, value), text.data() + 3);
+        EXPECT_EQ(value, 123);
+
+        EXPECT_EQ(utility::number_parser::parse(text.data(), text.data(), value), nullptr);
+    }
+
+    TEST(number_parser_test, parse_integer)
+    {
+        const std::string text = "42 -7 +3 9223372036854775807 9223372036854775808 a";
+        const char* last = text.data() + text.size();
+
+        std::int64_t value = 0;
+        const char* next = utility::number_parser::parse(text.data(), last, value);
+        EXPECT_EQ(value, 42);
+        next = utility::number_parser::parse(next, last, value);
+        EXPECT_EQ(value, -7);
+        next = utility::number_parser::parse(next, last, value);
+        EXPECT_EQ(value, 3);
+        next = utility::number_parser::parse(next, last, value);
+        EXPECT_EQ(value, INT64_C(9223372036854775807));
+
+        //too big
+        EXPECT_EQ(utility::number_parser::parse(next, last, value), nullptr);
+
+        //not a number
+        EXPECT_EQ(utility::number_parser::parse(last - 1, last, value), nullptr);
+    }
+
+    TEST(number_parser_test, skip)
+    {
+        const std::string text = " \t word rest";
+        const char* last = text.data() + text.size();
+
+        const char* word = utility::number_parser::skip_spaces(text.data(), last);
+        EXPECT_EQ(*word, 'w');
+        EXPECT_EQ(utility::number_parser::skip_token(word, last), word + 4);
+    }
+} // namespace testing
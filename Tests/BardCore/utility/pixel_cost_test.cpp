@@ -0,0 +1,96 @@
+#include "pch.h"
+#include "BardCore/utility/pixel_cost.h"
+#include "BardCore/utility/wavefront.h"
+#include "BardCore/geometry/sphere_set.h"
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+namespace testing
+{
+    using channel = utility::pixel_cost::channel;
+
+    TEST(pixel_cost_test, add)
+    {
+        utility::pixel_cost cost(4, 3);
+        EXPECT_EQ(cost.size(), 12u);
+
+        cost.add(channel::primitive_tests, 2 * 4 + 1, 5);
+        cost.add(channel::primitive_tests, 2 * 4 + 1, 2);
+        cost.add(channel::primitive_tests, 0, 1);
+
+        EXPECT_EQ(cost.get(channel::primitive_tests, 1, 2), 7u);
+        EXPECT_EQ(cost.get(channel::bounces, 1, 2), 0u);
+        EXPECT_EQ(cost.max(channel::primitive_tests), 7u);
+        EXPECT_EQ(cost.total(channel::primitive_tests), 8u);
+
+        EXPECT_THROW(static_cast<void>(cost.get(channel::cycles, 4, 0)), exception::out_of_range_exception);
+        EXPECT_THROW(static_cast<void>(cost.get(channel::cycles, 0, 3)), exception::out_of_range_exception);
+
+        cost.clear();
+        EXPECT_EQ(cost.total(channel::primitive_tests), 0u);
+        EXPECT_TRUE(utility::pixel_cost().empty());
+    }
+
+    TEST(pixel_cost_test, write)
+    {
+        utility::pixel_cost cost(2, 2);
+        cost.add(channel::cycles, 1, 10); // top right is the most expensive
+
+        std::ostringstream ppm;
+        cost.write_ppm(ppm, channel::cycles);
+        const std::string header = "P6\n2 2\n255\n";
+        ASSERT_EQ(ppm.str().size(), header.size() + 2 * 2 * 3);
+        EXPECT_EQ(ppm.str().substr(0, header.size()), header);
+
+        const std::string pixels = ppm.str().substr(header.size());
+        EXPECT_EQ(pixels.substr(0, 3), std::string("\x00\x00\xff", 3)); // blue
+        EXPECT_EQ(pixels.substr(3, 3), std::string("\xff\x00\x00", 3)); // red
+
+        std::ostringstream pfm;
+        cost.write_pfm(pfm, channel::cycles);
+        const std::string pfm_header = pfm.str().substr(0, pfm.str().size() - 2 * 2 * sizeof(float));
+        EXPECT_EQ(pfm_header.substr(0, 7), "Pf\n2 2\n");
+
+        // bottom row first, so the top right pixel is the last float
+        float last = 0;
+        const std::string data = pfm.str();
+        std::memcpy(&last, data.data() + data.size() - sizeof(float), sizeof(float));
+        EXPECT_EQ(last, 10.f);
+
+        EXPECT_THROW(cost.write_ppm("", channel::cycles), exception::io_exception);
+    }
+
+    TEST(pixel_cost_test, render)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1, 0);
+
+        const utility::camera cam({0, 0, 0}, {0, 0, 1}, 10, 10);
+        utility::wavefront<geometry::sphere_set> tracer(spheres, {utility::light({0, 0, 0}, 2)},
+                                                        {utility::material(0.5)});
+        static_cast<void>(tracer.render(cam));
+
+        const utility::pixel_cost& cost = tracer.get_pixel_cost();
+        if (!utility::pixel_cost::enabled)
+        {
+            EXPECT_TRUE(cost.empty());
+            return;
+        }
+
+        ASSERT_EQ(cost.get_width(), 10u);
+        ASSERT_EQ(cost.get_height(), 10u);
+
+        // one path per pixel, the material doesn't reflect or refract
+        EXPECT_EQ(cost.total(channel::bounces), 100u);
+        EXPECT_EQ(cost.get(channel::bounces, 0, 0), 1u);
+
+        // the center has a shadow ray too, the corner misses the sphere
+        EXPECT_EQ(cost.get(channel::primitive_tests, 5, 5), 2u);
+        EXPECT_EQ(cost.get(channel::primitive_tests, 0, 0), 1u);
+        EXPECT_EQ(cost.total(channel::traversal_steps), 0u);
+        EXPECT_GT(cost.total(channel::cycles), 0u);
+    }
+} // namespace testing
@@ -0,0 +1,180 @@
+#include "pch.h"
+#include "BardCore/utility/pixel_sampler.h"
+
+namespace testing
+{
+    TEST(pixel_sampler_test, constructor)
+    {
+        const utility::pixel_sampler four(4);
+        EXPECT_EQ(four.get_samples_per_pixel(), 4u);
+        EXPECT_EQ(four.get_pattern(), utility::sample_pattern::stratified);
+        EXPECT_EQ(four.get_columns(), 2u);
+        EXPECT_EQ(four.get_rows(), 2u);
+
+        const utility::pixel_sampler five(5, utility::sample_pattern::jittered);
+        EXPECT_EQ(five.get_columns(), 3u);
+        EXPECT_EQ(five.get_rows(), 2u);
+
+        const utility::pixel_sampler one(1);
+        EXPECT_EQ(one.get_columns(), 1u);
+        EXPECT_EQ(one.get_rows(), 1u);
+
+        EXPECT_THROW(utility::pixel_sampler(0), exception::zero_exception);
+    }
+
+    TEST(pixel_sampler_test, stratified)
+    {
+        const utility::pixel_sampler sampler(4, utility::sample_pattern::stratified);
+        const double expected[4][2] = {{0.25, 0.25}, {0.75, 0.25}, {0.25, 0.75}, {0.75, 0.75}};
+
+        for (unsigned int sample = 0; sample < 4; ++sample)
+        {
+            double x = 0, y = 0;
+            sampler.sample_offset(3, 5, sample, 7, x, y);
+            EXPECT_DOUBLE_EQ(x, expected[sample][0]);
+            EXPECT_DOUBLE_EQ(y, expected[sample][1]);
+        }
+    }
+
+    TEST(pixel_sampler_test, jittered)
+    {
+        const utility::pixel_sampler sampler(9, utility::sample_pattern::jittered);
+
+        for (unsigned int sample = 0; sample < 9; ++sample)
+        {
+            double x = 0, y = 0;
+            sampler.sample_offset(3, 5, sample, 0, x, y);
+
+            //inside the stratum of the sample
+            EXPECT_GE(x, (sample % 3) / 3.);
+            EXPECT_LT(x, (sample % 3 + 1) / 3.);
+            EXPECT_GE(y, (sample / 3) / 3.);
+            EXPECT_LT(y, (sample / 3 + 1) / 3.);
+        }
+
+        //reproducible, but different for another pixel or seed
+        double x1 = 0, y1 = 0, x2 = 0, y2 = 0, x3 = 0, y3 = 0, x4 = 0, y4 = 0;
+        sampler.sample_offset(3, 5, 0, 0, x1, y1);
+        sampler.sample_offset(3, 5, 0, 0, x2, y2);
+        sampler.sample_offset(4, 5, 0, 0, x3, y3);
+        sampler.sample_offset(3, 5, 0, 1, x4, y4);
+        EXPECT_EQ(x1, x2);
+        EXPECT_EQ(y1, y2);
+        EXPECT_TRUE(x1 != x3 || y1 != y3);
+        EXPECT_TRUE(x1 != x4 || y1 != y4);
+    }
+
+    TEST(pixel_sampler_test, blue_noise)
+    {
+        const utility::pixel_sampler sampler(4, utility::sample_pattern::blue_noise);
+
+        //every sample of a pixel is shifted by the same amount, so the distance between them stays a half
+        double x0 = 0, y0 = 0;
+        sampler.sample_offset(3, 5, 0, 0, x0, y0);
+        for (unsigned int sample = 1; sample < 4; ++sample)
+        {
+            double x = 0, y = 0;
+            sampler.sample_offset(3, 5, sample, 0, x, y);
+            EXPECT_GE(x, 0);
+            EXPECT_LT(x, 1);
+            EXPECT_GE(y, 0);
+            EXPECT_LT(y, 1);
+
+            const double dx = std::abs(x - x0), dy = std::abs(y - y0);
+            EXPECT_NEAR(dx, sample % 2 == 1 ? 0.5 : 0, ROUND_EPSILON);
+            EXPECT_NEAR(dy, sample / 2 == 1 ? 0.5 : 0, ROUND_EPSILON);
+        }
+
+        //neighbouring pixels get a different shift
+        double x1 = 0, y1 = 0;
+        sampler.sample_offset(4, 5, 0, 0, x1, y1);
+        EXPECT_TRUE(x0 != x1 || y0 != y1);
+    }
+
+    TEST(pixel_sampler_test, sequences)
+    {
+        const utility::sample_pattern patterns[3] = {
+            utility::sample_pattern::sobol, utility::sample_pattern::halton, utility::sample_pattern::r2
+        };
+
+        for (const utility::sample_pattern pattern : patterns)
+        {
+            const utility::pixel_sampler sampler(16, pattern);
+
+            //inside the pixel, and different for every pixel
+            double first_x = 0, first_y = 0, other_x = 0, other_y = 0;
+            sampler.sample_offset(3, 5, 0, 0, first_x, first_y);
+            sampler.sample_offset(4, 5, 0, 0, other_x, other_y);
+            EXPECT_TRUE(first_x != other_x || first_y != other_y);
+
+            for (unsigned int sample = 0; sample < 16; ++sample)
+            {
+                double x = 0, y = 0;
+                sampler.sample_offset(3, 5, sample, 0, x, y);
+                EXPECT_GE(x, 0);
+                EXPECT_LT(x, 1);
+                EXPECT_GE(y, 0);
+                EXPECT_LT(y, 1);
+            }
+        }
+
+        //the scrambled Sobol samples of a pixel are still stratified, one in every column, row and 4 x 4 cell
+        const utility::pixel_sampler sobol(16, utility::sample_pattern::sobol);
+        int columns[16] = {}, rows[16] = {}, cells[16] = {};
+        for (unsigned int sample = 0; sample < 16; ++sample)
+        {
+            double x = 0, y = 0;
+            sobol.sample_offset(3, 5, sample, 9, x, y);
+            ++columns[static_cast<int>(x * 16)];
+            ++rows[static_cast<int>(y * 16)];
+            ++cells[static_cast<int>(y * 4) * 4 + static_cast<int>(x * 4)];
+        }
+
+        for (int index = 0; index < 16; ++index)
+        {
+            EXPECT_EQ(columns[index], 1);
+            EXPECT_EQ(rows[index], 1);
+            EXPECT_EQ(cells[index], 1);
+        }
+    }
+
+    TEST(pixel_sampler_test, shoot_rays)
+    {
+        const utility::camera cam(point3d(1, 2, 3), vector3d(0, -1, 1), 8, 6, 70);
+        const utility::sample_pattern patterns[6] = {
+            utility::sample_pattern::stratified, utility::sample_pattern::jittered, utility::sample_pattern::blue_noise,
+            utility::sample_pattern::sobol, utility::sample_pattern::halton, utility::sample_pattern::r2
+        };
+
+        for (const utility::sample_pattern pattern : patterns)
+        {
+            const utility::pixel_sampler sampler(4, pattern);
+            utility::ray_queue queue;
+            sampler.shoot_rays(cam, queue, 10, 3);
+
+            ASSERT_EQ(queue.size(), 8u * 6u * 4u);
+            for (std::size_t index = 0; index < queue.size(); ++index)
+            {
+                const unsigned int sample = static_cast<unsigned int>(index / 48);
+                const unsigned int x = static_cast<unsigned int>(index % 48 % 8);
+                const unsigned int y = static_cast<unsigned int>(index % 48 / 8);
+
+                double offset_x = 0, offset_y = 0;
+                sampler.sample_offset(x, y, sample, 3, offset_x, offset_y);
+                const utility::ray expected = cam.shoot_subpixel_ray(x + offset_x, y + offset_y, 10);
+
+                EXPECT_EQ(queue.origin.get(index), point3d(1, 2, 3));
+                EXPECT_NEAR(queue.direction.x()[index], expected.get_direction().x, ROUND_EPSILON);
+                EXPECT_NEAR(queue.direction.y()[index], expected.get_direction().y, ROUND_EPSILON);
+                EXPECT_NEAR(queue.direction.z()[index], expected.get_direction().z, ROUND_EPSILON);
+                EXPECT_EQ(queue.distance[index], 10);
+                EXPECT_EQ(queue.pixel[index], index % 48);
+                EXPECT_EQ(queue.throughput[index], 0.25);
+                EXPECT_EQ(queue.depth[index], 0u);
+            }
+        }
+
+        utility::ray_queue queue;
+        EXPECT_THROW(utility::pixel_sampler(4).shoot_rays(cam, queue, -1), exception::negative_exception);
+    }
+} // namespace testing
@@ -0,0 +1,124 @@
+#include "pch.h"
+#include "BardCore/utility/random_stream.h"
+
+#include <vector>
+
+namespace testing
+{
+    TEST(random_stream_test, reproducible)
+    {
+        utility::random_stream first(42, 7);
+        utility::random_stream second(42, 7);
+        utility::random_stream other_stream(42, 8);
+        utility::random_stream other_seed(43, 7);
+
+        std::uint32_t a[utility::random_stream::lanes], b[utility::random_stream::lanes];
+        std::uint32_t c[utility::random_stream::lanes], d[utility::random_stream::lanes];
+        for (int step = 0; step < 10; ++step)
+        {
+            first.next(a);
+            second.next(b);
+            other_stream.next(c);
+            other_seed.next(d);
+
+            for (std::size_t lane = 0; lane < utility::random_stream::lanes; ++lane)
+            {
+                EXPECT_EQ(a[lane], b[lane]);
+                EXPECT_NE(a[lane], c[lane]);
+                EXPECT_NE(a[lane], d[lane]);
+            }
+        }
+
+        //the lanes of one stream differ from each other as well
+        EXPECT_NE(a[0], a[1]);
+    }
+
+    TEST(random_stream_test, uniform)
+    {
+        utility::random_stream random(1);
+
+        //not a multiple of the lanes
+        std::vector<double> values(100003);
+        random.uniform(values.data(), values.size());
+
+        double mean = 0;
+        for (const double value : values)
+        {
+            ASSERT_GE(value, 0);
+            ASSERT_LT(value, 1);
+            mean += value / static_cast<double>(values.size());
+        }
+        EXPECT_NEAR(mean, 0.5, 0.01);
+
+        std::vector<float> floats(1001);
+        random.uniform(floats.data(), floats.size());
+        for (const float value : floats)
+        {
+            ASSERT_GE(value, 0);
+            ASSERT_LT(value, 1);
+        }
+
+        double single_mean = 0;
+        for (int index = 0; index < 10000; ++index)
+        {
+            const double value = random.uniform();
+            const float value_float = random.uniform_float();
+            ASSERT_GE(value, 0);
+            ASSERT_LT(value, 1);
+            ASSERT_GE(value_float, 0);
+            ASSERT_LT(value_float, 1);
+            single_mean += value / 10000;
+        }
+        EXPECT_NEAR(single_mean, 0.5, 0.02);
+    }
+
+    TEST(random_stream_test, unit_vectors)
+    {
+        utility::random_stream random(3, 1);
+
+        dimension3_soa<vector3d> directions;
+        random.unit_vectors(1000, directions);
+        ASSERT_EQ(directions.size(), 1000u);
+
+        vector3d mean(0, 0, 0);
+        for (std::size_t index = 0; index < directions.size(); ++index)
+        {
+            const vector3d direction = directions.get(index);
+            EXPECT_NEAR(direction.length(), 1, ROUND_EPSILON);
+            mean = mean + direction / 1000;
+        }
+
+        //uniform on the sphere, so the mean is close to the center
+        EXPECT_NEAR(mean.x, 0, 0.1);
+        EXPECT_NEAR(mean.y, 0, 0.1);
+        EXPECT_NEAR(mean.z, 0, 0.1);
+
+        EXPECT_NEAR(random.unit_vector().length(), 1, ROUND_EPSILON);
+    }
+
+    TEST(random_stream_test, cosine_directions)
+    {
+        utility::random_stream random(5, 2);
+        const utility::hemisphere hemisphere(vector3d(1, -1, 2));
+
+        dimension3_soa<vector3d> directions;
+        random.cosine_directions(hemisphere, 1000, directions);
+        ASSERT_EQ(directions.size(), 1000u);
+
+        double mean_cosine = 0;
+        for (std::size_t index = 0; index < directions.size(); ++index)
+        {
+            const vector3d direction = directions.get(index);
+            EXPECT_NEAR(direction.length(), 1, ROUND_EPSILON);
+            EXPECT_GE(direction.dot(hemisphere.get_normal()), 0);
+            mean_cosine += direction.dot(hemisphere.get_normal()) / 1000;
+        }
+
+        //the mean cosine of a cosine weighted hemisphere is 2 / 3
+        EXPECT_NEAR(mean_cosine, 2. / 3, 0.05);
+
+        const vector3d single = random.cosine_direction(hemisphere);
+        EXPECT_NEAR(single.length(), 1, ROUND_EPSILON);
+        EXPECT_GE(single.dot(hemisphere.get_normal()), 0);
+    }
+} // namespace testing
@@ -0,0 +1,93 @@
+#include "pch.h"
+#include "BardCore/utility/ray32.h"
+
+namespace testing
+{
+    TEST(ray32_test, pack_id)
+    {
+        const std::uint32_t id = utility::ray32_queue::pack_id(1234567, 200);
+        EXPECT_EQ(utility::ray32_queue::get_pixel(id), 1234567u);
+        EXPECT_EQ(utility::ray32_queue::get_sample(id), 200u);
+
+        const std::uint32_t largest = utility::ray32_queue::pack_id(utility::ray32_queue::max_pixel,
+                                                                    utility::ray32_queue::max_sample);
+        EXPECT_EQ(largest, 0xFFFFFFFFu);
+        EXPECT_EQ(utility::ray32_queue::pack_id(0, 0), 0u);
+
+        EXPECT_THROW(static_cast<void>(utility::ray32_queue::pack_id(1u << 24, 0)), exception::out_of_range_exception);
+        EXPECT_THROW(static_cast<void>(utility::ray32_queue::pack_id(0, 256)), exception::out_of_range_exception);
+    }
+
+    TEST(ray32_test, push_back)
+    {
+        utility::ray32_queue queue;
+        EXPECT_TRUE(queue.empty());
+
+        queue.push_back(utility::ray({1, 2, 3}, {0, 3, 4}, 10), 42, 3, 0.5);
+        ASSERT_EQ(queue.size(), 1u);
+        EXPECT_EQ(queue.origin_x[0], 1.f);
+        EXPECT_EQ(queue.origin_y[0], 2.f);
+        EXPECT_EQ(queue.origin_z[0], 3.f);
+        EXPECT_EQ(queue.direction_x[0], 0.f);
+        EXPECT_FLOAT_EQ(queue.direction_y[0], 0.6f);
+        EXPECT_FLOAT_EQ(queue.direction_z[0], 0.8f);
+        EXPECT_EQ(queue.tmax[0], 10.f);
+        EXPECT_EQ(utility::ray32_queue::get_pixel(queue.id[0]), 42u);
+        EXPECT_EQ(utility::ray32_queue::get_sample(queue.id[0]), 3u);
+
+        //tmin is the minimum distance plus the rounding error of the origin
+        EXPECT_GE(queue.tmin[0], 0.5f);
+        EXPECT_NEAR(queue.tmin[0], 0.5, ROUND_EPSILON);
+
+        const utility::ray ray = queue.get_ray(0);
+        EXPECT_EQ(ray.get_position(), point3d(1, 2, 3));
+        EXPECT_EQ(ray.get_direction(), vector3d(0, 0.6, 0.8));
+        EXPECT_EQ(ray.get_distance(), 10);
+
+        EXPECT_THROW(queue.push_back(utility::ray({0, 0, 0}, {0, 0, 1}, 1), 1u << 24),
+                     exception::out_of_range_exception);
+        EXPECT_EQ(queue.size(), 1u);
+
+        queue.clear();
+        EXPECT_TRUE(queue.empty());
+    }
+
+    TEST(ray32_test, assign)
+    {
+        utility::ray_queue rays;
+        rays.push_back(utility::ray({1, 2, 3}, {1, 1, 0}, 10), 7);
+        rays.push_back(utility::ray({100000, -2, 0.1}, {0, 0, -1}, 5), 8);
+        rays.push_back(utility::ray({0, 0, 0}, {0, 1, 0}, 1e10), 9);
+
+        utility::ray32_queue queue;
+        queue.assign(rays, 5, 0.001);
+
+        ASSERT_EQ(queue.size(), 3u);
+        for (std::size_t index = 0; index < rays.size(); ++index)
+        {
+            const point3d origin = rays.origin.get(index);
+            EXPECT_EQ(queue.origin_x[index], static_cast<float>(origin.x));
+            EXPECT_EQ(queue.origin_y[index], static_cast<float>(origin.y));
+            EXPECT_EQ(queue.origin_z[index], static_cast<float>(origin.z));
+            EXPECT_EQ(queue.direction_x[index], static_cast<float>(rays.direction.x()[index]));
+            EXPECT_EQ(queue.direction_y[index], static_cast<float>(rays.direction.y()[index]));
+            EXPECT_EQ(queue.direction_z[index], static_cast<float>(rays.direction.z()[index]));
+            EXPECT_EQ(queue.tmax[index], static_cast<float>(rays.distance[index]));
+            EXPECT_EQ(utility::ray32_queue::get_pixel(queue.id[index]), rays.pixel[index]);
+            EXPECT_EQ(utility::ray32_queue::get_sample(queue.id[index]), 5u);
+
+            //the rounded origin is never further than tmin from the original one
+            const double error = origin.distance(point3d(queue.origin_x[index], queue.origin_y[index],
+                                                         queue.origin_z[index]));
+            EXPECT_GE(queue.tmin[index], 0.001 + error - 1e-12);
+        }
+
+        //the origin of the far away ray is rounded, tmin grows with it
+        EXPECT_GT(queue.tmin[1], queue.tmin[0]);
+
+        rays.pixel[0] = 1u << 24;
+        EXPECT_THROW(queue.assign(rays), exception::out_of_range_exception);
+        rays.pixel[0] = 0;
+        EXPECT_THROW(queue.assign(rays, 256), exception::out_of_range_exception);
+    }
+} // namespace testing
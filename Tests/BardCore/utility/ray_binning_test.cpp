@@ -0,0 +1,146 @@
+#include "pch.h"
+#include "BardCore/utility/ray_binning.h"
+
+#include <vector>
+#include <algorithm>
+
+namespace testing
+{
+    /**
+     * \brief creates deterministic incoherent rays, like secondary rays after a diffuse bounce
+     */
+    static utility::ray_queue ray_binning_test_rays(const std::size_t count)
+    {
+        std::uint32_t state = 42;
+        const auto next = [&state]()
+        {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<double>(state >> 8) / static_cast<double>(1u << 24) * 2 - 1;
+        };
+
+        utility::ray_queue rays;
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            const point3d origin(next() * 10, next() * 10, next() * 10);
+            const vector3d direction(next(), next(), next() + 0.01);
+            rays.push_back(utility::ray(origin, direction, 100), static_cast<std::uint32_t>(index));
+        }
+
+        return rays;
+    }
+
+    TEST(ray_binning_test, octant)
+    {
+        constexpr std::uint32_t positive = utility::ray_binning::octant(1, 1, 1);
+        constexpr std::uint32_t negative = utility::ray_binning::octant(-1, -1, -1);
+
+        EXPECT_EQ(positive, 0u);
+        EXPECT_EQ(negative, 7u);
+        EXPECT_EQ(utility::ray_binning::octant(-1, 0, 0), 1u);
+        EXPECT_EQ(utility::ray_binning::octant(0, -1, 0), 2u);
+        EXPECT_EQ(utility::ray_binning::octant(0, 0, -1), 4u);
+    }
+
+    TEST(ray_binning_test, morton)
+    {
+        constexpr std::uint32_t code = utility::ray_binning::morton(1, 0, 0);
+
+        EXPECT_EQ(code, 1u);
+        EXPECT_EQ(utility::ray_binning::morton(0, 1, 0), 2u);
+        EXPECT_EQ(utility::ray_binning::morton(0, 0, 1), 4u);
+        EXPECT_EQ(utility::ray_binning::morton(3, 0, 0), 9u);
+        EXPECT_EQ(utility::ray_binning::morton(1023, 1023, 1023), (1u << 30) - 1);
+    }
+
+    TEST(ray_binning_test, sort)
+    {
+        const utility::ray_queue rays = ray_binning_test_rays(1000);
+
+        utility::ray_binning binning(6, 1);
+        const std::vector<std::size_t> permutation = binning.sort(rays);
+
+        ASSERT_EQ(permutation.size(), rays.size());
+
+        const std::vector<std::uint32_t>& keys = binning.get_keys();
+        EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+
+        std::vector<std::size_t> indices = permutation;
+        std::sort(indices.begin(), indices.end());
+        for (std::size_t index = 0; index < indices.size(); ++index)
+            EXPECT_EQ(indices[index], index);
+
+        // the octant is in the highest bits
+        for (std::size_t index = 1; index < permutation.size(); ++index)
+        {
+            const vector3d previous = rays.direction.get(permutation[index - 1]);
+            const vector3d current = rays.direction.get(permutation[index]);
+            EXPECT_LE(utility::ray_binning::octant(previous.x, previous.y, previous.z),
+                      utility::ray_binning::octant(current.x, current.y, current.z));
+        }
+    }
+
+    TEST(ray_binning_test, sort_stable_and_parallel)
+    {
+        utility::ray_queue rays;
+        for (std::uint32_t index = 0; index < 100; ++index)
+            rays.push_back(utility::ray({0, 0, 0}, {index % 2 == 0 ? 1. : -1., 0, 0}, 1), index);
+
+        utility::ray_binning serial(4, 1);
+        utility::ray_binning threaded(4, 3);
+        const std::vector<std::size_t> permutation = serial.sort(rays);
+
+        EXPECT_EQ(permutation, threaded.sort(rays));
+        for (std::size_t index = 0; index < 50; ++index)
+        {
+            EXPECT_EQ(permutation[index], index * 2); // equal keys keep their order
+            EXPECT_EQ(permutation[50 + index], index * 2 + 1);
+        }
+    }
+
+    TEST(ray_binning_test, apply_coherence)
+    {
+        utility::ray_queue rays = ray_binning_test_rays(4000);
+        const utility::ray_queue original = rays;
+
+        utility::ray_binning binning;
+        const double before = utility::ray_binning::coherence(rays);
+        binning.apply(rays);
+        const double after = utility::ray_binning::coherence(rays);
+
+        EXPECT_GT(after, before + 0.2);
+
+        ASSERT_EQ(rays.size(), original.size());
+        for (std::size_t index = 0; index < rays.size(); ++index)
+            EXPECT_EQ(rays.get_ray(index), original.get_ray(rays.pixel[index])); // pixel holds the original index
+    }
+
+    TEST(ray_binning_test, apply_vector)
+    {
+        std::vector<utility::ray> rays = {
+            utility::ray({0, 0, 0}, {-1, -1, -1}, 1), utility::ray({0, 0, 0}, {1, 1, 1}, 1),
+            utility::ray({0, 0, 0}, {1, -1, 1}, 1)
+        };
+
+        utility::ray_binning binning(0);
+        binning.apply(rays);
+
+        EXPECT_EQ(rays[0].get_direction(), vector3d(1, 1, 1).normalize());
+        EXPECT_EQ(rays[1].get_direction(), vector3d(1, -1, 1).normalize());
+        EXPECT_EQ(rays[2].get_direction(), vector3d(-1, -1, -1).normalize());
+    }
+
+    TEST(ray_binning_test, empty)
+    {
+        utility::ray_queue rays;
+        utility::ray_binning binning;
+
+        EXPECT_TRUE(binning.sort(rays).empty());
+        EXPECT_EQ(utility::ray_binning::coherence(rays), 1);
+    }
+
+    TEST(ray_binning_test, constructor_exceptions)
+    {
+        EXPECT_THROW(utility::ray_binning(10), exception::out_of_range_exception);
+        EXPECT_NO_THROW(utility::ray_binning(9));
+    }
+} // namespace testing
@@ -0,0 +1,291 @@
+#include "pch.h"
+#include "BardCore/utility/camera.h"
+#include "BardCore/utility/ray_differentials.h"
+
+namespace testing
+{
+    //step for the finite differences the differentials are compared to
+    constexpr double ray_differentials_test_step = 0.0001;
+
+    /**
+     * \brief hits a tilted plane or a sphere, returns the distance and writes the normal
+     */
+    double ray_differentials_test_hit(const bool sphere, const point3d& origin, const vector3d& direction,
+                                      vector3d& normal)
+    {
+        if (sphere)
+        {
+            //sphere around (0, 0, -6) with radius 4
+            const vector3d center = origin.get_vector(point3d(0, 0, -6));
+            const double b = direction.dot(center);
+            const double t = b - std::sqrt(b * b - center.dot(center) + 16);
+            normal = (direction * t - center) / 4;
+            return t;
+        }
+
+        //plane through (0, 0, -5)
+        normal = vector3d(0, 0.3, 1).normalize();
+        return origin.get_vector(point3d(0, 0, -5)).dot(normal) / direction.dot(normal);
+    }
+
+    /**
+     * \brief refraction with the same convention as wavefront, the normal faces the ray
+     */
+    vector3d ray_differentials_test_refract(const vector3d& direction, const vector3d& normal, const double index)
+    {
+        const double ratio = direction.dot(normal) > 0 ? index : 1 / index;
+        const vector3d facing = direction.dot(normal) > 0 ? normal * -1 : normal;
+        const double cosine = -direction.dot(facing);
+        const double k = 1 - ratio * ratio * (1 - cosine * cosine);
+        return direction * ratio + facing * (ratio * cosine - std::sqrt(k));
+    }
+
+    /**
+     * \brief shoots the rays of a camera with differentials, hits the surface and checks every differential against
+     * a finite difference of the rays through pixel (x + step, y) and (x, y + step)
+     */
+    void ray_differentials_test_check(const bool sphere, const bool refract)
+    {
+        const utility::camera cam(point3d(0, 0, 0), vector3d(0, 0, -1), 4, 3, 60);
+        const double index = 1.5;
+
+        utility::ray_queue rays;
+        utility::ray_differentials differentials;
+        cam.shoot_rays(rays, differentials, 100);
+        ASSERT_EQ(differentials.size(), rays.size());
+
+        utility::hit_queue hits;
+        hits.resize(rays.size());
+        for (std::size_t i = 0; i < rays.size(); ++i)
+        {
+            vector3d normal;
+            hits.distance[i] = ray_differentials_test_hit(sphere, rays.origin.get(i), rays.direction.get(i), normal);
+            hits.normal.set(i, normal);
+            hits.primitive[i] = hits.material[i] = 0;
+        }
+
+        differentials.transfer(rays, hits);
+
+        //the normal of a sphere changes with the hit point, the normal of the plane doesn't
+        dimension3_soa<vector3d> normal_dx(rays.size()), normal_dy(rays.size());
+        for (std::size_t i = 0; sphere && i < rays.size(); ++i)
+        {
+            normal_dx.set(i, differentials.origin_dx.get(i) / 4);
+            normal_dy.set(i, differentials.origin_dy.get(i) / 4);
+        }
+
+        const std::vector<double> indices(rays.size(), index);
+        if (refract)
+            differentials.refract(rays, hits, normal_dx, normal_dy, indices.data());
+        else
+            differentials.reflect(rays, hits, normal_dx, normal_dy);
+
+        for (std::size_t i = 0; i < rays.size(); ++i)
+        {
+            const double x = static_cast<double>(i % 4), y = static_cast<double>(i / 4);
+            const double offsets[2][2] = {{ray_differentials_test_step, 0}, {0, ray_differentials_test_step}};
+
+            for (int axis = 0; axis < 2; ++axis)
+            {
+                const utility::ray base = cam.shoot_subpixel_ray(x, y, 100);
+                const utility::ray moved = cam.shoot_subpixel_ray(x + offsets[axis][0], y + offsets[axis][1], 100);
+
+                vector3d base_normal, moved_normal;
+                const double base_t = ray_differentials_test_hit(sphere, base.get_position(), base.get_direction(),
+                                                                 base_normal);
+                const double moved_t = ray_differentials_test_hit(sphere, moved.get_position(), moved.get_direction(),
+                                                                  moved_normal);
+                if (!sphere)
+                    base_normal = moved_normal = vector3d(0, 0.3, 1).normalize();
+
+                const point3d base_point = base.get_position() + base.get_direction() * base_t;
+                const point3d moved_point = moved.get_position() + moved.get_direction() * moved_t;
+                const vector3d point_change = base_point.get_vector(moved_point) / ray_differentials_test_step;
+
+                const auto bend = [&](const vector3d& direction, const vector3d& normal)
+                {
+                    if (refract)
+                        return ray_differentials_test_refract(direction, normal, index);
+                    return direction - normal * (2 * direction.dot(normal));
+                };
+                const vector3d direction_change = (bend(moved.get_direction(), moved_normal) - bend(
+                    base.get_direction(), base_normal)) / ray_differentials_test_step;
+
+                const vector3d origin = axis == 0 ? differentials.origin_dx.get(i) : differentials.origin_dy.get(i);
+                const vector3d direction = axis == 0
+                                               ? differentials.direction_dx.get(i)
+                                               : differentials.direction_dy.get(i);
+
+                EXPECT_NEAR(origin.x, point_change.x, 0.001);
+                EXPECT_NEAR(origin.y, point_change.y, 0.001);
+                EXPECT_NEAR(origin.z, point_change.z, 0.001);
+                EXPECT_NEAR(direction.x, direction_change.x, 0.001);
+                EXPECT_NEAR(direction.y, direction_change.y, 0.001);
+                EXPECT_NEAR(direction.z, direction_change.z, 0.001);
+            }
+        }
+    }
+
+    TEST(ray_differentials_test, camera)
+    {
+        const utility::camera cam(point3d(1, 2, 3), vector3d(0, -1, 1), 8, 6, 70);
+
+        utility::ray_queue rays, expected;
+        utility::ray_differentials differentials;
+        cam.shoot_rays(rays, differentials, 10);
+        cam.shoot_rays(expected, 10);
+
+        ASSERT_EQ(differentials.size(), 48u);
+        for (std::size_t i = 0; i < rays.size(); ++i)
+        {
+            //same rays as without differentials
+            EXPECT_EQ(rays.direction.get(i), expected.direction.get(i));
+
+            const double x = static_cast<double>(i % 8), y = static_cast<double>(i / 8);
+            const vector3d base = cam.shoot_subpixel_ray(x, y, 10).get_direction();
+            const vector3d change_x = (cam.shoot_subpixel_ray(x + ray_differentials_test_step, y, 10).
+                get_direction() - base) / ray_differentials_test_step;
+            const vector3d change_y = (cam.shoot_subpixel_ray(x, y + ray_differentials_test_step, 10).
+                get_direction() - base) / ray_differentials_test_step;
+
+            EXPECT_EQ(differentials.origin_dx.get(i), vector3d(0, 0, 0));
+            EXPECT_EQ(differentials.origin_dy.get(i), vector3d(0, 0, 0));
+            EXPECT_NEAR(differentials.direction_dx.get(i).x, change_x.x, ROUND_EPSILON);
+            EXPECT_NEAR(differentials.direction_dx.get(i).y, change_x.y, ROUND_EPSILON);
+            EXPECT_NEAR(differentials.direction_dx.get(i).z, change_x.z, ROUND_EPSILON);
+            EXPECT_NEAR(differentials.direction_dy.get(i).x, change_y.x, ROUND_EPSILON);
+            EXPECT_NEAR(differentials.direction_dy.get(i).y, change_y.y, ROUND_EPSILON);
+            EXPECT_NEAR(differentials.direction_dy.get(i).z, change_y.z, ROUND_EPSILON);
+        }
+
+        EXPECT_THROW(cam.shoot_rays(rays, differentials, -1), exception::negative_exception);
+    }
+
+    TEST(ray_differentials_test, reflect)
+    {
+        ray_differentials_test_check(false, false);
+        ray_differentials_test_check(true, false);
+    }
+
+    TEST(ray_differentials_test, refract)
+    {
+        ray_differentials_test_check(false, true);
+        ray_differentials_test_check(true, true);
+    }
+
+    TEST(ray_differentials_test, flat)
+    {
+        const utility::camera cam(point3d(0, 0, 0), vector3d(0, 0, -1), 4, 3, 60);
+
+        utility::ray_queue rays;
+        utility::ray_differentials flat, curved;
+        cam.shoot_rays(rays, flat, 100);
+        cam.shoot_rays(rays, curved, 100);
+
+        utility::hit_queue hits;
+        hits.resize(rays.size());
+        for (std::size_t i = 0; i < rays.size(); ++i)
+        {
+            vector3d normal;
+            hits.distance[i] = ray_differentials_test_hit(false, rays.origin.get(i), rays.direction.get(i), normal);
+            hits.normal.set(i, normal);
+            hits.primitive[i] = hits.material[i] = 0;
+        }
+
+        //a flat surface is a curved surface without normal differentials
+        const dimension3_soa<vector3d> zero(rays.size());
+        const std::vector<double> indices(rays.size(), 1.5);
+        flat.refract(rays, hits, indices.data());
+        curved.refract(rays, hits, zero, zero, indices.data());
+
+        for (std::size_t i = 0; i < rays.size(); ++i)
+        {
+            EXPECT_EQ(flat.direction_dx.get(i), curved.direction_dx.get(i));
+            EXPECT_EQ(flat.direction_dy.get(i), curved.direction_dy.get(i));
+        }
+    }
+
+    TEST(ray_differentials_test, total_internal_reflection)
+    {
+        //leaving glass at 60 degrees is a total internal reflection
+        utility::ray_queue rays;
+        rays.push_back(point3d(0, 0, 0), vector3d(std::sqrt(3) / 2, 0, -0.5), 10);
+
+        utility::hit_queue hits;
+        hits.resize(1);
+        hits.distance[0] = 1;
+        hits.normal.set(0, vector3d(0, 0, -1));
+        hits.primitive[0] = hits.material[0] = 0;
+
+        utility::ray_differentials reflected, refracted;
+        reflected.resize(1);
+        reflected.direction_dx.set(0, vector3d(0.1, 0.2, 0.3));
+        reflected.direction_dy.set(0, vector3d(-0.3, 0.1, 0.2));
+        refracted = reflected;
+
+        const double index = 1.5;
+        reflected.reflect(rays, hits);
+        refracted.refract(rays, hits, &index);
+
+        EXPECT_EQ(refracted.direction_dx.get(0), reflected.direction_dx.get(0));
+        EXPECT_EQ(refracted.direction_dy.get(0), reflected.direction_dy.get(0));
+    }
+
+    TEST(ray_differentials_test, transfer_miss)
+    {
+        utility::ray_queue rays;
+        rays.push_back(point3d(0, 0, 0), vector3d(0, 0, -1), 10);
+
+        utility::hit_queue hits;
+        hits.resize(1);
+        hits.distance[0] = std::numeric_limits<double>::infinity();
+        hits.primitive[0] = hits.material[0] = utility::hit_queue::no_hit;
+
+        utility::ray_differentials differentials;
+        differentials.resize(1);
+        differentials.origin_dx.set(0, vector3d(1, 0, 0));
+        differentials.direction_dx.set(0, vector3d(0.5, 0, 0));
+
+        //a miss is not moved
+        differentials.transfer(rays, hits);
+        EXPECT_EQ(differentials.origin_dx.get(0), vector3d(1, 0, 0));
+        EXPECT_EQ(differentials.origin_dy.get(0), vector3d(0, 0, 0));
+    }
+
+    TEST(ray_differentials_test, footprints)
+    {
+        utility::ray_differentials differentials;
+        differentials.resize(2);
+        differentials.origin_dx.set(0, vector3d(3, 4, 0));
+        differentials.origin_dy.set(0, vector3d(0, 1, 0));
+        differentials.origin_dx.set(1, vector3d(0, 0, 1));
+        differentials.origin_dy.set(1, vector3d(0, 2, 0));
+
+        std::vector<double> footprints;
+        differentials.footprints(footprints);
+        ASSERT_EQ(footprints.size(), 2u);
+        EXPECT_DOUBLE_EQ(footprints[0], 5);
+        EXPECT_DOUBLE_EQ(footprints[1], 2);
+    }
+
+    TEST(ray_differentials_test, size)
+    {
+        utility::ray_queue rays;
+        rays.push_back(point3d(0, 0, 0), vector3d(0, 0, -1), 10);
+        utility::hit_queue hits;
+        hits.resize(1);
+        utility::ray_differentials differentials;
+        const dimension3_soa<vector3d> normals(1);
+        const double index = 1.5;
+
+        EXPECT_THROW(differentials.transfer(rays, hits), exception::out_of_range_exception);
+        EXPECT_THROW(differentials.reflect(rays, hits), exception::out_of_range_exception);
+        EXPECT_THROW(differentials.refract(rays, hits, &index), exception::out_of_range_exception);
+
+        differentials.resize(1);
+        const dimension3_soa<vector3d> empty;
+        EXPECT_THROW(differentials.reflect(rays, hits, normals, empty), exception::out_of_range_exception);
+        EXPECT_THROW(differentials.refract(rays, hits, empty, normals, &index), exception::out_of_range_exception);
+        EXPECT_NO_THROW(differentials.reflect(rays, hits, normals, normals));
+    }
+} // namespace testing
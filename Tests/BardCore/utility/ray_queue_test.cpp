@@ -0,0 +1,117 @@
+#include "pch.h"
+#include "BardCore/utility/ray_queue.h"
+
+#include <vector>
+
+namespace testing
+{
+    TEST(ray_queue_test, push_back)
+    {
+        const utility::ray ray({1, 2, 3}, {0, 0, 2}, 10);
+
+        utility::ray_queue queue;
+        queue.push_back(ray, 7, 0.5, 2);
+
+        ASSERT_EQ(queue.size(), 1u);
+        EXPECT_EQ(queue.get_ray(0), ray);
+        EXPECT_EQ(queue.direction.get(0), vector3d(0, 0, 1)); // ray already normalized it
+        EXPECT_EQ(queue.pixel[0], 7u);
+        EXPECT_EQ(queue.throughput[0], 0.5);
+        EXPECT_EQ(queue.depth[0], 2u);
+    }
+
+    TEST(ray_queue_test, gather)
+    {
+        utility::ray_queue queue;
+        for (std::uint32_t index = 0; index < 4; ++index)
+            queue.push_back({static_cast<double>(index), 0, 0}, {1, 0, 0}, index + 1., index, index * 0.25, index);
+
+        const std::vector<std::size_t> permutation = {3, 1, 2, 0};
+        utility::ray_queue result;
+        result.gather(queue, permutation.data(), permutation.size());
+
+        ASSERT_EQ(result.size(), 4u);
+        for (std::size_t index = 0; index < permutation.size(); ++index)
+        {
+            EXPECT_EQ(result.get_ray(index), queue.get_ray(permutation[index]));
+            EXPECT_EQ(result.pixel[index], queue.pixel[permutation[index]]);
+            EXPECT_EQ(result.throughput[index], queue.throughput[permutation[index]]);
+            EXPECT_EQ(result.depth[index], queue.depth[permutation[index]]);
+        }
+    }
+
+    TEST(ray_queue_test, clear_swap)
+    {
+        utility::ray_queue first;
+        utility::ray_queue second;
+        first.push_back(utility::ray({1, 0, 0}));
+
+        first.swap(second);
+        EXPECT_TRUE(first.empty());
+        EXPECT_EQ(second.size(), 1u);
+
+        second.clear();
+        EXPECT_TRUE(second.empty());
+    }
+
+    TEST(ray_queue_test, push_segment)
+    {
+        utility::ray_queue queue;
+        queue.push_segment({1, 1, 1}, {1, 1, 4}, 3);
+
+        ASSERT_EQ(queue.size(), 1u);
+        EXPECT_EQ(queue.get_ray(0), utility::ray(point3d(1, 1, 1), point3d(1, 1, 4)));
+        EXPECT_EQ(queue.pixel[0], 3u);
+        EXPECT_THROW(queue.push_segment({1, 1, 1}, {1, 1, 1}), exception::zero_exception);
+    }
+
+    TEST(ray_queue_test, assign_segments)
+    {
+        const dimension3_soa<point3d> starts(std::vector<point3d>{{0, 0, 0}, {1, 2, 3}, {5, 5, 5}});
+        const dimension3_soa<point3d> ends(std::vector<point3d>{{0, 3, 4}, {2, 2, 3}, {5, 5, 5}});
+
+        utility::ray_queue queue;
+        queue.assign_segments(starts, ends);
+
+        ASSERT_EQ(queue.size(), 3u);
+        EXPECT_EQ(queue.get_ray(0), utility::ray(starts.get(0), ends.get(0)));
+        EXPECT_EQ(queue.get_ray(1), utility::ray(starts.get(1), ends.get(1)));
+        EXPECT_EQ(queue.direction.get(2), vector3d::zero()); // zero length doesn't throw
+        EXPECT_EQ(queue.distance[2], 0);
+        EXPECT_EQ(queue.pixel[2], 2u);
+        EXPECT_EQ(queue.throughput[2], 1);
+
+        //rays already in the queue keep their pixel, throughput and depth
+        queue.pixel[1] = 42;
+        queue.throughput[1] = 0.5;
+        queue.depth[1] = 3;
+        queue.assign_segments(ends, starts);
+        EXPECT_EQ(queue.get_ray(1), utility::ray(ends.get(1), starts.get(1)));
+        EXPECT_EQ(queue.pixel[1], 42u);
+        EXPECT_EQ(queue.throughput[1], 0.5);
+        EXPECT_EQ(queue.depth[1], 3u);
+
+        const dimension3_soa<point3d> wrong(1);
+        EXPECT_THROW(queue.assign_segments(starts, wrong), exception::out_of_range_exception);
+    }
+
+    TEST(hit_queue_test, gather)
+    {
+        utility::hit_queue hits;
+        hits.resize(2);
+        hits.distance = {1, 2};
+        hits.normal.set(1, {0, 1, 0});
+        hits.primitive = {utility::hit_queue::no_hit, 4};
+        hits.material = {utility::hit_queue::no_hit, 3};
+
+        const std::vector<std::size_t> permutation = {1, 0};
+        utility::hit_queue result;
+        result.gather(hits, permutation.data(), permutation.size());
+
+        EXPECT_TRUE(result.is_hit(0));
+        EXPECT_FALSE(result.is_hit(1));
+        EXPECT_EQ(result.distance[0], 2);
+        EXPECT_EQ(result.normal.get(0), vector3d(0, 1, 0));
+        EXPECT_EQ(result.material[0], 3u);
+    }
+} // namespace testing
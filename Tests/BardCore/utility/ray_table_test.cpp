@@ -0,0 +1,166 @@
+#include "pch.h"
+#include "BardCore/utility/ray_table.h"
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <utility>
+
+namespace testing
+{
+    /**
+     * \brief stream buffer over a string that can't seek, like a pipe
+     */
+    class unseekable_buffer : public std::streambuf
+    {
+        std::string data_;
+
+    public:
+        explicit unseekable_buffer(std::string data) : data_(std::move(data))
+        {
+            setg(&data_[0], &data_[0], &data_[0] + data_.size());
+        }
+    };
+
+    TEST(ray_table_test, constructor)
+    {
+        constexpr utility::camera cam{{1, 2, 3}, {0, 0, 1}, 8, 6, 70};
+        constexpr utility::ray_table<8, 6> table(cam);
+
+        //calculated at compile time
+        constexpr vector3d corner = table.get_direction(0, 0);
+        static_assert(corner.z > 0, "direction must point away from the camera");
+
+        EXPECT_EQ(table.get_position(), point3d(1, 2, 3));
+        EXPECT_EQ(table.get_width(), 8u);
+        EXPECT_EQ(table.get_height(), 6u);
+
+        EXPECT_THROW((utility::ray_table<8, 5>(cam)), exception::out_of_range_exception);
+        EXPECT_THROW((utility::ray_table<4, 6>(cam)), exception::out_of_range_exception);
+    }
+
+    TEST(ray_table_test, shoot_ray)
+    {
+        const utility::camera cam{{1, 2, 3}, {1, 1, 0}, 8, 6, 70};
+        const utility::ray_table<8, 6> table(cam);
+
+        for (unsigned int y = 0; y < 6; ++y)
+        {
+            for (unsigned int x = 0; x < 8; ++x)
+            {
+                const utility::ray expected = cam.shoot_ray(x, y, 10);
+                const utility::ray actual = table.shoot_ray(x, y, 10);
+
+                EXPECT_EQ(actual.get_position(), expected.get_position());
+                EXPECT_NEAR(actual.get_direction().x, expected.get_direction().x, ROUND_EPSILON);
+                EXPECT_NEAR(actual.get_direction().y, expected.get_direction().y, ROUND_EPSILON);
+                EXPECT_NEAR(actual.get_direction().z, expected.get_direction().z, ROUND_EPSILON);
+                EXPECT_NEAR(actual.get_direction().length(), 1, ROUND_EPSILON);
+            }
+        }
+
+        EXPECT_THROW(table.shoot_ray(8, 0, 10), exception::out_of_range_exception);
+        EXPECT_THROW(table.shoot_ray(0, 6, 10), exception::out_of_range_exception);
+    }
+
+    TEST(ray_table_test, shoot_rays)
+    {
+        const utility::camera cam{{1, 2, 3}, {0, -1, 1}, 8, 6, 90};
+        const utility::ray_table<8, 6> table(cam);
+
+        utility::ray_queue expected, actual;
+        cam.shoot_rays(expected, 5);
+        table.shoot_rays(actual, 5);
+
+        ASSERT_EQ(actual.size(), expected.size());
+        for (std::size_t index = 0; index < actual.size(); ++index)
+        {
+            EXPECT_EQ(actual.origin.get(index), expected.origin.get(index));
+            EXPECT_NEAR(actual.direction.x()[index], expected.direction.x()[index], ROUND_EPSILON);
+            EXPECT_NEAR(actual.direction.y()[index], expected.direction.y()[index], ROUND_EPSILON);
+            EXPECT_NEAR(actual.direction.z()[index], expected.direction.z()[index], ROUND_EPSILON);
+            EXPECT_EQ(actual.distance[index], 5);
+            EXPECT_EQ(actual.pixel[index], expected.pixel[index]);
+            EXPECT_EQ(actual.throughput[index], 1);
+            EXPECT_EQ(actual.depth[index], 0u);
+        }
+
+        EXPECT_THROW(table.shoot_rays(actual, -1), exception::negative_exception);
+    }
+
+    TEST(ray_cache_test, save_load)
+    {
+        const utility::camera cam{{1, 2, 3}, {0, -1, 1}, 16, 9, 60};
+        const utility::ray_cache cache(cam);
+
+        EXPECT_EQ(cache.size(), 144u);
+        EXPECT_TRUE(cache.matches(cam));
+        EXPECT_FALSE(cache.matches(utility::camera({1, 2, 3}, {0, -1, 1}, 16, 9, 61)));
+
+        std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+        cache.save(stream);
+        const utility::ray_cache loaded = utility::ray_cache::load(stream);
+
+        EXPECT_TRUE(loaded.matches(cam));
+        EXPECT_EQ(loaded.get_screen_width(), 16u);
+        EXPECT_EQ(loaded.get_screen_height(), 9u);
+
+        utility::ray_queue expected, actual;
+        cam.shoot_rays(expected, 5);
+        loaded.shoot_rays(actual, 5);
+
+        ASSERT_EQ(actual.size(), expected.size());
+        for (std::size_t index = 0; index < actual.size(); ++index)
+        {
+            EXPECT_EQ(actual.origin.get(index), expected.origin.get(index));
+            EXPECT_EQ(actual.direction.get(index), expected.direction.get(index));
+            EXPECT_EQ(actual.pixel[index], expected.pixel[index]);
+        }
+    }
+
+    TEST(ray_cache_test, load_invalid)
+    {
+        std::stringstream empty(std::ios::in | std::ios::out | std::ios::binary);
+        EXPECT_THROW(utility::ray_cache::load(empty), exception::io_exception);
+
+        std::stringstream wrong_magic("BRT0 and some more bytes", std::ios::in | std::ios::binary);
+        EXPECT_THROW(utility::ray_cache::load(wrong_magic), exception::io_exception);
+
+        //a valid header without the directions
+        const utility::ray_cache cache(utility::camera({0, 0, 0}, {0, 0, 1}, 4, 4));
+        std::stringstream full(std::ios::in | std::ios::out | std::ios::binary);
+        cache.save(full);
+        std::stringstream truncated(full.str().substr(0, 64), std::ios::in | std::ios::binary);
+        EXPECT_THROW(utility::ray_cache::load(truncated), exception::io_exception);
+
+        //a header with a huge screen size throws before allocating the directions
+        std::string huge = full.str();
+        const std::uint32_t size = 0xFFFFFFFFu;
+        std::memcpy(&huge[4], &size, sizeof(size));
+        std::memcpy(&huge[8], &size, sizeof(size));
+        std::stringstream corrupt(huge, std::ios::in | std::ios::binary);
+        EXPECT_THROW(utility::ray_cache::load(corrupt), exception::io_exception);
+
+        //the same without seeking, it fails on the short read
+        unseekable_buffer buffer(huge);
+        std::istream unseekable(&buffer);
+        EXPECT_THROW(utility::ray_cache::load(unseekable), exception::io_exception);
+    }
+
+    TEST(ray_cache_test, load_unseekable)
+    {
+        const utility::ray_cache cache(utility::camera({1, 2, 3}, {0, 0, 1}, 8, 4));
+        std::stringstream full(std::ios::in | std::ios::out | std::ios::binary);
+        cache.save(full);
+
+        unseekable_buffer buffer(full.str());
+        std::istream unseekable(&buffer);
+        const utility::ray_cache loaded = utility::ray_cache::load(unseekable);
+
+        ASSERT_EQ(loaded.size(), cache.size());
+        for (std::size_t index = 0; index < cache.size(); ++index)
+            EXPECT_EQ(loaded.get_directions().get(index), cache.get_directions().get(index));
+    }
+} // namespace testing
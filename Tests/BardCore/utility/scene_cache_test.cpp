@@ -0,0 +1,162 @@
+#include "pch.h"
+#include "BardCore/utility/scene_cache.h"
+#include "BardCore/geometry/sphere_set.h"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace testing
+{
+    constexpr std::uint32_t scene_cache_test_values = utility::scene_format::make_tag('T', 'V', 'A', 'L');
+    constexpr std::uint32_t scene_cache_test_points = utility::scene_format::make_tag('T', 'P', 'N', 'T');
+
+    /**
+     * \brief writes a cache with a section of 5 doubles and a section of 3 points to a string
+     */
+    std::string scene_cache_test_write()
+    {
+        const std::vector<double> values = {1, 2, 3, 4, 5};
+        const std::vector<point3d> points = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+
+        utility::scene_writer writer;
+        writer.add(scene_cache_test_values, values);
+        writer.add(scene_cache_test_points, points.data(), points.size());
+
+        std::ostringstream stream(std::ios::binary);
+        writer.write(stream);
+        return stream.str();
+    }
+
+    TEST(scene_cache_test, write_view)
+    {
+        //copied to a vector of doubles so the start is aligned like a mapped file
+        const std::string bytes = scene_cache_test_write();
+        std::vector<double> memory(bytes.size() / sizeof(double) + 1);
+        std::memcpy(memory.data(), bytes.data(), bytes.size());
+
+        EXPECT_EQ(bytes.size() % utility::scene_format::alignment, 0u);
+
+        const utility::scene_view view(memory.data(), bytes.size());
+        EXPECT_EQ(view.get_section_count(), 2u);
+        EXPECT_TRUE(view.contains(scene_cache_test_values));
+        EXPECT_FALSE(view.contains(utility::scene_format::make_tag('N', 'O', 'N', 'E')));
+
+        const utility::scene_array<double> values = view.get<double>(scene_cache_test_values);
+        ASSERT_EQ(values.size(), 5u);
+        EXPECT_EQ(values[4], 5);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(values.data()) % utility::scene_format::alignment,
+                  reinterpret_cast<std::uintptr_t>(memory.data()) % utility::scene_format::alignment);
+
+        //the array points into the memory, nothing is copied
+        const char* start = reinterpret_cast<const char*>(memory.data());
+        EXPECT_GE(reinterpret_cast<const char*>(values.data()), start);
+        EXPECT_LT(reinterpret_cast<const char*>(values.data()), start + bytes.size());
+
+        const utility::scene_array<point3d> points = view.get<point3d>(scene_cache_test_points);
+        ASSERT_EQ(points.size(), 3u);
+        EXPECT_EQ(points[2], point3d(7, 8, 9));
+
+        EXPECT_THROW(static_cast<void>(view.get<double>(utility::scene_format::make_tag('N', 'O', 'N', 'E'))),
+                     exception::io_exception);
+        EXPECT_THROW(static_cast<void>(view.get<float>(scene_cache_test_values)), exception::io_exception);
+    }
+
+    TEST(scene_cache_test, view_invalid)
+    {
+        const std::string bytes = scene_cache_test_write();
+        std::vector<double> memory(bytes.size() / sizeof(double) + 1);
+        std::memcpy(memory.data(), bytes.data(), bytes.size());
+
+        //truncated
+        EXPECT_THROW(utility::scene_view(memory.data(), bytes.size() - 1), exception::io_exception);
+        EXPECT_THROW(utility::scene_view(memory.data(), 8), exception::io_exception);
+        EXPECT_THROW(utility::scene_view(nullptr, 0), exception::io_exception);
+
+        //another version
+        std::vector<double> version = memory;
+        reinterpret_cast<char*>(version.data())[4] = 2;
+        EXPECT_THROW(utility::scene_view(version.data(), bytes.size()), exception::io_exception);
+
+        //another byte order
+        std::vector<double> order = memory;
+        reinterpret_cast<char*>(order.data())[8] = 9;
+        EXPECT_THROW(utility::scene_view(order.data(), bytes.size()), exception::io_exception);
+
+        //not a cache
+        const std::vector<double> zeros(memory.size());
+        EXPECT_THROW(utility::scene_view(zeros.data(), bytes.size()), exception::io_exception);
+    }
+
+    TEST(scene_cache_test, writer)
+    {
+        const std::vector<double> values = {1};
+        utility::scene_writer writer;
+        writer.add(scene_cache_test_values, values);
+
+        EXPECT_EQ(writer.size(), 1u);
+        EXPECT_TRUE(writer.contains(scene_cache_test_values));
+        EXPECT_THROW(writer.add(scene_cache_test_values, values), exception::same_object_exception);
+
+        //an empty section
+        const std::vector<double> empty;
+        writer.add(scene_cache_test_points, empty);
+
+        std::ostringstream stream(std::ios::binary);
+        writer.write(stream);
+        const std::string bytes = stream.str();
+        std::vector<double> memory(bytes.size() / sizeof(double) + 1);
+        std::memcpy(memory.data(), bytes.data(), bytes.size());
+
+        const utility::scene_view view(memory.data(), bytes.size());
+        EXPECT_TRUE(view.get<double>(scene_cache_test_points).empty());
+    }
+
+    TEST(scene_cache_test, mapped_file)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 10}, 1, 0);
+        spheres.add({0, 0, 5}, 1, 1);
+        spheres.add({5, 0, 0}, 2, 2);
+
+        const std::string path = "scene_cache_test.bsc";
+        utility::scene_writer writer;
+        spheres.save(writer);
+        writer.write(path);
+
+        {
+            utility::mapped_file file(path);
+            const utility::scene_view scene = file.view();
+            const geometry::sphere_view view(scene);
+
+            ASSERT_EQ(view.size(), 3u);
+            EXPECT_EQ(view.get_center(2), point3d(5, 0, 0));
+            EXPECT_EQ(view.get_radius(2), 2);
+            EXPECT_EQ(view.get_material(1), 1u);
+
+            //the mapped spheres give the same hits as the set
+            utility::ray_queue rays;
+            rays.push_back(utility::ray({0, 0, 0}, {0, 0, 1}, 100));
+            rays.push_back(utility::ray({0, 0, 0}, {0, 1, 0}, 100));
+            rays.push_back(utility::ray({0, 0, 0}, {1, 0, 0}, 100));
+
+            utility::hit_queue mapped_hits, set_hits;
+            view.intersect(rays, mapped_hits);
+            spheres.intersect(rays, set_hits);
+            for (std::size_t index = 0; index < rays.size(); ++index)
+            {
+                EXPECT_EQ(mapped_hits.primitive[index], set_hits.primitive[index]);
+                EXPECT_EQ(mapped_hits.distance[index], set_hits.distance[index]);
+            }
+
+            //moving keeps the mapping
+            utility::mapped_file moved(std::move(file));
+            EXPECT_EQ(moved.size(), scene.size());
+            EXPECT_EQ(geometry::sphere_set(geometry::sphere_view(moved.view())).get_center(0), point3d(0, 0, 10));
+        }
+
+        std::remove(path.c_str());
+        EXPECT_THROW(utility::mapped_file{path}, exception::io_exception);
+    }
+} // namespace testing
@@ -0,0 +1,222 @@
+#include "pch.h"
+#include "BardCore/utility/spatial_hash.h"
+#include "BardCore/math/math.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace testing
+{
+    /**
+     * \brief creates a deterministic cloud of points in [0, size)^3
+     */
+    static std::vector<point3d> spatial_hash_test_points(const std::size_t count, const double size)
+    {
+        std::vector<point3d> points;
+        points.reserve(count);
+
+        std::uint32_t state = 12345;
+        const auto next = [&state, size]()
+        {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<double>(state >> 8) / static_cast<double>(1u << 24) * size;
+        };
+
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            const double x = next();
+            const double y = next();
+            const double z = next();
+            points.emplace_back(x, y, z);
+        }
+
+        return points;
+    }
+
+    static std::vector<std::size_t> spatial_hash_brute_force(const std::vector<point3d>& points, const point3d& center,
+                                                             const double radius)
+    {
+        std::vector<std::size_t> result;
+        for (std::size_t index = 0; index < points.size(); ++index)
+            if (center.distance_squared(points[index]) <= radius * radius)
+                result.push_back(index);
+        return result;
+    }
+
+    TEST(spatial_hash_test, constructor)
+    {
+        const utility::spatial_hash hash(0.5, 1000);
+
+        EXPECT_EQ(hash.get_cell_size(), 0.5);
+        EXPECT_EQ(hash.get_table_size(), 1024u); // rounded up to a power of two
+        EXPECT_EQ(hash.size(), 0u);
+    }
+
+    TEST(spatial_hash_test, constructor_exceptions)
+    {
+        EXPECT_THROW(utility::spatial_hash(0, 10), exception::zero_exception);
+        EXPECT_THROW(utility::spatial_hash(1, 0), exception::zero_exception);
+        EXPECT_THROW(utility::spatial_hash(-1, 10), exception::negative_exception);
+    }
+
+    TEST(spatial_hash_test, build_counting_sort)
+    {
+        const std::vector<point3d> points = spatial_hash_test_points(1000, 10);
+
+        utility::spatial_hash hash(1, 256);
+        hash.build(points, 1);
+
+        ASSERT_EQ(hash.size(), points.size());
+
+        // every point is stored exactly once, next to the other points of its bucket
+        std::vector<std::size_t> indices = hash.get_indices();
+        std::sort(indices.begin(), indices.end());
+        for (std::size_t index = 0; index < indices.size(); ++index)
+            EXPECT_EQ(indices[index], index);
+
+        std::size_t total = 0;
+        for (std::size_t bucket = 0; bucket < hash.get_table_size(); ++bucket)
+            total += hash.bucket_size(bucket);
+        EXPECT_EQ(total, points.size());
+
+        for (std::size_t position = 1; position < hash.size(); ++position)
+            EXPECT_LE(hash.bucket(hash.get_points()[position - 1]), hash.bucket(hash.get_points()[position]));
+    }
+
+    TEST(spatial_hash_test, build_parallel_same_as_serial)
+    {
+        const std::vector<point3d> points = spatial_hash_test_points(5000, 20);
+
+        utility::spatial_hash serial(1, 512);
+        utility::spatial_hash threaded(1, 512);
+        serial.build(points, 1);
+        threaded.build(points, 4);
+
+        EXPECT_EQ(serial.get_indices(), threaded.get_indices());
+    }
+
+    TEST(spatial_hash_test, rebuild)
+    {
+        std::vector<point3d> points = spatial_hash_test_points(500, 10);
+
+        utility::spatial_hash hash(1, 128);
+        hash.build(points);
+
+        for (point3d& point : points)
+            point += vector3d(0.3, -0.2, 0.1);
+        points.resize(400);
+        hash.build(points);
+
+        EXPECT_EQ(hash.size(), 400u);
+
+        std::vector<std::size_t> result;
+        hash.query_radius(points[0], 0, result);
+        EXPECT_NE(std::find(result.begin(), result.end(), 0u), result.end());
+    }
+
+    TEST(spatial_hash_test, query_radius_brute_force)
+    {
+        const std::vector<point3d> points = spatial_hash_test_points(2000, 10);
+
+        utility::spatial_hash hash(1, 64); // small table, lots of collisions
+        hash.build(points, 3);
+
+        const std::vector<point3d> centers = spatial_hash_test_points(20, 10);
+        for (const double radius : {0.0, 0.5, 1.0, 2.5, 20.0})
+        {
+            for (const point3d& center : centers)
+            {
+                std::vector<std::size_t> result;
+                hash.query_radius(center, radius, result);
+                std::sort(result.begin(), result.end());
+
+                EXPECT_EQ(result, spatial_hash_brute_force(points, center, radius));
+            }
+        }
+    }
+
+    TEST(spatial_hash_test, for_each_in_radius_distance)
+    {
+        const std::vector<point3d> points = {{0, 0, 0}, {1, 0, 0}, {0, 3, 0}, {-0.5, 0.5, 0}};
+
+        utility::spatial_hash hash(1, 16);
+        hash.build(points);
+
+        std::size_t found = 0;
+        hash.for_each_in_radius({0, 0, 0}, 1, [&points, &found](const std::size_t index, const point3d& point,
+                                                                const double distance_squared)
+        {
+            EXPECT_EQ(points[index], point);
+            EXPECT_NEAR(distance_squared, point.distance_squared({0, 0, 0}), ROUND_EPSILON);
+            ++found;
+        });
+
+        EXPECT_EQ(found, 3u);
+        EXPECT_THROW(hash.for_each_in_radius({0, 0, 0}, -1, [](std::size_t, const point3d&, double) {}),
+                     exception::negative_exception);
+    }
+
+    TEST(spatial_hash_test, for_each_neighbour)
+    {
+        const std::vector<point3d> points = {{0.5, 0.5, 0.5}, {1.5, 1.5, 1.5}, {5.5, 5.5, 5.5}};
+
+        utility::spatial_hash hash(1, 1024);
+        hash.build(points);
+
+        std::vector<std::size_t> result;
+        hash.for_each_neighbour({0.5, 0.5, 0.5}, [&result](const std::size_t index, const point3d&)
+        {
+            result.push_back(index);
+        });
+        std::sort(result.begin(), result.end());
+
+        EXPECT_NE(std::find(result.begin(), result.end(), 0u), result.end());
+        EXPECT_NE(std::find(result.begin(), result.end(), 1u), result.end());
+    }
+
+    TEST(spatial_hash_test, cell_coordinate_clamp)
+    {
+        const utility::spatial_hash hash(0.5, 16);
+        const std::int64_t max_cell = utility::spatial_hash::max_cell;
+
+        EXPECT_EQ(hash.cell_coordinate(1.2), 2);
+        EXPECT_EQ(hash.cell_coordinate(-0.2), -1);
+        EXPECT_EQ(hash.cell_coordinate(1e300), max_cell);
+        EXPECT_EQ(hash.cell_coordinate(-1e300), -max_cell);
+        EXPECT_EQ(hash.cell_coordinate(math::inf), max_cell);
+        EXPECT_EQ(hash.cell_coordinate(-math::inf), -max_cell);
+        EXPECT_EQ(hash.cell_coordinate(std::nan("")), -max_cell);
+
+        //points far away still build and can be found
+        utility::spatial_hash grid(1, 64);
+        grid.build({{0, 0, 0}, {1e300, 0, 0}, {math::inf, 0, 0}});
+        std::vector<std::size_t> result;
+        grid.query_radius({1e300, 0, 0}, 1, result);
+        ASSERT_EQ(result.size(), 1u);
+        EXPECT_EQ(result[0], 1u);
+    }
+
+    TEST(spatial_hash_test, query_radius_large)
+    {
+        const std::vector<point3d> points = {{0.5, 0.5, 0.5}, {1000, -1000, 5}, {-1e6, 2e6, 3e5}};
+
+        utility::spatial_hash hash(1, 64);
+        hash.build(points);
+
+        // 2^22 cells per axis, the amount of cells (2^66) doesn't fit an uint64, all points are scanned instead
+        std::vector<std::size_t> result;
+        hash.query_radius({0.5, 0.5, 0.5}, 2097152 - 0.5, result);
+        std::sort(result.begin(), result.end());
+
+        EXPECT_EQ(result, std::vector<std::size_t>({0, 1}));
+    }
+
+    TEST(spatial_hash_test, bucket_size_exception)
+    {
+        const utility::spatial_hash hash(1, 16);
+
+        EXPECT_THROW(static_cast<void>(hash.bucket_size(16)), exception::out_of_range_exception);
+        EXPECT_NO_THROW(static_cast<void>(hash.bucket_size(15)));
+    }
+} // namespace testing
@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "BardCore/utility/text_io.h"
+#include "BardCore/math/imaginary/quaternion.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace testing
+{
+    /**
+     * \brief reads a whole file into a string
+     */
+    std::string text_io_test_read(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+
+    TEST(text_io_test, format)
+    {
+        char buffer[utility::text_writer::max_number_length];
+        const double values[5] = {0, -1.5, 0.1, 1e300, -2.2250738585072014e-308};
+
+        for (const double value : values)
+        {
+            char* end = utility::text_writer::format(buffer, buffer + sizeof(buffer), value);
+
+            //reads back to the same double
+            double parsed = 1;
+            EXPECT_EQ(utility::number_parser::parse(buffer, end, parsed), end);
+            EXPECT_EQ(parsed, value);
+        }
+
+#if defined(FLOAT_CHARCONV)
+        //the shortest text
+        char* end = utility::text_writer::format(buffer, buffer + sizeof(buffer), 0.1);
+        EXPECT_EQ(std::string(buffer, end), "0.1");
+#endif
+    }
+
+    TEST(text_io_test, round_trip)
+    {
+        const std::string path = "text_io_test.txt";
+        const std::vector<point3d> points = {{1, 2, 3}, {-0.5, 1e-10, 123456789.125}, {0.1, 0.2, 0.3}};
+        const dimension3_soa<vector3d> vectors(std::vector<vector3d>{{4, 5, 6}, {1.0 / 3, 2.0 / 3, -1}});
+        const std::vector<quaternion> quaternions = {{1, 0, 0, 0}, {0.5, -0.5, 0.25, 0.125}};
+
+        {
+            //a small buffer, so it is written several times
+            utility::text_writer writer(path, 64);
+            writer.write(points);
+            writer.write(vectors);
+            writer.write(quaternions.data(), quaternions.size());
+            writer.flush();
+        }
+
+        const std::string text = text_io_test_read(path);
+        const char* first = text.data();
+        const char* points_end = first;
+        for (int line = 0; line < 3; ++line)
+            points_end = std::strchr(points_end, '\n') + 1;
+        const char* vectors_end = std::strchr(std::strchr(points_end, '\n') + 1, '\n') + 1;
+
+        std::vector<point3d> parsed_points;
+        dimension3_soa<vector3d> parsed_vectors;
+        std::vector<quaternion> parsed_quaternions;
+        utility::text_parser::parse(first, points_end, parsed_points);
+        utility::text_parser::parse(points_end, vectors_end, parsed_vectors);
+        utility::text_parser::parse(vectors_end, first + text.size(), parsed_quaternions);
+
+        EXPECT_EQ(parsed_points, points);
+        ASSERT_EQ(parsed_vectors.size(), vectors.size());
+        for (std::size_t index = 0; index < vectors.size(); ++index)
+            EXPECT_EQ(parsed_vectors.get(index), vectors.get(index));
+        EXPECT_EQ(parsed_quaternions, quaternions);
+
+        //23 numbers are not a whole amount of points
+        std::vector<point3d> mixed;
+        EXPECT_THROW(utility::text_parser::load(path, mixed), exception::io_exception);
+
+        {
+            utility::text_writer writer(path);
+            writer.write(points);
+        }
+
+        dimension3_soa<point3d> loaded;
+        utility::text_parser::load(path, loaded);
+        ASSERT_EQ(loaded.size(), points.size());
+        EXPECT_EQ(loaded.get(1), points[1]);
+
+        std::remove(path.c_str());
+    }
+
+    TEST(text_io_test, parse_stream_output)
+    {
+        //the output of operator<< can be read too
+        std::ostringstream stream;
+        stream << point3d(1, 2, 3) << "\n" << point3d(-4, 5.5, 6) << "\n";
+        const std::string text = stream.str();
+
+        dimension3_soa<point3d> points;
+        utility::text_parser::parse(text.data(), text.data() + text.size(), points);
+
+        ASSERT_EQ(points.size(), 2u);
+        EXPECT_EQ(points.get(1), point3d(-4, 5.5, 6));
+    }
+
+    TEST(text_io_test, parse_invalid)
+    {
+        const std::string incomplete = "1 2 3\n4 5\n";
+        const std::string word = "1 2 three\n";
+
+        std::vector<point3d> points;
+        EXPECT_THROW(utility::text_parser::parse(incomplete.data(), incomplete.data() + incomplete.size(), points),
+                     exception::io_exception);
+        EXPECT_THROW(utility::text_parser::parse(word.data(), word.data() + word.size(), points),
+                     exception::io_exception);
+
+        //empty text is no elements
+        const std::string empty = " \n\n";
+        dimension3_soa<point3d> none;
+        utility::text_parser::parse(empty.data(), empty.data() + empty.size(), none);
+        EXPECT_TRUE(none.empty());
+
+        EXPECT_THROW(utility::text_writer("missing_directory/text_io_test.txt"), exception::io_exception);
+    }
+} // namespace testing
@@ -0,0 +1,146 @@
+#include "pch.h"
+#include "BardCore/utility/thin_lens.h"
+
+namespace testing
+{
+    TEST(thin_lens_test, constructor)
+    {
+        const utility::thin_lens lens(0.5, 4);
+        EXPECT_EQ(lens.get_aperture(), 0.5);
+        EXPECT_EQ(lens.get_focal_distance(), 4);
+
+        EXPECT_NO_THROW(utility::thin_lens(0, 1));
+        EXPECT_THROW(utility::thin_lens(-1, 1), exception::negative_exception);
+        EXPECT_THROW(utility::thin_lens(1, -1), exception::negative_exception);
+        EXPECT_THROW(utility::thin_lens(1, 0), exception::zero_exception);
+    }
+
+    TEST(thin_lens_test, setters)
+    {
+        utility::thin_lens lens(0.5, 4);
+        lens.set_aperture(0.25);
+        lens.set_focal_distance(2);
+        EXPECT_EQ(lens.get_aperture(), 0.25);
+        EXPECT_EQ(lens.get_focal_distance(), 2);
+
+        EXPECT_THROW(lens.set_aperture(-1), exception::negative_exception);
+        EXPECT_THROW(lens.set_focal_distance(-1), exception::negative_exception);
+        EXPECT_THROW(lens.set_focal_distance(0), exception::zero_exception);
+    }
+
+    TEST(thin_lens_test, lens_sample)
+    {
+        const utility::thin_lens lens(2, 1);
+
+        //the center and the corners of the square map to the center and the rim of the disk
+        double x = 0, y = 0;
+        lens.lens_sample(0.5, 0.5, x, y);
+        EXPECT_NEAR(x, 0, ROUND_EPSILON);
+        EXPECT_NEAR(y, 0, ROUND_EPSILON);
+
+        lens.lens_sample(1, 0.5, x, y);
+        EXPECT_NEAR(x, 2, ROUND_EPSILON);
+        EXPECT_NEAR(y, 0, ROUND_EPSILON);
+
+        lens.lens_sample(0.5, 0, x, y);
+        EXPECT_NEAR(x, 0, ROUND_EPSILON);
+        EXPECT_NEAR(y, -2, ROUND_EPSILON);
+
+        for (int u = 0; u < 10; ++u)
+        {
+            for (int v = 0; v < 10; ++v)
+            {
+                lens.lens_sample(u / 10., v / 10., x, y);
+                EXPECT_LE(std::sqrt(x * x + y * y), 2 + ROUND_EPSILON);
+            }
+        }
+    }
+
+    TEST(thin_lens_test, shoot_ray)
+    {
+        const utility::camera cam(point3d(1, 2, 3), vector3d(0, -1, 1), 8, 6, 70);
+
+        //no aperture is the pinhole camera
+        const utility::thin_lens pinhole(0, 3);
+        const utility::ray expected = cam.shoot_subpixel_ray(2.5, 3.5, 10);
+        const utility::ray actual = pinhole.shoot_ray(cam, 2.5, 3.5, 0.2, 0.7, 10);
+        EXPECT_EQ(actual.get_position(), expected.get_position());
+        EXPECT_EQ(actual.get_direction(), expected.get_direction());
+        EXPECT_EQ(actual.get_distance(), 10);
+
+        //every lens sample of a screen position goes through the same point on the focal plane
+        const utility::thin_lens lens(0.5, 3);
+        const vector3d direction = cam.get_direction();
+        const utility::ray center = lens.shoot_ray(cam, 2.5, 3.5, 0.5, 0.5, 10);
+        const point3d focus = center.get_position() + center.get_direction() * (3 / center.get_direction().
+            dot(direction));
+
+        const double samples[3][2] = {{0.1, 0.2}, {0.9, 0.4}, {0.3, 0.95}};
+        for (const auto& sample : samples)
+        {
+            const utility::ray ray = lens.shoot_ray(cam, 2.5, 3.5, sample[0], sample[1], 10);
+            const vector3d offset = cam.get_position().get_vector(ray.get_position());
+
+            //the origin lies on the lens, in the plane of the screen
+            EXPECT_NEAR(offset.dot(direction), 0, ROUND_EPSILON);
+            EXPECT_LE(offset.length(), 0.5 + ROUND_EPSILON);
+            EXPECT_GT(offset.length(), 0);
+
+            const point3d hit = ray.get_position() + ray.get_direction() * (3 / ray.get_direction().dot(direction));
+            EXPECT_NEAR(hit.x, focus.x, ROUND_EPSILON);
+            EXPECT_NEAR(hit.y, focus.y, ROUND_EPSILON);
+            EXPECT_NEAR(hit.z, focus.z, ROUND_EPSILON);
+        }
+
+        EXPECT_THROW(lens.shoot_ray(cam, 8, 0, 0.5, 0.5, 10), exception::out_of_range_exception);
+        EXPECT_THROW(lens.shoot_ray(cam, -0.5, 0, 0.5, 0.5, 10), exception::out_of_range_exception);
+    }
+
+    TEST(thin_lens_test, shoot_rays)
+    {
+        const utility::camera cam(point3d(1, 2, 3), vector3d(0, -1, 1), 8, 6, 70);
+        const utility::thin_lens lens(0.25, 5);
+
+        utility::ray_queue queue;
+        lens.shoot_rays(cam, queue, 10, 3);
+
+        ASSERT_EQ(queue.size(), 8u * 6u);
+        for (std::size_t index = 0; index < queue.size(); ++index)
+        {
+            double u = 0, v = 0;
+            utility::thin_lens::lens_hash(static_cast<std::uint32_t>(index), 3, u, v);
+            const utility::ray expected = lens.shoot_ray(cam, static_cast<double>(index % 8),
+                                                         static_cast<double>(index / 8), u, v, 10);
+
+            EXPECT_NEAR(queue.origin.x()[index], expected.get_position().x, ROUND_EPSILON);
+            EXPECT_NEAR(queue.origin.y()[index], expected.get_position().y, ROUND_EPSILON);
+            EXPECT_NEAR(queue.origin.z()[index], expected.get_position().z, ROUND_EPSILON);
+            EXPECT_NEAR(queue.direction.x()[index], expected.get_direction().x, ROUND_EPSILON);
+            EXPECT_NEAR(queue.direction.y()[index], expected.get_direction().y, ROUND_EPSILON);
+            EXPECT_NEAR(queue.direction.z()[index], expected.get_direction().z, ROUND_EPSILON);
+            EXPECT_EQ(queue.distance[index], 10);
+            EXPECT_EQ(queue.pixel[index], index);
+            EXPECT_EQ(queue.throughput[index], 1);
+            EXPECT_EQ(queue.depth[index], 0u);
+        }
+
+        //another seed moves the origins on the lens
+        utility::ray_queue other;
+        lens.shoot_rays(cam, other, 10, 4);
+        EXPECT_NE(queue.origin.get(0), other.origin.get(0));
+
+        //no aperture is the pinhole camera
+        utility::ray_queue pinhole;
+        cam.shoot_rays(pinhole, 10);
+        utility::thin_lens(0, 5).shoot_rays(cam, queue, 10);
+        for (std::size_t index = 0; index < queue.size(); ++index)
+        {
+            EXPECT_EQ(queue.origin.get(index), pinhole.origin.get(index));
+            EXPECT_NEAR(queue.direction.x()[index], pinhole.direction.x()[index], ROUND_EPSILON);
+            EXPECT_NEAR(queue.direction.y()[index], pinhole.direction.y()[index], ROUND_EPSILON);
+            EXPECT_NEAR(queue.direction.z()[index], pinhole.direction.z()[index], ROUND_EPSILON);
+        }
+
+        EXPECT_THROW(lens.shoot_rays(cam, queue, -1), exception::negative_exception);
+    }
+} // namespace testing
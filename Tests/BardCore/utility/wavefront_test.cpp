@@ -0,0 +1,168 @@
+#include "pch.h"
+#include "BardCore/utility/wavefront.h"
+#include "BardCore/geometry/sphere_set.h"
+
+#include <vector>
+
+namespace testing
+{
+    TEST(wavefront_test, direct_light)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1, 0);
+
+        const utility::camera cam({0, 0, 0}, {0, 0, 1}, 10, 10);
+        utility::wavefront<geometry::sphere_set> tracer(spheres, {utility::light({0, 0, 0}, 2)},
+                                                        {utility::material(0.5)});
+
+        const std::vector<double>& image = tracer.render(cam);
+
+        ASSERT_EQ(image.size(), 100u);
+        EXPECT_NEAR(image[5 * 10 + 5], 0.5 * 2 / 16, ROUND_FOUR_DECIMALS); // hit at (0, 0, 4), lambert 1
+        EXPECT_EQ(image[0], 0); // corner misses the sphere
+    }
+
+    TEST(wavefront_test, shadow)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1, 0);
+
+        const utility::camera cam({0, 0, 0}, {0, 0, 1}, 10, 10);
+        const std::vector<utility::light> lights = {utility::light({0, 3, 0}, 1)};
+        const std::vector<utility::material> materials = {utility::material(1)};
+
+        utility::wavefront<geometry::sphere_set> lit(spheres, lights, materials);
+        EXPECT_NEAR(lit.render(cam)[5 * 10 + 5], 0.8 / 25, ROUND_FOUR_DECIMALS); // lambert 4/5, distance 5
+
+        geometry::sphere_set blocked_spheres = spheres;
+        blocked_spheres.add({0, 1.5, 2}, 0.3, 0); // halfway between hit and light
+        utility::wavefront<geometry::sphere_set> blocked(blocked_spheres, lights, materials);
+        EXPECT_EQ(blocked.render(cam)[5 * 10 + 5], 0);
+    }
+
+    TEST(wavefront_test, reflection)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1, 0); // mirror in front of the camera
+        spheres.add({0, 0, -5}, 1, 1); // diffuse behind the camera
+
+        const utility::camera cam({0, 0, 0}, {0, 0, 1}, 10, 10);
+        utility::wavefront<geometry::sphere_set> tracer(spheres, {utility::light({0, 0, 0}, 1)},
+                                                        {utility::material(0, 1), utility::material(1)});
+
+        // the mirror itself has no albedo, the light comes from the diffuse sphere at (0, 0, -4)
+        EXPECT_NEAR(tracer.render(cam)[5 * 10 + 5], 1. / 16, ROUND_FOUR_DECIMALS);
+
+        tracer.set_max_depth(1);
+        EXPECT_EQ(tracer.render(cam)[5 * 10 + 5], 0);
+    }
+
+    TEST(wavefront_test, refraction)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1, 0); // glass in front of the camera
+        spheres.add({0, 0, 12}, 1, 1); // diffuse behind the glass
+
+        const utility::camera cam({0, 0, 0}, {0, 0, 1}, 10, 10);
+        utility::wavefront<geometry::sphere_set> tracer(spheres, {utility::light({0, 0, 8}, 1)},
+                                                        {utility::material(0, 0, 1, 1.5), utility::material(1)});
+
+        // the center ray goes straight through the glass and hits the diffuse sphere at (0, 0, 11)
+        EXPECT_NEAR(tracer.render(cam)[5 * 10 + 5], 1. / 9, ROUND_FOUR_DECIMALS);
+    }
+
+    TEST(wavefront_test, sort_by_octant)
+    {
+        const geometry::sphere_set spheres;
+        const utility::camera cam({0, 0, 0}, {1, 1, 1}, 16, 16);
+        utility::wavefront<geometry::sphere_set> tracer(spheres, {}, {});
+
+        tracer.generate(cam);
+        tracer.sort_by_octant();
+
+        const utility::ray_queue& paths = tracer.get_paths();
+        ASSERT_EQ(paths.size(), 256u);
+
+        unsigned int previous = 0;
+        for (std::size_t index = 0; index < paths.size(); ++index)
+        {
+            const vector3d direction = paths.direction.get(index);
+            const unsigned int octant = (direction.x < 0) | (direction.y < 0) << 1 | (direction.z < 0) << 2;
+            EXPECT_LE(previous, octant);
+            previous = octant;
+        }
+    }
+
+    TEST(wavefront_test, sort_by_material)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({-1, 0, 5}, 1, 1);
+        spheres.add({1, 0, 5}, 1, 0);
+
+        const utility::camera cam({0, 0, 0}, {0, 0, 1}, 16, 16);
+        utility::wavefront<geometry::sphere_set> tracer(spheres, {}, {utility::material(1), utility::material(1)});
+
+        tracer.generate(cam);
+        tracer.extend();
+        tracer.sort_by_material();
+
+        const utility::hit_queue& hits = tracer.get_hits();
+        for (std::size_t index = 1; index < hits.size(); ++index)
+            EXPECT_LE(hits.material[index - 1], hits.material[index]); // no_hit is the biggest value
+        EXPECT_EQ(hits.material[0], 0u);
+        EXPECT_FALSE(hits.is_hit(hits.size() - 1));
+    }
+
+    TEST(wavefront_test, light_on_hit)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1, 0);
+
+        // the center ray hits (0, 0, 4), the same falloff as light_set gives 0 there
+        const utility::light light({0, 0, 4}, 1);
+        const utility::camera cam({0, 0, 0}, {0, 0, 1}, 10, 10);
+        utility::wavefront<geometry::sphere_set> tracer(spheres, {light}, {utility::material(1)});
+
+        EXPECT_EQ(tracer.render(cam)[5 * 10 + 5], 0);
+        EXPECT_EQ(utility::light_set::falloff(1, 0), 0);
+    }
+
+    TEST(wavefront_test, threads)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1, 0);
+        spheres.add({1.5, 0.5, 6}, 1, 1);
+        spheres.add({-1, -1, 4}, 0.5, 2);
+
+        const utility::camera cam({0, 0, 0}, {0, 0, 1}, 24, 24);
+        const std::vector<utility::light> lights = {utility::light({0, 3, 0}, 5), utility::light({3, 0, 1}, 2)};
+        const std::vector<utility::material> materials = {
+            utility::material(0.5, 0.5), utility::material(0.2, 0.1, 0.7, 1.4), utility::material(1)
+        };
+
+        utility::wavefront<geometry::sphere_set> serial(spheres, lights, materials);
+        utility::wavefront<geometry::sphere_set> threaded(spheres, lights, materials);
+        serial.set_threads(1);
+        threaded.set_threads(3);
+
+        const std::vector<double> serial_image = serial.render(cam);
+        const std::vector<double>& threaded_image = threaded.render(cam);
+
+        ASSERT_EQ(serial_image.size(), threaded_image.size());
+        for (std::size_t index = 0; index < serial_image.size(); ++index)
+            EXPECT_NEAR(serial_image[index], threaded_image[index], ROUND_EPSILON);
+    }
+
+    TEST(wavefront_test, exceptions)
+    {
+        geometry::sphere_set spheres;
+        spheres.add({0, 0, 5}, 1, 3); // material 3 does not exist
+
+        const utility::camera cam({0, 0, 0}, {0, 0, 1}, 4, 4);
+        utility::wavefront<geometry::sphere_set> tracer(spheres, {}, {utility::material(1)});
+
+        EXPECT_THROW(tracer.render(cam), exception::out_of_range_exception);
+        EXPECT_THROW(tracer.set_max_depth(0), exception::zero_exception);
+        EXPECT_THROW(tracer.set_min_throughput(-1), exception::negative_exception);
+    }
+} // namespace testing